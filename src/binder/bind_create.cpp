@@ -20,6 +20,7 @@
 // THE SOFTWARE.
 //===----------------------------------------------------------------------===//
 
+#include <cstring>
 #include <iterator>
 #include <memory>
 #include <string>
@@ -112,7 +113,32 @@ auto Binder::BindCreate(duckdb_libpgquery::PGCreateStmt *pg_stmt) -> std::unique
     throw bustub::Exception("should have at least 1 column");
   }
 
-  return std::make_unique<CreateStatement>(std::move(table), std::move(columns));
+  auto storage = TableStorage::ROW;
+  if (pg_stmt->options != nullptr) {
+    for (auto node = pg_stmt->options->head; node != nullptr; node = node->next) {
+      auto option = reinterpret_cast<duckdb_libpgquery::PGDefElem *>(node->data.ptr_value);
+      if (strcmp(option->defname, "storage") != 0) {
+        throw NotImplementedException(fmt::format("unsupported table option: {}", option->defname));
+      }
+      // `storage = columnar` is parsed as a type name, `storage = 'columnar'` as a string.
+      std::string value;
+      if (option->arg != nullptr && option->arg->type == duckdb_libpgquery::T_PGTypeName) {
+        auto type_name = reinterpret_cast<duckdb_libpgquery::PGTypeName *>(option->arg);
+        value = reinterpret_cast<duckdb_libpgquery::PGValue *>(type_name->names->tail->data.ptr_value)->val.str;
+      } else if (option->arg != nullptr && option->arg->type == duckdb_libpgquery::T_PGString) {
+        value = reinterpret_cast<duckdb_libpgquery::PGValue *>(option->arg)->val.str;
+      }
+      if (value == "row") {
+        storage = TableStorage::ROW;
+      } else if (value == "columnar") {
+        storage = TableStorage::COLUMNAR;
+      } else {
+        throw NotImplementedException(fmt::format("unsupported table storage: {}", value));
+      }
+    }
+  }
+
+  return std::make_unique<CreateStatement>(std::move(table), std::move(columns), storage);
 }
 
 auto Binder::BindIndex(duckdb_libpgquery::PGIndexStmt *stmt) -> std::unique_ptr<IndexStatement> {
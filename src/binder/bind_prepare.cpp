@@ -0,0 +1,113 @@
+#include <algorithm>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "binder/binder.h"
+#include "binder/bound_expression.h"
+#include "binder/expressions/bound_constant.h"
+#include "binder/expressions/bound_parameter.h"
+#include "binder/statement/prepare_statement.h"
+#include "common/exception.h"
+#include "fmt/format.h"
+#include "nodes/parsenodes.hpp"
+
+namespace bustub {
+
+namespace {
+
+auto BindParameterType(duckdb_libpgquery::PGTypeName *type_name) -> TypeId {
+  auto name =
+      std::string(reinterpret_cast<duckdb_libpgquery::PGValue *>(type_name->names->tail->data.ptr_value)->val.str);
+  if (name == "int4") {
+    return TypeId::INTEGER;
+  }
+  if (name == "int8") {
+    return TypeId::BIGINT;
+  }
+  if (name == "int2") {
+    return TypeId::SMALLINT;
+  }
+  if (name == "bool") {
+    return TypeId::BOOLEAN;
+  }
+  if (name == "numeric" || name == "float8") {
+    return TypeId::DECIMAL;
+  }
+  if (name == "varchar" || name == "text") {
+    return TypeId::VARCHAR;
+  }
+  throw NotImplementedException(fmt::format("unsupported parameter type: {}", name));
+}
+
+}  // namespace
+
+auto Binder::BindPrepare(duckdb_libpgquery::PGPrepareStmt *stmt) -> std::unique_ptr<PrepareStatement> {
+  std::vector<TypeId> types;
+  if (stmt->argtypes != nullptr) {
+    for (auto node = stmt->argtypes->head; node != nullptr; node = lnext(node)) {
+      types.push_back(BindParameterType(reinterpret_cast<duckdb_libpgquery::PGTypeName *>(node->data.ptr_value)));
+    }
+  }
+  auto sql = statement_length_ == 0 ? query_.substr(statement_location_)
+                                    : query_.substr(statement_location_, statement_length_);
+
+  parameter_types_ = types;
+  num_parameters_ = 0;
+  auto statement = BindStatement(stmt->query);
+  parameter_types_ = std::nullopt;
+
+  auto num_parameters = std::max<uint32_t>(num_parameters_, types.size());
+  return std::make_unique<PrepareStatement>(stmt->name, std::move(sql), std::move(types), num_parameters,
+                                            std::move(statement));
+}
+
+auto Binder::BindExecute(duckdb_libpgquery::PGExecuteStmt *stmt) -> std::unique_ptr<ExecuteStatement> {
+  std::vector<Value> parameters;
+  if (stmt->params != nullptr) {
+    for (const auto &expr : BindExpressionList(stmt->params)) {
+      if (expr->type_ != ExpressionType::CONSTANT) {
+        throw bustub::NotImplementedException("Only constants are supported as parameters");
+      }
+      parameters.push_back(dynamic_cast<const BoundConstant &>(*expr).val_);
+    }
+  }
+  return std::make_unique<ExecuteStatement>(stmt->name, std::move(parameters));
+}
+
+auto Binder::BindDeallocate(duckdb_libpgquery::PGDeallocateStmt *stmt) -> std::unique_ptr<DeallocateStatement> {
+  if (stmt->name == nullptr) {
+    return std::make_unique<DeallocateStatement>(std::nullopt);
+  }
+  return std::make_unique<DeallocateStatement>(stmt->name);
+}
+
+auto Binder::BindParamRef(duckdb_libpgquery::PGParamRef *node) -> std::unique_ptr<BoundExpression> {
+  if (!parameter_types_.has_value()) {
+    throw bustub::Exception("parameters are only supported in prepared statements");
+  }
+  uint32_t index;
+  if (node->number > 0) {
+    index = node->number - 1;
+  } else {
+    // A `?` is numbered by its position among the `?` of the statement, which are not bound in the order they appear.
+    index = 0;
+    char quote = 0;
+    for (auto i = static_cast<size_t>(statement_location_); i < static_cast<size_t>(node->location); i++) {
+      auto c = query_[i];
+      if (quote != 0) {
+        quote = c == quote ? 0 : quote;
+      } else if (c == '\'' || c == '"') {
+        quote = c;
+      } else if (c == '?') {
+        index++;
+      }
+    }
+  }
+  num_parameters_ = std::max(num_parameters_, index + 1);
+  auto type = index < parameter_types_->size() ? (*parameter_types_)[index] : TypeId::INTEGER;
+  return std::make_unique<BoundParameter>(index, type);
+}
+
+}  // namespace bustub
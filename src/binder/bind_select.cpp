@@ -2,6 +2,7 @@
 #include <iterator>
 #include <memory>
 #include <optional>
+#include <utility>
 #include <vector>
 #include "binder/binder.h"
 #include "binder/bound_expression.h"
@@ -125,6 +126,8 @@ auto Binder::BindCTE(duckdb_libpgquery::PGWithClause *node) -> std::vector<std::
 
 auto Binder::BindSelect(duckdb_libpgquery::PGSelectStmt *pg_stmt) -> std::unique_ptr<SelectStatement> {
   auto ctx_guard = NewContext();
+  // Only the WHERE clause of a subquery in WHERE may refer to the columns of the query it is in.
+  auto outer_scope = std::exchange(outer_scope_, nullptr);
   // Bind VALUES clause.
   if (pg_stmt->valuesLists != nullptr) {
     auto values_list_name = fmt::format("__values#{}", universal_id_++);
@@ -174,7 +177,9 @@ auto Binder::BindSelect(duckdb_libpgquery::PGSelectStmt *pg_stmt) -> std::unique
   // Bind WHERE clause.
   auto where = std::make_unique<BoundExpression>();
   if (pg_stmt->whereClause != nullptr) {
-    where = BindWhere(pg_stmt->whereClause);
+    outer_scope_ = outer_scope;
+    where = BindWhere(pg_stmt->whereClause, &table);
+    outer_scope_ = nullptr;
   }
 
   // Bind GROUP BY clause.
@@ -480,6 +485,11 @@ auto Binder::BindColumnRef(duckdb_libpgquery::PGColumnRef *node) -> std::unique_
       for (auto node = fields->head; node != nullptr; node = node->next) {
         column_names.emplace_back(reinterpret_cast<duckdb_libpgquery::PGValue *>(node->data.ptr_value)->val.str);
       }
+      if (outer_scope_ != nullptr && ResolveColumnInternal(*scope_, column_names) == nullptr) {
+        auto expr = ResolveColumn(*outer_scope_, column_names);
+        outer_column_refs_.insert(expr.get());
+        return expr;
+      }
       return ResolveColumn(*scope_, column_names);
     }
     case duckdb_libpgquery::T_PGAStar: {
@@ -620,9 +630,10 @@ auto Binder::ResolveColumnRefFromSelectList(const std::vector<std::vector<std::s
 auto Binder::ResolveColumnRefFromSubqueryRef(const BoundSubqueryRef &subquery_ref, const std::string &alias,
                                              const std::vector<std::string> &col_name)
     -> std::unique_ptr<BoundColumnRef> {
-  // Firstly, try directly resolve the column name through schema
+  // Firstly, try directly resolve the column name through schema. Columns are named after the alias, which differs
+  // from the name of the subquery for a CTE referenced as `cte AS alias`.
   std::unique_ptr<BoundColumnRef> direct_resolved_expr = BoundColumnRef::Prepend(
-      ResolveColumnRefFromSelectList(subquery_ref.select_list_name_, col_name), subquery_ref.alias_);
+      ResolveColumnRefFromSelectList(subquery_ref.select_list_name_, col_name), alias);
 
   std::unique_ptr<BoundColumnRef> strip_resolved_expr = nullptr;
 
@@ -632,7 +643,7 @@ auto Binder::ResolveColumnRefFromSubqueryRef(const BoundSubqueryRef &subquery_re
       auto strip_column_name = col_name;
       strip_column_name.erase(strip_column_name.begin());
       strip_resolved_expr = BoundColumnRef::Prepend(
-          ResolveColumnRefFromSelectList(subquery_ref.select_list_name_, strip_column_name), subquery_ref.alias_);
+          ResolveColumnRefFromSelectList(subquery_ref.select_list_name_, strip_column_name), alias);
     }
   }
 
@@ -668,6 +679,9 @@ auto Binder::ResolveColumnInternal(const BoundTableRef &table_ref, const std::ve
     case TableReferenceType::JOIN: {
       const auto &join_ref = dynamic_cast<const BoundJoinRef &>(table_ref);
       auto left_column = ResolveColumnInternal(*join_ref.left_, col_name);
+      if (join_ref.join_type_ == JoinType::SEMI || join_ref.join_type_ == JoinType::ANTI) {
+        return left_column;
+      }
       auto right_column = ResolveColumnInternal(*join_ref.right_, col_name);
       if (left_column != nullptr && right_column != nullptr) {
         throw Exception(fmt::format("{} is ambiguous", fmt::join(col_name, ".")));
@@ -706,8 +720,35 @@ auto Binder::ResolveColumn(const BoundTableRef &scope, const std::vector<std::st
   return expr;
 }
 
-auto Binder::BindWhere(duckdb_libpgquery::PGNode *root) -> std::unique_ptr<BoundExpression> {
-  return BindExpression(root);
+auto Binder::BindWhere(duckdb_libpgquery::PGNode *root, std::unique_ptr<BoundTableRef> *table)
+    -> std::unique_ptr<BoundExpression> {
+  std::vector<duckdb_libpgquery::PGNode *> conjuncts{root};
+  if (root->type == duckdb_libpgquery::T_PGBoolExpr &&
+      reinterpret_cast<duckdb_libpgquery::PGBoolExpr *>(root)->boolop == duckdb_libpgquery::PG_AND_EXPR) {
+    conjuncts.clear();
+    for (auto node = reinterpret_cast<duckdb_libpgquery::PGBoolExpr *>(root)->args->head; node != nullptr;
+         node = node->next) {
+      conjuncts.push_back(reinterpret_cast<duckdb_libpgquery::PGNode *>(node->data.ptr_value));
+    }
+  }
+
+  // The subqueries among the conjuncts join the FROM clause, and the other conjuncts filter the result.
+  std::unique_ptr<BoundExpression> where = nullptr;
+  for (auto *conjunct : conjuncts) {
+    if (BindSubqueryPredicate(conjunct, table)) {
+      continue;
+    }
+    auto expr = BindExpression(conjunct);
+    if (where == nullptr) {
+      where = std::move(expr);
+    } else {
+      where = std::make_unique<BoundBinaryOp>("and", std::move(where), std::move(expr));
+    }
+  }
+  if (where == nullptr) {
+    return std::make_unique<BoundExpression>();
+  }
+  return where;
 }
 
 auto Binder::BindGroupBy(duckdb_libpgquery::PGList *list) -> std::vector<std::unique_ptr<BoundExpression>> {
@@ -800,6 +841,10 @@ auto Binder::BindExpression(duckdb_libpgquery::PGNode *node) -> std::unique_ptr<
       return BindAExpr(reinterpret_cast<duckdb_libpgquery::PGAExpr *>(node));
     case duckdb_libpgquery::T_PGBoolExpr:
       return BindBoolExpr(reinterpret_cast<duckdb_libpgquery::PGBoolExpr *>(node));
+    case duckdb_libpgquery::T_PGParamRef:
+      return BindParamRef(reinterpret_cast<duckdb_libpgquery::PGParamRef *>(node));
+    case duckdb_libpgquery::T_PGSubLink:
+      throw NotImplementedException("subqueries are only supported as conjuncts of WHERE");
     default:
       break;
   }
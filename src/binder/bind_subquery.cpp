@@ -0,0 +1,212 @@
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "binder/binder.h"
+#include "binder/bound_expression.h"
+#include "binder/expressions/bound_agg_call.h"
+#include "binder/expressions/bound_alias.h"
+#include "binder/expressions/bound_binary_op.h"
+#include "binder/expressions/bound_column_ref.h"
+#include "binder/expressions/bound_constant.h"
+#include "binder/expressions/bound_func_call.h"
+#include "binder/expressions/bound_unary_op.h"
+#include "binder/statement/select_statement.h"
+#include "binder/table_ref/bound_join_ref.h"
+#include "binder/table_ref/bound_subquery_ref.h"
+#include "common/exception.h"
+#include "fmt/format.h"
+#include "fmt/ranges.h"
+#include "nodes/parsenodes.hpp"
+#include "nodes/primnodes.hpp"
+#include "type/value_factory.h"
+
+namespace bustub {
+
+namespace {
+
+void SplitConjuncts(std::unique_ptr<BoundExpression> expr, std::vector<std::unique_ptr<BoundExpression>> *conjuncts) {
+  if (expr->type_ == ExpressionType::BINARY_OP) {
+    auto &binary_op = dynamic_cast<BoundBinaryOp &>(*expr);
+    if (binary_op.op_name_ == "and") {
+      SplitConjuncts(std::move(binary_op.larg_), conjuncts);
+      SplitConjuncts(std::move(binary_op.rarg_), conjuncts);
+      return;
+    }
+  }
+  conjuncts->push_back(std::move(expr));
+}
+
+auto MakeConjunction(std::vector<std::unique_ptr<BoundExpression>> conjuncts) -> std::unique_ptr<BoundExpression> {
+  if (conjuncts.empty()) {
+    return std::make_unique<BoundExpression>();
+  }
+  auto expr = std::move(conjuncts[0]);
+  for (size_t i = 1; i < conjuncts.size(); i++) {
+    expr = std::make_unique<BoundBinaryOp>("and", std::move(expr), std::move(conjuncts[i]));
+  }
+  return expr;
+}
+
+/** Call `visit` on every column ref of an expression, which it may replace. */
+void VisitColumnRefs(std::unique_ptr<BoundExpression> *expr,
+                     const std::function<void(std::unique_ptr<BoundExpression> *)> &visit) {
+  switch ((*expr)->type_) {
+    case ExpressionType::COLUMN_REF:
+      visit(expr);
+      return;
+    case ExpressionType::BINARY_OP: {
+      auto &binary_op = dynamic_cast<BoundBinaryOp &>(**expr);
+      VisitColumnRefs(&binary_op.larg_, visit);
+      VisitColumnRefs(&binary_op.rarg_, visit);
+      return;
+    }
+    case ExpressionType::UNARY_OP:
+      VisitColumnRefs(&dynamic_cast<BoundUnaryOp &>(**expr).arg_, visit);
+      return;
+    case ExpressionType::FUNC_CALL:
+      for (auto &arg : dynamic_cast<BoundFuncCall &>(**expr).args_) {
+        VisitColumnRefs(&arg, visit);
+      }
+      return;
+    case ExpressionType::AGG_CALL:
+      for (auto &arg : dynamic_cast<BoundAggCall &>(**expr).args_) {
+        VisitColumnRefs(&arg, visit);
+      }
+      return;
+    case ExpressionType::ALIAS:
+      VisitColumnRefs(&dynamic_cast<BoundAlias &>(**expr).child_, visit);
+      return;
+    default:
+      return;
+  }
+}
+
+}  // namespace
+
+auto Binder::BindSubqueryPredicate(duckdb_libpgquery::PGNode *node, std::unique_ptr<BoundTableRef> *table) -> bool {
+  auto join_type = JoinType::SEMI;
+  if (node->type == duckdb_libpgquery::T_PGBoolExpr) {
+    auto *bool_expr = reinterpret_cast<duckdb_libpgquery::PGBoolExpr *>(node);
+    if (bool_expr->boolop != duckdb_libpgquery::PG_NOT_EXPR || bool_expr->args->length != 1) {
+      return false;
+    }
+    node = reinterpret_cast<duckdb_libpgquery::PGNode *>(bool_expr->args->head->data.ptr_value);
+    join_type = JoinType::ANTI;
+  }
+  if (node->type != duckdb_libpgquery::T_PGSubLink) {
+    return false;
+  }
+  auto *sub_link = reinterpret_cast<duckdb_libpgquery::PGSubLink *>(node);
+
+  // Neither side of the predicate may refer to the query around this one.
+  auto saved_outer_scope = std::exchange(outer_scope_, nullptr);
+  std::unique_ptr<BoundExpression> in_expr = nullptr;
+  switch (sub_link->subLinkType) {
+    case duckdb_libpgquery::PG_EXISTS_SUBLINK:
+      break;
+    case duckdb_libpgquery::PG_ANY_SUBLINK: {
+      // `x IN (...)` has no operator name, `x = ANY (...)` has one.
+      std::string op_name = "=";
+      if (sub_link->operName != nullptr) {
+        op_name = reinterpret_cast<duckdb_libpgquery::PGValue *>(sub_link->operName->head->data.ptr_value)->val.str;
+      }
+      if (op_name != "=") {
+        throw NotImplementedException(fmt::format("{} ANY (subquery) is not supported", op_name));
+      }
+      if (join_type == JoinType::ANTI) {
+        // `x NOT IN (...)` is null rather than true if `x` or any value of the subquery is null.
+        throw NotImplementedException("NOT IN (subquery) is not supported, use NOT EXISTS instead");
+      }
+      in_expr = BindExpression(sub_link->testexpr);
+      break;
+    }
+    default:
+      throw NotImplementedException("only EXISTS and IN subqueries are supported in WHERE");
+  }
+
+  auto alias = fmt::format("__subquery#{}", universal_id_++);
+  outer_scope_ = scope_;
+  auto subquery_ref = BindSubquery(reinterpret_cast<duckdb_libpgquery::PGSelectStmt *>(sub_link->subselect), alias);
+  outer_scope_ = saved_outer_scope;
+
+  std::vector<std::unique_ptr<BoundExpression>> conditions;
+  if (in_expr != nullptr) {
+    if (subquery_ref->select_list_name_.size() != 1) {
+      throw bustub::Exception("subquery of IN must return exactly one column");
+    }
+    auto column =
+        BoundColumnRef::Prepend(std::make_unique<BoundColumnRef>(subquery_ref->select_list_name_[0]), alias);
+    conditions.push_back(std::make_unique<BoundBinaryOp>("=", std::move(in_expr), std::move(column)));
+  }
+  for (auto &condition : DecorrelateSubquery(subquery_ref.get())) {
+    conditions.push_back(std::move(condition));
+  }
+
+  auto condition = MakeConjunction(std::move(conditions));
+  if (condition->IsInvalid()) {
+    condition = std::make_unique<BoundConstant>(ValueFactory::GetBooleanValue(true));
+  }
+  *table = std::make_unique<BoundJoinRef>(join_type, std::move(*table), std::move(subquery_ref), std::move(condition));
+  return true;
+}
+
+auto Binder::DecorrelateSubquery(BoundSubqueryRef *subquery_ref) -> std::vector<std::unique_ptr<BoundExpression>> {
+  auto &subquery = *subquery_ref->subquery_;
+  std::vector<std::unique_ptr<BoundExpression>> correlated;
+  if (subquery.where_->IsInvalid()) {
+    return correlated;
+  }
+
+  // The conjuncts of the subquery's WHERE clause that refer to the outer query become part of the join condition.
+  std::vector<std::unique_ptr<BoundExpression>> conjuncts;
+  SplitConjuncts(std::move(subquery.where_), &conjuncts);
+  std::vector<std::unique_ptr<BoundExpression>> uncorrelated;
+  for (auto &conjunct : conjuncts) {
+    bool is_correlated = false;
+    VisitColumnRefs(&conjunct, [&](std::unique_ptr<BoundExpression> *expr) {
+      is_correlated = is_correlated || outer_column_refs_.count(expr->get()) != 0;
+    });
+    (is_correlated ? correlated : uncorrelated).push_back(std::move(conjunct));
+  }
+  subquery.where_ = MakeConjunction(std::move(uncorrelated));
+  if (correlated.empty()) {
+    return correlated;
+  }
+
+  // Pulling the conjuncts up is only correct if the subquery produces one row for each row it reads.
+  bool has_aggregation = false;
+  for (const auto &expr : subquery.select_list_) {
+    has_aggregation = has_aggregation || expr->HasAggregation();
+  }
+  if (has_aggregation || !subquery.group_by_.empty() || !subquery.having_->IsInvalid() || subquery.is_distinct_ ||
+      !subquery.limit_count_->IsInvalid() || !subquery.limit_offset_->IsInvalid()) {
+    throw NotImplementedException("correlated subqueries with aggregation, DISTINCT or LIMIT are not supported");
+  }
+
+  // The columns of the subquery the conjuncts use are added to its select list, for the join to evaluate them on.
+  std::unordered_map<std::string, std::string> correlated_columns;
+  for (auto &conjunct : correlated) {
+    VisitColumnRefs(&conjunct, [&](std::unique_ptr<BoundExpression> *expr) {
+      if (outer_column_refs_.erase(expr->get()) != 0) {
+        return;
+      }
+      const auto &col_name = dynamic_cast<const BoundColumnRef &>(**expr).col_name_;
+      auto key = fmt::format("{}", fmt::join(col_name, "."));
+      auto it = correlated_columns.find(key);
+      if (it == correlated_columns.end()) {
+        auto name = fmt::format("__corr#{}", universal_id_++);
+        subquery.select_list_.push_back(std::make_unique<BoundAlias>(name, std::make_unique<BoundColumnRef>(col_name)));
+        subquery_ref->select_list_name_.push_back({name});
+        it = correlated_columns.emplace(key, name).first;
+      }
+      *expr = std::make_unique<BoundColumnRef>(std::vector{subquery_ref->alias_, it->second});
+    });
+  }
+  return correlated;
+}
+
+}  // namespace bustub
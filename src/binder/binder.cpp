@@ -43,6 +43,7 @@ namespace bustub {
 Binder::Binder(const Catalog &catalog) : catalog_(catalog) {}
 
 void Binder::ParseAndSave(const std::string &query) {
+  query_ = query;
   parser_.Parse(query);
   if (!parser_.success) {
     LOG_INFO("Query failed to parse!");
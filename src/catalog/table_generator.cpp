@@ -116,6 +116,13 @@ void TableGenerator::GenerateTestTables() {
         {"colB", TypeId::INTEGER, true, Dist::Uniform, 0, 999},
         {"colC", TypeId::INTEGER, true, Dist::Cyclic, 0, 9}}},
 
+      // A table of many morsels for parallel scans, with values that do not depend on the random generator
+      {"test_parallel",
+       TEST_PARALLEL_SIZE,
+       {{"colA", TypeId::INTEGER, false, Dist::Serial, 0, 0},
+        {"colB", TypeId::INTEGER, false, Dist::Cyclic, 0, 99},
+        {"colC", TypeId::INTEGER, false, Dist::Cyclic, 0, 6}}},
+
       // // Table 3
       // {"test_3",
       //  TEST3_SIZE,
@@ -1,5 +1,5 @@
-// DDL (Data Definition Language) statement handling in BusTub, including create table, create index, and set/show
-// variable.
+// DDL (Data Definition Language) statement handling in BusTub, including create table, create index, set/show
+// variable, and prepare/execute/deallocate.
 
 #include <optional>
 #include <shared_mutex>
@@ -12,6 +12,7 @@
 #include "binder/statement/create_statement.h"
 #include "binder/statement/explain_statement.h"
 #include "binder/statement/index_statement.h"
+#include "binder/statement/prepare_statement.h"
 #include "binder/statement/select_statement.h"
 #include "binder/statement/set_show_statement.h"
 #include "buffer/buffer_pool_manager.h"
@@ -31,6 +32,7 @@
 #include "fmt/core.h"
 #include "fmt/format.h"
 #include "optimizer/optimizer.h"
+#include "optimizer/plan_cache.h"
 #include "planner/planner.h"
 #include "recovery/checkpoint_manager.h"
 #include "recovery/log_manager.h"
@@ -42,7 +44,7 @@ namespace bustub {
 
 void BustubInstance::HandleCreateStatement(Transaction *txn, const CreateStatement &stmt, ResultWriter &writer) {
   std::unique_lock<std::shared_mutex> l(catalog_lock_);
-  auto info = catalog_->CreateTable(txn, stmt.table_, Schema(stmt.columns_));
+  auto info = catalog_->CreateTable(txn, stmt.table_, Schema(stmt.columns_), true, stmt.storage_);
   l.unlock();
 
   if (info == nullptr) {
@@ -136,4 +138,89 @@ void BustubInstance::HandleVariableSetStatement(Transaction *txn, const Variable
   session_variables_[stmt.variable_] = stmt.value_;
 }
 
+auto BustubInstance::MakePreparedPlan(const PrepareStatement &stmt) -> std::shared_ptr<const PreparedPlan> {
+  return std::make_shared<PreparedPlan>(
+      PreparedPlan{stmt.sql_, stmt.types_, stmt.num_parameters_, PlanStatement(*stmt.statement_)});
+}
+
+void BustubInstance::HandlePrepareStatement(Transaction *txn, const PrepareStatement &stmt, ResultWriter &writer) {
+  auto prepared = MakePreparedPlan(stmt);
+  std::scoped_lock<std::mutex> guard(prepared_statements_latch_);
+  if (prepared_statements_.count(stmt.name_) != 0) {
+    throw bustub::Exception(fmt::format("prepared statement {} already exists", stmt.name_));
+  }
+  prepared_statements_.emplace(stmt.name_, std::move(prepared));
+}
+
+auto BustubInstance::HandleExecuteStatement(Transaction *txn, const ExecuteStatement &stmt,
+                                            std::shared_ptr<CheckOptions> check_options, ResultWriter &writer)
+    -> bool {
+  std::unique_lock<std::mutex> guard(prepared_statements_latch_);
+  auto it = prepared_statements_.find(stmt.name_);
+  if (it == prepared_statements_.end()) {
+    throw bustub::Exception(fmt::format("prepared statement {} does not exist", stmt.name_));
+  }
+  auto prepared = it->second;
+  guard.unlock();
+
+  if (stmt.parameters_.size() != prepared->num_parameters_) {
+    throw bustub::Exception(fmt::format("prepared statement {} takes {} parameters, but {} are given", stmt.name_,
+                                        prepared->num_parameters_, stmt.parameters_.size()));
+  }
+  std::vector<Value> parameters;
+  for (uint32_t i = 0; i < stmt.parameters_.size(); i++) {
+    const auto &value = stmt.parameters_[i];
+    if (i >= prepared->types_.size() || value.GetTypeId() == prepared->types_[i]) {
+      parameters.push_back(value);
+    } else if (value.IsNull()) {
+      parameters.push_back(ValueFactory::GetNullValueByType(prepared->types_[i]));
+    } else {
+      parameters.push_back(value.CastAs(prepared->types_[i]));
+    }
+  }
+
+  // Only the parameters are bound, the rest of the generic plan is shared by all executions.
+  auto plan = *prepared->plan_;
+  plan.plan_ = BindPlanParameters(plan.plan_, parameters);
+  return ExecutePlan(txn, plan, std::move(check_options), writer);
+}
+
+void BustubInstance::HandleDeallocateStatement(Transaction *txn, const DeallocateStatement &stmt,
+                                               ResultWriter &writer) {
+  std::scoped_lock<std::mutex> guard(prepared_statements_latch_);
+  if (!stmt.name_.has_value()) {
+    prepared_statements_.clear();
+    return;
+  }
+  if (prepared_statements_.erase(*stmt.name_) == 0) {
+    throw bustub::Exception(fmt::format("prepared statement {} does not exist", *stmt.name_));
+  }
+}
+
+void BustubInstance::RefreshPreparedStatements() {
+  auto catalog_version = catalog_->GetVersion();
+  std::scoped_lock<std::mutex> guard(prepared_statements_latch_);
+  if (prepared_statements_version_ == catalog_version) {
+    return;
+  }
+  for (auto &[name, prepared] : prepared_statements_) {
+    if (prepared->plan_->catalog_version_ == catalog_version) {
+      continue;
+    }
+    // A new table or index may give a better plan. The old plan still works, as nothing is ever dropped, so it is
+    // kept if the statement no longer plans.
+    try {
+      std::shared_lock<std::shared_mutex> l(catalog_lock_);
+      bustub::Binder binder(*catalog_);
+      binder.ParseAndSave(prepared->sql_);
+      l.unlock();
+      auto statement = binder.BindStatement(binder.statement_nodes_.at(0));
+      prepared = MakePreparedPlan(dynamic_cast<const PrepareStatement &>(*statement));
+    } catch (bustub::Exception &e) {
+      continue;
+    }
+  }
+  prepared_statements_version_ = catalog_version;
+}
+
 }  // namespace bustub
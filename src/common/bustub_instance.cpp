@@ -9,6 +9,7 @@
 #include "binder/statement/create_statement.h"
 #include "binder/statement/explain_statement.h"
 #include "binder/statement/index_statement.h"
+#include "binder/statement/prepare_statement.h"
 #include "binder/statement/select_statement.h"
 #include "binder/statement/set_show_statement.h"
 #include "buffer/buffer_pool_manager.h"
@@ -21,25 +22,40 @@
 #include "concurrency/lock_manager.h"
 #include "concurrency/transaction.h"
 #include "execution/check_options.h"
+#include "execution/compiled_pipeline.h"
+#include "execution/cte_buffer.h"
 #include "execution/execution_engine.h"
 #include "execution/executor_context.h"
 #include "execution/executors/mock_scan_executor.h"
 #include "execution/expressions/abstract_expression.h"
 #include "execution/plans/abstract_plan.h"
+#include "execution/runtime_filter.h"
 #include "fmt/core.h"
 #include "fmt/format.h"
 #include "optimizer/optimizer.h"
+#include "optimizer/plan_cache.h"
 #include "planner/planner.h"
 #include "recovery/checkpoint_manager.h"
 #include "recovery/log_manager.h"
 #include "storage/disk/disk_manager.h"
 #include "storage/disk/disk_manager_memory.h"
+#include "storage/table/vacuum_manager.h"
 #include "type/value_factory.h"
 
 namespace bustub {
 
 auto BustubInstance::MakeExecutorContext(Transaction *txn, bool is_modify) -> std::unique_ptr<ExecutorContext> {
-  return std::make_unique<ExecutorContext>(txn, catalog_, buffer_pool_manager_, txn_manager_, lock_manager_, is_modify);
+  auto exec_ctx =
+      std::make_unique<ExecutorContext>(txn, catalog_, buffer_pool_manager_, txn_manager_, lock_manager_, is_modify);
+  exec_ctx->SetDegreeOfParallelism(GetDegreeOfParallelism());
+  exec_ctx->SetMemoryLimit(GetMemoryLimit());
+  exec_ctx->SetSortMemoryBudget(GetSortMemoryBudget());
+  if (IsPipelineCompilationEnabled()) {
+    exec_ctx->SetPipelineCache(pipeline_cache_);
+  }
+  exec_ctx->SetRuntimeFilters(std::make_shared<RuntimeFilterRegistry>());
+  exec_ctx->SetCTEBuffers(std::make_shared<CTEBufferRegistry>());
+  return exec_ctx;
 }
 
 BustubInstance::BustubInstance(const std::string &db_file_name) {
@@ -78,8 +94,18 @@ BustubInstance::BustubInstance(const std::string &db_file_name) {
   // Catalog.
   catalog_ = new Catalog(buffer_pool_manager_, lock_manager_, log_manager_);
 
+  // Vacuum.
+  vacuum_manager_ = new VacuumManager(catalog_, txn_manager_, &catalog_lock_);
+#ifndef __EMSCRIPTEN__
+  if (buffer_pool_manager_ != nullptr && enable_background_vacuum) {
+    vacuum_manager_->StartBackgroundVacuum();
+  }
+#endif
+
   // Execution engine.
   execution_engine_ = new ExecutionEngine(buffer_pool_manager_, txn_manager_, catalog_);
+  pipeline_cache_ = new PipelineCache();
+  plan_cache_ = new PlanCache();
 }
 
 BustubInstance::BustubInstance() {
@@ -118,8 +144,18 @@ BustubInstance::BustubInstance() {
   // Catalog.
   catalog_ = new Catalog(buffer_pool_manager_, lock_manager_, log_manager_);
 
+  // Vacuum.
+  vacuum_manager_ = new VacuumManager(catalog_, txn_manager_, &catalog_lock_);
+#ifndef __EMSCRIPTEN__
+  if (buffer_pool_manager_ != nullptr && enable_background_vacuum) {
+    vacuum_manager_->StartBackgroundVacuum();
+  }
+#endif
+
   // Execution engine.
   execution_engine_ = new ExecutionEngine(buffer_pool_manager_, txn_manager_, catalog_);
+  pipeline_cache_ = new PipelineCache();
+  plan_cache_ = new PlanCache();
 }
 
 void BustubInstance::CmdDisplayTables(ResultWriter &writer) {
@@ -163,6 +199,33 @@ void BustubInstance::CmdDisplayIndices(ResultWriter &writer) {
   writer.EndTable();
 }
 
+void BustubInstance::CmdVacuum(ResultWriter &writer, Transaction *txn) {
+  auto tables = vacuum_manager_->VacuumAllTables(txn);
+  writer.BeginTable(false);
+  writer.BeginHeader();
+  writer.WriteHeaderCell("table_name");
+  writer.WriteHeaderCell("pages_vacuumed");
+  writer.WriteHeaderCell("pages_emptied");
+  writer.WriteHeaderCell("tuples_reclaimed");
+  writer.WriteHeaderCell("bytes_reclaimed");
+  writer.EndHeader();
+  auto write_row = [&writer](const std::string &name, const VacuumStats &stats) {
+    writer.BeginRow();
+    writer.WriteCell(name);
+    writer.WriteCell(fmt::format("{}", stats.pages_scanned_));
+    writer.WriteCell(fmt::format("{}", stats.pages_emptied_));
+    writer.WriteCell(fmt::format("{}", stats.tuples_reclaimed_));
+    writer.WriteCell(fmt::format("{}", stats.bytes_reclaimed_));
+    writer.EndRow();
+  };
+  for (const auto &[name, stats] : tables) {
+    write_row(name, stats);
+  }
+  // Includes everything the background vacuum reclaimed since startup.
+  write_row("(total)", vacuum_manager_->GetTotalStats());
+  writer.EndTable();
+}
+
 void BustubInstance::WriteOneCell(const std::string &cell, ResultWriter &writer) {
   writer.BeginTable(true);
   writer.BeginRow();
@@ -176,6 +239,7 @@ void BustubInstance::CmdDisplayHelp(ResultWriter &writer) {
 
 \dt: show all tables
 \di: show all indices
+\vacuum: reclaim the space of deleted tuples in all tables
 \help: show this message again
 
 BusTub shell currently only supports a small set of Postgres queries. We'll set
@@ -216,6 +280,10 @@ auto BustubInstance::ExecuteSqlTxn(const std::string &sql, ResultWriter &writer,
       CmdDisplayIndices(writer);
       return true;
     }
+    if (sql == "\\vacuum") {
+      CmdVacuum(writer, txn);
+      return true;
+    }
     if (sql == "\\help") {
       CmdDisplayHelp(writer);
       return true;
@@ -223,6 +291,19 @@ auto BustubInstance::ExecuteSqlTxn(const std::string &sql, ResultWriter &writer,
     throw Exception(fmt::format("unsupported internal command: {}", sql));
   }
 
+  RefreshPreparedStatements();
+
+  // A statement that was run before skips the whole front end. The key includes the optimizer options.
+  auto use_plan_cache = IsPlanCacheEnabled();
+  std::string cache_key;
+  if (use_plan_cache) {
+    cache_key = fmt::format("{} {}", IsForceStarterRule() ? 1 : 0, PlanCache::Normalize(sql));
+    auto cached_plan = plan_cache_->Get(cache_key, catalog_->GetVersion());
+    if (cached_plan != nullptr) {
+      return ExecutePlan(txn, *cached_plan, std::move(check_options), writer);
+    }
+  }
+
   bool is_successful = true;
 
   std::shared_lock<std::shared_mutex> l(catalog_lock_);
@@ -233,8 +314,6 @@ auto BustubInstance::ExecuteSqlTxn(const std::string &sql, ResultWriter &writer,
   for (auto *stmt : binder.statement_nodes_) {
     auto statement = binder.BindStatement(stmt);
 
-    bool is_delete = false;
-
     switch (statement->type_) {
       case StatementType::CREATE_STATEMENT: {
         const auto &create_stmt = dynamic_cast<const CreateStatement &>(*statement);
@@ -261,55 +340,91 @@ auto BustubInstance::ExecuteSqlTxn(const std::string &sql, ResultWriter &writer,
         HandleExplainStatement(txn, explain_stmt, writer);
         continue;
       }
-      case StatementType::DELETE_STATEMENT:
-      case StatementType::UPDATE_STATEMENT:
-        is_delete = true;
+      case StatementType::PREPARE_STATEMENT: {
+        const auto &prepare_stmt = dynamic_cast<const PrepareStatement &>(*statement);
+        HandlePrepareStatement(txn, prepare_stmt, writer);
+        continue;
+      }
+      case StatementType::EXECUTE_STATEMENT: {
+        const auto &execute_stmt = dynamic_cast<const ExecuteStatement &>(*statement);
+        is_successful &= HandleExecuteStatement(txn, execute_stmt, std::move(check_options), writer);
+        continue;
+      }
+      case StatementType::DEALLOCATE_STATEMENT: {
+        const auto &deallocate_stmt = dynamic_cast<const DeallocateStatement &>(*statement);
+        HandleDeallocateStatement(txn, deallocate_stmt, writer);
+        continue;
+      }
       default:
         break;
     }
 
-    std::shared_lock<std::shared_mutex> l(catalog_lock_);
-
     // Plan the query.
-    bustub::Planner planner(*catalog_);
-    planner.PlanQuery(*statement);
+    auto plan = PlanStatement(*statement);
+    if (use_plan_cache && binder.statement_nodes_.size() == 1) {
+      plan_cache_->Put(cache_key, plan);
+    }
 
-    // Optimize the query.
-    bustub::Optimizer optimizer(*catalog_, IsForceStarterRule());
-    auto optimized_plan = optimizer.Optimize(planner.plan_);
+    // Execute the query.
+    is_successful &= ExecutePlan(txn, *plan, std::move(check_options), writer);
+  }
 
-    l.unlock();
+  return is_successful;
+}
 
-    // Execute the query.
-    auto exec_ctx = MakeExecutorContext(txn, is_delete);
-    if (check_options != nullptr) {
-      exec_ctx->InitCheckOptions(std::move(check_options));
-    }
-    std::vector<Tuple> result_set{};
-    is_successful &= execution_engine_->Execute(optimized_plan, &result_set, txn, exec_ctx.get());
+auto BustubInstance::PlanStatement(const BoundStatement &statement) -> std::shared_ptr<const CachedPlan> {
+  std::shared_lock<std::shared_mutex> l(catalog_lock_);
+  auto catalog_version = catalog_->GetVersion();
 
-    // Return the result set as a vector of string.
-    auto schema = planner.plan_->OutputSchema();
+  // Plan the query.
+  bustub::Planner planner(*catalog_);
+  planner.PlanQuery(statement);
 
-    // Generate header for the result set.
-    writer.BeginTable(false);
-    writer.BeginHeader();
-    for (const auto &column : schema.GetColumns()) {
-      writer.WriteHeaderCell(column.GetName());
-    }
-    writer.EndHeader();
+  // Optimize the query.
+  bustub::Optimizer optimizer(*catalog_, IsForceStarterRule());
+  auto optimized_plan = optimizer.Optimize(planner.plan_);
 
-    // Transforming result set into strings.
-    for (const auto &tuple : result_set) {
-      writer.BeginRow();
-      for (uint32_t i = 0; i < schema.GetColumnCount(); i++) {
-        writer.WriteCell(tuple.GetValue(&schema, i).ToString());
-      }
-      writer.EndRow();
-    }
-    writer.EndTable();
+  l.unlock();
+
+  bool is_modify =
+      statement.type_ == StatementType::DELETE_STATEMENT || statement.type_ == StatementType::UPDATE_STATEMENT;
+  // The result set is named after the columns of the plan before optimization.
+  return std::make_shared<CachedPlan>(CachedPlan{std::move(optimized_plan),
+                                                 std::make_shared<Schema>(planner.plan_->OutputSchema()), is_modify,
+                                                 catalog_version});
+}
+
+auto BustubInstance::ExecutePlan(Transaction *txn, const CachedPlan &plan, std::shared_ptr<CheckOptions> check_options,
+                                 ResultWriter &writer) -> bool {
+  auto exec_ctx = MakeExecutorContext(txn, plan.is_modify_);
+  if (check_options != nullptr) {
+    exec_ctx->InitCheckOptions(std::move(check_options));
   }
 
+  const auto &schema = *plan.schema_;
+
+  // Generate header for the result set.
+  writer.BeginTable(false);
+  writer.BeginHeader();
+  for (const auto &column : schema.GetColumns()) {
+    writer.WriteHeaderCell(column.GetName());
+  }
+  writer.EndHeader();
+
+  // Stream the results into strings as the root executor produces them.
+  auto is_successful = execution_engine_->Execute(
+      plan.plan_,
+      [&](const TupleBatch &batch) {
+        for (uint32_t row = 0; row < batch.Size(); row++) {
+          writer.BeginRow();
+          for (uint32_t i = 0; i < schema.GetColumnCount(); i++) {
+            writer.WriteCell(batch.GetValue(row, i).ToString());
+          }
+          writer.EndRow();
+        }
+      },
+      txn, exec_ctx.get());
+  writer.EndTable();
   return is_successful;
 }
 
@@ -355,6 +470,9 @@ BustubInstance::~BustubInstance() {
     log_manager_->StopFlushThread();
   }
   delete execution_engine_;
+  delete pipeline_cache_;
+  delete plan_cache_;
+  delete vacuum_manager_;
   delete catalog_;
   delete checkpoint_manager_;
   delete log_manager_;
@@ -20,4 +20,8 @@ std::chrono::duration<int64_t> log_timeout = std::chrono::seconds(1);
 
 std::chrono::milliseconds cycle_detection_interval = std::chrono::milliseconds(50);
 
+std::chrono::milliseconds vacuum_interval = std::chrono::milliseconds(1000);
+
+std::atomic<bool> enable_background_vacuum(false);
+
 }  // namespace bustub
@@ -0,0 +1,148 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// compression_util.cpp
+//
+// Identification: src/common/util/compression_util.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include "common/util/compression_util.h"
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace bustub {
+
+namespace {
+
+constexpr size_t MIN_MATCH = 4;
+constexpr size_t MAX_OFFSET = UINT16_MAX;
+constexpr size_t HASH_BITS = 12;
+
+auto Read32(const char *p) -> uint32_t {
+  uint32_t v;
+  memcpy(&v, p, sizeof(v));
+  return v;
+}
+
+auto Hash(uint32_t v) -> size_t { return (v * 2654435761U) >> (32 - HASH_BITS); }
+
+void WriteLength(std::vector<char> *out, size_t len) {
+  while (len >= 255) {
+    out->push_back(static_cast<char>(255));
+    len -= 255;
+  }
+  out->push_back(static_cast<char>(len));
+}
+
+auto ReadLength(const uint8_t **ip, const uint8_t *end, size_t *len) -> bool {
+  uint8_t b;
+  do {
+    if (*ip == end) {
+      return false;
+    }
+    b = *(*ip)++;
+    *len += b;
+  } while (b == 255);
+  return true;
+}
+
+void WriteSequence(std::vector<char> *out, const char *literals, size_t literal_len, size_t offset,
+                   size_t match_len) {
+  auto token_pos = out->size();
+  uint8_t token = (literal_len < 15 ? literal_len : 15) << 4;
+  out->push_back(0);
+  if (literal_len >= 15) {
+    WriteLength(out, literal_len - 15);
+  }
+  out->insert(out->end(), literals, literals + literal_len);
+  if (match_len > 0) {
+    auto len = match_len - MIN_MATCH;
+    token |= len < 15 ? len : 15;
+    out->push_back(static_cast<char>(offset & 0xff));
+    out->push_back(static_cast<char>(offset >> 8));
+    if (len >= 15) {
+      WriteLength(out, len - 15);
+    }
+  }
+  (*out)[token_pos] = static_cast<char>(token);
+}
+
+}  // namespace
+
+auto CompressionUtil::LzCompress(const char *src, size_t size) -> std::vector<char> {
+  std::vector<char> out;
+  out.reserve(size / 2 + 16);
+  std::vector<uint32_t> table(1 << HASH_BITS, UINT32_MAX);
+
+  size_t anchor = 0;
+  size_t pos = 0;
+  while (pos + MIN_MATCH <= size) {
+    auto v = Read32(src + pos);
+    auto &candidate = table[Hash(v)];
+    auto match = candidate;
+    candidate = pos;
+    if (match == UINT32_MAX || pos - match > MAX_OFFSET || Read32(src + match) != v) {
+      pos++;
+      continue;
+    }
+    auto match_len = MIN_MATCH;
+    while (pos + match_len < size && src[match + match_len] == src[pos + match_len]) {
+      match_len++;
+    }
+    WriteSequence(&out, src + anchor, pos - anchor, pos - match, match_len);
+    pos += match_len;
+    anchor = pos;
+  }
+  WriteSequence(&out, src + anchor, size - anchor, 0, 0);
+  return out;
+}
+
+auto CompressionUtil::LzDecompress(const char *src, size_t size, char *dst, size_t raw_size) -> bool {
+  auto ip = reinterpret_cast<const uint8_t *>(src);
+  auto iend = ip + size;
+  size_t op = 0;
+  while (true) {
+    // A block always ends with a sequence of only literals.
+    if (ip == iend) {
+      return false;
+    }
+    uint8_t token = *ip++;
+    size_t literal_len = token >> 4;
+    if (literal_len == 15 && !ReadLength(&ip, iend, &literal_len)) {
+      return false;
+    }
+    if (literal_len > static_cast<size_t>(iend - ip) || literal_len > raw_size - op) {
+      return false;
+    }
+    memcpy(dst + op, ip, literal_len);
+    ip += literal_len;
+    op += literal_len;
+    if (ip == iend) {
+      return op == raw_size;
+    }
+
+    if (iend - ip < 2) {
+      return false;
+    }
+    size_t offset = ip[0] | (ip[1] << 8);
+    ip += 2;
+    size_t match_len = token & 0xf;
+    if (match_len == 15 && !ReadLength(&ip, iend, &match_len)) {
+      return false;
+    }
+    match_len += MIN_MATCH;
+    if (offset == 0 || offset > op || match_len > raw_size - op) {
+      return false;
+    }
+    // Matches may overlap with their own output, so copy byte by byte.
+    for (size_t i = 0; i < match_len; i++, op++) {
+      dst[op] = dst[op - offset];
+    }
+  }
+}
+
+}  // namespace bustub
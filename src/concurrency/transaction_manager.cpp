@@ -27,6 +27,8 @@ void TransactionManager::Commit(Transaction *txn) {
   ReleaseLocks(txn);
 
   txn->SetState(TransactionState::COMMITTED);
+  std::unique_lock<std::shared_mutex> l(txn_map_mutex_);
+  active_txn_ids_.erase(txn->GetTransactionId());
 }
 
 void TransactionManager::Abort(Transaction *txn) {
@@ -35,6 +37,20 @@ void TransactionManager::Abort(Transaction *txn) {
   ReleaseLocks(txn);
 
   txn->SetState(TransactionState::ABORTED);
+  std::unique_lock<std::shared_mutex> l(txn_map_mutex_);
+  active_txn_ids_.erase(txn->GetTransactionId());
+}
+
+auto TransactionManager::IsDeleteFinal(const TupleMeta &meta, const Transaction *txn) -> bool {
+  std::shared_lock<std::shared_mutex> l(txn_map_mutex_);
+  if (meta.delete_txn_id_ != INVALID_TXN_ID) {
+    return active_txn_ids_.count(meta.delete_txn_id_) == 0;
+  }
+  auto num_others = active_txn_ids_.size();
+  if (txn != nullptr && active_txn_ids_.count(txn->GetTransactionId()) > 0) {
+    num_others--;
+  }
+  return num_others == 0;
 }
 
 void TransactionManager::BlockAllTransactions() { UNIMPLEMENTED("block is not supported now!"); }
@@ -0,0 +1,47 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// abstract_executor.cpp
+//
+// Identification: src/execution/abstract_executor.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include "execution/executors/abstract_executor.h"
+
+#include <memory>
+
+namespace bustub {
+
+auto AbstractExecutor::NextBatch(TupleBatch *batch) -> bool {
+  batch->Reset(&GetOutputSchema());
+  Tuple tuple;
+  RID rid;
+  while (!batch->IsFull() && Next(&tuple, &rid)) {
+    tuple.SetRid(rid);
+    batch->AppendTuple(std::move(tuple));
+  }
+  return !batch->Empty();
+}
+
+auto AbstractExecutor::NextFromBatch(Tuple *tuple, RID *rid) -> bool {
+  if (adapter_batch_ == nullptr) {
+    adapter_batch_ = std::make_unique<TupleBatch>();
+    adapter_pos_ = adapter_batch_->Size();
+  }
+  while (adapter_pos_ == adapter_batch_->Size()) {
+    adapter_pos_ = 0;
+    if (!NextBatch(adapter_batch_.get())) {
+      // Keep returning false, as a tuple-at-a-time executor would.
+      adapter_batch_->Reset(&GetOutputSchema());
+      return false;
+    }
+  }
+  *tuple = adapter_batch_->GetTuple(adapter_pos_);
+  *rid = adapter_batch_->GetRid(adapter_pos_);
+  adapter_pos_++;
+  return true;
+}
+
+}  // namespace bustub
@@ -1,29 +1,120 @@
-//===----------------------------------------------------------------------===//
-//
-//                         BusTub
-//
-// aggregation_executor.cpp
-//
-// Identification: src/execution/aggregation_executor.cpp
-//
-// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
-//
-//===----------------------------------------------------------------------===//
-#include <memory>
-#include <vector>
-
-#include "execution/executors/aggregation_executor.h"
-
-namespace bustub {
-
-AggregationExecutor::AggregationExecutor(ExecutorContext *exec_ctx, const AggregationPlanNode *plan,
-                                         std::unique_ptr<AbstractExecutor> &&child_executor)
-    : AbstractExecutor(exec_ctx) {}
-
-void AggregationExecutor::Init() {}
-
-auto AggregationExecutor::Next(Tuple *tuple, RID *rid) -> bool { return false; }
-
-auto AggregationExecutor::GetChildExecutor() const -> const AbstractExecutor * { return child_executor_.get(); }
-
-}  // namespace bustub
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// aggregation_executor.cpp
+//
+// Identification: src/execution/aggregation_executor.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+#include <iterator>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "execution/executors/aggregation_executor.h"
+#include "execution/parallel_pipeline.h"
+
+namespace bustub {
+
+AggregationExecutor::AggregationExecutor(ExecutorContext *exec_ctx, const AggregationPlanNode *plan,
+                                         std::unique_ptr<AbstractExecutor> &&child_executor,
+                                         std::shared_ptr<const CompiledPipeline> pipeline)
+    : AbstractExecutor(exec_ctx),
+      plan_(plan),
+      child_executor_(std::move(child_executor)),
+      pipeline_(std::move(pipeline)),
+      aht_(plan_->GetAggregateTypes(), exec_ctx->GetBufferPoolManager(), exec_ctx->GetMemoryLimit()) {}
+
+void AggregationExecutor::Init() {
+  aht_.Clear();
+  ResetBatchAdapter();
+
+  // The child executor runs the source of the pipeline, if there is one.
+  const auto &child_plan = pipeline_ != nullptr ? pipeline_->GetSource(*plan_) : plan_->GetChildPlan();
+  auto num_workers = exec_ctx_->GetDegreeOfParallelism();
+  if (num_workers > 1 && ParallelPipeline::CanRunInParallel(*child_plan)) {
+    // The workers share the memory limit.
+    std::vector<std::unique_ptr<AggregationHashTable>> partials;
+    std::vector<std::unique_ptr<CompiledPipeline::Runner>> runners(num_workers);
+    partials.reserve(num_workers);
+    for (size_t i = 0; i < num_workers; i++) {
+      partials.push_back(std::make_unique<AggregationHashTable>(
+          plan_->GetAggregateTypes(), exec_ctx_->GetBufferPoolManager(), exec_ctx_->GetMemoryLimit() / num_workers));
+      if (pipeline_ != nullptr) {
+        runners[i] = std::make_unique<CompiledPipeline::Runner>(*pipeline_);
+      }
+    }
+    ParallelPipeline pipeline(exec_ctx_, child_plan, num_workers);
+    pipeline.Run([&](size_t worker, TupleBatch *batch) {
+      AggregateBatch(partials[worker].get(), batch, runners[worker].get());
+    });
+    for (const auto &partial : partials) {
+      aht_.Merge(partial.get());
+    }
+  } else {
+    std::unique_ptr<CompiledPipeline::Runner> runner;
+    if (pipeline_ != nullptr) {
+      runner = std::make_unique<CompiledPipeline::Runner>(*pipeline_);
+    }
+    child_executor_->Init();
+    TupleBatch batch;
+    while (child_executor_->NextBatch(&batch)) {
+      AggregateBatch(&aht_, &batch, runner.get());
+    }
+  }
+
+  aht_.Finalize();
+  emit_initial_value_ = plan_->GetGroupBys().empty() && aht_.Empty();
+}
+
+void AggregationExecutor::AggregateBatch(AggregationHashTable *aht, TupleBatch *batch,
+                                         CompiledPipeline::Runner *runner) const {
+  const auto &group_bys = plan_->GetGroupBys();
+  if (runner != nullptr) {
+    // The pipeline computes the group-by values followed by the aggregate inputs.
+    std::vector<std::vector<Value>> columns;
+    if (!runner->Run(batch, &columns)) {
+      return;
+    }
+    std::vector<std::vector<Value>> vals(std::make_move_iterator(columns.begin() + group_bys.size()),
+                                         std::make_move_iterator(columns.end()));
+    columns.resize(group_bys.size());
+    aht->InsertBatch(columns, vals, batch->Size());
+    return;
+  }
+
+  // Evaluate every expression over the whole batch, then add the rows to their groups.
+  const auto &aggregates = plan_->GetAggregates();
+  std::vector<std::vector<Value>> keys(group_bys.size());
+  std::vector<std::vector<Value>> vals(aggregates.size());
+  for (size_t i = 0; i < group_bys.size(); i++) {
+    group_bys[i]->EvaluateBatch(*batch, &keys[i]);
+  }
+  for (size_t i = 0; i < aggregates.size(); i++) {
+    aggregates[i]->EvaluateBatch(*batch, &vals[i]);
+  }
+  aht->InsertBatch(keys, vals, batch->Size());
+}
+
+auto AggregationExecutor::Next(Tuple *tuple, RID *rid) -> bool { return NextFromBatch(tuple, rid); }
+
+auto AggregationExecutor::NextBatch(TupleBatch *batch) -> bool {
+  batch->Reset(&GetOutputSchema());
+  if (emit_initial_value_) {
+    emit_initial_value_ = false;
+    batch->AppendValues(aht_.GenerateInitialAggregateValue().aggregates_);
+    return true;
+  }
+  std::vector<Value> values;
+  while (!batch->IsFull() && aht_.Next(&values)) {
+    batch->AppendValues(std::move(values));
+  }
+  return !batch->Empty();
+}
+
+auto AggregationExecutor::GetChildExecutor() const -> const AbstractExecutor * { return child_executor_.get(); }
+
+}  // namespace bustub
@@ -0,0 +1,607 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// aggregation_hash_table.cpp
+//
+// Identification: src/execution/aggregation_hash_table.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include "execution/aggregation_hash_table.h"
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "common/exception.h"
+#include "type/limits.h"
+#include "type/type.h"
+#include "type/type_util.h"
+#include "type/value_factory.h"
+
+namespace bustub {
+
+namespace {
+
+/** Groups are allocated from blocks of this size, larger groups get a block of their own */
+constexpr size_t ARENA_BLOCK_SIZE = 64 * 1024;
+constexpr size_t INITIAL_SLOTS = 64;
+
+/** Append the group-by values of a row to a key: the type of each value, then the value as stored in a tuple. */
+void EncodeKey(const std::vector<std::vector<Value>> &keys, uint32_t row, std::string *key) {
+  for (const auto &column : keys) {
+    const auto &value = column[row];
+    auto type = value.GetTypeId();
+    key->push_back(static_cast<char>(type));
+    if (type == TypeId::INVALID) {
+      continue;
+    }
+    auto size = type == TypeId::VARCHAR ? sizeof(uint32_t) + (value.IsNull() ? 0 : value.GetLength())
+                                        : Type::GetTypeSize(type);
+    auto pos = key->size();
+    key->resize(pos + size);
+    value.SerializeTo(key->data() + pos);
+  }
+}
+
+/** Append the group-by values stored in a key. */
+void DecodeKey(const char *key, uint32_t key_size, std::vector<Value> *values) {
+  for (uint32_t pos = 0; pos < key_size;) {
+    auto type = static_cast<TypeId>(key[pos++]);
+    if (type == TypeId::INVALID) {
+      values->emplace_back();
+      continue;
+    }
+    values->push_back(Value::DeserializeFrom(key + pos, type));
+    if (type == TypeId::VARCHAR) {
+      uint32_t len;
+      memcpy(&len, key + pos, sizeof(uint32_t));
+      pos += sizeof(uint32_t) + (len == BUSTUB_VALUE_NULL ? 0 : len);
+    } else {
+      pos += Type::GetTypeSize(type);
+    }
+  }
+}
+
+/** @return a sum or an extreme value as the integer type it was computed over */
+template <typename T>
+auto Narrow(int64_t value, int64_t min, int64_t max) -> T {
+  if (value < min || value > max) {
+    throw Exception(ExceptionType::OUT_OF_RANGE, "Numeric value out of range.");
+  }
+  return static_cast<T>(value);
+}
+
+/*
+ * Update kernels. Each one handles inputs of one type for an accumulator that already holds a value of that type:
+ * it either updates the accumulator in place and returns false, or returns true if the input replaces the value.
+ */
+
+template <typename T>
+struct SumInteger {
+  template <typename Acc>
+  static auto Update(Acc *acc, const Value &input) -> bool {
+    acc->integer_ += input.GetAs<T>();
+    return false;
+  }
+};
+
+struct SumDecimal {
+  template <typename Acc>
+  static auto Update(Acc *acc, const Value &input) -> bool {
+    acc->decimal_ += input.GetAs<double>();
+    return false;
+  }
+};
+
+template <typename T, bool IS_MIN>
+struct MinMaxInteger {
+  template <typename Acc>
+  static auto Update(Acc *acc, const Value &input) -> bool {
+    auto current = static_cast<T>(acc->integer_);
+    auto value = input.GetAs<T>();
+    return IS_MIN ? value < current : value > current;
+  }
+};
+
+template <bool IS_MIN>
+struct MinMaxDecimal {
+  template <typename Acc>
+  static auto Update(Acc *acc, const Value &input) -> bool {
+    auto value = input.GetAs<double>();
+    return IS_MIN ? value < acc->decimal_ : value > acc->decimal_;
+  }
+};
+
+template <bool IS_MIN>
+struct MinMaxVarchar {
+  template <typename Acc>
+  static auto Update(Acc *acc, const Value &input) -> bool {
+    auto cmp = TypeUtil::CompareStrings(input.GetData(), static_cast<int>(input.GetLength()) - 1, acc->varchar_,
+                                        static_cast<int>(acc->length_) - 1);
+    return IS_MIN ? cmp < 0 : cmp > 0;
+  }
+};
+
+}  // namespace
+
+AggregationHashTable::AggregationHashTable(const std::vector<AggregationType> &agg_types, BufferPoolManager *bpm,
+                                           size_t memory_limit, uint32_t level)
+    : agg_types_(agg_types), bpm_(bpm), memory_limit_(memory_limit), level_(level) {
+  static_assert(sizeof(Accumulator) == 16);
+  static_assert(sizeof(EntryHeader) % alignof(Accumulator) == 0);
+}
+
+auto AggregationHashTable::GenerateInitialAggregateValue() const -> AggregateValue {
+  std::vector<Value> values{};
+  for (const auto &agg_type : agg_types_) {
+    switch (agg_type) {
+      case AggregationType::CountStarAggregate:
+        // Count start starts at zero.
+        values.emplace_back(ValueFactory::GetIntegerValue(0));
+        break;
+      case AggregationType::CountAggregate:
+      case AggregationType::SumAggregate:
+      case AggregationType::MinAggregate:
+      case AggregationType::MaxAggregate:
+        // Others starts at null.
+        values.emplace_back(ValueFactory::GetNullValueByType(TypeId::INTEGER));
+        break;
+    }
+  }
+  return {values};
+}
+
+void AggregationHashTable::InsertBatch(const std::vector<std::vector<Value>> &keys,
+                                       const std::vector<std::vector<Value>> &vals, uint32_t num_rows) {
+  // Find the groups of all rows first, so that every aggregate is then updated in one pass over the batch. Nothing is
+  // spilled before the batch is done, as that would free the groups.
+  std::vector<char *> groups(num_rows);
+  std::string key;
+  for (uint32_t row = 0; row < num_rows; row++) {
+    key.clear();
+    EncodeKey(keys, row, &key);
+    auto hash = HashUtil::MixBits(HashUtil::HashBytes(key.data(), key.size()));
+    groups[row] = FindOrInsert(hash, key.data(), key.size());
+  }
+  for (size_t i = 0; i < agg_types_.size(); i++) {
+    UpdateColumn(i, groups, vals[i]);
+  }
+  SpillIfFull();
+}
+
+auto AggregationHashTable::FindOrInsert(hash_t hash, const char *key, uint32_t key_size) -> char * {
+  if (2 * (entries_.size() + 1) > slots_.size()) {
+    Grow();
+  }
+  auto mask = slots_.size() - 1;
+  auto pos = (hash >> 32) & mask;
+  for (; slots_[pos].entry_ != nullptr; pos = (pos + 1) & mask) {
+    auto *entry = slots_[pos].entry_;
+    if (slots_[pos].hash_ == hash && reinterpret_cast<EntryHeader *>(entry)->key_size_ == key_size &&
+        memcmp(KeyData(entry), key, key_size) == 0) {
+      return entry;
+    }
+  }
+
+  auto *entry = Allocate(sizeof(EntryHeader) + agg_types_.size() * sizeof(Accumulator) + key_size);
+  auto *header = reinterpret_cast<EntryHeader *>(entry);
+  header->hash_ = hash;
+  header->key_size_ = key_size;
+  auto *accs = Accumulators(entry);
+  for (size_t i = 0; i < agg_types_.size(); i++) {
+    accs[i].integer_ = 0;
+    accs[i].length_ = 0;
+    accs[i].type_ = TypeId::INTEGER;
+    // COUNT(*) starts at zero, all others at null.
+    accs[i].is_null_ = agg_types_[i] != AggregationType::CountStarAggregate;
+  }
+  memcpy(KeyData(entry), key, key_size);
+
+  slots_[pos] = {hash, entry};
+  entries_.push_back(entry);
+  bytes_ += sizeof(char *);
+  return entry;
+}
+
+void AggregationHashTable::Grow() {
+  auto capacity = std::max(INITIAL_SLOTS, 2 * slots_.size());
+  bytes_ += (capacity - slots_.size()) * sizeof(Slot);
+  slots_.assign(capacity, {0, nullptr});
+  for (auto *entry : entries_) {
+    auto hash = reinterpret_cast<EntryHeader *>(entry)->hash_;
+    auto pos = (hash >> 32) & (capacity - 1);
+    while (slots_[pos].entry_ != nullptr) {
+      pos = (pos + 1) & (capacity - 1);
+    }
+    slots_[pos] = {hash, entry};
+  }
+}
+
+auto AggregationHashTable::Allocate(size_t size) -> char * {
+  size = (size + 7) & ~static_cast<size_t>(7);
+  if (arena_used_ + size > arena_capacity_) {
+    arena_capacity_ = std::max(ARENA_BLOCK_SIZE, size);
+    arena_.emplace_back(new char[arena_capacity_]);
+    arena_used_ = 0;
+    bytes_ += arena_capacity_;
+  }
+  auto *memory = arena_.back().get() + arena_used_;
+  arena_used_ += size;
+  return memory;
+}
+
+void AggregationHashTable::UpdateColumn(size_t agg_idx, const std::vector<char *> &groups,
+                                        const std::vector<Value> &inputs) {
+  auto agg_type = agg_types_[agg_idx];
+  auto offset = sizeof(EntryHeader) + agg_idx * sizeof(Accumulator);
+  switch (agg_type) {
+    case AggregationType::CountStarAggregate:
+      for (auto *group : groups) {
+        reinterpret_cast<Accumulator *>(group + offset)->integer_++;
+      }
+      return;
+    case AggregationType::CountAggregate:
+      for (size_t row = 0; row < groups.size(); row++) {
+        if (!inputs[row].IsNull()) {
+          auto *acc = reinterpret_cast<Accumulator *>(groups[row] + offset);
+          acc->integer_++;
+          acc->is_null_ = false;
+        }
+      }
+      return;
+    default:
+      break;
+  }
+
+  // Pick the kernel by the type of the inputs, which is the same for all rows but nulls.
+  auto first = std::find_if(inputs.begin(), inputs.end(), [](const Value &input) { return !input.IsNull(); });
+  if (first == inputs.end()) {
+    return;
+  }
+  auto type = first->GetTypeId();
+  switch (agg_type) {
+    case AggregationType::SumAggregate:
+      switch (type) {
+        case TypeId::TINYINT:
+          return RunKernel<SumInteger<int8_t>>(agg_idx, type, groups, inputs);
+        case TypeId::SMALLINT:
+          return RunKernel<SumInteger<int16_t>>(agg_idx, type, groups, inputs);
+        case TypeId::INTEGER:
+          return RunKernel<SumInteger<int32_t>>(agg_idx, type, groups, inputs);
+        case TypeId::BIGINT:
+          return RunKernel<SumInteger<int64_t>>(agg_idx, type, groups, inputs);
+        case TypeId::DECIMAL:
+          return RunKernel<SumDecimal>(agg_idx, type, groups, inputs);
+        default:
+          break;
+      }
+      break;
+    case AggregationType::MinAggregate:
+      if (RunMinMaxKernel<true>(agg_idx, type, groups, inputs)) {
+        return;
+      }
+      break;
+    case AggregationType::MaxAggregate:
+      if (RunMinMaxKernel<false>(agg_idx, type, groups, inputs)) {
+        return;
+      }
+      break;
+    default:
+      break;
+  }
+
+  for (size_t row = 0; row < groups.size(); row++) {
+    UpdateAccumulator(agg_type, reinterpret_cast<Accumulator *>(groups[row] + offset), inputs[row]);
+  }
+}
+
+template <typename Kernel>
+void AggregationHashTable::RunKernel(size_t agg_idx, TypeId type, const std::vector<char *> &groups,
+                                     const std::vector<Value> &inputs) {
+  auto offset = sizeof(EntryHeader) + agg_idx * sizeof(Accumulator);
+  for (size_t row = 0; row < groups.size(); row++) {
+    const auto &input = inputs[row];
+    if (input.IsNull()) {
+      continue;
+    }
+    auto *acc = reinterpret_cast<Accumulator *>(groups[row] + offset);
+    if (acc->is_null_) {
+      SetAccumulator(acc, input);
+    } else if (input.GetTypeId() != type || acc->type_ != type) {
+      UpdateAccumulator(agg_types_[agg_idx], acc, input);
+    } else if (Kernel::Update(acc, input)) {
+      SetAccumulator(acc, input);
+    }
+  }
+}
+
+template <bool IS_MIN>
+auto AggregationHashTable::RunMinMaxKernel(size_t agg_idx, TypeId type, const std::vector<char *> &groups,
+                                           const std::vector<Value> &inputs) -> bool {
+  switch (type) {
+    case TypeId::BOOLEAN:
+    case TypeId::TINYINT:
+      RunKernel<MinMaxInteger<int8_t, IS_MIN>>(agg_idx, type, groups, inputs);
+      return true;
+    case TypeId::SMALLINT:
+      RunKernel<MinMaxInteger<int16_t, IS_MIN>>(agg_idx, type, groups, inputs);
+      return true;
+    case TypeId::INTEGER:
+      RunKernel<MinMaxInteger<int32_t, IS_MIN>>(agg_idx, type, groups, inputs);
+      return true;
+    case TypeId::BIGINT:
+      RunKernel<MinMaxInteger<int64_t, IS_MIN>>(agg_idx, type, groups, inputs);
+      return true;
+    case TypeId::TIMESTAMP:
+      RunKernel<MinMaxInteger<uint64_t, IS_MIN>>(agg_idx, type, groups, inputs);
+      return true;
+    case TypeId::DECIMAL:
+      RunKernel<MinMaxDecimal<IS_MIN>>(agg_idx, type, groups, inputs);
+      return true;
+    case TypeId::VARCHAR:
+      RunKernel<MinMaxVarchar<IS_MIN>>(agg_idx, type, groups, inputs);
+      return true;
+    default:
+      return false;
+  }
+}
+
+void AggregationHashTable::UpdateAccumulator(AggregationType agg_type, Accumulator *acc, const Value &input) {
+  if (agg_type == AggregationType::CountStarAggregate) {
+    acc->integer_++;
+    return;
+  }
+  if (input.IsNull()) {
+    return;
+  }
+  switch (agg_type) {
+    case AggregationType::CountAggregate:
+      acc->integer_++;
+      acc->is_null_ = false;
+      break;
+    case AggregationType::SumAggregate:
+      SetAccumulator(acc, acc->is_null_ ? input : GetAccumulator(agg_type, *acc).Add(input));
+      break;
+    case AggregationType::MinAggregate:
+      if (acc->is_null_ || input.CompareLessThan(GetAccumulator(agg_type, *acc)) == CmpBool::CmpTrue) {
+        SetAccumulator(acc, input);
+      }
+      break;
+    case AggregationType::MaxAggregate:
+      if (acc->is_null_ || input.CompareGreaterThan(GetAccumulator(agg_type, *acc)) == CmpBool::CmpTrue) {
+        SetAccumulator(acc, input);
+      }
+      break;
+    default:
+      break;
+  }
+}
+
+void AggregationHashTable::SetAccumulator(Accumulator *acc, const Value &value) {
+  acc->type_ = value.GetTypeId();
+  acc->is_null_ = value.IsNull();
+  if (acc->is_null_) {
+    return;
+  }
+  switch (value.GetTypeId()) {
+    case TypeId::BOOLEAN:
+    case TypeId::TINYINT:
+      acc->integer_ = value.GetAs<int8_t>();
+      break;
+    case TypeId::SMALLINT:
+      acc->integer_ = value.GetAs<int16_t>();
+      break;
+    case TypeId::INTEGER:
+      acc->integer_ = value.GetAs<int32_t>();
+      break;
+    case TypeId::BIGINT:
+      acc->integer_ = value.GetAs<int64_t>();
+      break;
+    case TypeId::TIMESTAMP:
+      acc->integer_ = static_cast<int64_t>(value.GetAs<uint64_t>());
+      break;
+    case TypeId::DECIMAL:
+      acc->decimal_ = value.GetAs<double>();
+      break;
+    case TypeId::VARCHAR: {
+      auto *data = Allocate(value.GetLength());
+      memcpy(data, value.GetData(), value.GetLength());
+      acc->varchar_ = data;
+      acc->length_ = value.GetLength();
+      break;
+    }
+    default:
+      throw Exception(ExceptionType::UNKNOWN_TYPE, "cannot aggregate values of this type");
+  }
+}
+
+auto AggregationHashTable::GetAccumulator(AggregationType agg_type, const Accumulator &acc) -> Value {
+  if (acc.is_null_) {
+    return ValueFactory::GetNullValueByType(TypeId::INTEGER);
+  }
+  if (agg_type == AggregationType::CountStarAggregate || agg_type == AggregationType::CountAggregate) {
+    return ValueFactory::GetIntegerValue(Narrow<int32_t>(acc.integer_, BUSTUB_INT32_MIN, BUSTUB_INT32_MAX));
+  }
+  switch (static_cast<TypeId>(acc.type_)) {
+    case TypeId::BOOLEAN:
+      return {TypeId::BOOLEAN, static_cast<int8_t>(acc.integer_)};
+    case TypeId::TINYINT:
+      return {TypeId::TINYINT, Narrow<int8_t>(acc.integer_, BUSTUB_INT8_MIN, BUSTUB_INT8_MAX)};
+    case TypeId::SMALLINT:
+      return {TypeId::SMALLINT, Narrow<int16_t>(acc.integer_, BUSTUB_INT16_MIN, BUSTUB_INT16_MAX)};
+    case TypeId::INTEGER:
+      return {TypeId::INTEGER, Narrow<int32_t>(acc.integer_, BUSTUB_INT32_MIN, BUSTUB_INT32_MAX)};
+    case TypeId::BIGINT:
+      return {TypeId::BIGINT, acc.integer_};
+    case TypeId::TIMESTAMP:
+      return {TypeId::TIMESTAMP, static_cast<uint64_t>(acc.integer_)};
+    case TypeId::DECIMAL:
+      return {TypeId::DECIMAL, acc.decimal_};
+    case TypeId::VARCHAR:
+      return {TypeId::VARCHAR, acc.varchar_, acc.length_, true};
+    default:
+      throw Exception(ExceptionType::UNKNOWN_TYPE, "cannot aggregate values of this type");
+  }
+}
+
+void AggregationHashTable::MergeAccumulator(AggregationType agg_type, Accumulator *dst, const Accumulator &src) {
+  if (src.is_null_) {
+    return;
+  }
+  switch (agg_type) {
+    case AggregationType::CountStarAggregate:
+    case AggregationType::CountAggregate:
+      // Partial counts add up just like partial sums.
+      dst->integer_ += src.integer_;
+      dst->is_null_ = false;
+      break;
+    default:
+      UpdateAccumulator(agg_type, dst, GetAccumulator(agg_type, src));
+      break;
+  }
+}
+
+void AggregationHashTable::MergeGroup(hash_t hash, const char *key, uint32_t key_size, const Accumulator *accs) {
+  auto *dst = Accumulators(FindOrInsert(hash, key, key_size));
+  for (size_t i = 0; i < agg_types_.size(); i++) {
+    MergeAccumulator(agg_types_[i], &dst[i], accs[i]);
+  }
+}
+
+void AggregationHashTable::Merge(AggregationHashTable *other) {
+  BUSTUB_ASSERT(other->level_ == level_, "only tables of the same level can be merged");
+  for (auto *entry : other->entries_) {
+    auto *header = reinterpret_cast<EntryHeader *>(entry);
+    MergeGroup(header->hash_, other->KeyData(entry), header->key_size_, other->Accumulators(entry));
+    SpillIfFull();
+  }
+  if (other->spilled_) {
+    partitions_.resize(FANOUT);
+    for (uint32_t i = 0; i < FANOUT; i++) {
+      for (auto &file : other->partitions_[i]) {
+        partitions_[i].push_back(std::move(file));
+      }
+    }
+    spilled_ = true;
+  }
+  other->Clear();
+}
+
+void AggregationHashTable::SerializeGroup(char *entry, std::string *record) const {
+  auto key_size = reinterpret_cast<EntryHeader *>(entry)->key_size_;
+  record->append(entry, sizeof(EntryHeader) + agg_types_.size() * sizeof(Accumulator) + key_size);
+  const auto *accs = Accumulators(entry);
+  for (size_t i = 0; i < agg_types_.size(); i++) {
+    if (!accs[i].is_null_ && accs[i].type_ == TypeId::VARCHAR) {
+      record->append(accs[i].varchar_, accs[i].length_);
+    }
+  }
+}
+
+void AggregationHashTable::MergeRecord(const std::string &record) {
+  // The record is not aligned, so the header and the accumulators are copied out of it.
+  EntryHeader header;
+  memcpy(&header, record.data(), sizeof(EntryHeader));
+  std::vector<Accumulator> accs(agg_types_.size());
+  memcpy(accs.data(), record.data() + sizeof(EntryHeader), accs.size() * sizeof(Accumulator));
+  const char *key = record.data() + sizeof(EntryHeader) + accs.size() * sizeof(Accumulator);
+  const char *varchars = key + header.key_size_;
+  for (auto &acc : accs) {
+    if (!acc.is_null_ && acc.type_ == TypeId::VARCHAR) {
+      acc.varchar_ = varchars;
+      varchars += acc.length_;
+    }
+  }
+  MergeGroup(header.hash_, key, header.key_size_, accs.data());
+  SpillIfFull();
+}
+
+void AggregationHashTable::SpillIfFull() {
+  if (bpm_ != nullptr && level_ < MAX_LEVELS && bytes_ > memory_limit_) {
+    SpillAll();
+  }
+}
+
+void AggregationHashTable::SpillAll() {
+  partitions_.resize(FANOUT);
+  std::string record;
+  for (auto *entry : entries_) {
+    auto &files = partitions_[PartitionOf(reinterpret_cast<EntryHeader *>(entry)->hash_, level_)];
+    if (files.empty()) {
+      files.push_back(std::make_unique<SpillFile>(bpm_, nullptr));
+    }
+    record.clear();
+    SerializeGroup(entry, &record);
+    files.back()->AppendRecord(record);
+  }
+  ClearGroups();
+  spilled_ = true;
+}
+
+void AggregationHashTable::Finalize() {
+  if (spilled_ && !entries_.empty()) {
+    SpillAll();
+  }
+  read_pos_ = 0;
+  partition_table_.reset();
+}
+
+auto AggregationHashTable::Next(std::vector<Value> *values) -> bool {
+  if (!spilled_) {
+    if (read_pos_ == entries_.size()) {
+      return false;
+    }
+    auto *entry = entries_[read_pos_++];
+    values->clear();
+    DecodeKey(KeyData(entry), reinterpret_cast<EntryHeader *>(entry)->key_size_, values);
+    const auto *accs = Accumulators(entry);
+    for (size_t i = 0; i < agg_types_.size(); i++) {
+      values->push_back(GetAccumulator(agg_types_[i], accs[i]));
+    }
+    return true;
+  }
+
+  // Merge the partial aggregates of one partition at a time.
+  while (partition_table_ == nullptr || !partition_table_->Next(values)) {
+    if (read_pos_ == partitions_.size()) {
+      partition_table_.reset();
+      return false;
+    }
+    partition_table_ = std::make_unique<AggregationHashTable>(agg_types_, bpm_, memory_limit_, level_ + 1);
+    std::string record;
+    for (const auto &file : partitions_[read_pos_]) {
+      SpillFile::Reader reader(file.get());
+      while (reader.NextRecord(&record)) {
+        partition_table_->MergeRecord(record);
+      }
+    }
+    partitions_[read_pos_].clear();
+    read_pos_++;
+    partition_table_->Finalize();
+  }
+  return true;
+}
+
+void AggregationHashTable::ClearGroups() {
+  arena_.clear();
+  arena_used_ = 0;
+  arena_capacity_ = 0;
+  slots_ = {};
+  entries_ = {};
+  bytes_ = 0;
+}
+
+void AggregationHashTable::Clear() {
+  ClearGroups();
+  partitions_.clear();
+  spilled_ = false;
+  read_pos_ = 0;
+  partition_table_.reset();
+}
+
+}  // namespace bustub
@@ -0,0 +1,219 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// compiled_pipeline.cpp
+//
+// Identification: src/execution/compiled_pipeline.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include "execution/compiled_pipeline.h"
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "execution/expressions/column_value_expression.h"
+#include "execution/expressions/logic_expression.h"
+#include "execution/plans/aggregation_plan.h"
+#include "execution/plans/filter_plan.h"
+#include "execution/plans/projection_plan.h"
+#include "fmt/format.h"
+
+namespace bustub {
+
+namespace {
+
+/** @return an expression over the input of a projection, given the expressions of its outputs */
+auto Inline(const AbstractExpressionRef &expr, const std::vector<AbstractExpressionRef> &inputs)
+    -> AbstractExpressionRef {
+  if (const auto *column_expr = dynamic_cast<const ColumnValueExpression *>(expr.get()); column_expr != nullptr) {
+    return inputs[column_expr->GetColIdx()];
+  }
+  if (expr->GetChildren().empty()) {
+    return expr;
+  }
+  std::vector<AbstractExpressionRef> children;
+  children.reserve(expr->GetChildren().size());
+  for (const auto &child : expr->GetChildren()) {
+    children.push_back(Inline(child, inputs));
+  }
+  return expr->CloneWithChildren(std::move(children));
+}
+
+}  // namespace
+
+auto CompiledPipeline::Compile(const AbstractPlanNodeRef &plan) -> std::shared_ptr<const CompiledPipeline> {
+  std::shared_ptr<CompiledPipeline> pipeline(new CompiledPipeline());
+  // The outputs and predicates of the operators above `node`, as expressions over the output of `node`.
+  std::vector<AbstractExpressionRef> outputs;
+  std::vector<AbstractExpressionRef> predicates;
+  const AbstractPlanNode *node = plan.get();
+  if (node->GetType() == PlanType::Aggregation) {
+    const auto *agg_plan = dynamic_cast<const AggregationPlanNode *>(node);
+    outputs = agg_plan->GetGroupBys();
+    outputs.insert(outputs.end(), agg_plan->GetAggregates().begin(), agg_plan->GetAggregates().end());
+    pipeline->is_aggregation_ = true;
+    pipeline->is_projected_ = true;
+    node = agg_plan->GetChildPlan().get();
+  }
+  while (node->GetType() == PlanType::Filter || node->GetType() == PlanType::Projection) {
+    if (node->GetType() == PlanType::Filter) {
+      // A filter outputs the rows of its child as they are, so its predicate is over the same columns.
+      predicates.push_back(dynamic_cast<const FilterPlanNode *>(node)->GetPredicate());
+    } else {
+      const auto &exprs = dynamic_cast<const ProjectionPlanNode *>(node)->GetExpressions();
+      if (pipeline->is_projected_) {
+        for (auto &output : outputs) {
+          output = Inline(output, exprs);
+        }
+      } else {
+        outputs = exprs;
+        pipeline->is_projected_ = true;
+      }
+      for (auto &predicate : predicates) {
+        predicate = Inline(predicate, exprs);
+      }
+    }
+    pipeline->depth_++;
+    node = node->GetChildren()[0].get();
+  }
+  // A single filter or projection is already run on compiled expressions by its executor.
+  if (pipeline->depth_ == 0 || pipeline->depth_ + (pipeline->is_aggregation_ ? 1 : 0) < 2) {
+    return nullptr;
+  }
+
+  if (!predicates.empty()) {
+    // Evaluate the predicates from the bottom of the chain up, as the interpreted filters would.
+    std::reverse(predicates.begin(), predicates.end());
+    auto conjunction = predicates[0];
+    for (size_t i = 1; i < predicates.size(); i++) {
+      conjunction = std::make_shared<LogicExpression>(conjunction, predicates[i], LogicType::And);
+    }
+    pipeline->predicate_ = ExpressionProgram::Compile(conjunction);
+    if (pipeline->predicate_ == nullptr) {
+      return nullptr;
+    }
+  }
+
+  std::vector<AbstractExpressionRef> computed;
+  for (const auto &output : outputs) {
+    const auto *column_expr = dynamic_cast<const ColumnValueExpression *>(output.get());
+    if (column_expr != nullptr && column_expr->GetTupleIdx() == 0) {
+      pipeline->output_map_.push_back(Output{true, column_expr->GetColIdx()});
+    } else {
+      pipeline->output_map_.push_back(Output{false, static_cast<uint32_t>(computed.size())});
+      computed.push_back(output);
+    }
+  }
+  if (!computed.empty()) {
+    pipeline->outputs_ = ExpressionProgram::Compile(computed);
+    if (pipeline->outputs_ == nullptr) {
+      return nullptr;
+    }
+  }
+  return pipeline;
+}
+
+auto CompiledPipeline::GetSource(const AbstractPlanNode &plan) const -> const AbstractPlanNodeRef & {
+  // The source is below every filter and projection of the chain, and below the aggregation.
+  const auto *node = &plan.GetChildren()[0];
+  for (size_t i = is_aggregation_ ? 0 : 1; i < depth_; i++) {
+    node = &(*node)->GetChildren()[0];
+  }
+  return *node;
+}
+
+auto CompiledPipeline::ToString() const -> std::string {
+  auto str = fmt::format("CompiledPipeline {{ depth={}, aggregation={} }}\n", depth_, is_aggregation_);
+  if (predicate_ != nullptr) {
+    str += "predicate:\n" + predicate_->ToString();
+  }
+  if (is_projected_) {
+    std::vector<std::string> outputs;
+    for (const auto &output : output_map_) {
+      outputs.push_back(output.is_column_ ? fmt::format("#0.{}", output.idx_) : fmt::format("${}", output.idx_));
+    }
+    str += fmt::format("outputs: {}\n", fmt::join(outputs, ", "));
+  }
+  if (outputs_ != nullptr) {
+    str += outputs_->ToString();
+  }
+  return str;
+}
+
+CompiledPipeline::Runner::Runner(const CompiledPipeline &pipeline) : pipeline_(pipeline) {
+  if (pipeline.predicate_ != nullptr) {
+    predicate_ = std::make_unique<ExpressionProgram>(*pipeline.predicate_);
+  }
+  if (pipeline.outputs_ != nullptr) {
+    outputs_ = std::make_unique<ExpressionProgram>(*pipeline.outputs_);
+  }
+}
+
+auto CompiledPipeline::Runner::Run(TupleBatch *batch, std::vector<std::vector<Value>> *columns) -> bool {
+  if (predicate_ != nullptr) {
+    predicate_->Select(*batch, &selection_);
+    if (selection_.size() != batch->Size()) {
+      batch->Select(std::move(selection_));
+    }
+  }
+  if (batch->Empty()) {
+    return false;
+  }
+  if (!pipeline_.is_projected_) {
+    return true;
+  }
+
+  if (outputs_ != nullptr) {
+    outputs_->EvaluateBatch(*batch, &computed_);
+  }
+  const auto &output_map = pipeline_.output_map_;
+  columns->resize(output_map.size());
+  for (size_t j = 0; j < output_map.size(); j++) {
+    auto &column = (*columns)[j];
+    if (!output_map[j].is_column_) {
+      column = std::move(computed_[output_map[j].idx_]);
+      continue;
+    }
+    const auto &source = batch->GetColumn(output_map[j].idx_);
+    column.clear();
+    column.reserve(batch->Size());
+    for (uint32_t i = 0; i < batch->Size(); i++) {
+      column.push_back(source[batch->RowAt(i)]);
+    }
+  }
+  return true;
+}
+
+auto PipelineCache::GetOrCompile(const AbstractPlanNodeRef &plan) -> std::shared_ptr<const CompiledPipeline> {
+  auto fingerprint = CompiledPipeline::Fingerprint(*plan);
+  std::scoped_lock<std::mutex> guard(latch_);
+  auto it = pipelines_.find(fingerprint);
+  if (it != pipelines_.end()) {
+    hits_++;
+    return it->second;
+  }
+  misses_++;
+  if (pipelines_.size() >= CAPACITY) {
+    pipelines_.clear();
+  }
+  auto pipeline = CompiledPipeline::Compile(plan);
+  pipelines_.emplace(std::move(fingerprint), pipeline);
+  return pipeline;
+}
+
+auto PipelineCache::GetHits() const -> size_t {
+  std::scoped_lock<std::mutex> guard(latch_);
+  return hits_;
+}
+
+auto PipelineCache::GetMisses() const -> size_t {
+  std::scoped_lock<std::mutex> guard(latch_);
+  return misses_;
+}
+
+}  // namespace bustub
@@ -0,0 +1,63 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// compiled_pipeline_executor.cpp
+//
+// Identification: src/execution/compiled_pipeline_executor.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include "execution/executors/compiled_pipeline_executor.h"
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace bustub {
+
+CompiledPipelineExecutor::CompiledPipelineExecutor(ExecutorContext *exec_ctx, const AbstractPlanNode *plan,
+                                                   std::shared_ptr<const CompiledPipeline> pipeline,
+                                                   std::unique_ptr<AbstractExecutor> &&source_executor)
+    : AbstractExecutor(exec_ctx),
+      plan_(plan),
+      pipeline_(std::move(pipeline)),
+      source_executor_(std::move(source_executor)),
+      runner_(*pipeline_) {}
+
+void CompiledPipelineExecutor::Init() {
+  source_executor_->Init();
+  ResetBatchAdapter();
+}
+
+auto CompiledPipelineExecutor::Next(Tuple *tuple, RID *rid) -> bool { return NextFromBatch(tuple, rid); }
+
+auto CompiledPipelineExecutor::NextBatch(TupleBatch *batch) -> bool {
+  if (!pipeline_->IsProjected()) {
+    // Only filters: the output is the batch of the source, without the rejected rows.
+    while (source_executor_->NextBatch(batch)) {
+      if (runner_.Run(batch, &columns_)) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  while (source_executor_->NextBatch(&source_batch_)) {
+    if (!runner_.Run(&source_batch_, &columns_)) {
+      continue;
+    }
+    std::vector<RID> rids;
+    rids.reserve(source_batch_.Size());
+    for (uint32_t i = 0; i < source_batch_.Size(); i++) {
+      rids.push_back(source_batch_.GetRid(i));
+    }
+    batch->Reset(&GetOutputSchema());
+    batch->SetColumns(std::move(columns_), std::move(rids));
+    return true;
+  }
+  batch->Reset(&GetOutputSchema());
+  return false;
+}
+
+}  // namespace bustub
@@ -0,0 +1,72 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// cte_buffer.cpp
+//
+// Identification: src/execution/cte_buffer.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include "execution/cte_buffer.h"
+
+#include <memory>
+#include <utility>
+
+namespace bustub {
+
+CTEBuffer::CTEBuffer(BufferPoolManager *bpm, const Schema *schema, size_t memory_limit)
+    : bpm_(bpm), schema_(schema), memory_limit_(memory_limit) {}
+
+void CTEBuffer::Append(const TupleBatch &batch) {
+  for (uint32_t row = 0; row < batch.Size(); row++) {
+    auto tuple = batch.GetTuple(row);
+    // Once a row is spilled, all later rows are too, so that the rows are read back in order.
+    if (spill_ == nullptr) {
+      auto size = sizeof(Tuple) + tuple.GetLength();
+      if (bpm_ == nullptr || bytes_ + size <= memory_limit_) {
+        bytes_ += size;
+        rows_.push_back(std::move(tuple));
+        continue;
+      }
+      spill_ = std::make_unique<SpillFile>(bpm_, schema_);
+    }
+    spill_->Append(tuple);
+  }
+}
+
+CTEBuffer::Reader::Reader(const CTEBuffer *buffer) : buffer_(buffer) {
+  if (buffer_->spill_ != nullptr) {
+    spill_reader_.emplace(buffer_->spill_.get());
+  }
+}
+
+auto CTEBuffer::Reader::Next(const Schema *schema, TupleBatch *batch) -> bool {
+  batch->Reset(schema);
+  while (!batch->IsFull() && row_ < buffer_->rows_.size()) {
+    batch->AppendTuple(buffer_->rows_[row_++]);
+  }
+  Tuple tuple;
+  while (!batch->IsFull() && spill_reader_.has_value() && spill_reader_->Next(&tuple)) {
+    batch->AppendTuple(std::move(tuple));
+  }
+  return !batch->Empty();
+}
+
+auto CTEBufferRegistry::GetOrMaterialize(uint32_t cte_id,
+                                         const std::function<std::shared_ptr<const CTEBuffer>()> &materialize)
+    -> std::shared_ptr<const CTEBuffer> {
+  std::unique_lock<std::mutex> guard(latch_);
+  auto &slot = slots_[cte_id];
+  if (slot == nullptr) {
+    slot = std::make_shared<Slot>();
+  }
+  auto entry = slot;
+  guard.unlock();
+
+  // Materializing a CTE may take long, and may materialize the CTEs it reads, so only wait for the entry.
+  std::call_once(entry->once_, [&]() { entry->buffer_ = materialize(); });
+  return entry->buffer_;
+}
+
+}  // namespace bustub
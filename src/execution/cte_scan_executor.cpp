@@ -0,0 +1,46 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// cte_scan_executor.cpp
+//
+// Identification: src/execution/cte_scan_executor.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include "execution/executors/cte_scan_executor.h"
+
+#include <memory>
+#include <utility>
+
+namespace bustub {
+
+CTEScanExecutor::CTEScanExecutor(ExecutorContext *exec_ctx, const CTEScanPlanNode *plan,
+                                 std::unique_ptr<AbstractExecutor> &&child_executor)
+    : AbstractExecutor(exec_ctx), plan_(plan), child_executor_(std::move(child_executor)) {}
+
+void CTEScanExecutor::Init() {
+  ResetBatchAdapter();
+  if (buffer_ == nullptr) {
+    // Without a registry, each scan computes the CTE once for itself.
+    auto *registry = exec_ctx_->GetCTEBuffers();
+    buffer_ = registry != nullptr ? registry->GetOrMaterialize(plan_->GetCTEId(), [this]() { return Materialize(); })
+                                  : Materialize();
+  }
+  reader_.emplace(buffer_.get());
+}
+
+auto CTEScanExecutor::Materialize() -> std::shared_ptr<const CTEBuffer> {
+  child_executor_->Init();
+  auto buffer = std::make_shared<CTEBuffer>(exec_ctx_->GetBufferPoolManager(), &child_executor_->GetOutputSchema(),
+                                            exec_ctx_->GetMemoryLimit());
+  TupleBatch batch;
+  while (child_executor_->NextBatch(&batch)) {
+    buffer->Append(batch);
+  }
+  return buffer;
+}
+
+auto CTEScanExecutor::NextBatch(TupleBatch *batch) -> bool { return reader_->Next(&GetOutputSchema(), batch); }
+
+}  // namespace bustub
@@ -15,8 +15,11 @@
 #include <memory>
 #include <utility>
 
+#include "execution/compiled_pipeline.h"
 #include "execution/executors/abstract_executor.h"
 #include "execution/executors/aggregation_executor.h"
+#include "execution/executors/compiled_pipeline_executor.h"
+#include "execution/executors/cte_scan_executor.h"
 #include "execution/executors/delete_executor.h"
 #include "execution/executors/filter_executor.h"
 #include "execution/executors/hash_join_executor.h"
@@ -24,6 +27,7 @@
 #include "execution/executors/init_check_executor.h"
 #include "execution/executors/insert_executor.h"
 #include "execution/executors/limit_executor.h"
+#include "execution/executors/merge_join_executor.h"
 #include "execution/executors/mock_scan_executor.h"
 #include "execution/executors/nested_index_join_executor.h"
 #include "execution/executors/nested_loop_join_executor.h"
@@ -47,6 +51,21 @@ namespace bustub {
 auto ExecutorFactory::CreateExecutor(ExecutorContext *exec_ctx, const AbstractPlanNodeRef &plan)
     -> std::unique_ptr<AbstractExecutor> {
   auto check_options_set = exec_ctx->GetCheckOptions()->check_options_set_;
+
+  // Run chains of filters and projections, and the input of aggregations, as compiled pipelines if enabled.
+  auto *pipeline_cache = exec_ctx->GetPipelineCache();
+  if (pipeline_cache != nullptr && (plan->GetType() == PlanType::Filter || plan->GetType() == PlanType::Projection ||
+                                    plan->GetType() == PlanType::Aggregation)) {
+    if (auto pipeline = pipeline_cache->GetOrCompile(plan); pipeline != nullptr) {
+      auto source = ExecutorFactory::CreateExecutor(exec_ctx, pipeline->GetSource(*plan));
+      if (pipeline->IsAggregation()) {
+        return std::make_unique<AggregationExecutor>(exec_ctx, dynamic_cast<const AggregationPlanNode *>(plan.get()),
+                                                     std::move(source), std::move(pipeline));
+      }
+      return std::make_unique<CompiledPipelineExecutor>(exec_ctx, plan.get(), std::move(pipeline), std::move(source));
+    }
+  }
+
   switch (plan->GetType()) {
     // Create a new sequential scan executor
     case PlanType::SeqScan: {
@@ -126,12 +145,27 @@ auto ExecutorFactory::CreateExecutor(ExecutorContext *exec_ctx, const AbstractPl
       return std::make_unique<HashJoinExecutor>(exec_ctx, hash_join_plan, std::move(left), std::move(right));
     }
 
+    // Create a new merge join executor
+    case PlanType::MergeJoin: {
+      auto merge_join_plan = dynamic_cast<const MergeJoinPlanNode *>(plan.get());
+      auto left = ExecutorFactory::CreateExecutor(exec_ctx, merge_join_plan->GetLeftPlan());
+      auto right = ExecutorFactory::CreateExecutor(exec_ctx, merge_join_plan->GetRightPlan());
+      return std::make_unique<MergeJoinExecutor>(exec_ctx, merge_join_plan, std::move(left), std::move(right));
+    }
+
     // Create a new mock scan executor
     case PlanType::MockScan: {
       const auto *mock_scan_plan = dynamic_cast<const MockScanPlanNode *>(plan.get());
       return std::make_unique<MockScanExecutor>(exec_ctx, mock_scan_plan);
     }
 
+    // Create a new CTE scan executor
+    case PlanType::CTEScan: {
+      const auto *cte_scan_plan = dynamic_cast<const CTEScanPlanNode *>(plan.get());
+      auto child_executor = ExecutorFactory::CreateExecutor(exec_ctx, cte_scan_plan->GetChildPlan());
+      return std::make_unique<CTEScanExecutor>(exec_ctx, cte_scan_plan, std::move(child_executor));
+    }
+
     // Create a new projection executor
     case PlanType::Projection: {
       const auto *projection_plan = dynamic_cast<const ProjectionPlanNode *>(plan.get());
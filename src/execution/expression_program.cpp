@@ -0,0 +1,642 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// expression_program.cpp
+//
+// Identification: src/execution/expression_program.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include "execution/expression_program.h"
+
+#include <algorithm>
+#include <cctype>
+#include <functional>
+#include <memory>
+#include <numeric>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "common/exception.h"
+#include "common/macros.h"
+#include "execution/expressions/arithmetic_expression.h"
+#include "execution/expressions/column_value_expression.h"
+#include "execution/expressions/constant_value_expression.h"
+#include "execution/expressions/logic_expression.h"
+#include "execution/expressions/string_expression.h"
+#include "fmt/format.h"
+#include "type/limits.h"
+#include "type/value_factory.h"
+
+namespace bustub {
+
+namespace {
+
+/** @return whether an expression reads no column, so that it has the same value for every row */
+auto IsConstant(const AbstractExpression &expr) -> bool {
+  if (dynamic_cast<const ColumnValueExpression *>(&expr) != nullptr) {
+    return false;
+  }
+  return std::all_of(expr.GetChildren().begin(), expr.GetChildren().end(),
+                     [](const auto &child) { return IsConstant(*child); });
+}
+
+/** @return the value of an expression that reads no column, or std::nullopt if evaluating it fails */
+auto Fold(const AbstractExpression &expr) -> std::optional<Value> {
+  static const Schema empty_schema{std::vector<Column>{}};
+  try {
+    return expr.Evaluate(nullptr, empty_schema);
+  } catch (const Exception &) {
+    // Leave the error to the evaluation of the tree, which reports it when a row is evaluated.
+    return std::nullopt;
+  }
+}
+
+template <typename T, typename Cmp>
+void CompareKernel(const std::vector<uint32_t> &sel, const std::vector<T> &a, const std::vector<uint8_t> &a_nulls,
+                   const std::vector<T> &b, const std::vector<uint8_t> &b_nulls, std::vector<int64_t> *dst,
+                   std::vector<uint8_t> *dst_nulls) {
+  Cmp cmp;
+  for (auto i : sel) {
+    auto is_null = a_nulls[i] | b_nulls[i];
+    (*dst_nulls)[i] = is_null;
+    (*dst)[i] = is_null == 0 && cmp(a[i], b[i]) ? 1 : 0;
+  }
+}
+
+template <typename T>
+void Compare(ComparisonType comp_type, const std::vector<uint32_t> &sel, const std::vector<T> &a,
+             const std::vector<uint8_t> &a_nulls, const std::vector<T> &b, const std::vector<uint8_t> &b_nulls,
+             std::vector<int64_t> *dst, std::vector<uint8_t> *dst_nulls) {
+  switch (comp_type) {
+    case ComparisonType::Equal:
+      return CompareKernel<T, std::equal_to<T>>(sel, a, a_nulls, b, b_nulls, dst, dst_nulls);
+    case ComparisonType::NotEqual:
+      return CompareKernel<T, std::not_equal_to<T>>(sel, a, a_nulls, b, b_nulls, dst, dst_nulls);
+    case ComparisonType::LessThan:
+      return CompareKernel<T, std::less<T>>(sel, a, a_nulls, b, b_nulls, dst, dst_nulls);
+    case ComparisonType::LessThanOrEqual:
+      return CompareKernel<T, std::less_equal<T>>(sel, a, a_nulls, b, b_nulls, dst, dst_nulls);
+    case ComparisonType::GreaterThan:
+      return CompareKernel<T, std::greater<T>>(sel, a, a_nulls, b, b_nulls, dst, dst_nulls);
+    case ComparisonType::GreaterThanOrEqual:
+      return CompareKernel<T, std::greater_equal<T>>(sel, a, a_nulls, b, b_nulls, dst, dst_nulls);
+    default:
+      UNREACHABLE("Unsupported comparison type.");
+  }
+}
+
+/** Load an integer column whose values are stored as T. */
+template <typename T>
+void LoadIntegers(const TupleBatch &batch, const std::vector<Value> &column, const std::vector<uint32_t> &sel,
+                  std::vector<int64_t> *dst, std::vector<uint8_t> *dst_nulls) {
+  for (auto i : sel) {
+    const auto &value = column[batch.RowAt(i)];
+    auto is_null = value.IsNull();
+    (*dst_nulls)[i] = is_null ? 1 : 0;
+    (*dst)[i] = is_null ? 0 : static_cast<int64_t>(value.GetAs<T>());
+  }
+}
+
+/** @return a non-null value of an integer type, boolean or timestamp as an int64_t */
+auto IntegerOf(const Value &value) -> int64_t {
+  switch (value.GetTypeId()) {
+    case TypeId::TINYINT:
+    case TypeId::BOOLEAN:
+      return value.GetAs<int8_t>();
+    case TypeId::SMALLINT:
+      return value.GetAs<int16_t>();
+    case TypeId::INTEGER:
+      return value.GetAs<int32_t>();
+    case TypeId::TIMESTAMP:
+      return static_cast<int64_t>(value.GetAs<uint64_t>());
+    default:
+      return value.GetAs<int64_t>();
+  }
+}
+
+auto VarcharView(const Value &value) -> std::string_view {
+  return value.IsNull() ? std::string_view{} : std::string_view{value.GetData(), value.GetLength() - 1};
+}
+
+/** @return whether an expression produces timestamps, which are only compared with timestamps */
+auto IsTimestamp(const AbstractExpression &expr) -> bool { return expr.GetReturnType() == TypeId::TIMESTAMP; }
+
+}  // namespace
+
+auto ExpressionProgram::Compile(const AbstractExpressionRef &expr) -> std::unique_ptr<ExpressionProgram> {
+  return Compile(std::vector<AbstractExpressionRef>{expr});
+}
+
+auto ExpressionProgram::Compile(const std::vector<AbstractExpressionRef> &exprs) -> std::unique_ptr<ExpressionProgram> {
+  std::unique_ptr<ExpressionProgram> program(new ExpressionProgram());
+  program->selections_.emplace_back();
+  program->parents_.push_back(0);
+  for (const auto &expr : exprs) {
+    auto result = program->CompileNode(*expr, 0);
+    if (result < 0) {
+      return nullptr;
+    }
+    program->results_.emplace_back(result, expr->GetReturnType());
+  }
+  return program;
+}
+
+auto ExpressionProgram::RegisterTypeOf(TypeId type) -> std::optional<RegisterType> {
+  switch (type) {
+    case TypeId::TINYINT:
+    case TypeId::SMALLINT:
+    case TypeId::INTEGER:
+    case TypeId::BIGINT:
+    case TypeId::TIMESTAMP:
+      return RegisterType::Integer;
+    case TypeId::BOOLEAN:
+      return RegisterType::Boolean;
+    case TypeId::DECIMAL:
+      return RegisterType::Decimal;
+    case TypeId::VARCHAR:
+      return RegisterType::Varchar;
+    default:
+      return std::nullopt;
+  }
+}
+
+auto ExpressionProgram::NewRegister(RegisterType type) -> uint16_t {
+  registers_.push_back(Register{type, {}, {}, {}, {}, {}});
+  return registers_.size() - 1;
+}
+
+auto ExpressionProgram::NewSelection(uint16_t parent) -> uint16_t {
+  selections_.emplace_back();
+  parents_.push_back(parent);
+  return selections_.size() - 1;
+}
+
+auto ExpressionProgram::EmitConstant(const Value &value, uint16_t sel) -> int {
+  auto type = RegisterTypeOf(value.GetTypeId());
+  if (!type.has_value()) {
+    return -1;
+  }
+  auto dst = NewRegister(*type);
+  constants_.push_back(value);
+  code_.push_back(Instruction{OpCode::Constant, sel, dst, 0, 0, value.GetTypeId(),
+                              static_cast<uint32_t>(constants_.size() - 1)});
+  return dst;
+}
+
+auto ExpressionProgram::CompileNode(const AbstractExpression &expr, uint16_t sel) -> int {
+  if (IsConstant(expr)) {
+    auto value = Fold(expr);
+    return value.has_value() ? EmitConstant(*value, sel) : -1;
+  }
+
+  if (const auto *column_expr = dynamic_cast<const ColumnValueExpression *>(&expr); column_expr != nullptr) {
+    if (column_expr->GetTupleIdx() != 0) {
+      return -1;
+    }
+    auto type = RegisterTypeOf(column_expr->GetReturnType());
+    if (!type.has_value()) {
+      return -1;
+    }
+    // A column loaded on a selection can be read on the selections nested in it, whose instructions come later and
+    // run only if the instructions of the outer selection run.
+    for (auto outer = sel;; outer = parents_[outer]) {
+      auto loaded = loads_.find({outer, column_expr->GetColIdx()});
+      if (loaded != loads_.end() && registers_[loaded->second].type_ == *type) {
+        return loaded->second;
+      }
+      if (outer == 0) {
+        break;
+      }
+    }
+    auto dst = NewRegister(*type);
+    code_.push_back(Instruction{OpCode::Load, sel, dst, 0, 0, column_expr->GetReturnType(), column_expr->GetColIdx()});
+    loads_[{sel, column_expr->GetColIdx()}] = dst;
+    return dst;
+  }
+
+  if (const auto *cmp_expr = dynamic_cast<const ComparisonExpression *>(&expr); cmp_expr != nullptr) {
+    return CompileComparison(*cmp_expr, sel);
+  }
+
+  if (const auto *logic_expr = dynamic_cast<const LogicExpression *>(&expr); logic_expr != nullptr) {
+    return CompileLogic(expr, logic_expr->logic_type_ == LogicType::And, sel);
+  }
+
+  if (const auto *arith_expr = dynamic_cast<const ArithmeticExpression *>(&expr); arith_expr != nullptr) {
+    auto a = CompileNode(*expr.GetChildAt(0), sel);
+    auto b = a < 0 ? -1 : CompileNode(*expr.GetChildAt(1), sel);
+    if (b < 0 || registers_[a].type_ != RegisterType::Integer || registers_[b].type_ != RegisterType::Integer) {
+      return -1;
+    }
+    auto op = arith_expr->compute_type_ == ArithmeticType::Plus ? OpCode::AddInteger : OpCode::SubtractInteger;
+    auto dst = NewRegister(RegisterType::Integer);
+    code_.push_back(Instruction{op, sel, dst, static_cast<uint16_t>(a), static_cast<uint16_t>(b)});
+    return dst;
+  }
+
+  if (const auto *string_expr = dynamic_cast<const StringExpression *>(&expr); string_expr != nullptr) {
+    auto a = CompileNode(*expr.GetChildAt(0), sel);
+    if (a < 0 || registers_[a].type_ != RegisterType::Varchar) {
+      return -1;
+    }
+    auto op = string_expr->expr_type_ == StringExpressionType::Lower ? OpCode::Lower : OpCode::Upper;
+    auto dst = NewRegister(RegisterType::Varchar);
+    code_.push_back(Instruction{op, sel, dst, static_cast<uint16_t>(a)});
+    return dst;
+  }
+
+  return -1;
+}
+
+auto ExpressionProgram::CompileComparison(const ComparisonExpression &expr, uint16_t sel) -> int {
+  auto a = CompileNode(*expr.GetChildAt(0), sel);
+  auto b = a < 0 ? -1 : CompileNode(*expr.GetChildAt(1), sel);
+  if (b < 0) {
+    return -1;
+  }
+  auto a_type = registers_[a].type_;
+  auto b_type = registers_[b].type_;
+
+  OpCode op;
+  if ((a_type == RegisterType::Integer && b_type == RegisterType::Integer &&
+       IsTimestamp(*expr.GetChildAt(0)) == IsTimestamp(*expr.GetChildAt(1))) ||
+      (a_type == RegisterType::Boolean && b_type == RegisterType::Boolean)) {
+    op = OpCode::CompareInteger;
+  } else if (a_type == RegisterType::Varchar && b_type == RegisterType::Varchar) {
+    op = OpCode::CompareVarchar;
+  } else if ((a_type == RegisterType::Decimal || a_type == RegisterType::Integer) &&
+             (b_type == RegisterType::Decimal || b_type == RegisterType::Integer) &&
+             !IsTimestamp(*expr.GetChildAt(0)) && !IsTimestamp(*expr.GetChildAt(1))) {
+    // Values compare an integer with a decimal as decimals.
+    for (auto *operand : {&a, &b}) {
+      if (registers_[*operand].type_ == RegisterType::Integer) {
+        auto converted = NewRegister(RegisterType::Decimal);
+        code_.push_back(Instruction{OpCode::IntegerToDecimal, sel, converted, static_cast<uint16_t>(*operand)});
+        *operand = converted;
+      }
+    }
+    op = OpCode::CompareDecimal;
+  } else {
+    return -1;
+  }
+
+  auto dst = NewRegister(RegisterType::Boolean);
+  code_.push_back(Instruction{op, sel, dst, static_cast<uint16_t>(a), static_cast<uint16_t>(b), TypeId::INVALID,
+                              static_cast<uint32_t>(expr.comp_type_)});
+  return dst;
+}
+
+auto ExpressionProgram::CompileLogic(const AbstractExpression &expr, bool is_and, uint16_t sel) -> int {
+  // FALSE decides AND and TRUE decides OR, the other constant leaves the result to the other side.
+  for (size_t side = 0; side < 2; side++) {
+    if (!IsConstant(*expr.GetChildAt(side))) {
+      continue;
+    }
+    auto value = Fold(*expr.GetChildAt(side));
+    if (!value.has_value() || value->IsNull()) {
+      continue;
+    }
+    if (value->GetAs<bool>() != is_and) {
+      return EmitConstant(*value, sel);
+    }
+    return CompileNode(*expr.GetChildAt(1 - side), sel);
+  }
+
+  auto a = CompileNode(*expr.GetChildAt(0), sel);
+  if (a < 0) {
+    return -1;
+  }
+  auto undecided = NewSelection(sel);
+  code_.push_back(
+      Instruction{is_and ? OpCode::SelectNotFalse : OpCode::SelectNotTrue, sel, undecided, static_cast<uint16_t>(a)});
+  auto jump = code_.size();
+  code_.push_back(Instruction{OpCode::JumpIfEmpty, undecided});
+  auto b = CompileNode(*expr.GetChildAt(1), undecided);
+  if (b < 0) {
+    return -1;
+  }
+  code_[jump].aux_ = code_.size();
+
+  auto dst = NewRegister(RegisterType::Boolean);
+  code_.push_back(
+      Instruction{is_and ? OpCode::And : OpCode::Or, sel, dst, static_cast<uint16_t>(a), static_cast<uint16_t>(b)});
+  return dst;
+}
+
+void ExpressionProgram::Run(const TupleBatch &batch) {
+  auto num_rows = batch.Size();
+  selections_[0].resize(num_rows);
+  std::iota(selections_[0].begin(), selections_[0].end(), 0);
+  for (auto &reg : registers_) {
+    reg.nulls_.resize(num_rows);
+    switch (reg.type_) {
+      case RegisterType::Integer:
+      case RegisterType::Boolean:
+        reg.integers_.resize(num_rows);
+        break;
+      case RegisterType::Decimal:
+        reg.decimals_.resize(num_rows);
+        break;
+      case RegisterType::Varchar:
+        reg.strings_.resize(num_rows);
+        reg.owned_.resize(num_rows);
+        break;
+    }
+  }
+
+  size_t pc = 0;
+  while (pc < code_.size()) {
+    const auto &ins = code_[pc++];
+    const auto &sel = selections_[ins.sel_];
+    auto &dst = registers_[ins.dst_];
+    switch (ins.op_) {
+      case OpCode::Load: {
+        const auto &column = batch.GetColumn(ins.aux_);
+        switch (ins.type_) {
+          case TypeId::TINYINT:
+          case TypeId::BOOLEAN:
+            LoadIntegers<int8_t>(batch, column, sel, &dst.integers_, &dst.nulls_);
+            break;
+          case TypeId::SMALLINT:
+            LoadIntegers<int16_t>(batch, column, sel, &dst.integers_, &dst.nulls_);
+            break;
+          case TypeId::INTEGER:
+            LoadIntegers<int32_t>(batch, column, sel, &dst.integers_, &dst.nulls_);
+            break;
+          case TypeId::BIGINT:
+            LoadIntegers<int64_t>(batch, column, sel, &dst.integers_, &dst.nulls_);
+            break;
+          case TypeId::TIMESTAMP:
+            LoadIntegers<uint64_t>(batch, column, sel, &dst.integers_, &dst.nulls_);
+            break;
+          case TypeId::DECIMAL:
+            for (auto i : sel) {
+              const auto &value = column[batch.RowAt(i)];
+              dst.nulls_[i] = value.IsNull() ? 1 : 0;
+              dst.decimals_[i] = value.IsNull() ? 0 : value.GetAs<double>();
+            }
+            break;
+          case TypeId::VARCHAR:
+            for (auto i : sel) {
+              const auto &value = column[batch.RowAt(i)];
+              dst.nulls_[i] = value.IsNull() ? 1 : 0;
+              dst.strings_[i] = VarcharView(value);
+            }
+            break;
+          default:
+            UNREACHABLE("Unsupported column type.");
+        }
+        break;
+      }
+      case OpCode::Constant: {
+        const auto &value = constants_[ins.aux_];
+        uint8_t is_null = value.IsNull() ? 1 : 0;
+        for (auto i : sel) {
+          dst.nulls_[i] = is_null;
+        }
+        if (is_null != 0) {
+          break;
+        }
+        switch (dst.type_) {
+          case RegisterType::Integer:
+          case RegisterType::Boolean: {
+            auto integer = IntegerOf(value);
+            for (auto i : sel) {
+              dst.integers_[i] = integer;
+            }
+            break;
+          }
+          case RegisterType::Decimal:
+            for (auto i : sel) {
+              dst.decimals_[i] = value.GetAs<double>();
+            }
+            break;
+          case RegisterType::Varchar:
+            for (auto i : sel) {
+              dst.strings_[i] = VarcharView(value);
+            }
+            break;
+        }
+        break;
+      }
+      case OpCode::IntegerToDecimal: {
+        const auto &a = registers_[ins.a_];
+        for (auto i : sel) {
+          dst.nulls_[i] = a.nulls_[i];
+          dst.decimals_[i] = static_cast<double>(a.integers_[i]);
+        }
+        break;
+      }
+      case OpCode::CompareInteger: {
+        const auto &a = registers_[ins.a_];
+        const auto &b = registers_[ins.b_];
+        Compare(static_cast<ComparisonType>(ins.aux_), sel, a.integers_, a.nulls_, b.integers_, b.nulls_,
+                &dst.integers_, &dst.nulls_);
+        break;
+      }
+      case OpCode::CompareDecimal: {
+        const auto &a = registers_[ins.a_];
+        const auto &b = registers_[ins.b_];
+        Compare(static_cast<ComparisonType>(ins.aux_), sel, a.decimals_, a.nulls_, b.decimals_, b.nulls_,
+                &dst.integers_, &dst.nulls_);
+        break;
+      }
+      case OpCode::CompareVarchar: {
+        const auto &a = registers_[ins.a_];
+        const auto &b = registers_[ins.b_];
+        Compare(static_cast<ComparisonType>(ins.aux_), sel, a.strings_, a.nulls_, b.strings_, b.nulls_,
+                &dst.integers_, &dst.nulls_);
+        break;
+      }
+      case OpCode::AddInteger:
+      case OpCode::SubtractInteger: {
+        const auto &a = registers_[ins.a_];
+        const auto &b = registers_[ins.b_];
+        auto is_add = ins.op_ == OpCode::AddInteger;
+        for (auto i : sel) {
+          auto lhs = static_cast<uint32_t>(a.integers_[i]);
+          auto rhs = static_cast<uint32_t>(b.integers_[i]);
+          auto result = static_cast<int32_t>(is_add ? lhs + rhs : lhs - rhs);
+          // The smallest 32-bit integer is how INTEGER stores null.
+          dst.nulls_[i] = (a.nulls_[i] | b.nulls_[i]) != 0 || result == BUSTUB_INT32_NULL ? 1 : 0;
+          dst.integers_[i] = result;
+        }
+        break;
+      }
+      case OpCode::SelectNotFalse:
+      case OpCode::SelectNotTrue: {
+        const auto &a = registers_[ins.a_];
+        auto &out = selections_[ins.dst_];
+        auto decided = ins.op_ == OpCode::SelectNotFalse ? 0 : 1;
+        out.clear();
+        for (auto i : sel) {
+          if (a.nulls_[i] != 0 || a.integers_[i] != decided) {
+            out.push_back(i);
+          }
+        }
+        break;
+      }
+      case OpCode::JumpIfEmpty:
+        if (sel.empty()) {
+          pc = ins.aux_;
+        }
+        break;
+      case OpCode::And:
+      case OpCode::Or: {
+        const auto &a = registers_[ins.a_];
+        const auto &b = registers_[ins.b_];
+        // FALSE decides AND, TRUE decides OR. b is valid on the rows a does not decide.
+        int64_t decided = ins.op_ == OpCode::And ? 0 : 1;
+        for (auto i : sel) {
+          if ((a.nulls_[i] == 0 && a.integers_[i] == decided) || (b.nulls_[i] == 0 && b.integers_[i] == decided)) {
+            dst.nulls_[i] = 0;
+            dst.integers_[i] = decided;
+          } else {
+            dst.nulls_[i] = a.nulls_[i] | b.nulls_[i];
+            dst.integers_[i] = 1 - decided;
+          }
+        }
+        break;
+      }
+      case OpCode::Lower:
+      case OpCode::Upper: {
+        const auto &a = registers_[ins.a_];
+        auto (*convert)(int) -> int = ins.op_ == OpCode::Lower ? ::tolower : ::toupper;
+        for (auto i : sel) {
+          dst.nulls_[i] = a.nulls_[i];
+          auto &owned = dst.owned_[i];
+          owned.assign(a.strings_[i]);
+          std::transform(owned.begin(), owned.end(), owned.begin(),
+                         [convert](unsigned char c) { return static_cast<char>(convert(c)); });
+          dst.strings_[i] = owned;
+        }
+        break;
+      }
+    }
+  }
+}
+
+auto ExpressionProgram::GetResult(size_t result, uint32_t i) const -> Value {
+  const auto &[reg_idx, result_type] = results_[result];
+  const auto &reg = registers_[reg_idx];
+  if (reg.nulls_[i] != 0) {
+    return ValueFactory::GetNullValueByType(result_type);
+  }
+  switch (reg.type_) {
+    case RegisterType::Boolean:
+      return ValueFactory::GetBooleanValue(reg.integers_[i] != 0);
+    case RegisterType::Decimal:
+      return ValueFactory::GetDecimalValue(reg.decimals_[i]);
+    case RegisterType::Varchar:
+      return ValueFactory::GetVarcharValue(std::string(reg.strings_[i]));
+    case RegisterType::Integer:
+      break;
+  }
+  switch (result_type) {
+    case TypeId::TINYINT:
+      return ValueFactory::GetTinyIntValue(static_cast<int8_t>(reg.integers_[i]));
+    case TypeId::SMALLINT:
+      return ValueFactory::GetSmallIntValue(static_cast<int16_t>(reg.integers_[i]));
+    case TypeId::INTEGER:
+      return ValueFactory::GetIntegerValue(static_cast<int32_t>(reg.integers_[i]));
+    case TypeId::TIMESTAMP:
+      return ValueFactory::GetTimestampValue(reg.integers_[i]);
+    default:
+      return ValueFactory::GetBigIntValue(reg.integers_[i]);
+  }
+}
+
+void ExpressionProgram::EvaluateBatch(const TupleBatch &batch, std::vector<Value> *result) {
+  Run(batch);
+  result->clear();
+  result->reserve(batch.Size());
+  for (uint32_t i = 0; i < batch.Size(); i++) {
+    result->push_back(GetResult(0, i));
+  }
+}
+
+void ExpressionProgram::EvaluateBatch(const TupleBatch &batch, std::vector<std::vector<Value>> *results) {
+  Run(batch);
+  results->resize(results_.size());
+  for (size_t j = 0; j < results_.size(); j++) {
+    auto &result = (*results)[j];
+    result.clear();
+    result.reserve(batch.Size());
+    for (uint32_t i = 0; i < batch.Size(); i++) {
+      result.push_back(GetResult(j, i));
+    }
+  }
+}
+
+void ExpressionProgram::Select(const TupleBatch &batch, std::vector<uint32_t> *selection) {
+  BUSTUB_ASSERT(results_.size() == 1 && registers_[results_[0].first].type_ == RegisterType::Boolean,
+                "only a single boolean expression selects rows");
+  Run(batch);
+  const auto &reg = registers_[results_[0].first];
+  selection->clear();
+  for (uint32_t i = 0; i < batch.Size(); i++) {
+    if (reg.nulls_[i] == 0 && reg.integers_[i] != 0) {
+      selection->push_back(batch.RowAt(i));
+    }
+  }
+}
+
+auto ExpressionProgram::ToString() const -> std::string {
+  std::string str;
+  for (size_t pc = 0; pc < code_.size(); pc++) {
+    const auto &ins = code_[pc];
+    std::string text;
+    switch (ins.op_) {
+      case OpCode::Load:
+        text = fmt::format("r{} = load #0.{} {}", ins.dst_, ins.aux_, Type::TypeIdToString(ins.type_));
+        break;
+      case OpCode::Constant:
+        text = fmt::format("r{} = const {}", ins.dst_, constants_[ins.aux_].ToString());
+        break;
+      case OpCode::IntegerToDecimal:
+        text = fmt::format("r{} = decimal r{}", ins.dst_, ins.a_);
+        break;
+      case OpCode::CompareInteger:
+      case OpCode::CompareDecimal:
+      case OpCode::CompareVarchar: {
+        auto kind = ins.op_ == OpCode::CompareInteger ? "int" : ins.op_ == OpCode::CompareDecimal ? "dec" : "str";
+        text = fmt::format("r{} = r{} {}{} r{}", ins.dst_, ins.a_, static_cast<ComparisonType>(ins.aux_), kind, ins.b_);
+        break;
+      }
+      case OpCode::AddInteger:
+        text = fmt::format("r{} = r{} + r{}", ins.dst_, ins.a_, ins.b_);
+        break;
+      case OpCode::SubtractInteger:
+        text = fmt::format("r{} = r{} - r{}", ins.dst_, ins.a_, ins.b_);
+        break;
+      case OpCode::SelectNotFalse:
+        text = fmt::format("s{} = where r{} is not false", ins.dst_, ins.a_);
+        break;
+      case OpCode::SelectNotTrue:
+        text = fmt::format("s{} = where r{} is not true", ins.dst_, ins.a_);
+        break;
+      case OpCode::JumpIfEmpty:
+        text = fmt::format("jump {} if empty", ins.aux_);
+        break;
+      case OpCode::And:
+        text = fmt::format("r{} = r{} and r{}", ins.dst_, ins.a_, ins.b_);
+        break;
+      case OpCode::Or:
+        text = fmt::format("r{} = r{} or r{}", ins.dst_, ins.a_, ins.b_);
+        break;
+      case OpCode::Lower:
+        text = fmt::format("r{} = lower(r{})", ins.dst_, ins.a_);
+        break;
+      case OpCode::Upper:
+        text = fmt::format("r{} = upper(r{})", ins.dst_, ins.a_);
+        break;
+    }
+    str += fmt::format("{}: [s{}] {}\n", pc, ins.sel_, text);
+  }
+  return str;
+}
+
+}  // namespace bustub
@@ -6,7 +6,10 @@ namespace bustub {
 
 FilterExecutor::FilterExecutor(ExecutorContext *exec_ctx, const FilterPlanNode *plan,
                                std::unique_ptr<AbstractExecutor> &&child_executor)
-    : AbstractExecutor(exec_ctx), plan_(plan), child_executor_(std::move(child_executor)) {}
+    : AbstractExecutor(exec_ctx),
+      plan_(plan),
+      child_executor_(std::move(child_executor)),
+      predicate_program_(ExpressionProgram::Compile(plan_->GetPredicate())) {}
 
 void FilterExecutor::Init() {
   // Initialize the child executor
@@ -31,4 +34,29 @@ auto FilterExecutor::Next(Tuple *tuple, RID *rid) -> bool {
   }
 }
 
+auto FilterExecutor::NextBatch(TupleBatch *batch) -> bool {
+  std::vector<Value> result;
+  while (child_executor_->NextBatch(batch)) {
+    std::vector<uint32_t> selection;
+    if (predicate_program_ != nullptr) {
+      predicate_program_->Select(*batch, &selection);
+    } else {
+      plan_->GetPredicate()->EvaluateBatch(*batch, &result);
+      selection.reserve(result.size());
+      for (uint32_t i = 0; i < result.size(); i++) {
+        if (!result[i].IsNull() && result[i].GetAs<bool>()) {
+          selection.push_back(batch->RowAt(i));
+        }
+      }
+    }
+    if (selection.size() != batch->Size()) {
+      batch->Select(std::move(selection));
+    }
+    if (!batch->Empty()) {
+      return true;
+    }
+  }
+  return false;
+}
+
 }  // namespace bustub
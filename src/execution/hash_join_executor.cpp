@@ -10,22 +10,294 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <memory>
+#include <optional>
+#include <utility>
+#include <vector>
+
 #include "execution/executors/hash_join_executor.h"
+#include "execution/morsel.h"
+#include "type/value_factory.h"
 
 namespace bustub {
 
 HashJoinExecutor::HashJoinExecutor(ExecutorContext *exec_ctx, const HashJoinPlanNode *plan,
                                    std::unique_ptr<AbstractExecutor> &&left_child,
                                    std::unique_ptr<AbstractExecutor> &&right_child)
-    : AbstractExecutor(exec_ctx) {
-  if (!(plan->GetJoinType() == JoinType::LEFT || plan->GetJoinType() == JoinType::INNER)) {
-    // Note for 2023 Spring: You ONLY need to implement left join and inner join.
-    throw bustub::NotImplementedException(fmt::format("join type {} not supported", plan->GetJoinType()));
+    : AbstractExecutor(exec_ctx),
+      plan_(plan),
+      left_executor_(std::move(left_child)),
+      right_executor_(std::move(right_child)) {
+  if (!EmitsUnmatchedLeft() && exec_ctx_->GetRuntimeFilters() != nullptr) {
+    runtime_filter_target_ = RuntimeFilter::FindTarget(*plan_->GetLeftPlan(), plan_->LeftJoinKeyExpressions());
+  }
+}
+
+void HashJoinExecutor::Init() {
+  left_executor_->Init();
+  ResetBatchAdapter();
+
+  std::shared_ptr<const JoinHashTable> table;
+  auto parallel_ctx = exec_ctx_->GetParallelContext();
+  if (parallel_ctx != nullptr) {
+    table = parallel_ctx->GetOrCreateShared<JoinHashTable>(plan_, [this]() { return BuildHashTable(); });
+  } else {
+    table = BuildHashTable();
+  }
+
+  probe_spills_.clear();
+  spilled_tasks_.clear();
+  StartProbe(std::move(table), nullptr);
+  probing_left_child_ = true;
+}
+
+auto HashJoinExecutor::BuildHashTable() -> std::shared_ptr<const JoinHashTable> {
+  right_executor_->Init();
+  auto table = std::make_shared<JoinHashTable>(exec_ctx_->GetBufferPoolManager(), &right_executor_->GetOutputSchema(),
+                                               exec_ctx_->GetMemoryLimit());
+  std::vector<hash_t> hashes;
+  auto *runtime_hashes = runtime_filter_target_.has_value() ? &hashes : nullptr;
+  TupleBatch batch;
+  while (right_executor_->NextBatch(&batch)) {
+    InsertBatch(table.get(), batch, runtime_hashes);
+  }
+  table->Finalize();
+
+  // The scan looks up its filters when it is first asked for rows, which the join only does once the table is built.
+  if (runtime_hashes != nullptr) {
+    exec_ctx_->GetRuntimeFilters()->Publish(
+        runtime_filter_target_->scan_, plan_,
+        std::make_shared<const RuntimeFilter>(runtime_filter_target_->columns_, hashes));
+  }
+  return table;
+}
+
+void HashJoinExecutor::InsertBatch(JoinHashTable *table, const TupleBatch &batch, std::vector<hash_t> *hashes) const {
+  const auto &right_exprs = plan_->RightJoinKeyExpressions();
+  std::vector<std::vector<Value>> right_keys(right_exprs.size());
+  for (size_t i = 0; i < right_exprs.size(); i++) {
+    right_exprs[i]->EvaluateBatch(batch, &right_keys[i]);
+  }
+  for (uint32_t row = 0; row < batch.Size(); row++) {
+    HashJoinKey key;
+    key.keys_.reserve(right_keys.size());
+    auto has_null = false;
+    for (auto &column : right_keys) {
+      has_null = has_null || column[row].IsNull();
+      key.keys_.push_back(std::move(column[row]));
+    }
+    // A null never matches, so the row is only needed if it is part of the result anyway.
+    if (has_null && !EmitsUnmatchedRight()) {
+      continue;
+    }
+    if (hashes != nullptr && !has_null) {
+      hashes->push_back(RuntimeFilter::HashKey(key.keys_));
+    }
+    auto hash = key.Hash();
+    table->Insert(batch.GetTuple(row), std::move(key), hash);
+  }
+}
+
+void HashJoinExecutor::StartProbe(std::shared_ptr<const JoinHashTable> table, std::unique_ptr<SpillFile> probe_rows) {
+  table_ = std::move(table);
+  matched_.assign(EmitsUnmatchedRight() ? table_->NumRows() : 0, false);
+  probe_rows_ = std::move(probe_rows);
+  probe_reader_.reset();
+  if (probe_rows_ != nullptr) {
+    probe_reader_.emplace(probe_rows_.get());
+  }
+  probing_left_child_ = false;
+
+  left_batch_.Reset(&left_executor_->GetOutputSchema());
+  left_keys_.assign(plan_->LeftJoinKeyExpressions().size(), {});
+  left_pos_ = 0;
+  left_done_ = false;
+  match_partition_ = nullptr;
+  unmatched_leaf_ = 0;
+  unmatched_row_ = 0;
+}
+
+auto HashJoinExecutor::StartNextSpilledTask() -> bool {
+  if (table_ != nullptr) {
+    for (const auto *partition : table_->GetSpilledPartitions()) {
+      std::unique_ptr<SpillFile> probe_rows;
+      auto it = probe_spills_.find(partition);
+      if (it != probe_spills_.end()) {
+        probe_rows = std::move(it->second);
+      }
+      if (probe_rows == nullptr && !EmitsUnmatchedRight()) {
+        continue;
+      }
+      spilled_tasks_.push_back({partition->spill_, partition->level_, std::move(probe_rows)});
+    }
+    probe_spills_.clear();
+    table_ = nullptr;
+  }
+  if (spilled_tasks_.empty()) {
+    return false;
+  }
+
+  auto task = std::move(spilled_tasks_.back());
+  spilled_tasks_.pop_back();
+  auto table = std::make_shared<JoinHashTable>(exec_ctx_->GetBufferPoolManager(), &right_executor_->GetOutputSchema(),
+                                               exec_ctx_->GetMemoryLimit(), task.level_);
+  SpillFile::Reader reader(task.build_rows_.get());
+  TupleBatch batch;
+  while (reader.Next(&batch)) {
+    InsertBatch(table.get(), batch);
   }
+  table->Finalize();
+  StartProbe(std::move(table), std::move(task.probe_rows_));
+  return true;
 }
 
-void HashJoinExecutor::Init() { throw NotImplementedException("HashJoinExecutor is not implemented"); }
+auto HashJoinExecutor::Next(Tuple *tuple, RID *rid) -> bool { return NextFromBatch(tuple, rid); }
 
-auto HashJoinExecutor::Next(Tuple *tuple, RID *rid) -> bool { return false; }
+auto HashJoinExecutor::NextBatch(TupleBatch *batch) -> bool {
+  batch->Reset(&GetOutputSchema());
+  while (!batch->IsFull()) {
+    if (table_ != nullptr && !left_done_) {
+      Probe(batch);
+    } else if (table_ != nullptr && EmitsUnmatchedRight() && unmatched_leaf_ < table_->GetLeaves().size()) {
+      EmitUnmatchedRight(batch);
+    } else if (!StartNextSpilledTask()) {
+      break;
+    }
+  }
+  return !batch->Empty();
+}
+
+auto HashJoinExecutor::NextProbeBatch() -> bool {
+  if (probing_left_child_) {
+    if (!left_executor_->NextBatch(&left_batch_)) {
+      return false;
+    }
+  } else if (!probe_reader_.has_value() || !probe_reader_->Next(&left_batch_)) {
+    return false;
+  }
+  const auto &left_exprs = plan_->LeftJoinKeyExpressions();
+  for (size_t i = 0; i < left_exprs.size(); i++) {
+    left_exprs[i]->EvaluateBatch(left_batch_, &left_keys_[i]);
+  }
+  left_pos_ = 0;
+  return true;
+}
+
+void HashJoinExecutor::Probe(TupleBatch *batch) {
+  while (!batch->IsFull()) {
+    if (match_partition_ != nullptr) {
+      while (!batch->IsFull()) {
+        auto row = match_partition_->NextMatch(match_hash_, match_key_, &match_pos_);
+        if (!row.has_value()) {
+          break;
+        }
+        row_matched_ = true;
+        if (EmitsLeftOnly()) {
+          break;
+        }
+        if (EmitsUnmatchedRight()) {
+          matched_[match_partition_->row_offset_ + *row] = true;
+        }
+        EmitRow(batch, &match_partition_->rows_[*row]);
+      }
+      if (batch->IsFull()) {
+        return;
+      }
+      match_partition_ = nullptr;
+      if (row_matched_ ? plan_->GetJoinType() == JoinType::SEMI : EmitsUnmatchedLeft()) {
+        EmitRow(batch, nullptr);
+      }
+      left_pos_++;
+      continue;
+    }
+
+    if (left_pos_ == left_batch_.Size()) {
+      if (!NextProbeBatch()) {
+        left_done_ = true;
+        return;
+      }
+      continue;
+    }
+
+    HashJoinKey key;
+    key.keys_.reserve(left_keys_.size());
+    auto has_null = false;
+    for (const auto &column : left_keys_) {
+      has_null = has_null || column[left_pos_].IsNull();
+      key.keys_.push_back(column[left_pos_]);
+    }
+    if (has_null) {
+      if (EmitsUnmatchedLeft()) {
+        EmitRow(batch, nullptr);
+      }
+      left_pos_++;
+      continue;
+    }
+
+    auto hash = key.Hash();
+    const auto &leaf = table_->GetLeaf(hash);
+    if (leaf.IsSpilled()) {
+      // The right rows of this partition are joined later, so the left row has to wait for them.
+      auto &spill = probe_spills_[&leaf];
+      if (spill == nullptr) {
+        spill = std::make_unique<SpillFile>(exec_ctx_->GetBufferPoolManager(), &left_executor_->GetOutputSchema());
+      }
+      spill->Append(left_batch_.GetTuple(left_pos_));
+      left_pos_++;
+      continue;
+    }
+
+    match_partition_ = &leaf;
+    match_key_ = std::move(key);
+    match_hash_ = hash;
+    match_pos_ = leaf.StartSlot(hash);
+    row_matched_ = false;
+  }
+}
+
+void HashJoinExecutor::EmitUnmatchedRight(TupleBatch *batch) {
+  const auto &leaves = table_->GetLeaves();
+  while (!batch->IsFull() && unmatched_leaf_ < leaves.size()) {
+    const auto *leaf = leaves[unmatched_leaf_];
+    if (unmatched_row_ == leaf->rows_.size()) {
+      unmatched_leaf_++;
+      unmatched_row_ = 0;
+      continue;
+    }
+    if (!matched_[leaf->row_offset_ + unmatched_row_]) {
+      EmitRightOnly(batch, leaf->rows_[unmatched_row_]);
+    }
+    unmatched_row_++;
+  }
+}
+
+void HashJoinExecutor::EmitRow(TupleBatch *batch, const Tuple *right_row) {
+  const auto &left_schema = left_executor_->GetOutputSchema();
+  const auto &right_schema = right_executor_->GetOutputSchema();
+  std::vector<Value> values;
+  values.reserve(left_schema.GetColumnCount() + right_schema.GetColumnCount());
+  for (uint32_t col = 0; col < left_schema.GetColumnCount(); col++) {
+    values.push_back(left_batch_.GetValue(left_pos_, col));
+  }
+  for (uint32_t col = 0; col < right_schema.GetColumnCount() && !EmitsLeftOnly(); col++) {
+    values.push_back(right_row != nullptr ? right_row->GetValue(&right_schema, col)
+                                          : ValueFactory::GetNullValueByType(right_schema.GetColumn(col).GetType()));
+  }
+  batch->AppendValues(std::move(values));
+}
+
+void HashJoinExecutor::EmitRightOnly(TupleBatch *batch, const Tuple &right_row) {
+  const auto &left_schema = left_executor_->GetOutputSchema();
+  const auto &right_schema = right_executor_->GetOutputSchema();
+  std::vector<Value> values;
+  values.reserve(left_schema.GetColumnCount() + right_schema.GetColumnCount());
+  for (uint32_t col = 0; col < left_schema.GetColumnCount(); col++) {
+    values.push_back(ValueFactory::GetNullValueByType(left_schema.GetColumn(col).GetType()));
+  }
+  for (uint32_t col = 0; col < right_schema.GetColumnCount(); col++) {
+    values.push_back(right_row.GetValue(&right_schema, col));
+  }
+  batch->AppendValues(std::move(values));
+}
 
 }  // namespace bustub
@@ -0,0 +1,161 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// join_hash_table.cpp
+//
+// Identification: src/execution/join_hash_table.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include "execution/join_hash_table.h"
+
+#include <algorithm>
+#include <memory>
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace bustub {
+
+namespace {
+
+/** @return approximate memory used by a build row in a partition */
+auto RowSize(const Tuple &row, const HashJoinKey &key) -> size_t {
+  return sizeof(Tuple) + row.GetLength() + sizeof(HashJoinKey) + key.keys_.size() * sizeof(Value) + sizeof(hash_t) +
+         2 * sizeof(uint32_t);
+}
+
+}  // namespace
+
+auto HashJoinKey::Hash() const -> hash_t {
+  hash_t hash = 0;
+  for (const auto &key : keys_) {
+    if (!key.IsNull()) {
+      hash = HashUtil::CombineHashes(hash, HashUtil::HashValue(&key));
+    }
+  }
+  // The low bits used for partitioning have to depend on all bits of the hash.
+  return HashUtil::MixBits(hash);
+}
+
+auto JoinHashTable::Partition::NextMatch(hash_t hash, const HashJoinKey &key, size_t *pos) const
+    -> std::optional<uint32_t> {
+  auto mask = slots_.size() - 1;
+  while (slots_[*pos] != 0) {
+    auto row = slots_[*pos] - 1;
+    *pos = (*pos + 1) & mask;
+    if (hashes_[row] == hash && keys_[row] == key) {
+      return row;
+    }
+  }
+  return std::nullopt;
+}
+
+JoinHashTable::JoinHashTable(BufferPoolManager *bpm, const Schema *schema, size_t memory_limit, uint32_t level)
+    : bpm_(bpm),
+      schema_(schema),
+      memory_limit_(memory_limit),
+      level_(level),
+      partitions_(level < MAX_LEVELS ? FANOUT : 1) {
+  for (auto &partition : partitions_) {
+    partition.level_ = level_ + 1;
+  }
+}
+
+void JoinHashTable::Insert(Tuple row, HashJoinKey key, hash_t hash) {
+  auto &partition = partitions_[PartitionOf(hash, level_)];
+  if (partition.IsSpilled()) {
+    partition.spill_->Append(row);
+    return;
+  }
+
+  auto size = RowSize(row, key);
+  partition.rows_.push_back(std::move(row));
+  partition.keys_.push_back(std::move(key));
+  partition.hashes_.push_back(hash);
+  partition.bytes_ += size;
+  bytes_ += size;
+
+  if (bpm_ != nullptr && level_ < MAX_LEVELS) {
+    while (bytes_ > memory_limit_) {
+      SpillLargestPartition();
+    }
+  }
+}
+
+void JoinHashTable::SpillLargestPartition() {
+  auto largest = std::max_element(partitions_.begin(), partitions_.end(), [](const auto &a, const auto &b) {
+    return a.bytes_ < b.bytes_;
+  });
+  largest->spill_ = std::make_shared<SpillFile>(bpm_, schema_);
+  for (const auto &row : largest->rows_) {
+    largest->spill_->Append(row);
+  }
+  bytes_ -= largest->bytes_;
+  largest->bytes_ = 0;
+  largest->rows_ = {};
+  largest->keys_ = {};
+  largest->hashes_ = {};
+}
+
+void JoinHashTable::Finalize() {
+  for (auto &partition : partitions_) {
+    if (partition.IsSpilled()) {
+      spilled_.push_back(&partition);
+    } else {
+      FinalizePartition(&partition);
+    }
+  }
+}
+
+void JoinHashTable::FinalizePartition(Partition *partition) {
+  if (partition->bytes_ > CACHE_PARTITION_SIZE && partition->level_ < MAX_LEVELS) {
+    partition->children_.resize(FANOUT);
+    for (auto &child : partition->children_) {
+      child.level_ = partition->level_ + 1;
+    }
+    for (size_t i = 0; i < partition->rows_.size(); i++) {
+      auto &child = partition->children_[PartitionOf(partition->hashes_[i], partition->level_)];
+      child.bytes_ += RowSize(partition->rows_[i], partition->keys_[i]);
+      child.rows_.push_back(std::move(partition->rows_[i]));
+      child.keys_.push_back(std::move(partition->keys_[i]));
+      child.hashes_.push_back(partition->hashes_[i]);
+    }
+    partition->rows_ = {};
+    partition->keys_ = {};
+    partition->hashes_ = {};
+    for (auto &child : partition->children_) {
+      FinalizePartition(&child);
+    }
+    return;
+  }
+
+  // Keep the load factor at or below 1/2, so that probes are short and always reach an empty slot.
+  size_t capacity = 1;
+  while (capacity < 2 * partition->rows_.size() + 1) {
+    capacity <<= 1;
+  }
+  partition->slots_.assign(capacity, 0);
+  for (uint32_t row = 0; row < partition->rows_.size(); row++) {
+    auto pos = partition->StartSlot(partition->hashes_[row]);
+    while (partition->slots_[pos] != 0) {
+      pos = (pos + 1) & (capacity - 1);
+    }
+    partition->slots_[pos] = row + 1;
+  }
+
+  partition->row_offset_ = num_rows_;
+  num_rows_ += partition->rows_.size();
+  leaves_.push_back(partition);
+}
+
+auto JoinHashTable::GetLeaf(hash_t hash) const -> const Partition & {
+  const auto *partition = &partitions_[PartitionOf(hash, level_)];
+  while (!partition->children_.empty()) {
+    partition = &partition->children_[PartitionOf(hash, partition->level_)];
+  }
+  return *partition;
+}
+
+}  // namespace bustub
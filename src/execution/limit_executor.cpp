@@ -12,14 +12,48 @@
 
 #include "execution/executors/limit_executor.h"
 
+#include <utility>
+#include <vector>
+
 namespace bustub {
 
 LimitExecutor::LimitExecutor(ExecutorContext *exec_ctx, const LimitPlanNode *plan,
                              std::unique_ptr<AbstractExecutor> &&child_executor)
-    : AbstractExecutor(exec_ctx) {}
+    : AbstractExecutor(exec_ctx), plan_(plan), child_executor_(std::move(child_executor)) {}
+
+void LimitExecutor::Init() {
+  ResetBatchAdapter();
+  num_produced_ = 0;
+  child_executor_->Init();
+}
 
-void LimitExecutor::Init() { throw NotImplementedException("LimitExecutor is not implemented"); }
+auto LimitExecutor::Next(Tuple *tuple, RID *rid) -> bool {
+  if (child_executor_->SupportsBatch()) {
+    return NextFromBatch(tuple, rid);
+  }
+  if (num_produced_ >= plan_->GetLimit() || !child_executor_->Next(tuple, rid)) {
+    return false;
+  }
+  num_produced_++;
+  return true;
+}
 
-auto LimitExecutor::Next(Tuple *tuple, RID *rid) -> bool { return false; }
+auto LimitExecutor::NextBatch(TupleBatch *batch) -> bool {
+  if (num_produced_ >= plan_->GetLimit() || !child_executor_->NextBatch(batch)) {
+    batch->Reset(&GetOutputSchema());
+    return false;
+  }
+  auto remaining = plan_->GetLimit() - num_produced_;
+  if (batch->Size() > remaining) {
+    std::vector<uint32_t> selection;
+    selection.reserve(remaining);
+    for (uint32_t i = 0; i < remaining; i++) {
+      selection.push_back(batch->RowAt(i));
+    }
+    batch->Select(std::move(selection));
+  }
+  num_produced_ += batch->Size();
+  return true;
+}
 
 }  // namespace bustub
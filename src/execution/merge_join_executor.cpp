@@ -0,0 +1,222 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// merge_join_executor.cpp
+//
+// Identification: src/execution/merge_join_executor.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include "execution/executors/merge_join_executor.h"
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "type/value_factory.h"
+
+namespace bustub {
+
+namespace {
+
+/** @return <0, 0 or >0 as `a` is less than, equal to or greater than `b`, neither of which is null */
+auto CompareValues(const Value &a, const Value &b) -> int {
+  if (a.CompareLessThan(b) == CmpBool::CmpTrue) {
+    return -1;
+  }
+  return a.CompareGreaterThan(b) == CmpBool::CmpTrue ? 1 : 0;
+}
+
+}  // namespace
+
+void MergeJoinExecutor::Cursor::Init() {
+  executor_->Init();
+  batch_.Reset(&executor_->GetOutputSchema());
+  pos_ = 0;
+  LoadBatch();
+}
+
+void MergeJoinExecutor::Cursor::Advance() {
+  pos_++;
+  if (pos_ == batch_.Size()) {
+    LoadBatch();
+  }
+}
+
+void MergeJoinExecutor::Cursor::LoadBatch() {
+  pos_ = 0;
+  while (executor_->NextBatch(&batch_)) {
+    if (batch_.Empty()) {
+      continue;
+    }
+    for (size_t i = 0; i < key_exprs_.size(); i++) {
+      key_exprs_[i]->EvaluateBatch(batch_, &keys_[i]);
+    }
+    return;
+  }
+  batch_.Reset(&executor_->GetOutputSchema());
+}
+
+auto MergeJoinExecutor::Cursor::KeyHasNull() const -> bool {
+  for (const auto &column : keys_) {
+    if (column[pos_].IsNull()) {
+      return true;
+    }
+  }
+  return false;
+}
+
+auto MergeJoinExecutor::Cursor::GetKey() const -> std::vector<Value> {
+  std::vector<Value> key;
+  key.reserve(keys_.size());
+  for (const auto &column : keys_) {
+    key.push_back(column[pos_]);
+  }
+  return key;
+}
+
+auto MergeJoinExecutor::Cursor::GetValues() const -> std::vector<Value> {
+  const auto &schema = batch_.GetSchema();
+  std::vector<Value> values;
+  values.reserve(schema.GetColumnCount());
+  for (uint32_t col = 0; col < schema.GetColumnCount(); col++) {
+    values.push_back(batch_.GetValue(pos_, col));
+  }
+  return values;
+}
+
+MergeJoinExecutor::MergeJoinExecutor(ExecutorContext *exec_ctx, const MergeJoinPlanNode *plan,
+                                     std::unique_ptr<AbstractExecutor> &&left_child,
+                                     std::unique_ptr<AbstractExecutor> &&right_child)
+    : AbstractExecutor(exec_ctx),
+      plan_(plan),
+      left_executor_(std::move(left_child)),
+      right_executor_(std::move(right_child)),
+      left_(left_executor_.get(), plan_->LeftJoinKeyExpressions()),
+      right_(right_executor_.get(), plan_->RightJoinKeyExpressions()) {}
+
+void MergeJoinExecutor::Init() {
+  left_.Init();
+  right_.Init();
+  ResetBatchAdapter();
+  group_key_.clear();
+  group_.clear();
+  joining_left_ = false;
+  group_pos_ = 0;
+}
+
+auto MergeJoinExecutor::Next(Tuple *tuple, RID *rid) -> bool { return NextFromBatch(tuple, rid); }
+
+auto MergeJoinExecutor::NextBatch(TupleBatch *batch) -> bool {
+  batch->Reset(&GetOutputSchema());
+  while (!batch->IsFull()) {
+    if (joining_left_) {
+      if (group_pos_ < group_.size()) {
+        Emit(batch, &left_values_, &group_[group_pos_++]);
+        continue;
+      }
+      joining_left_ = false;
+      left_.Advance();
+      continue;
+    }
+
+    if (!left_.Valid()) {
+      // The rest of the right rows have keys no left row has.
+      group_.clear();
+      if (!KeepsRight() || !right_.Valid()) {
+        break;
+      }
+      auto right_values = right_.GetValues();
+      Emit(batch, nullptr, &right_values);
+      right_.Advance();
+      continue;
+    }
+
+    if (left_.KeyHasNull()) {
+      if (KeepsLeft()) {
+        auto left_values = left_.GetValues();
+        Emit(batch, &left_values, nullptr);
+      }
+      left_.Advance();
+      continue;
+    }
+
+    if (!group_.empty()) {
+      // A left row with the same key as the previous one joins the same right rows.
+      if (InGroup(left_)) {
+        left_values_ = left_.GetValues();
+        joining_left_ = true;
+        group_pos_ = 0;
+        continue;
+      }
+      group_.clear();
+    }
+
+    if (right_.Valid() && (right_.KeyHasNull() || CompareKeys(left_, right_) > 0)) {
+      if (KeepsRight()) {
+        auto right_values = right_.GetValues();
+        Emit(batch, nullptr, &right_values);
+      }
+      right_.Advance();
+      continue;
+    }
+
+    if (!right_.Valid() || CompareKeys(left_, right_) < 0) {
+      if (!right_.Valid() && !KeepsLeft()) {
+        break;
+      }
+      if (KeepsLeft()) {
+        auto left_values = left_.GetValues();
+        Emit(batch, &left_values, nullptr);
+      }
+      left_.Advance();
+      continue;
+    }
+
+    // The keys are equal: collect all right rows with this key, then join the left rows with them.
+    group_key_ = right_.GetKey();
+    do {
+      group_.push_back(right_.GetValues());
+      right_.Advance();
+    } while (right_.Valid() && !right_.KeyHasNull() && InGroup(right_));
+  }
+  return !batch->Empty();
+}
+
+auto MergeJoinExecutor::CompareKeys(const Cursor &left, const Cursor &right) const -> int {
+  for (size_t i = 0; i < plan_->LeftJoinKeyExpressions().size(); i++) {
+    auto cmp = CompareValues(left.Key(i), right.Key(i));
+    if (cmp != 0) {
+      return cmp;
+    }
+  }
+  return 0;
+}
+
+auto MergeJoinExecutor::InGroup(const Cursor &cursor) const -> bool {
+  for (size_t i = 0; i < group_key_.size(); i++) {
+    if (CompareValues(cursor.Key(i), group_key_[i]) != 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void MergeJoinExecutor::Emit(TupleBatch *batch, const std::vector<Value> *left, const std::vector<Value> *right) const {
+  const auto &left_schema = left_executor_->GetOutputSchema();
+  const auto &right_schema = right_executor_->GetOutputSchema();
+  std::vector<Value> values;
+  values.reserve(left_schema.GetColumnCount() + right_schema.GetColumnCount());
+  for (uint32_t col = 0; col < left_schema.GetColumnCount(); col++) {
+    values.push_back(left != nullptr ? (*left)[col]
+                                     : ValueFactory::GetNullValueByType(left_schema.GetColumn(col).GetType()));
+  }
+  for (uint32_t col = 0; col < right_schema.GetColumnCount(); col++) {
+    values.push_back(right != nullptr ? (*right)[col]
+                                      : ValueFactory::GetNullValueByType(right_schema.GetColumn(col).GetType()));
+  }
+  batch->AppendValues(std::move(values));
+}
+
+}  // namespace bustub
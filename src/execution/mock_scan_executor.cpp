@@ -46,10 +46,15 @@ const char *mock_table_list[] = {"__mock_table_1", "__mock_table_2", "__mock_tab
                                  // For leaderboard Q2
                                  "__mock_t4_1m", "__mock_t5_1m", "__mock_t6_1m",
                                  // For leaderboard Q3
-                                 "__mock_t7", "__mock_t8", nullptr};
+                                 "__mock_t7", "__mock_t8",
+                                 // For queries that fail after producing some rows
+                                 "__mock_table_fail", nullptr};
 
 static const int GRAPH_NODE_CNT = 10;
 
+/** The row at which a scan of __mock_table_fail throws */
+static const size_t MOCK_TABLE_FAIL_ROW = 2500;
+
 auto GetMockTableSchemaOf(const std::string &table) -> Schema {
   if (table == "__mock_table_1") {
     return Schema{std::vector{{Column{"colA", TypeId::INTEGER}, {Column{"colB", TypeId::INTEGER}}}}};
@@ -113,6 +118,10 @@ auto GetMockTableSchemaOf(const std::string &table) -> Schema {
     return Schema{std::vector{Column{"v4", TypeId::INTEGER}}};
   }
 
+  if (table == "__mock_table_fail") {
+    return Schema{std::vector{Column{"colA", TypeId::INTEGER}}};
+  }
+
   throw bustub::Exception(fmt::format("mock table {} not found", table));
 }
 
@@ -179,6 +188,10 @@ auto GetSizeOf(const MockScanPlanNode *plan) -> size_t {
     return 10;
   }
 
+  if (table == "__mock_table_fail") {
+    return 2 * MOCK_TABLE_FAIL_ROW;
+  }
+
   return 0;
 }
 
@@ -386,6 +399,17 @@ auto GetFunctionOf(const MockScanPlanNode *plan) -> std::function<Tuple(size_t)>
     };
   }
 
+  if (table == "__mock_table_fail") {
+    return [plan](size_t cursor) {
+      if (cursor >= MOCK_TABLE_FAIL_ROW) {
+        throw ExecutionException(fmt::format("__mock_table_fail failed at row {}", cursor));
+      }
+      std::vector<Value> values{};
+      values.push_back(ValueFactory::GetIntegerValue(cursor));
+      return Tuple{values, &plan->OutputSchema()};
+    };
+  }
+
   // By default, return table of all 0.
   return [plan](size_t cursor) {
     std::vector<Value> values{};
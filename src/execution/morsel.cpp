@@ -0,0 +1,53 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// morsel.cpp
+//
+// Identification: src/execution/morsel.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include "execution/morsel.h"
+
+#include <mutex>  // NOLINT
+#include <optional>
+
+#include "storage/page/page_guard.h"
+#include "storage/page/table_page.h"
+
+namespace bustub {
+
+MorselQueue::MorselQueue(TableHeap *table_heap)
+    : table_heap_(table_heap), stop_at_rid_(table_heap->GetStopRid()), next_page_id_(table_heap->first_page_id_) {}
+
+auto MorselQueue::Next() -> std::optional<TableIterator> {
+  std::unique_lock<std::mutex> guard(latch_);
+  if (next_page_id_ == INVALID_PAGE_ID) {
+    return std::nullopt;
+  }
+
+  auto first_page_id = next_page_id_;
+  auto page_id = first_page_id;
+  RID stop_at_rid;
+  for (size_t pages = 1;; pages++) {
+    if (page_id == stop_at_rid_.GetPageId()) {
+      stop_at_rid = stop_at_rid_;
+      next_page_id_ = INVALID_PAGE_ID;
+      break;
+    }
+    auto page_guard = table_heap_->bpm_->FetchPageRead(page_id);
+    auto page = page_guard.As<TablePage>();
+    if (pages == MORSEL_PAGES || page->GetNextPageId() == INVALID_PAGE_ID) {
+      stop_at_rid = RID{page_id, page->GetNumTuples()};
+      next_page_id_ = page->GetNextPageId();
+      break;
+    }
+    page_id = page->GetNextPageId();
+  }
+  guard.unlock();
+
+  return TableIterator{table_heap_, RID{first_page_id, 0}, stop_at_rid};
+}
+
+}  // namespace bustub
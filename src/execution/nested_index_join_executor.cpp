@@ -12,19 +12,129 @@
 
 #include "execution/executors/nested_index_join_executor.h"
 
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#include "type/value_factory.h"
+
 namespace bustub {
 
 NestIndexJoinExecutor::NestIndexJoinExecutor(ExecutorContext *exec_ctx, const NestedIndexJoinPlanNode *plan,
                                              std::unique_ptr<AbstractExecutor> &&child_executor)
-    : AbstractExecutor(exec_ctx) {
+    : AbstractExecutor(exec_ctx), plan_(plan), child_executor_(std::move(child_executor)) {
   if (!(plan->GetJoinType() == JoinType::LEFT || plan->GetJoinType() == JoinType::INNER)) {
     // Note for 2023 Spring: You ONLY need to implement left join and inner join.
     throw bustub::NotImplementedException(fmt::format("join type {} not supported", plan->GetJoinType()));
   }
 }
 
-void NestIndexJoinExecutor::Init() { throw NotImplementedException("NestIndexJoinExecutor is not implemented"); }
+void NestIndexJoinExecutor::Init() {
+  ResetBatchAdapter();
+  index_info_ = exec_ctx_->GetCatalog()->GetIndex(plan_->GetIndexOid());
+  table_info_ = exec_ctx_->GetCatalog()->GetTable(plan_->GetInnerTableOid());
+  child_executor_->Init();
+  outer_batch_.Reset(&child_executor_->GetOutputSchema());
+  probe_of_row_.clear();
+  matches_.clear();
+  outer_pos_ = 0;
+  match_pos_ = 0;
+}
+
+void NestIndexJoinExecutor::ProbeBatch() {
+  std::vector<Value> keys;
+  plan_->KeyPredicate()->EvaluateBatch(outer_batch_, &keys);
+
+  // Sort the rows by key, so that equal keys probe once and the probes walk the index in order.
+  std::vector<uint32_t> rows;
+  for (uint32_t row = 0; row < keys.size(); row++) {
+    if (!keys[row].IsNull()) {
+      rows.push_back(row);
+    }
+  }
+  std::sort(rows.begin(), rows.end(),
+            [&](uint32_t a, uint32_t b) { return keys[a].CompareLessThan(keys[b]) == CmpBool::CmpTrue; });
+
+  probe_of_row_.assign(keys.size(), -1);
+  matches_.clear();
+  std::vector<std::pair<RID, size_t>> found;
+  std::vector<RID> rids;
+  for (size_t i = 0; i < rows.size(); i++) {
+    if (i > 0 && keys[rows[i]].CompareEquals(keys[rows[i - 1]]) == CmpBool::CmpTrue) {
+      probe_of_row_[rows[i]] = probe_of_row_[rows[i - 1]];
+      continue;
+    }
+    auto probe = matches_.size();
+    matches_.emplace_back();
+    probe_of_row_[rows[i]] = static_cast<int64_t>(probe);
+    rids.clear();
+    index_info_->index_->ScanKey(Tuple{{keys[rows[i]]}, &index_info_->key_schema_}, &rids,
+                                 exec_ctx_->GetTransaction());
+    for (const auto &rid : rids) {
+      found.emplace_back(rid, probe);
+    }
+  }
+
+  // Read the inner tuples page by page rather than in the order of the keys.
+  std::sort(found.begin(), found.end(), [](const auto &a, const auto &b) {
+    return a.first.GetPageId() != b.first.GetPageId() ? a.first.GetPageId() < b.first.GetPageId()
+                                                      : a.first.GetSlotNum() < b.first.GetSlotNum();
+  });
+  for (const auto &[rid, probe] : found) {
+    auto [meta, tuple] = table_info_->table_->GetTuple(rid);
+    if (!meta.is_deleted_) {
+      matches_[probe].push_back(std::move(tuple));
+    }
+  }
+}
+
+auto NestIndexJoinExecutor::Next(Tuple *tuple, RID *rid) -> bool { return NextFromBatch(tuple, rid); }
 
-auto NestIndexJoinExecutor::Next(Tuple *tuple, RID *rid) -> bool { return false; }
+auto NestIndexJoinExecutor::NextBatch(TupleBatch *batch) -> bool {
+  batch->Reset(&GetOutputSchema());
+  while (!batch->IsFull()) {
+    if (outer_pos_ == outer_batch_.Size()) {
+      if (!child_executor_->NextBatch(&outer_batch_)) {
+        break;
+      }
+      ProbeBatch();
+      outer_pos_ = 0;
+      match_pos_ = 0;
+      continue;
+    }
+    auto probe = probe_of_row_[outer_pos_];
+    const auto *matches = probe < 0 ? nullptr : &matches_[probe];
+    if (matches == nullptr || matches->empty()) {
+      if (plan_->GetJoinType() == JoinType::LEFT) {
+        EmitRow(batch, nullptr);
+      }
+    } else {
+      while (!batch->IsFull() && match_pos_ < matches->size()) {
+        EmitRow(batch, &(*matches)[match_pos_++]);
+      }
+      if (match_pos_ < matches->size()) {
+        break;
+      }
+    }
+    outer_pos_++;
+    match_pos_ = 0;
+  }
+  return !batch->Empty();
+}
+
+void NestIndexJoinExecutor::EmitRow(TupleBatch *batch, const Tuple *inner) {
+  const auto &outer_schema = child_executor_->GetOutputSchema();
+  const auto &inner_schema = plan_->InnerTableSchema();
+  std::vector<Value> values;
+  values.reserve(outer_schema.GetColumnCount() + inner_schema.GetColumnCount());
+  for (uint32_t col = 0; col < outer_schema.GetColumnCount(); col++) {
+    values.push_back(outer_batch_.GetValue(outer_pos_, col));
+  }
+  for (uint32_t col = 0; col < inner_schema.GetColumnCount(); col++) {
+    values.push_back(inner != nullptr ? inner->GetValue(&inner_schema, col)
+                                      : ValueFactory::GetNullValueByType(inner_schema.GetColumn(col).GetType()));
+  }
+  batch->AppendValues(std::move(values));
+}
 
 }  // namespace bustub
@@ -0,0 +1,107 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// parallel_pipeline.cpp
+//
+// Identification: src/execution/parallel_pipeline.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include "execution/parallel_pipeline.h"
+
+#include <exception>
+#include <memory>
+#include <mutex>   // NOLINT
+#include <thread>  // NOLINT
+#include <utility>
+#include <vector>
+
+#include "execution/executor_factory.h"
+#include "execution/morsel.h"
+#include "execution/plans/hash_join_plan.h"
+#include "execution/plans/seq_scan_plan.h"
+
+namespace bustub {
+
+auto ParallelPipeline::CanRunInParallel(const AbstractPlanNode &plan) -> bool {
+  switch (plan.GetType()) {
+    case PlanType::SeqScan:
+      return true;
+    case PlanType::Filter:
+    case PlanType::Projection:
+      return CanRunInParallel(*plan.GetChildAt(0));
+    case PlanType::HashJoin: {
+      // The left child of a hash join is the probe side. Right rows without a match are only known once all workers
+      // are done, so right and outer joins do not run in parallel.
+      auto join_type = dynamic_cast<const HashJoinPlanNode &>(plan).GetJoinType();
+      return (join_type == JoinType::INNER || join_type == JoinType::LEFT || join_type == JoinType::SEMI ||
+              join_type == JoinType::ANTI) &&
+             CanRunInParallel(*plan.GetChildAt(0));
+    }
+    case PlanType::NestedIndexJoin:
+      // The child is the outer side, and every worker probes the index with its own outer rows.
+      return CanRunInParallel(*plan.GetChildAt(0));
+    default:
+      return false;
+  }
+}
+
+ParallelPipeline::ParallelPipeline(ExecutorContext *exec_ctx, AbstractPlanNodeRef plan, size_t num_workers)
+    : exec_ctx_(exec_ctx), plan_(std::move(plan)), num_workers_(num_workers) {
+  BUSTUB_ASSERT(CanRunInParallel(*plan_), "plan cannot run in parallel");
+  BUSTUB_ASSERT(num_workers_ > 0, "a pipeline needs a worker");
+}
+
+void ParallelPipeline::Run(const std::function<void(size_t, TupleBatch *)> &consume) {
+  const auto *scan = plan_.get();
+  while (scan->GetType() != PlanType::SeqScan) {
+    scan = scan->GetChildAt(0).get();
+  }
+  auto table_info = exec_ctx_->GetCatalog()->GetTable(dynamic_cast<const SeqScanPlanNode *>(scan)->GetTableOid());
+  auto parallel_ctx = std::make_shared<ParallelContext>(scan, table_info->table_.get());
+
+  std::mutex error_latch;
+  std::exception_ptr error;
+  auto work = [&](size_t worker) {
+    try {
+      ExecutorContext worker_ctx(exec_ctx_->GetTransaction(), exec_ctx_->GetCatalog(),
+                                 exec_ctx_->GetBufferPoolManager(), exec_ctx_->GetTransactionManager(),
+                                 exec_ctx_->GetLockManager(), exec_ctx_->IsDelete());
+      worker_ctx.InitCheckOptions(exec_ctx_->GetCheckOptions());
+      worker_ctx.SetParallelContext(parallel_ctx);
+      worker_ctx.SetPipelineCache(exec_ctx_->GetPipelineCache());
+      worker_ctx.SetRuntimeFilters(exec_ctx_->GetSharedRuntimeFilters());
+      worker_ctx.SetCTEBuffers(exec_ctx_->GetSharedCTEBuffers());
+
+      auto executor = ExecutorFactory::CreateExecutor(&worker_ctx, plan_);
+      executor->Init();
+      TupleBatch batch;
+      while (executor->NextBatch(&batch)) {
+        consume(worker, &batch);
+      }
+    } catch (...) {
+      std::scoped_lock<std::mutex> guard(error_latch);
+      if (error == nullptr) {
+        error = std::current_exception();
+      }
+    }
+  };
+
+  std::vector<std::thread> workers;
+  workers.reserve(num_workers_ - 1);
+  for (size_t worker = 1; worker < num_workers_; worker++) {
+    workers.emplace_back(work, worker);
+  }
+  // The calling thread is worker 0.
+  work(0);
+  for (auto &thread : workers) {
+    thread.join();
+  }
+
+  if (error != nullptr) {
+    std::rethrow_exception(error);
+  }
+}
+
+}  // namespace bustub
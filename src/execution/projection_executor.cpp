@@ -5,7 +5,12 @@ namespace bustub {
 
 ProjectionExecutor::ProjectionExecutor(ExecutorContext *exec_ctx, const ProjectionPlanNode *plan,
                                        std::unique_ptr<AbstractExecutor> &&child_executor)
-    : AbstractExecutor(exec_ctx), plan_(plan), child_executor_(std::move(child_executor)) {}
+    : AbstractExecutor(exec_ctx), plan_(plan), child_executor_(std::move(child_executor)) {
+  for (const auto &expr : plan_->GetExpressions()) {
+    auto is_leaf = expr->GetChildren().empty();
+    programs_.push_back(is_leaf ? nullptr : ExpressionProgram::Compile(expr));
+  }
+}
 
 void ProjectionExecutor::Init() {
   // Initialize the child executor
@@ -33,4 +38,32 @@ auto ProjectionExecutor::Next(Tuple *tuple, RID *rid) -> bool {
 
   return true;
 }
+
+auto ProjectionExecutor::NextBatch(TupleBatch *batch) -> bool {
+  if (!child_executor_->NextBatch(&child_batch_)) {
+    batch->Reset(&GetOutputSchema());
+    return false;
+  }
+
+  // Compute expressions, one column at a time
+  const auto &exprs = plan_->GetExpressions();
+  std::vector<std::vector<Value>> columns(exprs.size());
+  for (size_t i = 0; i < exprs.size(); i++) {
+    if (programs_[i] != nullptr) {
+      programs_[i]->EvaluateBatch(child_batch_, &columns[i]);
+    } else {
+      exprs[i]->EvaluateBatch(child_batch_, &columns[i]);
+    }
+  }
+  std::vector<RID> rids;
+  rids.reserve(child_batch_.Size());
+  for (uint32_t i = 0; i < child_batch_.Size(); i++) {
+    rids.push_back(child_batch_.GetRid(i));
+  }
+
+  batch->Reset(&GetOutputSchema());
+  batch->SetColumns(std::move(columns), std::move(rids));
+  return true;
+}
+
 }  // namespace bustub
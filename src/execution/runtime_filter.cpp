@@ -0,0 +1,288 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// runtime_filter.cpp
+//
+// Identification: src/execution/runtime_filter.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include "execution/runtime_filter.h"
+
+#include <array>
+#include <cstring>
+#include <memory>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "execution/expressions/column_value_expression.h"
+#include "execution/plans/hash_join_plan.h"
+#include "execution/plans/merge_join_plan.h"
+#include "execution/plans/nested_loop_join_plan.h"
+#include "execution/plans/projection_plan.h"
+#include "murmur3/MurmurHash3.h"
+
+namespace bustub {
+
+namespace {
+
+/** Odd multipliers that derive the bit of each word of a block from the same 32 bits of the hash */
+constexpr std::array<uint32_t, 8> BLOCK_SALTS{0x47b6137bU, 0x44974d91U, 0x8824ad5bU, 0xa2b7289dU,
+                                              0x705495c7U, 0x2df1424bU, 0x9efc4947U, 0x5c6bfb31U};
+
+/** @return a well mixed hash of a non-null value, the same for equal values of all integer types */
+auto HashOne(const Value &value) -> hash_t {
+  uint64_t raw;
+  switch (value.GetTypeId()) {
+    case TypeId::TINYINT:
+      raw = static_cast<int64_t>(value.GetAs<int8_t>());
+      break;
+    case TypeId::SMALLINT:
+      raw = static_cast<int64_t>(value.GetAs<int16_t>());
+      break;
+    case TypeId::INTEGER:
+      raw = static_cast<int64_t>(value.GetAs<int32_t>());
+      break;
+    case TypeId::BIGINT:
+      raw = value.GetAs<int64_t>();
+      break;
+    case TypeId::BOOLEAN:
+      raw = value.GetAs<int8_t>();
+      break;
+    case TypeId::TIMESTAMP:
+      raw = value.GetAs<uint64_t>();
+      break;
+    case TypeId::DECIMAL: {
+      // 0.0 and -0.0 are equal, so they must have the same hash.
+      auto decimal = value.GetAs<double>();
+      decimal = decimal == 0 ? 0 : decimal;
+      std::memcpy(&raw, &decimal, sizeof(raw));
+      break;
+    }
+    default: {
+      std::array<uint64_t, 2> out;
+      murmur3::MurmurHash3_x64_128(value.GetData(), static_cast<int>(value.GetLength()), 0, out.data());
+      return out[0];
+    }
+  }
+  return HashUtil::MixBits(raw);
+}
+
+}  // namespace
+
+BloomFilter::BloomFilter(size_t expected_keys) {
+  size_t num_blocks = 1;
+  while (num_blocks * BLOCK_WORDS * 64 < expected_keys * BITS_PER_KEY) {
+    num_blocks *= 2;
+  }
+  blocks_.assign(num_blocks, Block{});
+}
+
+auto BloomFilter::Mask(hash_t hash) -> Block {
+  Block mask;
+  auto key = static_cast<uint32_t>(hash);
+  for (size_t i = 0; i < BLOCK_WORDS; i++) {
+    mask[i] = uint64_t{1} << ((key * BLOCK_SALTS[i]) >> 26);
+  }
+  return mask;
+}
+
+void BloomFilter::Insert(hash_t hash) {
+  auto mask = Mask(hash);
+  auto &block = blocks_[BlockOf(hash)];
+  for (size_t i = 0; i < BLOCK_WORDS; i++) {
+    block[i] |= mask[i];
+  }
+}
+
+auto BloomFilter::MayContain(hash_t hash) const -> bool {
+  auto mask = Mask(hash);
+  const auto &block = blocks_[BlockOf(hash)];
+  uint64_t missing = 0;
+  for (size_t i = 0; i < BLOCK_WORDS; i++) {
+    missing |= mask[i] & ~block[i];
+  }
+  return missing == 0;
+}
+
+auto RuntimeFilter::FindTarget(const AbstractPlanNode &plan, const std::vector<AbstractExpressionRef> &keys)
+    -> std::optional<Target> {
+  std::vector<uint32_t> columns;
+  for (const auto &key : keys) {
+    const auto *column_expr = dynamic_cast<const ColumnValueExpression *>(key.get());
+    if (column_expr == nullptr || column_expr->GetTupleIdx() != 0) {
+      return std::nullopt;
+    }
+    columns.push_back(column_expr->GetColIdx());
+  }
+
+  // Follow the columns down to the scan they are read from, through operators that only drop rows or pass them on.
+  const AbstractPlanNode *node = &plan;
+  while (node->GetType() != PlanType::SeqScan) {
+    switch (node->GetType()) {
+      case PlanType::Filter:
+        break;
+      case PlanType::Projection: {
+        const auto &exprs = dynamic_cast<const ProjectionPlanNode *>(node)->GetExpressions();
+        for (auto &column : columns) {
+          const auto *column_expr = dynamic_cast<const ColumnValueExpression *>(exprs[column].get());
+          if (column_expr == nullptr || column_expr->GetTupleIdx() != 0) {
+            return std::nullopt;
+          }
+          column = column_expr->GetColIdx();
+        }
+        break;
+      }
+      case PlanType::HashJoin:
+      case PlanType::NestedLoopJoin:
+      case PlanType::MergeJoin: {
+        // An inner join only passes on rows that join, so dropping rows of either side drops only the rows with it.
+        // Semi and anti joins pass on some of their left rows, each on its own.
+        JoinType join_type = JoinType::INVALID;
+        if (const auto *hash_join = dynamic_cast<const HashJoinPlanNode *>(node); hash_join != nullptr) {
+          join_type = hash_join->GetJoinType();
+        } else if (const auto *nlj = dynamic_cast<const NestedLoopJoinPlanNode *>(node); nlj != nullptr) {
+          join_type = nlj->GetJoinType();
+        } else {
+          join_type = dynamic_cast<const MergeJoinPlanNode *>(node)->GetJoinType();
+        }
+        if (join_type != JoinType::INNER && join_type != JoinType::SEMI && join_type != JoinType::ANTI) {
+          return std::nullopt;
+        }
+        auto num_left_columns = node->GetChildAt(0)->OutputSchema().GetColumnCount();
+        bool all_left = true;
+        bool all_right = true;
+        for (auto column : columns) {
+          all_left = all_left && column < num_left_columns;
+          all_right = all_right && column >= num_left_columns;
+        }
+        if (all_right) {
+          for (auto &column : columns) {
+            column -= num_left_columns;
+          }
+          node = node->GetChildAt(1).get();
+          continue;
+        }
+        if (!all_left) {
+          return std::nullopt;
+        }
+        break;
+      }
+      default:
+        return std::nullopt;
+    }
+    node = node->GetChildAt(0).get();
+  }
+  return Target{node, std::move(columns)};
+}
+
+auto RuntimeFilter::HashKey(const std::vector<Value> &keys) -> hash_t {
+  hash_t hash = 0;
+  for (const auto &key : keys) {
+    hash = HashUtil::MixBits(hash * 31 + HashOne(key));
+  }
+  return hash;
+}
+
+RuntimeFilter::RuntimeFilter(std::vector<uint32_t> columns, const std::vector<hash_t> &hashes)
+    : columns_(std::move(columns)), bloom_(hashes.size()) {
+  for (auto hash : hashes) {
+    bloom_.Insert(hash);
+  }
+}
+
+auto RuntimeFilter::MayMatch(const Tuple &tuple, const Schema &schema) const -> bool {
+  std::vector<Value> key;
+  key.reserve(columns_.size());
+  for (auto column : columns_) {
+    key.push_back(tuple.GetValue(&schema, column));
+    if (key.back().IsNull()) {
+      return false;
+    }
+  }
+  return bloom_.MayContain(HashKey(key));
+}
+
+void RuntimeFilter::Filter(TupleBatch *batch) const {
+  std::vector<uint32_t> selection;
+  selection.reserve(batch->Size());
+  std::vector<Value> key;
+  for (uint32_t i = 0; i < batch->Size(); i++) {
+    key.clear();
+    bool has_null = false;
+    for (auto column : columns_) {
+      key.push_back(batch->GetValue(i, column));
+      has_null = has_null || key.back().IsNull();
+    }
+    if (!has_null && bloom_.MayContain(HashKey(key))) {
+      selection.push_back(batch->RowAt(i));
+    }
+  }
+  if (selection.size() != batch->Size()) {
+    batch->Select(std::move(selection));
+  }
+}
+
+void TopNBound::Tighten(const Value &key) {
+  if (key.IsNull()) {
+    return;
+  }
+  std::scoped_lock<std::mutex> guard(latch_);
+  key_ = key;
+  version_++;
+}
+
+void TopNBound::AddTo(const Schema &schema, ScanPredicate *predicate) const {
+  std::scoped_lock<std::mutex> guard(latch_);
+  if (version_.load() == 0) {
+    return;
+  }
+  // NULL sorts first in ascending order, so a row with a null key may still make it in, and last in descending order.
+  if (descending_) {
+    predicate->AddTerm(schema, column_, ScanPredicate::Op::GreaterThanOrEqual, key_);
+  } else {
+    predicate->AddTerm(schema, column_, ScanPredicate::Op::LessThanOrEqual, key_, true);
+  }
+}
+
+void RuntimeFilterRegistry::Publish(const AbstractPlanNode *scan, const AbstractPlanNode *join,
+                                    std::shared_ptr<const RuntimeFilter> filter) {
+  std::scoped_lock<std::mutex> guard(latch_);
+  filters_[scan][join] = std::move(filter);
+}
+
+auto RuntimeFilterRegistry::Get(const AbstractPlanNode *scan) const
+    -> std::vector<std::shared_ptr<const RuntimeFilter>> {
+  std::scoped_lock<std::mutex> guard(latch_);
+  std::vector<std::shared_ptr<const RuntimeFilter>> filters;
+  auto it = filters_.find(scan);
+  if (it != filters_.end()) {
+    for (const auto &[join, filter] : it->second) {
+      filters.push_back(filter);
+    }
+  }
+  return filters;
+}
+
+void RuntimeFilterRegistry::PublishBound(const AbstractPlanNode *scan, const AbstractPlanNode *topn,
+                                         std::shared_ptr<const TopNBound> bound) {
+  std::scoped_lock<std::mutex> guard(latch_);
+  bounds_[scan][topn] = std::move(bound);
+}
+
+auto RuntimeFilterRegistry::GetBounds(const AbstractPlanNode *scan) const
+    -> std::vector<std::shared_ptr<const TopNBound>> {
+  std::scoped_lock<std::mutex> guard(latch_);
+  std::vector<std::shared_ptr<const TopNBound>> bounds;
+  auto it = bounds_.find(scan);
+  if (it != bounds_.end()) {
+    for (const auto &[topn, bound] : it->second) {
+      bounds.push_back(bound);
+    }
+  }
+  return bounds;
+}
+
+}  // namespace bustub
@@ -1,23 +1,268 @@
-//===----------------------------------------------------------------------===//
-//
-//                         BusTub
-//
-// seq_scan_executor.cpp
-//
-// Identification: src/execution/seq_scan_executor.cpp
-//
-// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
-//
-//===----------------------------------------------------------------------===//
-
-#include "execution/executors/seq_scan_executor.h"
-
-namespace bustub {
-
-SeqScanExecutor::SeqScanExecutor(ExecutorContext *exec_ctx, const SeqScanPlanNode *plan) : AbstractExecutor(exec_ctx) {}
-
-void SeqScanExecutor::Init() { throw NotImplementedException("SeqScanExecutor is not implemented"); }
-
-auto SeqScanExecutor::Next(Tuple *tuple, RID *rid) -> bool { return false; }
-
-}  // namespace bustub
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// seq_scan_executor.cpp
+//
+// Identification: src/execution/seq_scan_executor.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "execution/executors/seq_scan_executor.h"
+#include "execution/expressions/column_value_expression.h"
+#include "execution/expressions/constant_value_expression.h"
+#include "execution/expressions/logic_expression.h"
+
+namespace bustub {
+
+namespace {
+
+/** Split a predicate into the operands of its top-level ANDs. */
+void SplitConjunction(const AbstractExpressionRef &expr, std::vector<AbstractExpressionRef> *conjuncts) {
+  if (const auto *logic = dynamic_cast<const LogicExpression *>(expr.get());
+      logic != nullptr && logic->logic_type_ == LogicType::And) {
+    SplitConjunction(logic->GetChildAt(0), conjuncts);
+    SplitConjunction(logic->GetChildAt(1), conjuncts);
+    return;
+  }
+  conjuncts->push_back(expr);
+}
+
+/** @return the comparison with its operands swapped, a < b to b > a */
+auto Flip(ScanPredicate::Op op) -> ScanPredicate::Op {
+  switch (op) {
+    case ScanPredicate::Op::LessThan:
+      return ScanPredicate::Op::GreaterThan;
+    case ScanPredicate::Op::LessThanOrEqual:
+      return ScanPredicate::Op::GreaterThanOrEqual;
+    case ScanPredicate::Op::GreaterThan:
+      return ScanPredicate::Op::LessThan;
+    case ScanPredicate::Op::GreaterThanOrEqual:
+      return ScanPredicate::Op::LessThanOrEqual;
+    default:
+      return op;
+  }
+}
+
+auto ToScanOp(ComparisonType type) -> ScanPredicate::Op {
+  switch (type) {
+    case ComparisonType::Equal:
+      return ScanPredicate::Op::Equal;
+    case ComparisonType::NotEqual:
+      return ScanPredicate::Op::NotEqual;
+    case ComparisonType::LessThan:
+      return ScanPredicate::Op::LessThan;
+    case ComparisonType::LessThanOrEqual:
+      return ScanPredicate::Op::LessThanOrEqual;
+    case ComparisonType::GreaterThan:
+      return ScanPredicate::Op::GreaterThan;
+    case ComparisonType::GreaterThanOrEqual:
+      return ScanPredicate::Op::GreaterThanOrEqual;
+  }
+  UNREACHABLE("unknown comparison");
+}
+
+/**
+ * Add a conjunct to a scan predicate if it compares a fixed-width column with a constant.
+ * @return whether the conjunct was added
+ */
+auto PushDown(const AbstractExpression &expr, const Schema &schema, ScanPredicate *predicate) -> bool {
+  const auto *comparison = dynamic_cast<const ComparisonExpression *>(&expr);
+  if (comparison == nullptr) {
+    return false;
+  }
+  auto op = ToScanOp(comparison->comp_type_);
+  const auto *column = dynamic_cast<const ColumnValueExpression *>(comparison->GetChildAt(0).get());
+  const auto *constant = dynamic_cast<const ConstantValueExpression *>(comparison->GetChildAt(1).get());
+  if (column == nullptr || constant == nullptr) {
+    column = dynamic_cast<const ColumnValueExpression *>(comparison->GetChildAt(1).get());
+    constant = dynamic_cast<const ConstantValueExpression *>(comparison->GetChildAt(0).get());
+    op = Flip(op);
+  }
+  if (column == nullptr || constant == nullptr || column->GetTupleIdx() != 0 || constant->val_.IsNull() ||
+      !ScanPredicate::IsSupported(schema.GetColumn(column->GetColIdx()).GetType()) ||
+      !ScanPredicate::IsSupported(constant->val_.GetTypeId())) {
+    return false;
+  }
+  predicate->AddTerm(schema, column->GetColIdx(), op, constant->val_);
+  return true;
+}
+
+}  // namespace
+
+SeqScanExecutor::SeqScanExecutor(ExecutorContext *exec_ctx, const SeqScanPlanNode *plan)
+    : AbstractExecutor(exec_ctx), plan_(plan) {
+  if (plan_->filter_predicate_ == nullptr) {
+    return;
+  }
+  // Push the comparisons with constants down into the table iterator, and keep the rest for the batches it returns.
+  std::vector<AbstractExpressionRef> conjuncts;
+  SplitConjunction(plan_->filter_predicate_, &conjuncts);
+  for (const auto &conjunct : conjuncts) {
+    if (PushDown(*conjunct, GetOutputSchema(), &scan_predicate_)) {
+      continue;
+    }
+    residual_predicate_ = residual_predicate_ == nullptr
+                              ? conjunct
+                              : std::make_shared<LogicExpression>(residual_predicate_, conjunct, LogicType::And);
+  }
+  if (residual_predicate_ != nullptr) {
+    predicate_program_ = ExpressionProgram::Compile(residual_predicate_);
+  }
+}
+
+void SeqScanExecutor::Init() {
+  table_info_ = exec_ctx_->GetCatalog()->GetTable(plan_->GetTableOid());
+  columnar_ = table_info_->table_->IsColumnar();
+  auto parallel_ctx = exec_ctx_->GetParallelContext();
+  morsels_ = parallel_ctx != nullptr ? parallel_ctx->GetMorselQueue(plan_) : nullptr;
+  if (morsels_ != nullptr) {
+    iter_ = nullptr;
+  } else {
+    iter_ = std::make_unique<TableIterator>(table_info_->table_->MakeIterator());
+  }
+  ResetBatchAdapter();
+  runtime_filters_.clear();
+  runtime_filters_fetched_ = false;
+  topn_bounds_.clear();
+  bounds_version_ = 0;
+}
+
+void SeqScanExecutor::FetchRuntimeFilters() {
+  if (runtime_filters_fetched_) {
+    return;
+  }
+  runtime_filters_fetched_ = true;
+  if (exec_ctx_->GetRuntimeFilters() != nullptr) {
+    runtime_filters_ = exec_ctx_->GetRuntimeFilters()->Get(plan_);
+    topn_bounds_ = exec_ctx_->GetRuntimeFilters()->GetBounds(plan_);
+  }
+}
+
+auto SeqScanExecutor::GetScanPredicate() -> ScanPredicate * {
+  uint64_t version = 0;
+  for (const auto &bound : topn_bounds_) {
+    version += bound->GetVersion();
+  }
+  if (version == 0) {
+    return scan_predicate_.Empty() ? nullptr : &scan_predicate_;
+  }
+  if (version != bounds_version_) {
+    bounded_predicate_ = scan_predicate_;
+    for (const auto &bound : topn_bounds_) {
+      bound->AddTo(GetOutputSchema(), &bounded_predicate_);
+    }
+    bounds_version_ = version;
+  }
+  return &bounded_predicate_;
+}
+
+auto SeqScanExecutor::HasNext() -> bool {
+  if (iter_ != nullptr && !iter_->IsEnd()) {
+    return true;
+  }
+  if (morsels_ == nullptr) {
+    return false;
+  }
+  while (auto morsel = morsels_->Next()) {
+    iter_ = std::make_unique<TableIterator>(std::move(*morsel));
+    if (!iter_->IsEnd()) {
+      return true;
+    }
+  }
+  return false;
+}
+
+auto SeqScanExecutor::Next(Tuple *tuple, RID *rid) -> bool { return NextFromBatch(tuple, rid); }
+
+auto SeqScanExecutor::NextBatch(TupleBatch *batch) -> bool {
+  FetchRuntimeFilters();
+  while (HasNext()) {
+    batch->Reset(&GetOutputSchema());
+    while (!batch->IsFull() && HasNext()) {
+      // The TopNs above may have tightened their bounds since the last page.
+      auto *predicate = GetScanPredicate();
+      if (columnar_) {
+        if (auto chunk = iter_->ReadColumns(TupleBatch::BATCH_SIZE - batch->Size(), predicate); chunk != nullptr) {
+          ScanChunk(chunk, batch);
+        }
+        continue;
+      }
+      iter_->ReadPage(
+          TupleBatch::BATCH_SIZE - batch->Size(),
+          [&](const TableIterator::TupleViews &tuples) { ScanPage(tuples, batch); }, predicate);
+    }
+    if (!batch->Empty()) {
+      return true;
+    }
+  }
+  batch->Reset(&GetOutputSchema());
+  return false;
+}
+
+void SeqScanExecutor::ScanPage(const TableIterator::TupleViews &tuples, TupleBatch *batch) {
+  page_batch_.Reset(&GetOutputSchema());
+  for (const auto &[meta, view] : tuples) {
+    if (!meta.is_deleted_) {
+      page_batch_.AppendTupleView(view);
+    }
+  }
+  FilterPageBatch();
+
+  // Only the tuples that pass leave the scan, so only they are copied out of the page.
+  for (uint32_t i = 0; i < page_batch_.Size(); i++) {
+    batch->AppendTuple(page_batch_.GetTuple(i));
+  }
+}
+
+void SeqScanExecutor::ScanChunk(const std::shared_ptr<const ColumnChunk> &chunk, TupleBatch *batch) {
+  std::vector<uint32_t> rows(chunk->Size());
+  for (uint32_t i = 0; i < rows.size(); i++) {
+    rows[i] = i;
+  }
+  page_batch_.Reset(&GetOutputSchema());
+  page_batch_.AppendChunk(chunk, rows);
+  FilterPageBatch();
+
+  // The batch holds one chunk, so its rows are the rows of the chunk.
+  rows.clear();
+  for (uint32_t i = 0; i < page_batch_.Size(); i++) {
+    rows.push_back(page_batch_.RowAt(i));
+  }
+  batch->AppendChunk(chunk, rows);
+}
+
+void SeqScanExecutor::FilterPageBatch() {
+  // Filter the tuples by the rest of the predicate, reading only its columns.
+  if (predicate_program_ != nullptr) {
+    std::vector<uint32_t> selection;
+    predicate_program_->Select(page_batch_, &selection);
+    page_batch_.Select(std::move(selection));
+  } else if (residual_predicate_ != nullptr) {
+    std::vector<Value> filter_result;
+    residual_predicate_->EvaluateBatch(page_batch_, &filter_result);
+    std::vector<uint32_t> selection;
+    selection.reserve(filter_result.size());
+    for (uint32_t i = 0; i < filter_result.size(); i++) {
+      if (!filter_result[i].IsNull() && filter_result[i].GetAs<bool>()) {
+        selection.push_back(page_batch_.RowAt(i));
+      }
+    }
+    page_batch_.Select(std::move(selection));
+  }
+
+  for (const auto &filter : runtime_filters_) {
+    if (page_batch_.Empty()) {
+      return;
+    }
+    filter->Filter(&page_batch_);
+  }
+}
+
+}  // namespace bustub
@@ -1,13 +1,151 @@
 #include "execution/executors/sort_executor.h"
 
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
 namespace bustub {
 
+namespace {
+
+/** @return approximate memory used by a row in the sort buffer */
+auto EntrySize(const std::string &key, const Tuple &row) -> size_t {
+  return sizeof(std::string) + key.size() + sizeof(Tuple) + row.GetLength();
+}
+
+}  // namespace
+
+SortedRunMerger::SortedRunMerger(std::vector<std::unique_ptr<SpillFile>> runs)
+    : runs_(std::move(runs)), heads_(runs_.size()) {
+  readers_.reserve(runs_.size());
+  for (size_t i = 0; i < runs_.size(); i++) {
+    readers_.emplace_back(runs_[i].get());
+    heads_[i].exhausted_ = !readers_[i].Next(&heads_[i].row_, &heads_[i].key_);
+  }
+  tree_.emplace(runs_.size(), HeadLess{&heads_});
+}
+
+auto SortedRunMerger::Next(Tuple *row, std::string *key) -> bool {
+  if (heads_.empty()) {
+    return false;
+  }
+  auto winner = tree_->Winner();
+  auto &head = heads_[winner];
+  if (head.exhausted_) {
+    return false;
+  }
+  std::swap(*row, head.row_);
+  std::swap(*key, head.key_);
+  head.exhausted_ = !readers_[winner].Next(&head.row_, &head.key_);
+  tree_->Replay(winner);
+  return true;
+}
+
 SortExecutor::SortExecutor(ExecutorContext *exec_ctx, const SortPlanNode *plan,
                            std::unique_ptr<AbstractExecutor> &&child_executor)
-    : AbstractExecutor(exec_ctx) {}
+    : AbstractExecutor(exec_ctx),
+      plan_(plan),
+      child_executor_(std::move(child_executor)),
+      key_encoder_(plan_->GetOrderBy()) {}
+
+void SortExecutor::Init() {
+  ResetBatchAdapter();
+  entries_.clear();
+  entries_bytes_ = 0;
+  next_entry_ = 0;
+  merger_.reset();
+  runs_.clear();
+
+  // Without a buffer pool there is nowhere to spill to, so everything is sorted in memory.
+  auto *bpm = exec_ctx_->GetBufferPoolManager();
+  auto budget = exec_ctx_->GetSortMemoryBudget();
+
+  child_executor_->Init();
+  TupleBatch batch;
+  std::vector<std::string> keys;
+  while (child_executor_->NextBatch(&batch)) {
+    key_encoder_.EncodeBatch(batch, &keys);
+    for (uint32_t i = 0; i < batch.Size(); i++) {
+      auto row = batch.GetTuple(i);
+      entries_bytes_ += EntrySize(keys[i], row);
+      entries_.push_back({std::move(keys[i]), std::move(row)});
+      if (bpm != nullptr && entries_bytes_ > budget) {
+        SpillRun();
+      }
+    }
+  }
+
+  if (runs_.empty()) {
+    std::stable_sort(entries_.begin(), entries_.end(),
+                     [](const SortEntry &a, const SortEntry &b) { return a.key_ < b.key_; });
+    return;
+  }
+  if (!entries_.empty()) {
+    SpillRun();
+  }
+
+  // Every run that is merged needs a page to read from, so the budget bounds how many runs are merged at a time.
+  // Merging neighbouring runs keeps rows with equal keys in the order the child produced them.
+  auto fan_in = std::max<size_t>(2, budget / BUSTUB_PAGE_SIZE);
+  while (runs_.size() > fan_in) {
+    std::vector<std::unique_ptr<SpillFile>> merged;
+    for (size_t begin = 0; begin < runs_.size(); begin += fan_in) {
+      merged.push_back(MergeRuns(begin, std::min(begin + fan_in, runs_.size())));
+    }
+    runs_ = std::move(merged);
+  }
+  merger_ = std::make_unique<SortedRunMerger>(std::move(runs_));
+  runs_.clear();
+}
+
+void SortExecutor::SpillRun() {
+  std::stable_sort(entries_.begin(), entries_.end(),
+                   [](const SortEntry &a, const SortEntry &b) { return a.key_ < b.key_; });
+  auto run = std::make_unique<SpillFile>(exec_ctx_->GetBufferPoolManager(), &child_executor_->GetOutputSchema());
+  for (const auto &entry : entries_) {
+    run->Append(entry.row_, entry.key_);
+  }
+  runs_.push_back(std::move(run));
+  entries_.clear();
+  entries_bytes_ = 0;
+}
+
+auto SortExecutor::MergeRuns(size_t begin, size_t end) -> std::unique_ptr<SpillFile> {
+  if (end - begin == 1) {
+    return std::move(runs_[begin]);
+  }
+  std::vector<std::unique_ptr<SpillFile>> inputs;
+  for (auto i = begin; i < end; i++) {
+    inputs.push_back(std::move(runs_[i]));
+  }
+  SortedRunMerger merger(std::move(inputs));
+  auto run = std::make_unique<SpillFile>(exec_ctx_->GetBufferPoolManager(), &child_executor_->GetOutputSchema());
+  Tuple row;
+  std::string key;
+  while (merger.Next(&row, &key)) {
+    run->Append(row, key);
+  }
+  return run;
+}
 
-void SortExecutor::Init() { throw NotImplementedException("SortExecutor is not implemented"); }
+auto SortExecutor::Next(Tuple *tuple, RID *rid) -> bool { return NextFromBatch(tuple, rid); }
 
-auto SortExecutor::Next(Tuple *tuple, RID *rid) -> bool { return false; }
+auto SortExecutor::NextBatch(TupleBatch *batch) -> bool {
+  batch->Reset(&GetOutputSchema());
+  if (merger_ != nullptr) {
+    Tuple row;
+    std::string key;
+    while (!batch->IsFull() && merger_->Next(&row, &key)) {
+      batch->AppendTuple(std::move(row));
+    }
+  } else {
+    while (!batch->IsFull() && next_entry_ < entries_.size()) {
+      batch->AppendTuple(std::move(entries_[next_entry_++].row_));
+    }
+  }
+  return !batch->Empty();
+}
 
 }  // namespace bustub
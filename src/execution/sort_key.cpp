@@ -0,0 +1,107 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// sort_key.cpp
+//
+// Identification: src/execution/sort_key.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include "execution/sort_key.h"
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "common/exception.h"
+
+namespace bustub {
+
+namespace {
+
+/** Append an unsigned integer in big-endian byte order, so that memcmp orders it like the integer. */
+template <typename T>
+void AppendBigEndian(T value, std::string *key) {
+  for (int shift = (sizeof(T) - 1) * 8; shift >= 0; shift -= 8) {
+    key->push_back(static_cast<char>((value >> shift) & 0xff));
+  }
+}
+
+/** Append a signed integer: flipping the sign bit moves the negative numbers below the positive ones. */
+template <typename S, typename U>
+void AppendSigned(S value, std::string *key) {
+  AppendBigEndian<U>(static_cast<U>(value) ^ (static_cast<U>(1) << (sizeof(U) * 8 - 1)), key);
+}
+
+}  // namespace
+
+void SortKeyEncoder::EncodeBatch(const TupleBatch &batch, std::vector<std::string> *keys) const {
+  keys->assign(batch.Size(), std::string{});
+  std::vector<Value> values;
+  for (const auto &[order_by_type, expr] : order_bys_) {
+    expr->EvaluateBatch(batch, &values);
+    for (uint32_t i = 0; i < batch.Size(); i++) {
+      EncodeValue(values[i], order_by_type == OrderByType::DESC, &(*keys)[i]);
+    }
+  }
+}
+
+void SortKeyEncoder::EncodeValue(const Value &value, bool descending, std::string *key) {
+  auto start = key->size();
+  if (value.IsNull()) {
+    key->push_back(0);
+  } else {
+    key->push_back(1);
+    switch (value.GetTypeId()) {
+      case TypeId::BOOLEAN:
+        key->push_back(static_cast<char>(value.GetAs<int8_t>()));
+        break;
+      case TypeId::TINYINT:
+        AppendSigned<int8_t, uint8_t>(value.GetAs<int8_t>(), key);
+        break;
+      case TypeId::SMALLINT:
+        AppendSigned<int16_t, uint16_t>(value.GetAs<int16_t>(), key);
+        break;
+      case TypeId::INTEGER:
+        AppendSigned<int32_t, uint32_t>(value.GetAs<int32_t>(), key);
+        break;
+      case TypeId::BIGINT:
+        AppendSigned<int64_t, uint64_t>(value.GetAs<int64_t>(), key);
+        break;
+      case TypeId::TIMESTAMP:
+        AppendBigEndian<uint64_t>(value.GetAs<uint64_t>(), key);
+        break;
+      case TypeId::DECIMAL: {
+        auto number = value.GetAs<double>();
+        uint64_t bits;
+        memcpy(&bits, &number, sizeof(bits));
+        bits = (bits >> 63) != 0 ? ~bits : bits | (static_cast<uint64_t>(1) << 63);
+        AppendBigEndian<uint64_t>(bits, key);
+        break;
+      }
+      case TypeId::VARCHAR: {
+        // The length of a varchar counts its terminating '\0'.
+        const char *data = value.GetData();
+        for (uint32_t i = 0; i + 1 < value.GetLength(); i++) {
+          key->push_back(data[i]);
+          if (data[i] == 0) {
+            key->push_back(static_cast<char>(0xff));
+          }
+        }
+        key->push_back(0);
+        key->push_back(0);
+        break;
+      }
+      default:
+        throw NotImplementedException("cannot sort by this type");
+    }
+  }
+  if (descending) {
+    for (auto i = start; i < key->size(); i++) {
+      (*key)[i] = static_cast<char>(~(*key)[i]);
+    }
+  }
+}
+
+}  // namespace bustub
@@ -0,0 +1,215 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// spill_file.cpp
+//
+// Identification: src/execution/spill_file.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include "execution/spill_file.h"
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "common/exception.h"
+#include "storage/page/page_guard.h"
+
+namespace bustub {
+
+SpillFile::SpillFile(BufferPoolManager *bpm, const Schema *schema)
+    : bpm_(bpm),
+      schema_(schema),
+      has_unlined_columns_(schema != nullptr && !schema->GetUnlinedColumns().empty()),
+      buffer_(new char[BUSTUB_PAGE_SIZE]) {
+  Buffer()->Init(INVALID_PAGE_ID, BUSTUB_PAGE_SIZE);
+}
+
+SpillFile::~SpillFile() {
+  for (auto page_id : page_ids_) {
+    bpm_->DeletePage(page_id);
+  }
+}
+
+void SpillFile::Append(const Tuple &tuple) {
+  BUSTUB_ASSERT(schema_ != nullptr, "a file of records has no rows");
+  BUSTUB_ASSERT(!has_keys_ || num_rows_ == 0, "all rows of a spill file must have keys");
+  AppendInline(has_unlined_columns_ ? Materialize(tuple) : tuple, nullptr);
+}
+
+void SpillFile::Append(const Tuple &tuple, std::string_view key) {
+  BUSTUB_ASSERT(schema_ != nullptr, "a file of records has no rows");
+  BUSTUB_ASSERT(has_keys_ || num_rows_ == 0, "rows of a spill file without keys cannot have keys");
+  has_keys_ = true;
+  AppendInline(has_unlined_columns_ ? Materialize(tuple) : tuple, &key);
+}
+
+void SpillFile::AppendRecord(std::string_view record) {
+  BUSTUB_ASSERT(schema_ == nullptr, "a file of rows has no records");
+  AppendEntry(record.data(), record.size());
+  num_rows_++;
+}
+
+auto SpillFile::Materialize(const Tuple &tuple) const -> Tuple {
+  // An out-of-line value points into the table it was read from, which a spilled row must not depend on.
+  std::vector<Value> values;
+  values.reserve(schema_->GetColumnCount());
+  for (uint32_t i = 0; i < schema_->GetColumnCount(); i++) {
+    values.push_back(tuple.GetValue(schema_, i));
+  }
+  return {std::move(values), schema_};
+}
+
+void SpillFile::AppendInline(const Tuple &tuple, const std::string_view *key) {
+  if (key != nullptr) {
+    AppendEntry(key->data(), key->size());
+  }
+  AppendEntry(tuple.GetData(), tuple.GetLength());
+  num_rows_++;
+}
+
+void SpillFile::AppendEntry(const char *data, uint32_t size) {
+  TmpTuple out{INVALID_PAGE_ID, 0};
+  if (Buffer()->Insert(data, size, &out)) {
+    num_entries_++;
+    return;
+  }
+  if (sizeof(uint32_t) + size <= BUSTUB_PAGE_SIZE - TMP_TUPLE_PAGE_HEADER_SIZE) {
+    // An entry that fits in a page is not split, so that readers can use it in place.
+    Flush();
+    Buffer()->Insert(data, size, &out);
+    num_entries_++;
+    return;
+  }
+
+  // The first part fills the rest of the buffer, and each further part a page of its own.
+  split_entries_.emplace_back(num_entries_, 0);
+  while (size > 0) {
+    if (Buffer()->GetFreeSpaceRemaining() <= sizeof(uint32_t)) {
+      Flush();
+    }
+    auto part_size = std::min<uint32_t>(size, Buffer()->GetFreeSpaceRemaining() - sizeof(uint32_t));
+    Buffer()->Insert(data, part_size, &out);
+    data += part_size;
+    size -= part_size;
+    num_entries_++;
+    split_entries_.back().second++;
+  }
+}
+
+void SpillFile::Flush() {
+  page_id_t page_id;
+  auto guard = bpm_->NewPageGuarded(&page_id);
+  BUSTUB_ENSURE(page_id != INVALID_PAGE_ID, "cannot allocate page");
+  memcpy(guard.GetDataMut(), buffer_.get(), BUSTUB_PAGE_SIZE);
+  guard.AsMut<TmpTuplePage>()->SetTablePageId(page_id);
+  page_ids_.push_back(page_id);
+  Buffer()->Init(INVALID_PAGE_ID, BUSTUB_PAGE_SIZE);
+}
+
+auto SpillFile::Reader::Next(TupleBatch *batch) -> bool {
+  batch->Reset(file_->schema_);
+  Tuple tuple;
+  while (!batch->IsFull() && Next(&tuple)) {
+    batch->AppendTuple(std::move(tuple));
+  }
+  return !batch->Empty();
+}
+
+auto SpillFile::Reader::Next(Tuple *tuple) -> bool {
+  BUSTUB_ASSERT(!file_->has_keys_, "rows of a spill file with keys must be read with their keys");
+  const char *entry = NextEntry();
+  if (entry == nullptr) {
+    return false;
+  }
+  tuple->DeserializeFrom(entry);
+  return true;
+}
+
+auto SpillFile::Reader::Next(Tuple *tuple, std::string *key) -> bool {
+  BUSTUB_ASSERT(file_->has_keys_ || file_->num_rows_ == 0, "rows of a spill file without keys have no keys");
+  const char *entry = NextEntry();
+  if (entry == nullptr) {
+    return false;
+  }
+  // The key is copied out first, as reading the row may load the next page.
+  uint32_t size;
+  memcpy(&size, entry, sizeof(uint32_t));
+  key->assign(entry + sizeof(uint32_t), size);
+  entry = NextEntry();
+  BUSTUB_ENSURE(entry != nullptr, "spill file ends after a key");
+  tuple->DeserializeFrom(entry);
+  return true;
+}
+
+auto SpillFile::Reader::NextRecord(std::string *record) -> bool {
+  BUSTUB_ASSERT(file_->schema_ == nullptr, "a file of rows has no records");
+  const char *entry = NextEntry();
+  if (entry == nullptr) {
+    return false;
+  }
+  uint32_t size;
+  memcpy(&size, entry, sizeof(uint32_t));
+  record->assign(entry + sizeof(uint32_t), size);
+  return true;
+}
+
+auto SpillFile::Reader::NextEntry() -> const char * {
+  if (offsets_.empty() && !LoadPage()) {
+    return nullptr;
+  }
+  const auto &split_entries = file_->split_entries_;
+  if (split_idx_ == split_entries.size() || split_entries[split_idx_].first != entry_idx_) {
+    entry_idx_++;
+    auto offset = offsets_.back();
+    offsets_.pop_back();
+    return page_.get() + offset;
+  }
+
+  // Concatenate the parts behind a size field, in the same format as an entry of a page.
+  auto num_parts = split_entries[split_idx_++].second;
+  split_entry_.assign(sizeof(uint32_t), '\0');
+  for (size_t i = 0; i < num_parts; i++) {
+    BUSTUB_ENSURE(!offsets_.empty() || LoadPage(), "spill file ends within a split entry");
+    const char *data;
+    uint32_t size;
+    Page()->ReadData(offsets_.back(), &data, &size);
+    offsets_.pop_back();
+    split_entry_.append(data, size);
+  }
+  entry_idx_ += num_parts;
+  auto size = static_cast<uint32_t>(split_entry_.size() - sizeof(uint32_t));
+  memcpy(split_entry_.data(), &size, sizeof(uint32_t));
+  return split_entry_.data();
+}
+
+auto SpillFile::Reader::LoadPage() -> bool {
+  while (offsets_.empty() && page_idx_ <= file_->page_ids_.size()) {
+    if (page_ == nullptr) {
+      page_ = std::make_unique<char[]>(BUSTUB_PAGE_SIZE);
+    }
+    if (page_idx_ < file_->page_ids_.size()) {
+      auto guard = file_->bpm_->FetchPageRead(file_->page_ids_[page_idx_]);
+      memcpy(page_.get(), guard.GetData(), BUSTUB_PAGE_SIZE);
+    } else {
+      memcpy(page_.get(), file_->buffer_.get(), BUSTUB_PAGE_SIZE);
+    }
+    page_idx_++;
+
+    // Entries are stored from the end of the page, so walking from the free space pointer visits the most recent
+    // one first and leaves the first one at the back.
+    const char *data;
+    uint32_t size;
+    for (auto offset = Page()->GetFreeSpacePointer(); offset < BUSTUB_PAGE_SIZE;) {
+      offsets_.push_back(offset);
+      offset = Page()->ReadData(offset, &data, &size);
+    }
+  }
+  return !offsets_.empty();
+}
+
+}  // namespace bustub
@@ -1,15 +1,108 @@
 #include "execution/executors/topn_executor.h"
 
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
 namespace bustub {
 
 TopNExecutor::TopNExecutor(ExecutorContext *exec_ctx, const TopNPlanNode *plan,
                            std::unique_ptr<AbstractExecutor> &&child_executor)
-    : AbstractExecutor(exec_ctx) {}
+    : AbstractExecutor(exec_ctx),
+      plan_(plan),
+      child_executor_(std::move(child_executor)),
+      key_encoder_(plan_->GetOrderBy()) {
+  if (plan_->GetN() == 0 || plan_->GetOrderBy().empty() || exec_ctx_->GetRuntimeFilters() == nullptr) {
+    return;
+  }
+  // Only a column that the scan can compare in place can be bounded.
+  bound_target_ = RuntimeFilter::FindTarget(*plan_->GetChildPlan(), {plan_->GetOrderBy()[0].second});
+  if (bound_target_.has_value() &&
+      !ScanPredicate::IsSupported(
+          bound_target_->scan_->OutputSchema().GetColumn(bound_target_->columns_[0]).GetType())) {
+    bound_target_ = std::nullopt;
+  }
+}
+
+void TopNExecutor::Init() {
+  ResetBatchAdapter();
+  heap_.clear();
+  num_offered_ = 0;
+  worst_changed_ = false;
+  next_entry_ = 0;
+
+  // The bound is published before the child is initialized, so that the scan finds it when it starts.
+  if (bound_target_.has_value()) {
+    bound_ = std::make_shared<TopNBound>(bound_target_->columns_[0],
+                                         plan_->GetOrderBy()[0].first == OrderByType::DESC);
+    exec_ctx_->GetRuntimeFilters()->PublishBound(bound_target_->scan_, plan_, bound_);
+  }
+
+  child_executor_->Init();
+  if (child_executor_->SupportsBatch()) {
+    TupleBatch batch;
+    std::vector<std::string> keys;
+    while (child_executor_->NextBatch(&batch)) {
+      key_encoder_.EncodeBatch(batch, &keys);
+      for (uint32_t i = 0; i < batch.Size(); i++) {
+        Push(std::move(keys[i]), batch.GetTuple(i));
+      }
+      TightenBound();
+    }
+  } else {
+    Tuple tuple;
+    RID rid;
+    while (child_executor_->Next(&tuple, &rid)) {
+      std::string key;
+      for (const auto &[order_by_type, expr] : plan_->GetOrderBy()) {
+        SortKeyEncoder::EncodeValue(expr->Evaluate(&tuple, child_executor_->GetOutputSchema()),
+                                    order_by_type == OrderByType::DESC, &key);
+      }
+      Push(std::move(key), std::move(tuple));
+      TightenBound();
+    }
+  }
+  std::sort_heap(heap_.begin(), heap_.end(), EntryLess{});
+}
+
+void TopNExecutor::Push(std::string key, Tuple row) {
+  auto seq = num_offered_++;
+  if (heap_.size() < plan_->GetN()) {
+    heap_.push_back({std::move(key), seq, std::move(row)});
+    std::push_heap(heap_.begin(), heap_.end(), EntryLess{});
+    worst_changed_ = true;
+    return;
+  }
+  // A row with the same key as the worst one comes after it, so only a smaller key displaces it.
+  if (heap_.empty() || key >= heap_.front().key_) {
+    return;
+  }
+  std::pop_heap(heap_.begin(), heap_.end(), EntryLess{});
+  heap_.back() = {std::move(key), seq, std::move(row)};
+  std::push_heap(heap_.begin(), heap_.end(), EntryLess{});
+  worst_changed_ = true;
+}
+
+void TopNExecutor::TightenBound() {
+  if (bound_ == nullptr || !worst_changed_ || heap_.size() < plan_->GetN()) {
+    return;
+  }
+  worst_changed_ = false;
+  bound_->Tighten(plan_->GetOrderBy()[0].second->Evaluate(&heap_.front().row_, child_executor_->GetOutputSchema()));
+}
 
-void TopNExecutor::Init() { throw NotImplementedException("TopNExecutor is not implemented"); }
+auto TopNExecutor::Next(Tuple *tuple, RID *rid) -> bool { return NextFromBatch(tuple, rid); }
 
-auto TopNExecutor::Next(Tuple *tuple, RID *rid) -> bool { return false; }
+auto TopNExecutor::NextBatch(TupleBatch *batch) -> bool {
+  batch->Reset(&GetOutputSchema());
+  while (!batch->IsFull() && next_entry_ < heap_.size()) {
+    batch->AppendTuple(std::move(heap_[next_entry_++].row_));
+  }
+  return !batch->Empty();
+}
 
-auto TopNExecutor::GetNumInHeap() -> size_t { throw NotImplementedException("TopNExecutor is not implemented"); };
+auto TopNExecutor::GetNumInHeap() -> size_t { return heap_.size(); }
 
 }  // namespace bustub
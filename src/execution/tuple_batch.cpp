@@ -0,0 +1,147 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// tuple_batch.cpp
+//
+// Identification: src/execution/tuple_batch.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include "execution/tuple_batch.h"
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "common/macros.h"
+
+namespace bustub {
+
+void TupleBatch::Reset(const Schema *schema) {
+  schema_ = schema;
+  num_rows_ = 0;
+  tuples_.clear();
+  views_.clear();
+  chunks_.clear();
+  chunk_rows_.clear();
+  rids_.clear();
+  columns_.resize(schema->GetColumnCount());
+  for (auto &column : columns_) {
+    column.clear();
+  }
+  decoded_.assign(schema->GetColumnCount(), false);
+  selection_.clear();
+  has_selection_ = false;
+}
+
+void TupleBatch::AppendTuple(Tuple tuple) {
+  BUSTUB_ASSERT(rids_.empty() && views_.empty() && chunk_rows_.empty() && !has_selection_,
+                "cannot mix tuples and values in a batch");
+  tuples_.push_back(std::move(tuple));
+  num_rows_++;
+}
+
+void TupleBatch::AppendTupleView(TupleView view) {
+  BUSTUB_ASSERT(rids_.empty() && tuples_.empty() && chunk_rows_.empty() && !has_selection_,
+                "cannot mix tuples and values in a batch");
+  views_.push_back(view);
+  num_rows_++;
+}
+
+void TupleBatch::AppendChunk(const std::shared_ptr<const ColumnChunk> &chunk, const std::vector<uint32_t> &rows) {
+  BUSTUB_ASSERT(rids_.empty() && tuples_.empty() && views_.empty() && !has_selection_,
+                "cannot mix tuples and values in a batch");
+  auto chunk_idx = static_cast<uint32_t>(chunks_.size());
+  chunks_.push_back(chunk);
+  for (auto row : rows) {
+    chunk_rows_.emplace_back(chunk_idx, row);
+  }
+  num_rows_ += rows.size();
+}
+
+void TupleBatch::AppendValues(std::vector<Value> values, RID rid) {
+  BUSTUB_ASSERT(tuples_.empty() && views_.empty() && chunk_rows_.empty() && !has_selection_,
+                "cannot mix tuples and values in a batch");
+  BUSTUB_ASSERT(values.size() == columns_.size(), "wrong number of values");
+  for (uint32_t i = 0; i < values.size(); i++) {
+    columns_[i].push_back(std::move(values[i]));
+    decoded_[i] = true;
+  }
+  rids_.push_back(rid);
+  num_rows_++;
+}
+
+void TupleBatch::SetColumns(std::vector<std::vector<Value>> columns, std::vector<RID> rids) {
+  BUSTUB_ASSERT(num_rows_ == 0, "batch must be empty");
+  BUSTUB_ASSERT(columns.size() == columns_.size(), "wrong number of columns");
+  for (const auto &column : columns) {
+    BUSTUB_ASSERT(column.size() == rids.size(), "columns must have one value per row");
+  }
+  columns_ = std::move(columns);
+  decoded_.assign(columns_.size(), true);
+  rids_ = std::move(rids);
+  num_rows_ = rids_.size();
+}
+
+auto TupleBatch::GetColumn(uint32_t column_idx) const -> const std::vector<Value> & {
+  auto &column = columns_[column_idx];
+  if (!decoded_[column_idx]) {
+    // Rows that are not selected anymore are never looked at again, so only decode the selected ones.
+    column.resize(num_rows_);
+    for (uint32_t i = 0; i < Size(); i++) {
+      auto row = RowAt(i);
+      if (!chunk_rows_.empty()) {
+        auto [chunk, chunk_row] = chunk_rows_[row];
+        column[row] = chunks_[chunk]->GetValue(chunk_row, column_idx);
+      } else {
+        column[row] =
+            views_.empty() ? tuples_[row].GetValue(schema_, column_idx) : views_[row].GetValue(schema_, column_idx);
+      }
+    }
+    decoded_[column_idx] = true;
+  }
+  return column;
+}
+
+auto TupleBatch::GetTuple(uint32_t i) const -> Tuple {
+  auto row = RowAt(i);
+  if (!tuples_.empty()) {
+    return tuples_[row];
+  }
+  if (!views_.empty()) {
+    return views_[row].ToTuple();
+  }
+  if (!chunk_rows_.empty()) {
+    auto [chunk, chunk_row] = chunk_rows_[row];
+    return chunks_[chunk]->GetTuple(chunk_row);
+  }
+  std::vector<Value> values;
+  values.reserve(columns_.size());
+  for (const auto &column : columns_) {
+    values.push_back(column[row]);
+  }
+  Tuple tuple{std::move(values), schema_};
+  tuple.SetRid(rids_[row]);
+  return tuple;
+}
+
+auto TupleBatch::GetRid(uint32_t i) const -> RID {
+  auto row = RowAt(i);
+  if (!views_.empty()) {
+    return views_[row].GetRid();
+  }
+  if (!chunk_rows_.empty()) {
+    auto [chunk, chunk_row] = chunk_rows_[row];
+    return chunks_[chunk]->GetRid(chunk_row);
+  }
+  return tuples_.empty() ? rids_[row] : tuples_[row].GetRid();
+}
+
+void TupleBatch::Select(std::vector<uint32_t> selection) {
+  BUSTUB_ASSERT(selection.size() <= Size(), "selection must be a subset of the selected rows");
+  selection_ = std::move(selection);
+  has_selection_ = true;
+}
+
+}  // namespace bustub
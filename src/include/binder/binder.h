@@ -31,7 +31,9 @@
 #pragma once
 
 #include <memory>
+#include <optional>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 #include <string>
@@ -81,6 +83,9 @@ class ExplainStatement;
 class IndexStatement;
 class DeleteStatement;
 class UpdateStatement;
+class PrepareStatement;
+class ExecuteStatement;
+class DeallocateStatement;
 
 /**
  * The binder is responsible for transforming the Postgres parse tree to a binder tree
@@ -131,7 +136,12 @@ class Binder {
 
   auto BindSelectList(duckdb_libpgquery::PGList *list) -> std::vector<std::unique_ptr<BoundExpression>>;
 
-  auto BindWhere(duckdb_libpgquery::PGNode *root) -> std::unique_ptr<BoundExpression>;
+  auto BindWhere(duckdb_libpgquery::PGNode *root, std::unique_ptr<BoundTableRef> *table)
+      -> std::unique_ptr<BoundExpression>;
+
+  auto BindSubqueryPredicate(duckdb_libpgquery::PGNode *node, std::unique_ptr<BoundTableRef> *table) -> bool;
+
+  auto DecorrelateSubquery(BoundSubqueryRef *subquery_ref) -> std::vector<std::unique_ptr<BoundExpression>>;
 
   auto BindGroupBy(duckdb_libpgquery::PGList *list) -> std::vector<std::unique_ptr<BoundExpression>>;
 
@@ -204,6 +214,14 @@ class Binder {
 
   auto BindVariableShow(duckdb_libpgquery::PGVariableShowStmt *stmt) -> std::unique_ptr<VariableShowStatement>;
 
+  auto BindPrepare(duckdb_libpgquery::PGPrepareStmt *stmt) -> std::unique_ptr<PrepareStatement>;
+
+  auto BindExecute(duckdb_libpgquery::PGExecuteStmt *stmt) -> std::unique_ptr<ExecuteStatement>;
+
+  auto BindDeallocate(duckdb_libpgquery::PGDeallocateStmt *stmt) -> std::unique_ptr<DeallocateStatement>;
+
+  auto BindParamRef(duckdb_libpgquery::PGParamRef *node) -> std::unique_ptr<BoundExpression>;
+
   class ContextGuard {
    public:
     explicit ContextGuard(const BoundTableRef **scope, const CTEList **cte_scope) {
@@ -246,12 +264,29 @@ class Binder {
   /** The current scope for resolving column ref, used in binding expressions */
   const BoundTableRef *scope_{nullptr};
 
+  /** The scope of the query whose WHERE clause the subquery being bound is in, used to resolve the column refs of
+   * the subquery's WHERE clause that are not in the subquery, and the column refs resolved in it. */
+  const BoundTableRef *outer_scope_{nullptr};
+  std::unordered_set<const BoundExpression *> outer_column_refs_;
+
   /** The current scope for resolving tables in CTEs, used in binding tables */
   const CTEList *cte_scope_{nullptr};
 
   /** Sometimes we will need to assign a name to some unnamed items. This variable gives them a universal ID. */
   size_t universal_id_{0};
 
+  /** The text given to ParseAndSave, and where the statement being bound starts in it and its length (0 for the
+   * rest of the text). */
+  std::string query_;
+  int statement_location_{0};
+  int statement_length_{0};
+
+  /** The declared parameter types of the statement being prepared, std::nullopt if no statement is. */
+  std::optional<std::vector<TypeId>> parameter_types_;
+
+  /** The number of parameters of the statement being prepared, i.e. the largest parameter number seen. */
+  uint32_t num_parameters_{0};
+
   duckdb::PostgresParser parser_;
 };
 
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <string>
+
+#include "binder/bound_expression.h"
+#include "type/type_id.h"
+
+namespace bustub {
+
+/**
+ * A parameter of a prepared statement, e.g., `$1` or `?`. Its value is given by EXECUTE.
+ */
+class BoundParameter : public BoundExpression {
+ public:
+  explicit BoundParameter(uint32_t index, TypeId type)
+      : BoundExpression(ExpressionType::PARAMETER), index_(index), type_id_(type) {}
+
+  auto ToString() const -> std::string override { return fmt::format("${}", index_ + 1); }
+
+  auto HasAggregation() const -> bool override { return false; }
+
+  /** The position of the parameter, starting at 0. */
+  uint32_t index_;
+
+  /** The type of the parameter, as declared by PREPARE (INTEGER if it is not declared). */
+  TypeId type_id_;
+};
+}  // namespace bustub
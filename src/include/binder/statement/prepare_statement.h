@@ -0,0 +1,93 @@
+//===----------------------------------------------------------------------===//
+//                         BusTub
+//
+// binder/prepare_statement.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <memory>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "binder/bound_statement.h"
+#include "common/enums/statement_type.h"
+#include "fmt/format.h"
+#include "fmt/ranges.h"
+#include "type/type_id.h"
+#include "type/value.h"
+
+namespace bustub {
+
+/** `PREPARE name [(types)] AS statement` */
+class PrepareStatement : public BoundStatement {
+ public:
+  explicit PrepareStatement(std::string name, std::string sql, std::vector<TypeId> types, uint32_t num_parameters,
+                            std::unique_ptr<BoundStatement> statement)
+      : BoundStatement(StatementType::PREPARE_STATEMENT),
+        name_(std::move(name)),
+        sql_(std::move(sql)),
+        types_(std::move(types)),
+        num_parameters_(num_parameters),
+        statement_(std::move(statement)) {}
+
+  std::string name_;
+
+  /** The text of the PREPARE statement, so that it can be planned again. */
+  std::string sql_;
+
+  /** The declared types of the parameters, which may be fewer than the parameters. */
+  std::vector<TypeId> types_;
+
+  uint32_t num_parameters_;
+
+  /** The statement, with its parameters bound as BoundParameter. */
+  std::unique_ptr<BoundStatement> statement_;
+
+  auto ToString() const -> std::string override {
+    std::vector<std::string> types;
+    for (auto type : types_) {
+      types.push_back(Type::TypeIdToString(type));
+    }
+    return fmt::format("BoundPrepare {{ name={}, types=[{}], num_parameters={}, statement={} }}", name_,
+                       fmt::join(types, ", "), num_parameters_, statement_->ToString());
+  }
+};
+
+/** `EXECUTE name [(values)]` */
+class ExecuteStatement : public BoundStatement {
+ public:
+  explicit ExecuteStatement(std::string name, std::vector<Value> parameters)
+      : BoundStatement(StatementType::EXECUTE_STATEMENT), name_(std::move(name)), parameters_(std::move(parameters)) {}
+
+  std::string name_;
+
+  std::vector<Value> parameters_;
+
+  auto ToString() const -> std::string override {
+    std::vector<std::string> parameters;
+    for (const auto &parameter : parameters_) {
+      parameters.push_back(parameter.ToString());
+    }
+    return fmt::format("BoundExecute {{ name={}, parameters=[{}] }}", name_, fmt::join(parameters, ", "));
+  }
+};
+
+/** `DEALLOCATE name` or `DEALLOCATE ALL` */
+class DeallocateStatement : public BoundStatement {
+ public:
+  explicit DeallocateStatement(std::optional<std::string> name)
+      : BoundStatement(StatementType::DEALLOCATE_STATEMENT), name_(std::move(name)) {}
+
+  /** The statement to deallocate, std::nullopt for all of them. */
+  std::optional<std::string> name_;
+
+  auto ToString() const -> std::string override {
+    return fmt::format("BoundDeallocate {{ name={} }}", name_.value_or("ALL"));
+  }
+};
+
+}  // namespace bustub
@@ -18,7 +18,9 @@ enum class JoinType : uint8_t {
   LEFT = 1,    /**< Left join. */
   RIGHT = 3,   /**< Right join. */
   INNER = 4,   /**< Inner join. */
-  OUTER = 5    /**< Outer join. */
+  OUTER = 5,   /**< Outer join. */
+  SEMI = 6,    /**< Semi join: the left rows that have a match, e.g. from `EXISTS (...)` or `IN (...)`. */
+  ANTI = 7     /**< Anti join: the left rows that have no match, e.g. from `NOT EXISTS (...)`. */
 };
 
 /**
@@ -45,7 +47,7 @@ class BoundJoinRef : public BoundTableRef {
   /** The left side of the join. */
   std::unique_ptr<BoundTableRef> left_;
 
-  /** The right side of the join. */
+  /** The right side of the join. Its columns are not part of the output of semi and anti joins. */
   std::unique_ptr<BoundTableRef> right_;
 
   /** Join condition. */
@@ -74,6 +76,12 @@ struct fmt::formatter<bustub::JoinType> : formatter<string_view> {
       case bustub::JoinType::OUTER:
         name = "Outer";
         break;
+      case bustub::JoinType::SEMI:
+        name = "Semi";
+        break;
+      case bustub::JoinType::ANTI:
+        name = "Anti";
+        break;
       default:
         name = "Unknown";
         break;
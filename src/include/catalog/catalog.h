@@ -121,10 +121,11 @@ class Catalog {
    * @param table_name The name of the new table, note that all tables beginning with `__` are reserved for the system.
    * @param schema The schema of the new table
    * @param create_table_heap whether to create a table heap for the new table
+   * @param storage The page format of the table heap
    * @return A (non-owning) pointer to the metadata for the table
    */
-  auto CreateTable(Transaction *txn, const std::string &table_name, const Schema &schema, bool create_table_heap = true)
-      -> TableInfo * {
+  auto CreateTable(Transaction *txn, const std::string &table_name, const Schema &schema, bool create_table_heap = true,
+                   TableStorage storage = TableStorage::ROW) -> TableInfo * {
     if (table_names_.count(table_name) != 0) {
       return NULL_TABLE_INFO;
     }
@@ -135,7 +136,7 @@ class Catalog {
     // When create_table_heap == false, it means that we're running binder tests (where no txn will be provided) or
     // we are running shell without buffer pool. We don't need to create TableHeap in this case.
     if (create_table_heap) {
-      table = std::make_unique<TableHeap>(bpm_);
+      table = std::make_unique<TableHeap>(bpm_, &schema, storage);
     } else {
       // Otherwise, create an empty heap only for binder tests
       table = TableHeap::CreateEmptyHeap(create_table_heap);
@@ -152,6 +153,7 @@ class Catalog {
     tables_.emplace(table_oid, std::move(meta));
     table_names_.emplace(table_name, table_oid);
     index_names_.emplace(table_name, std::unordered_map<std::string, index_oid_t>{});
+    version_.fetch_add(1);
 
     return tmp;
   }
@@ -248,6 +250,7 @@ class Catalog {
     // Update internal tracking
     indexes_.emplace(index_oid, std::move(index_info));
     table_indexes.emplace(index_name, index_oid);
+    version_.fetch_add(1);
 
     return tmp;
   }
@@ -300,7 +303,7 @@ class Catalog {
    * @param index_oid The OID of the index for which to query
    * @return A (non-owning) pointer to the metadata for the index
    */
-  auto GetIndex(index_oid_t index_oid) -> IndexInfo * {
+  auto GetIndex(index_oid_t index_oid) const -> IndexInfo * {
     auto index = indexes_.find(index_oid);
     if (index == indexes_.end()) {
       return NULL_INDEX_INFO;
@@ -335,6 +338,9 @@ class Catalog {
     return indexes;
   }
 
+  /** @return a number that changes whenever a table or an index is created, so that cached plans can be checked */
+  auto GetVersion() const -> uint64_t { return version_.load(); }
+
   auto GetTableNames() -> std::vector<std::string> {
     std::vector<std::string> result;
     for (const auto &x : table_names_) {
@@ -373,6 +379,9 @@ class Catalog {
 
   /** The next index identifier to be used. */
   std::atomic<index_oid_t> next_index_oid_{0};
+
+  /** The number of tables and indexes created, see GetVersion. */
+  std::atomic<uint64_t> version_{0};
 };
 
 }  // namespace bustub
@@ -18,6 +18,7 @@ static constexpr uint32_t TEST7_SIZE = 100;
 static constexpr uint32_t TEST8_SIZE = 10;
 static constexpr uint32_t TEST9_SIZE = 10;
 static constexpr uint32_t TEST_VARLEN_SIZE = 10;
+static constexpr uint32_t TEST_PARALLEL_SIZE = 10000;
 
 class TableGenerator {
  public:
@@ -12,11 +12,14 @@
 
 #pragma once
 
+#include <algorithm>
 #include <iostream>
 #include <memory>
+#include <mutex>  // NOLINT
 #include <optional>
 #include <shared_mutex>
 #include <sstream>
+#include <stdexcept>
 #include <string>
 #include <unordered_map>
 #include <utility>
@@ -38,15 +41,24 @@ class BufferPoolManager;
 class LockManager;
 class TransactionManager;
 class LogManager;
+class VacuumManager;
 class CheckpointManager;
 class Catalog;
 class ExecutionEngine;
+class PipelineCache;
+class PlanCache;
+struct CachedPlan;
+struct PreparedPlan;
 
 class CreateStatement;
 class IndexStatement;
 class VariableSetStatement;
 class VariableShowStatement;
 class ExplainStatement;
+class PrepareStatement;
+class ExecuteStatement;
+class DeallocateStatement;
+class BoundStatement;
 
 class ResultWriter {
  public:
@@ -260,7 +272,10 @@ class BustubInstance {
   LogManager *log_manager_;
   CheckpointManager *checkpoint_manager_;
   Catalog *catalog_;
+  VacuumManager *vacuum_manager_;
   ExecutionEngine *execution_engine_;
+  PipelineCache *pipeline_cache_;
+  PlanCache *plan_cache_;
   std::shared_mutex catalog_lock_;
 
   auto GetSessionVariable(const std::string &key) -> std::string {
@@ -275,10 +290,43 @@ class BustubInstance {
     return variable == "1" || variable == "true" || variable == "yes";
   }
 
+  /** @return the value of a numeric session variable, or `default_value` if it is not set or not a number */
+  auto GetSizeVariable(const std::string &key, size_t default_value) -> size_t {
+    try {
+      return std::stoul(GetSessionVariable(key));
+    } catch (std::logic_error &e) {
+      return default_value;
+    }
+  }
+
+  /** @return the number of threads a query may use, set with `SET degree_of_parallelism = n` (defaults to 1) */
+  auto GetDegreeOfParallelism() -> size_t {
+    return std::clamp<size_t>(GetSizeVariable("degree_of_parallelism", 1), 1, MAX_DEGREE_OF_PARALLELISM);
+  }
+
+  /** @return the bytes an operator may use before it spills, set with `SET memory_limit = n` */
+  auto GetMemoryLimit() -> size_t { return GetSizeVariable("memory_limit", DEFAULT_MEMORY_LIMIT); }
+
+  /** @return the bytes a sort may use before it spills, set with `SET sort_memory_budget = n` (the memory limit) */
+  auto GetSortMemoryBudget() -> size_t { return GetSizeVariable("sort_memory_budget", GetMemoryLimit()); }
+
+  /** @return whether pipelines are compiled, set with `SET enable_pipeline_compilation = true` (defaults to false) */
+  auto IsPipelineCompilationEnabled() -> bool {
+    auto variable = StringUtil::Lower(GetSessionVariable("enable_pipeline_compilation"));
+    return variable == "1" || variable == "true" || variable == "yes";
+  }
+
+  /** @return whether the plans of statements are cached, set with `SET enable_plan_cache = false` (defaults to true) */
+  auto IsPlanCacheEnabled() -> bool {
+    auto variable = StringUtil::Lower(GetSessionVariable("enable_plan_cache"));
+    return variable != "0" && variable != "false" && variable != "no";
+  }
+
  private:
   void CmdDisplayTables(ResultWriter &writer);
   void CmdDisplayIndices(ResultWriter &writer);
   void CmdDisplayHelp(ResultWriter &writer);
+  void CmdVacuum(ResultWriter &writer, Transaction *txn);
   void WriteOneCell(const std::string &cell, ResultWriter &writer);
 
   void HandleCreateStatement(Transaction *txn, const CreateStatement &stmt, ResultWriter &writer);
@@ -286,8 +334,30 @@ class BustubInstance {
   void HandleExplainStatement(Transaction *txn, const ExplainStatement &stmt, ResultWriter &writer);
   void HandleVariableShowStatement(Transaction *txn, const VariableShowStatement &stmt, ResultWriter &writer);
   void HandleVariableSetStatement(Transaction *txn, const VariableSetStatement &stmt, ResultWriter &writer);
+  void HandlePrepareStatement(Transaction *txn, const PrepareStatement &stmt, ResultWriter &writer);
+  auto HandleExecuteStatement(Transaction *txn, const ExecuteStatement &stmt,
+                              std::shared_ptr<CheckOptions> check_options, ResultWriter &writer) -> bool;
+  void HandleDeallocateStatement(Transaction *txn, const DeallocateStatement &stmt, ResultWriter &writer);
+
+  /** Plan and optimize a query. */
+  auto PlanStatement(const BoundStatement &statement) -> std::shared_ptr<const CachedPlan>;
+
+  /** Execute a plan, writing its result as a table. */
+  auto ExecutePlan(Transaction *txn, const CachedPlan &plan, std::shared_ptr<CheckOptions> check_options,
+                   ResultWriter &writer) -> bool;
+
+  /** Plan the statement of a PREPARE. */
+  auto MakePreparedPlan(const PrepareStatement &stmt) -> std::shared_ptr<const PreparedPlan>;
+
+  /** Plan the prepared statements again if the catalog has changed since they were planned. */
+  void RefreshPreparedStatements();
 
   std::unordered_map<std::string, std::string> session_variables_;
+
+  /** The statements prepared with PREPARE, by name, and the catalog version they were planned for. */
+  std::unordered_map<std::string, std::shared_ptr<const PreparedPlan>> prepared_statements_;
+  uint64_t prepared_statements_version_{0};
+  std::mutex prepared_statements_latch_;
 };
 
 }  // namespace bustub
@@ -21,6 +21,15 @@ namespace bustub {
 /** Cycle detection is performed every CYCLE_DETECTION_INTERVAL milliseconds. */
 extern std::chrono::milliseconds cycle_detection_interval;
 
+/** The background vacuum runs every VACUUM_INTERVAL milliseconds. */
+extern std::chrono::milliseconds vacuum_interval;
+
+/**
+ * True if BustubInstance should start the background vacuum. Off by default, so that pages only change when asked;
+ * `\vacuum` runs a pass on demand.
+ */
+extern std::atomic<bool> enable_background_vacuum;
+
 /** True if logging should be enabled, false otherwise. */
 extern std::atomic<bool> enable_logging;
 
@@ -36,6 +45,8 @@ static constexpr int BUFFER_POOL_SIZE = 10;
 static constexpr int LOG_BUFFER_SIZE = ((BUFFER_POOL_SIZE + 1) * BUSTUB_PAGE_SIZE);  // size of a log buffer in byte
 static constexpr int BUCKET_SIZE = 50;                                               // size of extendible hash bucket
 static constexpr int LRUK_REPLACER_K = 10;  // lookback window for lru-k replacer
+static constexpr size_t MAX_DEGREE_OF_PARALLELISM = 64;  // maximum number of threads of a query
+static constexpr size_t DEFAULT_MEMORY_LIMIT = 16 << 20;  // bytes an operator may use before it spills
 
 using frame_id_t = int32_t;    // frame id type
 using page_id_t = int32_t;     // page id type
@@ -0,0 +1,34 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// table_storage.h
+//
+// Identification: src/include/common/enums/table_storage.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+
+#include "fmt/format.h"
+
+namespace bustub {
+
+/** The page format a table heap stores its tuples in, chosen with `CREATE TABLE ... WITH (storage = ...)` */
+enum class TableStorage : uint8_t {
+  ROW,       // slotted pages of whole tuples (TablePage)
+  COLUMNAR,  // pages of per-column minipages (ColumnarTablePage)
+};
+
+}  // namespace bustub
+
+template <>
+struct fmt::formatter<bustub::TableStorage> : formatter<string_view> {
+  template <typename FormatContext>
+  auto format(bustub::TableStorage c, FormatContext &ctx) const {
+    string_view name = c == bustub::TableStorage::COLUMNAR ? "columnar" : "row";
+    return formatter<string_view>::format(name, ctx);
+  }
+};
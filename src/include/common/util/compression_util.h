@@ -0,0 +1,40 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// compression_util.h
+//
+// Identification: src/include/common/util/compression_util.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+namespace bustub {
+
+/**
+ * CompressionUtil provides a fast LZ77 block compressor in the style of LZ4. A block is a sequence of
+ * (literals, match) pairs: a token byte holds the literal length and the match length - 4 in its two nibbles, followed
+ * by extra length bytes if a nibble is 15, the literals, and a 2-byte little-endian match offset. The last sequence
+ * of a block only has literals.
+ */
+class CompressionUtil {
+ public:
+  /**
+   * Compress a buffer.
+   * @return the compressed block, which may be larger than the input for incompressible data
+   */
+  static auto LzCompress(const char *src, size_t size) -> std::vector<char>;
+
+  /**
+   * Decompress a block produced by LzCompress.
+   * @param dst output buffer of exactly `raw_size` bytes
+   * @return false if the block is corrupt or does not decompress to exactly `raw_size` bytes
+   */
+  static auto LzDecompress(const char *src, size_t size, char *dst, size_t raw_size) -> bool;
+};
+
+}  // namespace bustub
@@ -55,6 +55,7 @@ class TransactionManager {
 
     std::unique_lock<std::shared_mutex> l(txn_map_mutex_);
     txn_map_[txn->GetTransactionId()] = txn;
+    active_txn_ids_.insert(txn->GetTransactionId());
     return txn;
   }
 
@@ -91,6 +92,16 @@ class TransactionManager {
     return res;
   }
 
+  /**
+   * Check whether the delete of a tuple can no longer be rolled back, i.e. whether vacuum may reclaim it. That is the
+   * case once the transaction in its delete_txn_id_ has committed or finished aborting. A delete without a transaction
+   * id is only final once no transaction other than `txn` is active, as it may come from one that does not record it.
+   * @param meta the metadata of a deleted tuple
+   * @param txn the transaction asking, nullptr if none
+   * @return true if the tuple can be reclaimed
+   */
+  auto IsDeleteFinal(const TupleMeta &meta, const Transaction *txn = nullptr) -> bool;
+
   /** Prevents all transactions from performing operations, used for checkpointing. */
   void BlockAllTransactions();
 
@@ -148,6 +159,8 @@ class TransactionManager {
     }
   }
 
+  /** The transactions that have begun and not yet committed or finished aborting, protected by txn_map_mutex_. */
+  std::unordered_set<txn_id_t> active_txn_ids_;
   std::atomic<txn_id_t> next_txn_id_{0};
   LockManager *lock_manager_ __attribute__((__unused__));
   LogManager *log_manager_ __attribute__((__unused__));
@@ -0,0 +1,202 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// aggregation_hash_table.h
+//
+// Identification: src/include/execution/aggregation_hash_table.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "common/util/hash_util.h"
+#include "execution/plans/aggregation_plan.h"
+#include "execution/spill_file.h"
+#include "type/value.h"
+
+namespace bustub {
+
+/**
+ * AggregationHashTable holds the groups of a hash aggregation.
+ *
+ * A group is a single allocation from an arena: a header, one fixed-width accumulator per aggregate, and the
+ * serialized group-by values. Groups are found through an open-addressing table of (hash, group) slots. Rows are
+ * added a batch at a time: the groups of all rows are looked up first, then every aggregate is updated over the whole
+ * batch by an update kernel specialized for its aggregation type and input type.
+ *
+ * When the groups exceed the memory limit, all of them are written as partial aggregates to FANOUT spill files by
+ * the RADIX_BITS bits of their hash at the table's level, and the table starts over empty. At the end, the partial
+ * aggregates of each partition are merged in a table one level down, which partitions by the next bits of the hash
+ * and may spill again. From MAX_LEVELS on, a table does not spill.
+ */
+class AggregationHashTable {
+ public:
+  static constexpr uint32_t RADIX_BITS = 4;
+  static constexpr uint32_t FANOUT = 1 << RADIX_BITS;
+  static constexpr uint32_t MAX_LEVELS = 4;
+
+  /**
+   * @param agg_types the types of the aggregates
+   * @param bpm the buffer pool manager to spill to, nullptr to never spill
+   * @param memory_limit number of bytes the groups may use before they are spilled
+   * @param level the level of the table, 0 for the top-level table of an aggregation
+   */
+  AggregationHashTable(const std::vector<AggregationType> &agg_types, BufferPoolManager *bpm, size_t memory_limit,
+                       uint32_t level = 0);
+
+  /** @return the aggregates of a group without rows, which an aggregation without groups produces for no input */
+  auto GenerateInitialAggregateValue() const -> AggregateValue;
+
+  /**
+   * Add rows to their groups.
+   * @param keys keys[i][row] is the value of the i-th group-by of a row
+   * @param vals vals[i][row] is the input of the i-th aggregate for a row
+   * @param num_rows the number of rows
+   */
+  void InsertBatch(const std::vector<std::vector<Value>> &keys, const std::vector<std::vector<Value>> &vals,
+                   uint32_t num_rows);
+
+  /** Merge the groups of a table over the same aggregates into this one, including the groups it spilled. */
+  void Merge(AggregationHashTable *other);
+
+  /** Prepare to read the groups. No rows may be added afterwards. */
+  void Finalize();
+
+  /**
+   * Read the next group.
+   * @param[out] values the group-by values of the group, followed by its aggregates
+   * @return false if all groups were read
+   */
+  auto Next(std::vector<Value> *values) -> bool;
+
+  /** @return whether the table has no groups */
+  auto Empty() const -> bool { return entries_.empty() && !spilled_; }
+
+  /** Remove all groups. */
+  void Clear();
+
+ private:
+  /** The state of one aggregate of a group */
+  struct Accumulator {
+    union {
+      /** Counts, and sums, minima and maxima of integer, boolean and timestamp inputs */
+      int64_t integer_;
+      double decimal_;
+      /** Points into the arena, or into a spilled record while it is merged */
+      const char *varchar_;
+    };
+    /** Length of the varchar, including its terminating '\0' */
+    uint32_t length_;
+    /** TypeId of the value */
+    uint8_t type_;
+    bool is_null_;
+  };
+
+  /** The start of a group, followed by its accumulators and its serialized group-by values */
+  struct EntryHeader {
+    hash_t hash_;
+    uint32_t key_size_;
+  };
+
+  struct Slot {
+    hash_t hash_;
+    char *entry_;
+  };
+
+  /** @return the partition of a hash at a level */
+  static auto PartitionOf(hash_t hash, uint32_t level) -> uint32_t {
+    return (hash >> (level * RADIX_BITS)) & (FANOUT - 1);
+  }
+
+  auto Accumulators(char *entry) const -> Accumulator * {
+    return reinterpret_cast<Accumulator *>(entry + sizeof(EntryHeader));
+  }
+  auto KeyData(char *entry) const -> char * {
+    return entry + sizeof(EntryHeader) + agg_types_.size() * sizeof(Accumulator);
+  }
+
+  /** @return the group of a serialized key, which is created if it does not exist */
+  auto FindOrInsert(hash_t hash, const char *key, uint32_t key_size) -> char *;
+
+  /** Double the number of slots. */
+  void Grow();
+
+  /** @return memory from the arena, 8-byte aligned */
+  auto Allocate(size_t size) -> char *;
+
+  /** Update one aggregate with one input through Values, for inputs no kernel handles. */
+  void UpdateAccumulator(AggregationType agg_type, Accumulator *acc, const Value &input);
+
+  /** Update one aggregate of the groups of a batch with its inputs. */
+  void UpdateColumn(size_t agg_idx, const std::vector<char *> &groups, const std::vector<Value> &inputs);
+
+  /** Update one aggregate of the groups of a batch through the kernel for inputs of one type. */
+  template <typename Kernel>
+  void RunKernel(size_t agg_idx, TypeId type, const std::vector<char *> &groups, const std::vector<Value> &inputs);
+
+  /** Run the MIN or MAX kernel for inputs of a type. @return false if there is no kernel for the type */
+  template <bool IS_MIN>
+  auto RunMinMaxKernel(size_t agg_idx, TypeId type, const std::vector<char *> &groups,
+                       const std::vector<Value> &inputs) -> bool;
+
+  /** Combine the partial aggregate `src` into `dst`. */
+  void MergeAccumulator(AggregationType agg_type, Accumulator *dst, const Accumulator &src);
+
+  /** Merge a group, given by its hash, serialized key and partial aggregates, into this table. */
+  void MergeGroup(hash_t hash, const char *key, uint32_t key_size, const Accumulator *accs);
+
+  /** Merge a group that was spilled by SerializeGroup. */
+  void MergeRecord(const std::string &record);
+
+  /** Append a group to a record: the entry, then the varchars of its accumulators. */
+  void SerializeGroup(char *entry, std::string *record) const;
+
+  /** Set an accumulator to a value. */
+  void SetAccumulator(Accumulator *acc, const Value &value);
+
+  /** @return the value of an accumulator */
+  static auto GetAccumulator(AggregationType agg_type, const Accumulator &acc) -> Value;
+
+  /** Move all groups to the spill files of their partitions if they exceed the memory limit. */
+  void SpillIfFull();
+
+  /** Move all groups to the spill files of their partitions. */
+  void SpillAll();
+
+  /** Free the memory of the groups. */
+  void ClearGroups();
+
+  const std::vector<AggregationType> &agg_types_;
+  BufferPoolManager *bpm_;
+  size_t memory_limit_;
+  uint32_t level_;
+
+  std::vector<std::unique_ptr<char[]>> arena_;
+  /** Bytes used and available in the last arena block */
+  size_t arena_used_{0};
+  size_t arena_capacity_{0};
+  /** The open-addressing table, a power of two slots kept at most half full */
+  std::vector<Slot> slots_;
+  /** The groups in the order they were created */
+  std::vector<char *> entries_;
+  /** Approximate memory used by the groups */
+  size_t bytes_{0};
+
+  /** Whether any group was spilled */
+  bool spilled_{false};
+  /** The spill files of each partition */
+  std::vector<std::vector<std::unique_ptr<SpillFile>>> partitions_;
+
+  /** The next group to read if nothing was spilled, or the next partition to read otherwise */
+  size_t read_pos_{0};
+  /** The table of the partition being read */
+  std::unique_ptr<AggregationHashTable> partition_table_;
+};
+
+}  // namespace bustub
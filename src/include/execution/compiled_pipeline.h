@@ -0,0 +1,136 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// compiled_pipeline.h
+//
+// Identification: src/include/execution/compiled_pipeline.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "execution/expression_program.h"
+#include "execution/plans/abstract_plan.h"
+#include "execution/tuple_batch.h"
+
+namespace bustub {
+
+/**
+ * CompiledPipeline is a chain of filters and projections, optionally ending in the input of an aggregation, fused
+ * into two expression programs that run directly on the batches of the plan below the chain, the source.
+ *
+ * The expressions of every projection are inlined into the expressions above it, so that all predicates and the
+ * outputs of the chain are expressions over the columns of the source. The predicates are combined into one program
+ * that selects rows, and the outputs are compiled into one program, which computes them only for the selected rows.
+ * No batch is materialized between the operators of the chain, and columns read by several expressions are loaded
+ * once. The source itself, such as a scan or the probe of a hash join, is run by its own executor.
+ *
+ * A CompiledPipeline is immutable and may be shared by queries and threads; each user runs it with its own Runner.
+ */
+class CompiledPipeline {
+ public:
+  /**
+   * Compile the pipeline that ends at a plan node.
+   * @param plan a filter, projection or aggregation
+   * @return the pipeline, or nullptr if the plan does not start a chain of at least two operators that can be fused,
+   * or an expression of the chain cannot be compiled, in which case the chain is run by the interpreted executors
+   */
+  static auto Compile(const AbstractPlanNodeRef &plan) -> std::shared_ptr<const CompiledPipeline>;
+
+  /** @return the key under which the pipeline of a plan node is cached, the plan with all its children */
+  static auto Fingerprint(const AbstractPlanNode &plan) -> std::string { return plan.ToString(); }
+
+  /** @return whether the pipeline computes the group-by values and aggregate inputs of an aggregation */
+  auto IsAggregation() const -> bool { return is_aggregation_; }
+
+  /** @return whether the pipeline computes new columns, otherwise its output is the batch of the source */
+  auto IsProjected() const -> bool { return is_projected_; }
+
+  /**
+   * @param plan the plan the pipeline was compiled from, or a plan with the same fingerprint
+   * @return the plan node whose batches the pipeline consumes
+   */
+  auto GetSource(const AbstractPlanNode &plan) const -> const AbstractPlanNodeRef &;
+
+  /** @return the fused operators and their programs, for debugging */
+  auto ToString() const -> std::string;
+
+  /** The mutable state to run a pipeline; one per thread. */
+  class Runner {
+   public:
+    explicit Runner(const CompiledPipeline &pipeline);
+
+    /**
+     * Run the pipeline on a batch of the source.
+     * @param[in,out] batch the batch of the source, from which the rows the predicates reject are unselected
+     * @param[out] columns the values of the outputs for the selected rows, one vector per output, left untouched if
+     * the chain has no projection and its output is the batch itself
+     * @return false if no row of the batch is selected
+     */
+    auto Run(TupleBatch *batch, std::vector<std::vector<Value>> *columns) -> bool;
+
+   private:
+    const CompiledPipeline &pipeline_;
+    std::unique_ptr<ExpressionProgram> predicate_;
+    std::unique_ptr<ExpressionProgram> outputs_;
+    std::vector<uint32_t> selection_;
+    std::vector<std::vector<Value>> computed_;
+  };
+
+ private:
+  /** An output of the pipeline, either a column of the source or an expression of the outputs program */
+  struct Output {
+    bool is_column_;
+    /** The column of the source, or the expression's position in the outputs program */
+    uint32_t idx_;
+  };
+
+  CompiledPipeline() = default;
+
+  /** Number of filters and projections between the plan and the source */
+  size_t depth_{0};
+  bool is_aggregation_{false};
+  /** Whether the chain has a projection; otherwise the output is the source batch */
+  bool is_projected_{false};
+  /** The conjunction of all predicates, nullptr if there is no filter */
+  std::unique_ptr<const ExpressionProgram> predicate_;
+  /** The outputs that are not columns of the source, nullptr if there are none */
+  std::unique_ptr<const ExpressionProgram> outputs_;
+  std::vector<Output> output_map_;
+};
+
+/**
+ * PipelineCache keeps the compiled pipelines by the fingerprint of their plans, so that a query that is run again
+ * reuses them. Plans that cannot be compiled are cached too, as nullptr. It is shared by all queries of a BusTub
+ * instance and is thread-safe.
+ */
+class PipelineCache {
+ public:
+  /** The number of pipelines kept; the cache is emptied when it is full */
+  static constexpr size_t CAPACITY = 1024;
+
+  /** @return the compiled pipeline of a plan, compiling it if it is not cached, or nullptr if it cannot be compiled */
+  auto GetOrCompile(const AbstractPlanNodeRef &plan) -> std::shared_ptr<const CompiledPipeline>;
+
+  /** @return the number of lookups that found the plan */
+  auto GetHits() const -> size_t;
+
+  /** @return the number of lookups that compiled the plan */
+  auto GetMisses() const -> size_t;
+
+ private:
+  mutable std::mutex latch_;
+  std::unordered_map<std::string, std::shared_ptr<const CompiledPipeline>> pipelines_;
+  size_t hits_{0};
+  size_t misses_{0};
+};
+
+}  // namespace bustub
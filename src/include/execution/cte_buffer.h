@@ -0,0 +1,111 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// cte_buffer.h
+//
+// Identification: src/include/execution/cte_buffer.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "catalog/schema.h"
+#include "common/macros.h"
+#include "execution/spill_file.h"
+#include "execution/tuple_batch.h"
+#include "storage/table/tuple.h"
+
+namespace bustub {
+
+/**
+ * CTEBuffer holds the rows of a materialized common table expression, which every reference to it reads. Rows are
+ * kept in memory up to the memory limit of the query, and the rows past it go to a spill file in temporary pages of
+ * the buffer pool. Without a buffer pool manager all rows stay in memory.
+ *
+ * A buffer is written by one thread. Once it is written, any number of threads may read it at the same time.
+ */
+class CTEBuffer {
+ public:
+  /**
+   * @param bpm the buffer pool manager to spill to, may be nullptr
+   * @param schema the schema of the rows
+   * @param memory_limit number of bytes the rows may use in memory
+   */
+  CTEBuffer(BufferPoolManager *bpm, const Schema *schema, size_t memory_limit);
+
+  DISALLOW_COPY_AND_MOVE(CTEBuffer);
+
+  /** Append the rows of a batch. */
+  void Append(const TupleBatch &batch);
+
+  /** @return the number of rows in the buffer */
+  auto NumRows() const -> size_t { return rows_.size() + (spill_ == nullptr ? 0 : spill_->NumRows()); }
+
+  /** @return the number of rows that were spilled */
+  auto NumSpilledRows() const -> size_t { return spill_ == nullptr ? 0 : spill_->NumRows(); }
+
+  /** Reader reads the rows of a buffer in the order they were appended. */
+  class Reader {
+   public:
+    explicit Reader(const CTEBuffer *buffer);
+
+    /**
+     * Fill a batch with the next rows.
+     * @param schema the schema of the batch, which lays out its columns as the schema of the buffer does
+     * @return false if all rows were read
+     */
+    auto Next(const Schema *schema, TupleBatch *batch) -> bool;
+
+   private:
+    const CTEBuffer *buffer_;
+    /** The next in-memory row to read */
+    size_t row_{0};
+    std::optional<SpillFile::Reader> spill_reader_;
+  };
+
+ private:
+  BufferPoolManager *bpm_;
+  const Schema *schema_;
+  size_t memory_limit_;
+  /** The number of bytes the in-memory rows use */
+  size_t bytes_{0};
+  /** The first rows, which fit in memory */
+  std::vector<Tuple> rows_;
+  /** The rows past the memory limit, nullptr if there are none */
+  std::unique_ptr<SpillFile> spill_;
+};
+
+/**
+ * CTEBufferRegistry holds the materialized common table expressions of a query, by their id, so that the first
+ * reference to be initialized computes a CTE and the others read its rows. It is shared by all workers of the query.
+ */
+class CTEBufferRegistry {
+ public:
+  /**
+   * @param cte_id the id of the CTE, see CTEScanPlanNode
+   * @param materialize computes the CTE, only called by the first caller
+   * @return the materialized CTE
+   */
+  auto GetOrMaterialize(uint32_t cte_id, const std::function<std::shared_ptr<const CTEBuffer>()> &materialize)
+      -> std::shared_ptr<const CTEBuffer>;
+
+ private:
+  struct Slot {
+    std::once_flag once_;
+    std::shared_ptr<const CTEBuffer> buffer_;
+  };
+
+  std::mutex latch_;
+  std::unordered_map<uint32_t, std::shared_ptr<Slot>> slots_;
+};
+
+}  // namespace bustub
@@ -12,6 +12,8 @@
 
 #pragma once
 
+#include <functional>
+#include <mutex>  // NOLINT
 #include <vector>
 
 #include "buffer/buffer_pool_manager.h"
@@ -21,7 +23,9 @@
 #include "execution/executor_context.h"
 #include "execution/executor_factory.h"
 #include "execution/executors/init_check_executor.h"
+#include "execution/parallel_pipeline.h"
 #include "execution/plans/abstract_plan.h"
+#include "execution/tuple_batch.h"
 #include "storage/table/tuple.h"
 
 namespace bustub {
@@ -42,6 +46,9 @@ class ExecutionEngine {
 
   DISALLOW_COPY_AND_MOVE(ExecutionEngine);
 
+  /** Receives the tuples a query produces, one batch at a time, as soon as the root executor yields them */
+  using ResultConsumer = std::function<void(const TupleBatch &batch)>;
+
   /**
    * Execute a query plan.
    * @param plan The query plan to execute
@@ -53,23 +60,51 @@ class ExecutionEngine {
   // NOLINTNEXTLINE
   auto Execute(const AbstractPlanNodeRef &plan, std::vector<Tuple> *result_set, Transaction *txn,
                ExecutorContext *exec_ctx) -> bool {
-    BUSTUB_ASSERT((txn == exec_ctx->GetTransaction()), "Broken Invariant");
+    auto executor_succeeded = Execute(
+        plan,
+        [&](const TupleBatch &batch) {
+          if (result_set != nullptr) {
+            for (uint32_t i = 0; i < batch.Size(); i++) {
+              result_set->push_back(batch.GetTuple(i));
+            }
+          }
+        },
+        txn, exec_ctx);
+    if (!executor_succeeded && result_set != nullptr) {
+      result_set->clear();
+    }
+    return executor_succeeded;
+  }
 
-    // Construct the executor for the abstract plan node
-    auto executor = ExecutorFactory::CreateExecutor(exec_ctx, plan);
+  /**
+   * Execute a query plan, and stream its results: each batch is passed to `consume` as soon as it is produced, so the
+   * results are never held in memory as a whole. If the query fails, the batches consumed so far are not taken back.
+   * @param plan The query plan to execute
+   * @param consume Called with each batch of tuples produced by executing the plan, never concurrently
+   * @param txn The transaction context in which the query executes
+   * @param exec_ctx The executor context in which the query executes
+   * @return `true` if execution of the query plan succeeds, `false` otherwise
+   */
+  // NOLINTNEXTLINE
+  auto Execute(const AbstractPlanNodeRef &plan, const ResultConsumer &consume, Transaction *txn,
+               ExecutorContext *exec_ctx) -> bool {
+    BUSTUB_ASSERT((txn == exec_ctx->GetTransaction()), "Broken Invariant");
 
-    // Initialize the executor
     auto executor_succeeded = true;
 
     try {
-      executor->Init();
-      PollExecutor(executor.get(), plan, result_set);
+      if (exec_ctx->GetDegreeOfParallelism() > 1 && ParallelPipeline::CanRunInParallel(*plan)) {
+        // Every worker builds its own executor tree.
+        PollParallel(exec_ctx, plan, consume);
+      } else {
+        // Construct the executor for the abstract plan node, and initialize it
+        auto executor = ExecutorFactory::CreateExecutor(exec_ctx, plan);
+        executor->Init();
+        PollExecutor(executor.get(), plan, consume);
+      }
       PerformChecks(exec_ctx);
     } catch (const ExecutionException &ex) {
       executor_succeeded = false;
-      if (result_set != nullptr) {
-        result_set->clear();
-      }
     }
 
     return executor_succeeded;
@@ -90,17 +125,49 @@ class ExecutionEngine {
    * Poll the executor until exhausted, or exception escapes.
    * @param executor The root executor
    * @param plan The plan to execute
-   * @param result_set The tuple result set
+   * @param consume Called with each batch of results
    */
   static void PollExecutor(AbstractExecutor *executor, const AbstractPlanNodeRef &plan,
-                           std::vector<Tuple> *result_set) {
+                           const ResultConsumer &consume) {
+    TupleBatch batch;
+    if (executor->SupportsBatch()) {
+      while (executor->NextBatch(&batch)) {
+        consume(batch);
+      }
+      return;
+    }
+
+    // Gather the tuples of a tuple-at-a-time executor into batches.
     RID rid{};
     Tuple tuple{};
+    batch.Reset(&executor->GetOutputSchema());
     while (executor->Next(&tuple, &rid)) {
-      if (result_set != nullptr) {
-        result_set->push_back(tuple);
+      batch.AppendTuple(tuple);
+      if (batch.IsFull()) {
+        consume(batch);
+        batch.Reset(&executor->GetOutputSchema());
       }
     }
+    if (!batch.Empty()) {
+      consume(batch);
+    }
+  }
+
+  /**
+   * Run a plan that is a parallel pipeline on all the threads the query may use, and pass on the results as the
+   * workers produce them. The results come in no particular order.
+   * @param exec_ctx The executor context of the query
+   * @param plan The plan to execute
+   * @param consume Called with each batch of results, by one worker at a time
+   */
+  static void PollParallel(ExecutorContext *exec_ctx, const AbstractPlanNodeRef &plan,
+                           const ResultConsumer &consume) {
+    std::mutex consume_latch;
+    ParallelPipeline pipeline(exec_ctx, plan, exec_ctx->GetDegreeOfParallelism());
+    pipeline.Run([&](size_t worker, TupleBatch *batch) {
+      std::scoped_lock lock(consume_latch);
+      consume(*batch);
+    });
   }
 
   [[maybe_unused]] BufferPoolManager *bpm_;
@@ -26,6 +26,10 @@
 
 namespace bustub {
 class AbstractExecutor;
+class ParallelContext;
+class PipelineCache;
+class RuntimeFilterRegistry;
+class CTEBufferRegistry;
 /**
  * ExecutorContext stores all the context necessary to run an executor.
  */
@@ -93,6 +97,52 @@ class ExecutorContext {
 
   auto IsDelete() const -> bool { return is_delete_; }
 
+  /** @return the number of threads a query may use, 1 runs the query on the calling thread only */
+  auto GetDegreeOfParallelism() const -> size_t { return degree_of_parallelism_; }
+
+  void SetDegreeOfParallelism(size_t degree_of_parallelism) {
+    BUSTUB_ASSERT(degree_of_parallelism > 0, "degree of parallelism must be positive");
+    degree_of_parallelism_ = degree_of_parallelism;
+  }
+
+  /** @return the number of bytes an operator may keep in memory before it spills to temporary pages */
+  auto GetMemoryLimit() const -> size_t { return memory_limit_; }
+
+  void SetMemoryLimit(size_t memory_limit) { memory_limit_ = memory_limit; }
+
+  /** @return the number of bytes a sort may keep in memory before it writes sorted runs to temporary pages */
+  auto GetSortMemoryBudget() const -> size_t { return sort_memory_budget_; }
+
+  void SetSortMemoryBudget(size_t sort_memory_budget) { sort_memory_budget_ = sort_memory_budget; }
+
+  /** @return the state shared with the other workers of a parallel pipeline, nullptr if not running in one */
+  auto GetParallelContext() -> ParallelContext * { return parallel_ctx_.get(); }
+
+  void SetParallelContext(std::shared_ptr<ParallelContext> parallel_ctx) { parallel_ctx_ = std::move(parallel_ctx); }
+
+  /** @return the cache of compiled pipelines, nullptr if pipelines are not compiled */
+  auto GetPipelineCache() const -> PipelineCache * { return pipeline_cache_; }
+
+  void SetPipelineCache(PipelineCache *pipeline_cache) { pipeline_cache_ = pipeline_cache; }
+
+  /** @return the runtime filters of the query, nullptr if joins do not push runtime filters into scans */
+  auto GetRuntimeFilters() const -> RuntimeFilterRegistry * { return runtime_filters_.get(); }
+
+  /** @return the runtime filters of the query, to share them with the contexts of its workers */
+  auto GetSharedRuntimeFilters() const -> std::shared_ptr<RuntimeFilterRegistry> { return runtime_filters_; }
+
+  void SetRuntimeFilters(std::shared_ptr<RuntimeFilterRegistry> runtime_filters) {
+    runtime_filters_ = std::move(runtime_filters);
+  }
+
+  /** @return the materialized CTEs of the query, nullptr if each CTE scan computes its CTE itself */
+  auto GetCTEBuffers() const -> CTEBufferRegistry * { return cte_buffers_.get(); }
+
+  /** @return the materialized CTEs of the query, to share them with the contexts of its workers */
+  auto GetSharedCTEBuffers() const -> std::shared_ptr<CTEBufferRegistry> { return cte_buffers_; }
+
+  void SetCTEBuffers(std::shared_ptr<CTEBufferRegistry> cte_buffers) { cte_buffers_ = std::move(cte_buffers); }
+
  private:
   /** The transaction context associated with this executor context */
   Transaction *transaction_;
@@ -109,6 +159,20 @@ class ExecutorContext {
   /** The set of check options associated with this executor context */
   std::shared_ptr<CheckOptions> check_options_;
   bool is_delete_;
+  /** The number of threads the query may use */
+  size_t degree_of_parallelism_{1};
+  /** The number of bytes an operator may keep in memory */
+  size_t memory_limit_{DEFAULT_MEMORY_LIMIT};
+  /** The number of bytes a sort may keep in memory */
+  size_t sort_memory_budget_{DEFAULT_MEMORY_LIMIT};
+  /** The state of the parallel pipeline this context belongs to, if any */
+  std::shared_ptr<ParallelContext> parallel_ctx_;
+  /** The compiled pipelines, shared by all queries */
+  PipelineCache *pipeline_cache_{nullptr};
+  /** The runtime filters of the query, shared by all its workers */
+  std::shared_ptr<RuntimeFilterRegistry> runtime_filters_;
+  /** The materialized CTEs of the query, shared by all its workers */
+  std::shared_ptr<CTEBufferRegistry> cte_buffers_;
 };
 
 }  // namespace bustub
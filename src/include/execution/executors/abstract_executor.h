@@ -12,7 +12,10 @@
 
 #pragma once
 
+#include <memory>
+
 #include "execution/executor_context.h"
+#include "execution/tuple_batch.h"
 #include "storage/table/tuple.h"
 
 namespace bustub {
@@ -21,6 +24,11 @@ class ExecutorContext;
  * The AbstractExecutor implements the Volcano tuple-at-a-time iterator model.
  * This is the base class from which all executors in the BustTub execution
  * engine inherit, and defines the minimal interface that all executors support.
+ *
+ * Executors may also produce batches of rows with NextBatch(), which saves a virtual call and a tuple per row.
+ * Executors that don't implement it natively produce batches by calling Next(), and executors that only implement
+ * batches can implement Next() with NextFromBatch(). A consumer must stick to one of the two interfaces between
+ * calls to Init().
  */
 class AbstractExecutor {
  public:
@@ -47,6 +55,16 @@ class AbstractExecutor {
    */
   virtual auto Next(Tuple *tuple, RID *rid) -> bool = 0;
 
+  /**
+   * Yield the next batch of rows from this executor. The default implementation fills the batch with Next().
+   * @param[out] batch The next rows produced by this executor, reset to the output schema of this executor
+   * @return `true` if at least one row was produced, `false` if there are no more rows
+   */
+  virtual auto NextBatch(TupleBatch *batch) -> bool;
+
+  /** @return `true` if this executor and all executors below it implement NextBatch() natively */
+  virtual auto SupportsBatch() const -> bool { return false; }
+
   /** @return The schema of the tuples that this executor produces */
   virtual auto GetOutputSchema() const -> const Schema & = 0;
 
@@ -54,7 +72,24 @@ class AbstractExecutor {
   auto GetExecutorContext() -> ExecutorContext * { return exec_ctx_; }
 
  protected:
+  /**
+   * Implements Next() on top of NextBatch(), for executors that natively produce batches. Such executors must call
+   * ResetBatchAdapter() in Init().
+   */
+  auto NextFromBatch(Tuple *tuple, RID *rid) -> bool;
+
+  /** Drop the rows buffered by NextFromBatch(). */
+  void ResetBatchAdapter() {
+    adapter_batch_ = nullptr;
+    adapter_pos_ = 0;
+  }
+
   /** The executor context in which the executor runs */
   ExecutorContext *exec_ctx_;
+
+ private:
+  /** Rows produced by NextBatch() and not yet returned by NextFromBatch() */
+  std::unique_ptr<TupleBatch> adapter_batch_;
+  uint32_t adapter_pos_{0};
 };
 }  // namespace bustub
@@ -0,0 +1,81 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// compiled_pipeline_executor.h
+//
+// Identification: src/include/execution/executors/compiled_pipeline_executor.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "execution/compiled_pipeline.h"
+#include "execution/executor_context.h"
+#include "execution/executors/abstract_executor.h"
+#include "execution/plans/abstract_plan.h"
+
+namespace bustub {
+
+/**
+ * CompiledPipelineExecutor runs a chain of filters and projections as one CompiledPipeline on the batches of the
+ * executor of its source, in place of the executors of the chain.
+ */
+class CompiledPipelineExecutor : public AbstractExecutor {
+ public:
+  /**
+   * Construct a new CompiledPipelineExecutor instance.
+   * @param exec_ctx The executor context
+   * @param plan The topmost plan node of the chain
+   * @param pipeline The chain compiled
+   * @param source_executor The executor of the source of the pipeline
+   */
+  CompiledPipelineExecutor(ExecutorContext *exec_ctx, const AbstractPlanNode *plan,
+                           std::shared_ptr<const CompiledPipeline> pipeline,
+                           std::unique_ptr<AbstractExecutor> &&source_executor);
+
+  /** Initialize the pipeline */
+  void Init() override;
+
+  /**
+   * Yield the next tuple from the pipeline.
+   * @param[out] tuple The next tuple produced by the pipeline
+   * @param[out] rid The next tuple RID produced by the pipeline
+   * @return `true` if a tuple was produced, `false` if there are no more tuples
+   */
+  auto Next(Tuple *tuple, RID *rid) -> bool override;
+
+  /**
+   * Yield the next batch of tuples from the pipeline.
+   * @param[out] batch The next tuples produced by the pipeline
+   * @return `true` if a tuple was produced, `false` if there are no more tuples
+   */
+  auto NextBatch(TupleBatch *batch) -> bool override;
+
+  auto SupportsBatch() const -> bool override { return source_executor_->SupportsBatch(); }
+
+  /** @return The output schema of the topmost plan node of the chain */
+  auto GetOutputSchema() const -> const Schema & override { return plan_->OutputSchema(); }
+
+ private:
+  /** The topmost plan node of the chain */
+  const AbstractPlanNode *plan_;
+
+  /** The compiled chain, which the runner refers to */
+  std::shared_ptr<const CompiledPipeline> pipeline_;
+
+  /** The executor from which batches are obtained */
+  std::unique_ptr<AbstractExecutor> source_executor_;
+
+  CompiledPipeline::Runner runner_;
+
+  /** The current batch of the source, if the pipeline computes new columns */
+  TupleBatch source_batch_;
+
+  std::vector<std::vector<Value>> columns_;
+};
+
+}  // namespace bustub
@@ -0,0 +1,71 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// cte_scan_executor.h
+//
+// Identification: src/include/execution/executors/cte_scan_executor.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <memory>
+#include <optional>
+
+#include "execution/cte_buffer.h"
+#include "execution/executor_context.h"
+#include "execution/executors/abstract_executor.h"
+#include "execution/plans/cte_scan_plan.h"
+#include "storage/table/tuple.h"
+
+namespace bustub {
+
+/**
+ * CTEScanExecutor reads a materialized common table expression. The CTE is computed by the first scan of the query
+ * to be initialized and kept in a CTEBuffer, which the other scans of it, and the same scan once it is initialized
+ * again, read without computing it again.
+ */
+class CTEScanExecutor : public AbstractExecutor {
+ public:
+  /**
+   * Construct a new CTEScanExecutor instance.
+   * @param exec_ctx The executor context
+   * @param plan The CTE scan plan to be executed
+   * @param child_executor The executor of the plan of the CTE
+   */
+  CTEScanExecutor(ExecutorContext *exec_ctx, const CTEScanPlanNode *plan,
+                  std::unique_ptr<AbstractExecutor> &&child_executor);
+
+  /** Initialize the scan, materializing the CTE if no other scan did. */
+  void Init() override;
+
+  /**
+   * Yield the next row of the CTE.
+   * @param[out] tuple The next tuple
+   * @param[out] rid The next tuple's RID
+   * @return `true` if a tuple was produced, `false` if there are no more tuples
+   */
+  auto Next(Tuple *tuple, RID *rid) -> bool override { return NextFromBatch(tuple, rid); }
+
+  /** Fill a batch with the next rows of the CTE. */
+  auto NextBatch(TupleBatch *batch) -> bool override;
+
+  auto SupportsBatch() const -> bool override { return true; }
+
+  /** @return The output schema for the CTE scan */
+  auto GetOutputSchema() const -> const Schema & override { return plan_->OutputSchema(); }
+
+ private:
+  /** @return the rows of the CTE, computed by the child executor */
+  auto Materialize() -> std::shared_ptr<const CTEBuffer>;
+
+  /** The CTE scan plan node to be executed */
+  const CTEScanPlanNode *plan_;
+  /** The executor of the plan of the CTE, only run by the scan that materializes it */
+  std::unique_ptr<AbstractExecutor> child_executor_;
+  std::shared_ptr<const CTEBuffer> buffer_;
+  std::optional<CTEBuffer::Reader> reader_;
+};
+
+}  // namespace bustub
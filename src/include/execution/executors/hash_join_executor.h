@@ -13,17 +13,36 @@
 #pragma once
 
 #include <memory>
+#include <optional>
+#include <unordered_map>
 #include <utility>
+#include <vector>
 
 #include "execution/executor_context.h"
 #include "execution/executors/abstract_executor.h"
+#include "execution/join_hash_table.h"
 #include "execution/plans/hash_join_plan.h"
+#include "execution/runtime_filter.h"
+#include "execution/spill_file.h"
 #include "storage/table/tuple.h"
 
 namespace bustub {
 
 /**
- * HashJoinExecutor executes a nested-loop JOIN on two tables.
+ * HashJoinExecutor executes a JOIN on two tables with a hash table. The right child is the build side: its rows go
+ * into a radix-partitioned JoinHashTable, which spills partitions when it exceeds the memory limit of the query. The
+ * rows of the left child then probe the table a batch at a time. Left rows whose partition was spilled are spilled as
+ * well, and every spilled partition is joined afterwards, the same way, with a table of its own.
+ *
+ * In a parallel pipeline, the top-level table is built by one worker and probed by all of them, and every worker
+ * joins the spilled partitions for the left rows it spilled.
+ *
+ * Semi and anti joins emit each left row at most once, without the right columns: semi joins on its first match,
+ * anti joins if it has none.
+ *
+ * If the join drops left rows without a match and its left keys are columns of a scan below it, it builds a Bloom
+ * filter of the right keys along with the table, and pushes it into that scan as a RuntimeFilter, so that left rows
+ * that cannot match are dropped before the operators between the scan and the join process them.
  */
 class HashJoinExecutor : public AbstractExecutor {
  public:
@@ -48,12 +67,114 @@ class HashJoinExecutor : public AbstractExecutor {
    */
   auto Next(Tuple *tuple, RID *rid) -> bool override;
 
+  /**
+   * Yield the next batch of tuples from the join.
+   * @param[out] batch The next tuples produced by the join
+   * @return `true` if a tuple was produced, `false` if there are no more tuples
+   */
+  auto NextBatch(TupleBatch *batch) -> bool override;
+
+  auto SupportsBatch() const -> bool override {
+    return left_executor_->SupportsBatch() && right_executor_->SupportsBatch();
+  }
+
   /** @return The output schema for the join */
   auto GetOutputSchema() const -> const Schema & override { return plan_->OutputSchema(); };
 
  private:
-  /** The NestedLoopJoin plan node to be executed. */
+  /** A spilled partition that still has to be joined. */
+  struct SpilledTask {
+    /** The right rows of the partition */
+    std::shared_ptr<const SpillFile> build_rows_;
+    /** The level of the table to build from them */
+    uint32_t level_;
+    /** The left rows of the partition, nullptr if there are none */
+    std::unique_ptr<SpillFile> probe_rows_;
+  };
+
+  /** @return whether left rows without a match are part of the result */
+  auto EmitsUnmatchedLeft() const -> bool {
+    return plan_->GetJoinType() == JoinType::LEFT || plan_->GetJoinType() == JoinType::OUTER ||
+           plan_->GetJoinType() == JoinType::ANTI;
+  }
+
+  /** @return whether the result is made of left rows only, which the first match of a left row decides on */
+  auto EmitsLeftOnly() const -> bool {
+    return plan_->GetJoinType() == JoinType::SEMI || plan_->GetJoinType() == JoinType::ANTI;
+  }
+
+  /** @return whether right rows without a match are part of the result */
+  auto EmitsUnmatchedRight() const -> bool {
+    return plan_->GetJoinType() == JoinType::RIGHT || plan_->GetJoinType() == JoinType::OUTER;
+  }
+
+  /** Run the right child and build the top-level hash table from its rows */
+  auto BuildHashTable() -> std::shared_ptr<const JoinHashTable>;
+
+  /** Insert a batch of right rows into a table, and append the runtime filter hashes of their keys to `hashes` */
+  void InsertBatch(JoinHashTable *table, const TupleBatch &batch, std::vector<hash_t> *hashes = nullptr) const;
+
+  /** Start probing a table, with the left child or with spilled left rows (nullptr for none) */
+  void StartProbe(std::shared_ptr<const JoinHashTable> table, std::unique_ptr<SpillFile> probe_rows);
+
+  /** Start joining the next spilled partition. @return false if there is none left */
+  auto StartNextSpilledTask() -> bool;
+
+  /** @return the next batch of left rows, evaluating their keys */
+  auto NextProbeBatch() -> bool;
+
+  /** Probe the table with left rows until the batch is full or the left rows are exhausted */
+  void Probe(TupleBatch *batch);
+
+  /** Emit the right rows that found no match until the batch is full or all were emitted */
+  void EmitUnmatchedRight(TupleBatch *batch);
+
+  /** Append the current left row joined with `right_row` (or with nulls, if nullptr) to the batch. Semi and anti
+   * joins append the left row alone. */
+  void EmitRow(TupleBatch *batch, const Tuple *right_row);
+
+  /** Append `right_row` joined with nulls to the batch. */
+  void EmitRightOnly(TupleBatch *batch, const Tuple &right_row);
+
+  /** The HashJoin plan node to be executed. */
   const HashJoinPlanNode *plan_;
+
+  std::unique_ptr<AbstractExecutor> left_executor_;
+  std::unique_ptr<AbstractExecutor> right_executor_;
+
+  /** The scan the runtime filter of the join is pushed into, if any */
+  std::optional<RuntimeFilter::Target> runtime_filter_target_;
+
+  /** The table being probed */
+  std::shared_ptr<const JoinHashTable> table_;
+  /** Whether each in-memory right row of the table found a match, for right and outer joins */
+  std::vector<bool> matched_;
+  /** The spilled left rows being probed, nullptr when probing with the left child */
+  std::unique_ptr<SpillFile> probe_rows_;
+  std::optional<SpillFile::Reader> probe_reader_;
+  bool probing_left_child_{false};
+  /** The left rows of each spilled partition of the table */
+  std::unordered_map<const JoinHashTable::Partition *, std::unique_ptr<SpillFile>> probe_spills_;
+  /** The spilled partitions left to join */
+  std::vector<SpilledTask> spilled_tasks_;
+
+  /** The current batch of left rows and their join keys */
+  TupleBatch left_batch_;
+  std::vector<std::vector<Value>> left_keys_;
+  /** The left row being joined */
+  uint32_t left_pos_{0};
+  bool left_done_{false};
+
+  /** The leaf partition the current left row is being matched in, if any, and its key, hash and probe position */
+  const JoinHashTable::Partition *match_partition_{nullptr};
+  HashJoinKey match_key_;
+  hash_t match_hash_{0};
+  size_t match_pos_{0};
+  bool row_matched_{false};
+
+  /** The next leaf partition and row to look for unmatched right rows in */
+  size_t unmatched_leaf_{0};
+  size_t unmatched_row_{0};
 };
 
 }  // namespace bustub
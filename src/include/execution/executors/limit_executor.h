@@ -21,7 +21,8 @@
 namespace bustub {
 
 /**
- * LimitExecutor limits the number of output tuples produced by a child operator.
+ * LimitExecutor limits the number of output tuples produced by a child operator. It stops pulling from the child as
+ * soon as it has produced the limit, so the child never produces more than one batch past it.
  */
 class LimitExecutor : public AbstractExecutor {
  public:
@@ -45,6 +46,15 @@ class LimitExecutor : public AbstractExecutor {
    */
   auto Next(Tuple *tuple, RID *rid) -> bool override;
 
+  /**
+   * Yield the next batch of tuples from the limit.
+   * @param[out] batch The next tuples produced by the limit
+   * @return `true` if a tuple was produced, `false` if there are no more tuples
+   */
+  auto NextBatch(TupleBatch *batch) -> bool override;
+
+  auto SupportsBatch() const -> bool override { return child_executor_->SupportsBatch(); }
+
   /** @return The output schema for the limit */
   auto GetOutputSchema() const -> const Schema & override { return plan_->OutputSchema(); };
 
@@ -54,5 +64,8 @@ class LimitExecutor : public AbstractExecutor {
 
   /** The child executor from which tuples are obtained */
   std::unique_ptr<AbstractExecutor> child_executor_;
+
+  /** The number of tuples produced since Init */
+  size_t num_produced_{0};
 };
 }  // namespace bustub
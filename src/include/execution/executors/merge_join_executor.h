@@ -0,0 +1,148 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// merge_join_executor.h
+//
+// Identification: src/include/execution/executors/merge_join_executor.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "execution/executor_context.h"
+#include "execution/executors/abstract_executor.h"
+#include "execution/plans/merge_join_plan.h"
+#include "execution/tuple_batch.h"
+#include "storage/table/tuple.h"
+
+namespace bustub {
+
+/**
+ * MergeJoinExecutor executes a JOIN on two inputs that are sorted in ascending order on their join keys. Both inputs
+ * are read once, in step: the right rows that share a key with the current left row are collected into a group, and
+ * every left row with that key is joined with the whole group, so duplicate keys on both sides produce all their
+ * combinations. Rows whose key contains a null
+ * never match, wherever the inputs sorted them.
+ *
+ * All join types are supported: unmatched rows of either side are padded with nulls as soon as the other side has
+ * moved past their key.
+ */
+class MergeJoinExecutor : public AbstractExecutor {
+ public:
+  /**
+   * Construct a new MergeJoinExecutor instance.
+   * @param exec_ctx The executor context
+   * @param plan The merge join plan to be executed
+   * @param left_child The child executor that produces tuples for the left side of join
+   * @param right_child The child executor that produces tuples for the right side of join
+   */
+  MergeJoinExecutor(ExecutorContext *exec_ctx, const MergeJoinPlanNode *plan,
+                    std::unique_ptr<AbstractExecutor> &&left_child, std::unique_ptr<AbstractExecutor> &&right_child);
+
+  /** Initialize the join */
+  void Init() override;
+
+  /**
+   * Yield the next tuple from the join.
+   * @param[out] tuple The next tuple produced by the join.
+   * @param[out] rid The next tuple RID, not used by merge join.
+   * @return `true` if a tuple was produced, `false` if there are no more tuples.
+   */
+  auto Next(Tuple *tuple, RID *rid) -> bool override;
+
+  /**
+   * Yield the next batch of tuples from the join.
+   * @param[out] batch The next tuples produced by the join
+   * @return `true` if a tuple was produced, `false` if there are no more tuples
+   */
+  auto NextBatch(TupleBatch *batch) -> bool override;
+
+  auto SupportsBatch() const -> bool override {
+    return left_executor_->SupportsBatch() && right_executor_->SupportsBatch();
+  }
+
+  /** @return The output schema for the join */
+  auto GetOutputSchema() const -> const Schema & override { return plan_->OutputSchema(); };
+
+ private:
+  /** Cursor reads the rows of a child one at a time, with their join keys, from batches. */
+  class Cursor {
+   public:
+    Cursor(AbstractExecutor *executor, const std::vector<AbstractExpressionRef> &key_exprs)
+        : executor_(executor), key_exprs_(key_exprs), keys_(key_exprs.size()) {}
+
+    /** Start reading from the first row. */
+    void Init();
+
+    /** Move to the next row. */
+    void Advance();
+
+    /** @return whether the cursor is at a row, false at the end of the input */
+    auto Valid() const -> bool { return pos_ < batch_.Size(); }
+
+    /** @return the i-th key value of the current row */
+    auto Key(size_t i) const -> const Value & { return keys_[i][pos_]; }
+
+    /** @return whether a key value of the current row is null */
+    auto KeyHasNull() const -> bool;
+
+    /** @return the key of the current row */
+    auto GetKey() const -> std::vector<Value>;
+
+    /** @return the values of the current row */
+    auto GetValues() const -> std::vector<Value>;
+
+   private:
+    /** Read the next batch that has rows. */
+    void LoadBatch();
+
+    AbstractExecutor *executor_;
+    const std::vector<AbstractExpressionRef> &key_exprs_;
+    TupleBatch batch_;
+    /** keys_[i][row] is the value of the i-th key expression for a row of the batch */
+    std::vector<std::vector<Value>> keys_;
+    uint32_t pos_{0};
+  };
+
+  /** @return <0, 0 or >0 as the key of the current left row is less than, equal to or greater than the right one */
+  auto CompareKeys(const Cursor &left, const Cursor &right) const -> int;
+
+  /** @return whether the key of the current row of a cursor equals the key of the group */
+  auto InGroup(const Cursor &cursor) const -> bool;
+
+  /** Append a row of left values and right values to a batch, null for a missing side. */
+  void Emit(TupleBatch *batch, const std::vector<Value> *left, const std::vector<Value> *right) const;
+
+  /** @return whether unmatched left rows are produced */
+  auto KeepsLeft() const -> bool {
+    return plan_->GetJoinType() == JoinType::LEFT || plan_->GetJoinType() == JoinType::OUTER;
+  }
+
+  /** @return whether unmatched right rows are produced */
+  auto KeepsRight() const -> bool {
+    return plan_->GetJoinType() == JoinType::RIGHT || plan_->GetJoinType() == JoinType::OUTER;
+  }
+
+  /** The merge join plan node to be executed */
+  const MergeJoinPlanNode *plan_;
+  std::unique_ptr<AbstractExecutor> left_executor_;
+  std::unique_ptr<AbstractExecutor> right_executor_;
+  Cursor left_;
+  Cursor right_;
+
+  /** The key and the values of the right rows in the current group, which all match the current left key */
+  std::vector<Value> group_key_;
+  std::vector<std::vector<Value>> group_;
+  /** The values of the current left row while it is joined with the group */
+  std::vector<Value> left_values_;
+  bool joining_left_{false};
+  /** The next row of the group to join the current left row with */
+  size_t group_pos_{0};
+};
+
+}  // namespace bustub
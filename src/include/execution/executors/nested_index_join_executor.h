@@ -22,6 +22,7 @@
 #include "execution/executors/abstract_executor.h"
 #include "execution/expressions/abstract_expression.h"
 #include "execution/plans/nested_index_join_plan.h"
+#include "execution/tuple_batch.h"
 #include "storage/table/tmp_tuple.h"
 #include "storage/table/tuple.h"
 
@@ -29,6 +30,12 @@ namespace bustub {
 
 /**
  * IndexJoinExecutor executes index join operations.
+ *
+ * The outer rows are joined a batch at a time. The keys of a batch are sorted and each distinct key probes the index
+ * once, so that probes for neighbouring keys follow each other down the same path of the B+ tree and hit the pages
+ * the previous probe left in the buffer pool. The inner tuples the probes found are then read in the order of their
+ * RIDs, which reads every page of the inner table once per batch, before the joined rows are produced in the order
+ * of the outer rows.
  */
 class NestIndexJoinExecutor : public AbstractExecutor {
  public:
@@ -47,8 +54,37 @@ class NestIndexJoinExecutor : public AbstractExecutor {
 
   auto Next(Tuple *tuple, RID *rid) -> bool override;
 
+  /**
+   * Yield the next batch of tuples from the join.
+   * @param[out] batch The next tuples produced by the join
+   * @return `true` if a tuple was produced, `false` if there are no more tuples
+   */
+  auto NextBatch(TupleBatch *batch) -> bool override;
+
+  auto SupportsBatch() const -> bool override { return child_executor_->SupportsBatch(); }
+
  private:
+  /** Probe the index with the keys of outer_batch_ and read the inner tuples they match into matches_. */
+  void ProbeBatch();
+
+  /** Append the current outer row joined with `inner` (or with nulls, if nullptr) to the batch. */
+  void EmitRow(TupleBatch *batch, const Tuple *inner);
+
   /** The nested index join plan node. */
   const NestedIndexJoinPlanNode *plan_;
+  /** The executor of the outer table */
+  std::unique_ptr<AbstractExecutor> child_executor_;
+  IndexInfo *index_info_{nullptr};
+  TableInfo *table_info_{nullptr};
+
+  /** The outer rows being joined */
+  TupleBatch outer_batch_;
+  /** The distinct key each outer row probed with, as an index into matches_, or -1 for a null key */
+  std::vector<int64_t> probe_of_row_;
+  /** The inner tuples each distinct key matches */
+  std::vector<std::vector<Tuple>> matches_;
+  /** The current outer row, and its next match */
+  uint32_t outer_pos_{0};
+  size_t match_pos_{0};
 };
 }  // namespace bustub
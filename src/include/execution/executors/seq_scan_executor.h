@@ -12,17 +12,24 @@
 
 #pragma once
 
+#include <memory>
 #include <vector>
 
 #include "execution/executor_context.h"
 #include "execution/executors/abstract_executor.h"
+#include "execution/expression_program.h"
+#include "execution/morsel.h"
 #include "execution/plans/seq_scan_plan.h"
+#include "execution/runtime_filter.h"
+#include "storage/table/scan_predicate.h"
+#include "storage/table/table_iterator.h"
 #include "storage/table/tuple.h"
 
 namespace bustub {
 
 /**
- * The SeqScanExecutor executor executes a sequential table scan.
+ * The SeqScanExecutor executor executes a sequential table scan. In a parallel pipeline, it scans the morsels of the
+ * table it is handed instead of the whole table.
  */
 class SeqScanExecutor : public AbstractExecutor {
  public:
@@ -37,18 +44,85 @@ class SeqScanExecutor : public AbstractExecutor {
   void Init() override;
 
   /**
-   * Yield the next tuple from the sequential scan.
+   * Yield the next tuple from the sequential scan. The tuples are read a batch at a time with NextBatch, so that the
+   * comparisons pushed into the table iterator, the runtime filters and the TopN bounds apply to this path as well.
    * @param[out] tuple The next tuple produced by the scan
    * @param[out] rid The next tuple RID produced by the scan
    * @return `true` if a tuple was produced, `false` if there are no more tuples
    */
   auto Next(Tuple *tuple, RID *rid) -> bool override;
 
+  /**
+   * Yield the next batch of tuples from the sequential scan. The filter predicate is evaluated on the tuples in place
+   * in their pages, and only the tuples that pass are copied. Its comparisons of fixed-width columns against constants
+   * are pushed down into the table iterator, which applies them to a whole page before any tuple is looked at. The
+   * runtime filters that joins above the scan pushed into it are applied last, and the bounds of the TopNs above it
+   * join the comparisons pushed into the table iterator as they tighten. The tuples of a columnar table are not
+   * copied but returned as rows of the column chunks they were read into, whose columns are decoded only when an
+   * operator reads them.
+   * @param[out] batch The next tuples produced by the scan
+   * @return `true` if a tuple was produced, `false` if there are no more tuples
+   */
+  auto NextBatch(TupleBatch *batch) -> bool override;
+
+  auto SupportsBatch() const -> bool override { return true; }
+
   /** @return The output schema for the sequential scan */
   auto GetOutputSchema() const -> const Schema & override { return plan_->OutputSchema(); }
 
  private:
+  /** Look up the runtime filters pushed into the scan, the first time it is asked for tuples after Init. */
+  void FetchRuntimeFilters();
+
+  /** @return the predicate for the table iterator, with the current TopN bounds, nullptr if it has no terms */
+  auto GetScanPredicate() -> ScanPredicate *;
+
+  /** @return whether the scan has tuples left, moving on to the next morsel when the current one is done */
+  auto HasNext() -> bool;
+
+  /** Filter the tuples read in place from a page, and append copies of the ones that pass to `batch`. */
+  void ScanPage(const TableIterator::TupleViews &tuples, TupleBatch *batch);
+
+  /** Filter the tuples of a column chunk, and append the rows of the ones that pass to `batch`. */
+  void ScanChunk(const std::shared_ptr<const ColumnChunk> &chunk, TupleBatch *batch);
+
+  /** Unselect the tuples of page_batch_ that the residual predicate or a runtime filter drops. */
+  void FilterPageBatch();
+
   /** The sequential scan plan node to be executed */
   const SeqScanPlanNode *plan_;
+
+  /** The table being scanned */
+  TableInfo *table_info_{nullptr};
+
+  /** The position of the scan */
+  std::unique_ptr<TableIterator> iter_;
+
+  /** Whether the table is read column by column */
+  bool columnar_{false};
+
+  /** The morsels left to scan, nullptr if the scan covers the whole table */
+  MorselQueue *morsels_{nullptr};
+
+  /** The terms of the filter predicate that the table iterator evaluates on the pages */
+  ScanPredicate scan_predicate_;
+
+  /** The rest of the filter predicate, nullptr if it was pushed down entirely */
+  AbstractExpressionRef residual_predicate_;
+
+  /** The residual predicate compiled for batches, nullptr if there is none or it has to be evaluated as a tree */
+  std::unique_ptr<ExpressionProgram> predicate_program_;
+
+  /** The runtime filters of the joins above the scan, and whether they were looked up since Init */
+  std::vector<std::shared_ptr<const RuntimeFilter>> runtime_filters_;
+  bool runtime_filters_fetched_{false};
+
+  /** The bounds of the TopNs above the scan, and scan_predicate_ with them as of the sum of their versions */
+  std::vector<std::shared_ptr<const TopNBound>> topn_bounds_;
+  ScanPredicate bounded_predicate_;
+  uint64_t bounds_version_{0};
+
+  /** The tuples of the page being read, as views into the page or rows of its column chunk */
+  TupleBatch page_batch_;
 };
 }  // namespace bustub
@@ -13,18 +13,72 @@
 #pragma once
 
 #include <memory>
+#include <optional>
+#include <string>
 #include <vector>
 
 #include "execution/executor_context.h"
 #include "execution/executors/abstract_executor.h"
+#include "execution/loser_tree.h"
 #include "execution/plans/seq_scan_plan.h"
 #include "execution/plans/sort_plan.h"
+#include "execution/sort_key.h"
+#include "execution/spill_file.h"
 #include "storage/table/tuple.h"
 
 namespace bustub {
 
+/**
+ * SortedRunMerger merges sorted runs, spill files whose rows have their normalized sort keys and are in the order of
+ * these keys, into one sorted stream. Rows with equal keys come out in the order of their runs.
+ */
+class SortedRunMerger {
+ public:
+  explicit SortedRunMerger(std::vector<std::unique_ptr<SpillFile>> runs);
+
+  /**
+   * Read the next row in sorted order.
+   * @param[out] row the row
+   * @param[out] key its sort key
+   * @return false if all rows were read
+   */
+  auto Next(Tuple *row, std::string *key) -> bool;
+
+ private:
+  /** The next row of a run */
+  struct Head {
+    std::string key_;
+    Tuple row_;
+    bool exhausted_{false};
+  };
+
+  /** Orders runs by their heads, exhausted ones last */
+  struct HeadLess {
+    auto operator()(size_t a, size_t b) const -> bool {
+      const auto &head_a = (*heads_)[a];
+      const auto &head_b = (*heads_)[b];
+      if (head_a.exhausted_ || head_b.exhausted_) {
+        return !head_a.exhausted_ && head_b.exhausted_;
+      }
+      auto cmp = head_a.key_.compare(head_b.key_);
+      return cmp < 0 || (cmp == 0 && a < b);
+    }
+
+    const std::vector<Head> *heads_;
+  };
+
+  std::vector<std::unique_ptr<SpillFile>> runs_;
+  std::vector<SpillFile::Reader> readers_;
+  std::vector<Head> heads_;
+  std::optional<LoserTree<HeadLess>> tree_;
+};
+
 /**
  * The SortExecutor executor executes a sort.
+ *
+ * Rows are sorted by their normalized sort keys (see SortKeyEncoder). While the rows fit in the sort memory budget,
+ * they are sorted in memory. Beyond it, the rows collected so far are sorted and written to a spill file as a sorted
+ * run, and the runs are merged at the end, up to as many at a time as the budget has pages for reading them.
  */
 class SortExecutor : public AbstractExecutor {
  public:
@@ -46,11 +100,46 @@ class SortExecutor : public AbstractExecutor {
    */
   auto Next(Tuple *tuple, RID *rid) -> bool override;
 
+  /**
+   * Yield the next batch of tuples from the sort.
+   * @param[out] batch The next tuples produced by the sort
+   * @return `true` if a tuple was produced, `false` if there are no more tuples
+   */
+  auto NextBatch(TupleBatch *batch) -> bool override;
+
+  auto SupportsBatch() const -> bool override { return child_executor_->SupportsBatch(); }
+
   /** @return The output schema for the sort */
   auto GetOutputSchema() const -> const Schema & override { return plan_->OutputSchema(); }
 
  private:
+  /** A row in memory and its sort key */
+  struct SortEntry {
+    std::string key_;
+    Tuple row_;
+  };
+
+  /** Sort the rows in memory and write them to a new run. */
+  void SpillRun();
+
+  /** Merge runs [begin, end) into one run. */
+  auto MergeRuns(size_t begin, size_t end) -> std::unique_ptr<SpillFile>;
+
   /** The sort plan node to be executed */
   const SortPlanNode *plan_;
+  /** The child executor that produces the rows to sort */
+  std::unique_ptr<AbstractExecutor> child_executor_;
+  SortKeyEncoder key_encoder_;
+
+  /** The rows in memory, all rows in sorted order once Init() is done unless there are runs */
+  std::vector<SortEntry> entries_;
+  /** Approximate memory used by entries_ */
+  size_t entries_bytes_{0};
+  /** The next entry to produce */
+  size_t next_entry_{0};
+  /** The sorted runs, in the order their rows were produced by the child */
+  std::vector<std::unique_ptr<SpillFile>> runs_;
+  /** Merges the runs, if there were any */
+  std::unique_ptr<SortedRunMerger> merger_;
 };
 }  // namespace bustub
@@ -13,6 +13,8 @@
 #pragma once
 
 #include <memory>
+#include <optional>
+#include <string>
 #include <utility>
 #include <vector>
 
@@ -20,12 +22,20 @@
 #include "execution/executors/abstract_executor.h"
 #include "execution/plans/seq_scan_plan.h"
 #include "execution/plans/topn_plan.h"
+#include "execution/runtime_filter.h"
+#include "execution/sort_key.h"
 #include "storage/table/tuple.h"
 
 namespace bustub {
 
 /**
  * The TopNExecutor executor executes a topn.
+ *
+ * The best N rows seen so far are kept in a max-heap by their normalized sort keys (see SortKeyEncoder), so a row
+ * that does not sort before the worst of them is dropped after one comparison, and memory stays bounded by N rows.
+ * Rows with equal keys keep the order the child produced them in. When the leading ORDER BY expression is a column
+ * of a sequential scan below, the TopN pushes a TopNBound into that scan, which then drops the rows, and skips the
+ * pages, that could not make it into the heap.
  */
 class TopNExecutor : public AbstractExecutor {
  public:
@@ -47,6 +57,15 @@ class TopNExecutor : public AbstractExecutor {
    */
   auto Next(Tuple *tuple, RID *rid) -> bool override;
 
+  /**
+   * Yield the next batch of tuples from the TopN.
+   * @param[out] batch The next tuples produced by the TopN
+   * @return `true` if a tuple was produced, `false` if there are no more tuples
+   */
+  auto NextBatch(TupleBatch *batch) -> bool override;
+
+  auto SupportsBatch() const -> bool override { return child_executor_->SupportsBatch(); }
+
   /** @return The output schema for the TopN */
   auto GetOutputSchema() const -> const Schema & override { return plan_->OutputSchema(); }
 
@@ -59,9 +78,44 @@ class TopNExecutor : public AbstractExecutor {
   auto GetNumInHeap() -> size_t;
 
  private:
+  /** A row in the heap, its sort key, and its position in the output of the child, which breaks ties */
+  struct HeapEntry {
+    std::string key_;
+    size_t seq_;
+    Tuple row_;
+  };
+
+  /** Orders entries by key, then by position, so the top of the max-heap is the row that is dropped first */
+  struct EntryLess {
+    auto operator()(const HeapEntry &a, const HeapEntry &b) const -> bool {
+      auto cmp = a.key_.compare(b.key_);
+      return cmp < 0 || (cmp == 0 && a.seq_ < b.seq_);
+    }
+  };
+
+  /** Offer a row of the child to the heap. */
+  void Push(std::string key, Tuple row);
+
+  /** Tighten the bound pushed into the scan to the leading key of the worst row, if the heap is full. */
+  void TightenBound();
+
   /** The TopN plan node to be executed */
   const TopNPlanNode *plan_;
   /** The child executor from which tuples are obtained */
   std::unique_ptr<AbstractExecutor> child_executor_;
+  SortKeyEncoder key_encoder_;
+
+  /** The best rows so far as a max-heap while the child is read, then all of them in sorted order */
+  std::vector<HeapEntry> heap_;
+  /** The number of rows of the child offered to the heap */
+  size_t num_offered_{0};
+  /** Whether the worst row of the heap changed since the bound was last tightened */
+  bool worst_changed_{false};
+  /** The next row to produce once the heap is sorted */
+  size_t next_entry_{0};
+
+  /** The scan the bound is pushed into, if the leading ORDER BY expression comes from one */
+  std::optional<RuntimeFilter::Target> bound_target_;
+  std::shared_ptr<TopNBound> bound_;
 };
 }  // namespace bustub
@@ -0,0 +1,177 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// expression_program.h
+//
+// Identification: src/include/execution/expression_program.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "execution/expressions/abstract_expression.h"
+#include "execution/expressions/comparison_expression.h"
+#include "execution/tuple_batch.h"
+#include "type/type_id.h"
+#include "type/value.h"
+
+namespace bustub {
+
+/**
+ * ExpressionProgram is an expression tree compiled to bytecode for a register machine.
+ *
+ * Every register holds one column of unboxed values, a value for each row of a batch, with a null flag per row. An
+ * instruction runs over a whole batch, or over the rows of a selection, in a loop that is specialized for the
+ * physical type of its operands, so a batch costs one dispatch per instruction instead of virtual calls and Value
+ * copies per row and node. Integer types, booleans and timestamps are held as int64_t, decimals as double, and
+ * strings as views into the batch or into the register.
+ *
+ * The compiler folds subtrees without columns into constants, and evaluates the right side of AND and OR only on the
+ * rows whose result the left side did not decide, skipping it when there are none. A program may compute several
+ * expressions at once, which then share the loads of the columns they read.
+ */
+class ExpressionProgram {
+ public:
+  /**
+   * Compile an expression over the columns of one input.
+   * @return the program, or nullptr if the expression uses something the program does not support, such as columns
+   * of the right side of a join, in which case the expression has to be evaluated as a tree
+   */
+  static auto Compile(const AbstractExpressionRef &expr) -> std::unique_ptr<ExpressionProgram>;
+
+  /**
+   * Compile several expressions over the columns of one input into one program.
+   * @return the program, or nullptr if any of the expressions cannot be compiled
+   */
+  static auto Compile(const std::vector<AbstractExpressionRef> &exprs) -> std::unique_ptr<ExpressionProgram>;
+
+  /**
+   * Evaluate the expression on every selected row of a batch.
+   * @param batch the input rows
+   * @param[out] result the value for the i-th selected row is stored at position i
+   */
+  void EvaluateBatch(const TupleBatch &batch, std::vector<Value> *result);
+
+  /**
+   * Evaluate every expression of the program on every selected row of a batch.
+   * @param batch the input rows
+   * @param[out] results the value of the j-th expression for the i-th selected row is stored at (*results)[j][i]
+   */
+  void EvaluateBatch(const TupleBatch &batch, std::vector<std::vector<Value>> *results);
+
+  /**
+   * Evaluate a boolean expression on every selected row of a batch.
+   * @param batch the input rows
+   * @param[out] selection the physical positions of the rows for which the expression is true, in order
+   */
+  void Select(const TupleBatch &batch, std::vector<uint32_t> *selection);
+
+  /** @return the instructions of the program, one per line */
+  auto ToString() const -> std::string;
+
+ private:
+  /** The physical type of the values of a register */
+  enum class RegisterType : uint8_t { Integer, Decimal, Boolean, Varchar };
+
+  enum class OpCode : uint8_t {
+    /** dst = column `aux_` of the batch, whose type is `type_` */
+    Load,
+    /** dst = constant `aux_` */
+    Constant,
+    /** dst = a converted from Integer to Decimal */
+    IntegerToDecimal,
+    /** dst = a `aux_` b, a ComparisonType */
+    CompareInteger,
+    CompareDecimal,
+    CompareVarchar,
+    /** dst = a + b and dst = a - b, with the wrap-around of 32-bit integers */
+    AddInteger,
+    SubtractInteger,
+    /** selection `dst` = the rows of selection `sel_` on which a is not false, or not true */
+    SelectNotFalse,
+    SelectNotTrue,
+    /** Continue at instruction `aux_` if selection `sel_` is empty */
+    JumpIfEmpty,
+    /** dst = a AND b, a OR b. b is only read on the rows that a does not decide. */
+    And,
+    Or,
+    /** dst = lower(a), upper(a) */
+    Lower,
+    Upper,
+  };
+
+  struct Instruction {
+    OpCode op_;
+    /** Selection of the rows the instruction runs on */
+    uint16_t sel_{0};
+    uint16_t dst_{0};
+    uint16_t a_{0};
+    uint16_t b_{0};
+    TypeId type_{TypeId::INVALID};
+    uint32_t aux_{0};
+  };
+
+  struct Register {
+    RegisterType type_;
+    /** Integer, boolean (0 or 1) and timestamp values */
+    std::vector<int64_t> integers_;
+    std::vector<double> decimals_;
+    std::vector<std::string_view> strings_;
+    /** Strings computed by the program, which strings_ point into */
+    std::vector<std::string> owned_;
+    std::vector<uint8_t> nulls_;
+  };
+
+  ExpressionProgram() = default;
+
+  /** @return the register type that holds values of a type, or std::nullopt if there is none */
+  static auto RegisterTypeOf(TypeId type) -> std::optional<RegisterType>;
+
+  /** Compile a node. @return the register of its result, or -1 if the node is not supported */
+  auto CompileNode(const AbstractExpression &expr, uint16_t sel) -> int;
+
+  /** Compile a comparison, converting integer operands to decimals if needed. */
+  auto CompileComparison(const ComparisonExpression &expr, uint16_t sel) -> int;
+
+  /** Compile AND and OR, evaluating the right side only on the rows the left side does not decide. */
+  auto CompileLogic(const AbstractExpression &expr, bool is_and, uint16_t sel) -> int;
+
+  /** Emit an instruction that loads a value into a new register. @return the register */
+  auto EmitConstant(const Value &value, uint16_t sel) -> int;
+
+  /** @return a new register of a type */
+  auto NewRegister(RegisterType type) -> uint16_t;
+
+  /** @return a new selection of some of the rows of selection `parent` */
+  auto NewSelection(uint16_t parent) -> uint16_t;
+
+  /** Run the program on the rows of a batch. */
+  void Run(const TupleBatch &batch);
+
+  /** @return the value of the `result`-th expression in row `i` */
+  auto GetResult(size_t result, uint32_t i) const -> Value;
+
+  std::vector<Instruction> code_;
+  std::vector<Register> registers_;
+  std::vector<Value> constants_;
+  /** Row numbers, selection 0 has all rows of the batch */
+  std::vector<std::vector<uint32_t>> selections_;
+  /** The selection each selection was made from */
+  std::vector<uint16_t> parents_;
+  /** The register a column is loaded into within a selection, keyed by (selection, column) */
+  std::map<std::pair<uint16_t, uint32_t>, uint16_t> loads_;
+  /** The register and the type of the value of each expression */
+  std::vector<std::pair<uint16_t, TypeId>> results_;
+};
+
+}  // namespace bustub
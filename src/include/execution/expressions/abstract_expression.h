@@ -18,6 +18,7 @@
 #include <vector>
 
 #include "catalog/schema.h"
+#include "execution/tuple_batch.h"
 #include "fmt/format.h"
 #include "storage/table/tuple.h"
 
@@ -65,6 +66,20 @@ class AbstractExpression {
   virtual auto EvaluateJoin(const Tuple *left_tuple, const Schema &left_schema, const Tuple *right_tuple,
                             const Schema &right_schema) const -> Value = 0;
 
+  /**
+   * Evaluate the expression on every selected row of a batch. The default implementation evaluates it row by row.
+   * @param batch The input rows
+   * @param[out] result The value for the i-th selected row is stored at position i
+   */
+  virtual void EvaluateBatch(const TupleBatch &batch, std::vector<Value> *result) const {
+    result->clear();
+    result->reserve(batch.Size());
+    for (uint32_t i = 0; i < batch.Size(); i++) {
+      auto tuple = batch.GetTuple(i);
+      result->push_back(Evaluate(&tuple, batch.GetSchema()));
+    }
+  }
+
   /** @return the child_idx'th child of this expression */
   auto GetChildAt(uint32_t child_idx) const -> const AbstractExpressionRef & { return children_[child_idx]; }
 
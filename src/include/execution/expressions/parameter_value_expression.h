@@ -0,0 +1,46 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// parameter_value_expression.h
+//
+// Identification: src/include/execution/expressions/parameter_value_expression.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "common/exception.h"
+#include "execution/expressions/abstract_expression.h"
+
+namespace bustub {
+/**
+ * ParameterValueExpression is a parameter of a prepared statement in its plan. EXECUTE replaces it by a constant before
+ * the plan runs (see BindPlanParameters), so it is never evaluated.
+ */
+class ParameterValueExpression : public AbstractExpression {
+ public:
+  /** Creates a new parameter expression for the parameter at `index`, starting at 0. */
+  ParameterValueExpression(uint32_t index, TypeId ret_type) : AbstractExpression({}, ret_type), index_(index) {}
+
+  auto Evaluate(const Tuple *tuple, const Schema &schema) const -> Value override {
+    throw Exception(fmt::format("parameter ${} is not bound", index_ + 1));
+  }
+
+  auto EvaluateJoin(const Tuple *left_tuple, const Schema &left_schema, const Tuple *right_tuple,
+                    const Schema &right_schema) const -> Value override {
+    throw Exception(fmt::format("parameter ${} is not bound", index_ + 1));
+  }
+
+  /** @return the string representation of the plan node and its children */
+  auto ToString() const -> std::string override { return fmt::format("${}", index_ + 1); }
+
+  BUSTUB_EXPR_CLONE_WITH_CHILDREN(ParameterValueExpression);
+
+  uint32_t index_;
+};
+}  // namespace bustub
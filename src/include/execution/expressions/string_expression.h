@@ -45,12 +45,18 @@ class StringExpression : public AbstractExpression {
   }
 
   auto Compute(const std::string &val) const -> std::string {
-    // TODO(student): implement upper / lower.
-    return {};
+    std::string result = val;
+    auto convert = expr_type_ == StringExpressionType::Lower ? ::tolower : ::toupper;
+    std::transform(result.begin(), result.end(), result.begin(),
+                   [convert](unsigned char c) { return static_cast<char>(convert(c)); });
+    return result;
   }
 
   auto Evaluate(const Tuple *tuple, const Schema &schema) const -> Value override {
     Value val = GetChildAt(0)->Evaluate(tuple, schema);
+    if (val.IsNull()) {
+      return ValueFactory::GetNullValueByType(TypeId::VARCHAR);
+    }
     auto str = val.GetAs<char *>();
     return ValueFactory::GetVarcharValue(Compute(str));
   }
@@ -58,6 +64,9 @@ class StringExpression : public AbstractExpression {
   auto EvaluateJoin(const Tuple *left_tuple, const Schema &left_schema, const Tuple *right_tuple,
                     const Schema &right_schema) const -> Value override {
     Value val = GetChildAt(0)->EvaluateJoin(left_tuple, left_schema, right_tuple, right_schema);
+    if (val.IsNull()) {
+      return ValueFactory::GetNullValueByType(TypeId::VARCHAR);
+    }
     auto str = val.GetAs<char *>();
     return ValueFactory::GetVarcharValue(Compute(str));
   }
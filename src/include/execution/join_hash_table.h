@@ -0,0 +1,163 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// join_hash_table.h
+//
+// Identification: src/include/execution/join_hash_table.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "catalog/schema.h"
+#include "common/util/hash_util.h"
+#include "execution/spill_file.h"
+#include "storage/table/tuple.h"
+#include "type/value.h"
+
+namespace bustub {
+
+/** HashJoinKey represents the join key values of a row */
+struct HashJoinKey {
+  /** The join key values */
+  std::vector<Value> keys_;
+
+  /**
+   * Compares two join keys for equality.
+   * @param other the other join key to be compared with
+   * @return `true` if both join keys have equivalent values, `false` otherwise
+   */
+  auto operator==(const HashJoinKey &other) const -> bool {
+    for (uint32_t i = 0; i < other.keys_.size(); i++) {
+      if (keys_[i].CompareEquals(other.keys_[i]) != CmpBool::CmpTrue) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  /** @return the hash of the key, with all bits well mixed so that any of them can be used for partitioning */
+  auto Hash() const -> hash_t;
+};
+
+/**
+ * JoinHashTable holds the build side of a hash join.
+ *
+ * Rows are radix partitioned by the bits of their hash: a table at level L splits its rows into FANOUT partitions by
+ * the RADIX_BITS bits of the hash starting at bit L * RADIX_BITS. After all rows were inserted, partitions larger than
+ * CACHE_PARTITION_SIZE are split again by the next bits (multi-pass partitioning), so that every partition that is
+ * probed fits in the CPU cache. Each of these leaf partitions gets a compact open-addressing table of row numbers.
+ *
+ * When the rows in memory exceed the memory limit, the largest partitions are moved to spill files, and so are all
+ * rows inserted into them later. Such a partition is joined after the rest: its build rows go into a JoinHashTable
+ * one level down, which partitions them by the next bits of the hash and may spill again. From MAX_LEVELS on, a table
+ * neither partitions nor spills, as partitioning does not help once all rows have the same hash.
+ *
+ * A finalized table is read-only, so the workers of a parallel pipeline can probe it at the same time.
+ */
+class JoinHashTable {
+ public:
+  static constexpr uint32_t RADIX_BITS = 6;
+  static constexpr uint32_t FANOUT = 1 << RADIX_BITS;
+  static constexpr uint32_t MAX_LEVELS = 4;
+  /** Partitions larger than this are split, roughly the size of an L2 cache */
+  static constexpr size_t CACHE_PARTITION_SIZE = 256 * 1024;
+
+  /** A partition of the build rows. */
+  struct Partition {
+    /** Level of the bits that distinguish the children of this partition */
+    uint32_t level_{0};
+    /** The rows, their keys and their hashes, if the partition is in memory and not split */
+    std::vector<Tuple> rows_;
+    std::vector<HashJoinKey> keys_;
+    std::vector<hash_t> hashes_;
+    /** Approximate memory used by the rows */
+    size_t bytes_{0};
+    /** The rows, if the partition was spilled */
+    std::shared_ptr<SpillFile> spill_;
+    /** The partitions this partition was split into, by the bits at level_ */
+    std::vector<Partition> children_;
+    /** Open-addressing table: the number of a row plus one, 0 for empty slots */
+    std::vector<uint32_t> slots_;
+    /** The number of the first row of this partition among the rows of all leaves in memory */
+    size_t row_offset_{0};
+
+    /** @return whether the rows of this partition are in spill_ */
+    auto IsSpilled() const -> bool { return spill_ != nullptr; }
+
+    /**
+     * Find the next row with a key.
+     * @param hash the hash of the key
+     * @param key the key
+     * @param[in,out] pos the slot to continue from, use StartSlot(hash) to find the first match
+     * @return the number of the row within this partition, or std::nullopt if there are no more matches
+     */
+    auto NextMatch(hash_t hash, const HashJoinKey &key, size_t *pos) const -> std::optional<uint32_t>;
+
+    /** @return the slot to start looking for a hash at */
+    auto StartSlot(hash_t hash) const -> size_t { return (hash >> 32) & (slots_.size() - 1); }
+  };
+
+  /**
+   * @param bpm the buffer pool manager to spill to, nullptr to never spill
+   * @param schema the schema of the build rows
+   * @param memory_limit number of bytes the rows may use before partitions are spilled
+   * @param level the level of the table, 0 for the top-level table of a join
+   */
+  JoinHashTable(BufferPoolManager *bpm, const Schema *schema, size_t memory_limit, uint32_t level = 0);
+
+  /** Insert a build row. A row whose key contains a null never matches. */
+  void Insert(Tuple row, HashJoinKey key, hash_t hash);
+
+  /** Split large partitions and build the tables of the leaf partitions. No row may be inserted afterwards. */
+  void Finalize();
+
+  /** @return the leaf partition a hash belongs to */
+  auto GetLeaf(hash_t hash) const -> const Partition &;
+
+  /** @return the leaf partitions that are in memory */
+  auto GetLeaves() const -> const std::vector<const Partition *> & { return leaves_; }
+
+  /** @return the partitions that were spilled */
+  auto GetSpilledPartitions() const -> const std::vector<const Partition *> & { return spilled_; }
+
+  /** @return the number of rows in memory */
+  auto NumRows() const -> size_t { return num_rows_; }
+
+  /** @return the level of the table */
+  auto GetLevel() const -> uint32_t { return level_; }
+
+ private:
+  /** @return the partition number of a hash at a level */
+  static auto PartitionOf(hash_t hash, uint32_t level) -> uint32_t {
+    return level >= MAX_LEVELS ? 0 : (hash >> (level * RADIX_BITS)) & (FANOUT - 1);
+  }
+
+  /** Move the rows of the largest partition in memory to a spill file. */
+  void SpillLargestPartition();
+
+  /** Split a partition until its leaves fit in the cache, and build their tables. */
+  void FinalizePartition(Partition *partition);
+
+  BufferPoolManager *bpm_;
+  const Schema *schema_;
+  size_t memory_limit_;
+  uint32_t level_;
+
+  /** The top-level partitions: FANOUT of them, or one if the level is MAX_LEVELS or more */
+  std::vector<Partition> partitions_;
+  /** Memory used by the partitions in memory */
+  size_t bytes_{0};
+
+  std::vector<const Partition *> leaves_;
+  std::vector<const Partition *> spilled_;
+  size_t num_rows_{0};
+};
+
+}  // namespace bustub
@@ -0,0 +1,73 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// loser_tree.h
+//
+// Identification: src/include/execution/loser_tree.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace bustub {
+
+/**
+ * LoserTree selects the smallest of k sorted inputs for a k-way merge. Every inner node of the tree remembers the
+ * loser of the match played there, so after the winner's input advanced, only the matches on the path from its leaf
+ * to the root are replayed: log2(k) comparisons per row, against the 2 * log2(k) of a binary heap.
+ *
+ * The tree only knows the inputs by their number; `less(i, j)` compares the current heads of inputs i and j. It has
+ * to order exhausted inputs after all others, and should break ties by input number to keep the merge stable.
+ */
+template <typename Less>
+class LoserTree {
+ public:
+  LoserTree(size_t num_inputs, Less less) : num_inputs_(num_inputs), less_(std::move(less)), tree_(num_inputs) {
+    if (num_inputs_ > 0) {
+      tree_[0] = Build(1);
+    }
+  }
+
+  /** @return the input with the smallest head */
+  auto Winner() const -> size_t { return tree_[0]; }
+
+  /** Find the new winner after the head of an input changed, usually the previous winner. */
+  void Replay(size_t input) {
+    auto winner = input;
+    // Inputs are the leaves num_inputs_ ... 2 * num_inputs_ - 1 of a tree laid out like a binary heap.
+    for (auto node = (input + num_inputs_) / 2; node > 0; node /= 2) {
+      if (less_(tree_[node], winner)) {
+        std::swap(tree_[node], winner);
+      }
+    }
+    tree_[0] = winner;
+  }
+
+ private:
+  /** Play the matches below a node. @return the winner of the node */
+  auto Build(size_t node) -> size_t {
+    if (node >= num_inputs_) {
+      return node - num_inputs_;
+    }
+    auto left = Build(2 * node);
+    auto right = Build(2 * node + 1);
+    if (less_(right, left)) {
+      tree_[node] = left;
+      return right;
+    }
+    tree_[node] = right;
+    return left;
+  }
+
+  size_t num_inputs_;
+  Less less_;
+  /** The losers of the inner nodes 1 ... num_inputs_ - 1, and the overall winner at 0 */
+  std::vector<size_t> tree_;
+};
+
+}  // namespace bustub
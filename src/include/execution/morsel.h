@@ -0,0 +1,107 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// morsel.h
+//
+// Identification: src/include/execution/morsel.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <optional>
+#include <unordered_map>
+
+#include "common/config.h"
+#include "common/rid.h"
+#include "storage/table/table_heap.h"
+#include "storage/table/table_iterator.h"
+
+namespace bustub {
+
+class AbstractPlanNode;
+
+/**
+ * MorselQueue splits a table heap into morsels, runs of up to MORSEL_PAGES consecutive pages, and hands them out to
+ * the workers of a parallel scan. Workers pull a new morsel whenever they finish one, so fast workers take over the
+ * work of slow ones. Like TableHeap::MakeIterator, the scan stops at the end of the table as it was when the queue
+ * was created.
+ */
+class MorselQueue {
+ public:
+  /** Maximum number of table pages in one morsel. */
+  static constexpr size_t MORSEL_PAGES = 16;
+
+  explicit MorselQueue(TableHeap *table_heap);
+
+  /** @return an iterator over the next morsel, or std::nullopt if the whole table was handed out */
+  auto Next() -> std::optional<TableIterator>;
+
+ private:
+  TableHeap *table_heap_;
+  /** Where the scan of the whole table stops */
+  RID stop_at_rid_;
+
+  std::mutex latch_;
+  /** The first page of the next morsel, INVALID_PAGE_ID once all pages were handed out. Protected by latch_. */
+  page_id_t next_page_id_;
+};
+
+/**
+ * ParallelContext is the state shared by the workers of one parallel pipeline: the morsels of the table that drives
+ * the pipeline, and the objects the workers build once and then share, such as the hash tables of joins.
+ */
+class ParallelContext {
+ public:
+  /**
+   * @param driving_scan the scan plan node whose table is split into morsels
+   * @param table_heap the table heap scanned by it
+   */
+  ParallelContext(const AbstractPlanNode *driving_scan, TableHeap *table_heap)
+      : driving_scan_(driving_scan), morsels_(table_heap) {}
+
+  /** @return the morsels to scan for `scan`, or nullptr if every worker has to scan its whole table */
+  auto GetMorselQueue(const AbstractPlanNode *scan) -> MorselQueue * {
+    return scan == driving_scan_ ? &morsels_ : nullptr;
+  }
+
+  /**
+   * Get the object shared under `key`. The first worker to ask creates it, and the others wait until it is created.
+   * Shared objects are read-only, as all workers use them at the same time.
+   * @param key identifies the object, usually the plan node that uses it
+   * @param create creates the object
+   */
+  template <typename T>
+  auto GetOrCreateShared(const void *key, const std::function<std::shared_ptr<const T>()> &create)
+      -> std::shared_ptr<const T> {
+    std::unique_lock<std::mutex> guard(latch_);
+    auto &slot = shared_[key];
+    if (slot == nullptr) {
+      slot = std::make_shared<SharedSlot>();
+    }
+    auto entry = slot;
+    guard.unlock();
+
+    // Creating the object may take long (e.g. building a hash table), so only wait for the entry, not the map.
+    std::call_once(entry->once_, [&]() { entry->object_ = create(); });
+    return std::static_pointer_cast<const T>(entry->object_);
+  }
+
+ private:
+  struct SharedSlot {
+    std::once_flag once_;
+    std::shared_ptr<const void> object_;
+  };
+
+  const AbstractPlanNode *driving_scan_;
+  MorselQueue morsels_;
+
+  std::mutex latch_;
+  std::unordered_map<const void *, std::shared_ptr<SharedSlot>> shared_;
+};
+
+}  // namespace bustub
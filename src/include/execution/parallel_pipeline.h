@@ -0,0 +1,56 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// parallel_pipeline.h
+//
+// Identification: src/include/execution/parallel_pipeline.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <functional>
+
+#include "execution/executor_context.h"
+#include "execution/plans/abstract_plan.h"
+#include "execution/tuple_batch.h"
+
+namespace bustub {
+
+/**
+ * ParallelPipeline runs a plan on several worker threads at once. Every worker builds its own executors for the plan,
+ * and the workers split the table scanned at the bottom of the plan into morsels (see MorselQueue). The hash tables
+ * of hash joins in the plan are built once and shared by all workers.
+ *
+ * Only pipelines whose output can be split by the rows of that scan run in parallel: a sequential scan, followed by
+ * any number of filters, projections, inner or left hash join probes (the scan is on the left side of the joins) and
+ * index joins (the scan is on their outer side).
+ */
+class ParallelPipeline {
+ public:
+  /** @return whether `plan` can run as a parallel pipeline */
+  static auto CanRunInParallel(const AbstractPlanNode &plan) -> bool;
+
+  /**
+   * @param exec_ctx the executor context of the query
+   * @param plan the pipeline to run, CanRunInParallel must be true for it
+   * @param num_workers the number of worker threads
+   */
+  ParallelPipeline(ExecutorContext *exec_ctx, AbstractPlanNodeRef plan, size_t num_workers);
+
+  /**
+   * Run the pipeline until all workers are done. If a worker throws, the exception is rethrown once all workers have
+   * stopped.
+   * @param consume called by the workers with every batch they produce, which it may change, along with the number of
+   * the worker (from 0 to num_workers - 1). Calls from different workers run concurrently.
+   */
+  void Run(const std::function<void(size_t, TupleBatch *)> &consume);
+
+ private:
+  ExecutorContext *exec_ctx_;
+  AbstractPlanNodeRef plan_;
+  size_t num_workers_;
+};
+
+}  // namespace bustub
@@ -42,13 +42,15 @@ enum class PlanType {
   NestedLoopJoin,
   NestedIndexJoin,
   HashJoin,
+  MergeJoin,
   Filter,
   Values,
   Projection,
   Sort,
   TopN,
   MockScan,
-  InitCheck
+  InitCheck,
+  CTEScan
 };
 
 class AbstractPlanNode;
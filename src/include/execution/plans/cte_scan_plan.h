@@ -0,0 +1,65 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// cte_scan_plan.h
+//
+// Identification: src/include/execution/plans/cte_scan_plan.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <string>
+#include <utility>
+
+#include "execution/plans/abstract_plan.h"
+#include "fmt/format.h"
+
+namespace bustub {
+
+/**
+ * The CTEScanPlanNode reads a common table expression that is materialized once per query. Each reference to the CTE
+ * has its own CTEScanPlanNode with a copy of the plan of the CTE as its child, and all of them share the id of the
+ * CTE. The first of them to be initialized runs its child into a buffer, and all of them read that buffer.
+ */
+class CTEScanPlanNode : public AbstractPlanNode {
+ public:
+  /**
+   * Construct a new CTEScanPlanNode instance.
+   * @param output The output schema, which has the columns of the child under the names of the reference
+   * @param child The plan of the CTE
+   * @param cte_id The id of the CTE, unique within the query
+   * @param cte_name The name of the CTE
+   */
+  CTEScanPlanNode(SchemaRef output, AbstractPlanNodeRef child, uint32_t cte_id, std::string cte_name)
+      : AbstractPlanNode(std::move(output), {std::move(child)}), cte_id_(cte_id), cte_name_(std::move(cte_name)) {}
+
+  /** @return The type of the plan node */
+  auto GetType() const -> PlanType override { return PlanType::CTEScan; }
+
+  /** @return The plan of the CTE */
+  auto GetChildPlan() const -> AbstractPlanNodeRef {
+    BUSTUB_ASSERT(GetChildren().size() == 1, "CTE scan should have exactly one child plan.");
+    return GetChildAt(0);
+  }
+
+  /** @return The id of the CTE */
+  auto GetCTEId() const -> uint32_t { return cte_id_; }
+
+  /** @return The name of the CTE */
+  auto GetCTEName() const -> const std::string & { return cte_name_; }
+
+  BUSTUB_PLAN_NODE_CLONE_WITH_CHILDREN(CTEScanPlanNode);
+
+ protected:
+  auto PlanNodeToString() const -> std::string override {
+    return fmt::format("CTEScan {{ cte={}, id={} }}", cte_name_, cte_id_);
+  }
+
+ private:
+  uint32_t cte_id_;
+  std::string cte_name_;
+};
+
+}  // namespace bustub
@@ -0,0 +1,187 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// runtime_filter.h
+//
+// Identification: src/include/execution/runtime_filter.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+#include "common/util/hash_util.h"
+#include "execution/expressions/abstract_expression.h"
+#include "execution/plans/abstract_plan.h"
+#include "execution/tuple_batch.h"
+#include "storage/table/scan_predicate.h"
+#include "storage/table/tuple.h"
+
+namespace bustub {
+
+/**
+ * BloomFilter is a blocked Bloom filter of hashes. Every hash sets eight bits, one in each 64-bit word of a single
+ * 512-bit block, so a lookup touches one cache line and checks its bits with a fixed loop of eight words. The block is
+ * chosen by the high bits of the hash and the bits within it by the low bits, so the hashes must be well mixed.
+ */
+class BloomFilter {
+ public:
+  /** The number of filter bits per expected key, which gives a false positive rate of about 0.5% */
+  static constexpr size_t BITS_PER_KEY = 16;
+
+  /** @param expected_keys the number of hashes that are going to be inserted */
+  explicit BloomFilter(size_t expected_keys);
+
+  void Insert(hash_t hash);
+
+  /** @return false if the hash was definitely not inserted */
+  auto MayContain(hash_t hash) const -> bool;
+
+  /** @return the size of the filter in bytes */
+  auto GetSize() const -> size_t { return blocks_.size() * sizeof(Block); }
+
+ private:
+  static constexpr size_t BLOCK_WORDS = 8;
+  using Block = std::array<uint64_t, BLOCK_WORDS>;
+
+  /** @return the mask of the bit the hash sets in each word of its block */
+  static auto Mask(hash_t hash) -> Block;
+
+  auto BlockOf(hash_t hash) const -> size_t { return (hash >> 32) & (blocks_.size() - 1); }
+
+  std::vector<Block> blocks_;
+};
+
+/**
+ * RuntimeFilter is a Bloom filter of the join keys of the build side of a hash join, which is pushed down into a scan
+ * on the probe side. The scan drops the rows whose join key is not in the filter, which cannot find a match, before
+ * they are processed by the operators between the scan and the join. Only joins that do not return left rows without
+ * a match use runtime filters, and the key columns must be plain columns of the scan.
+ */
+class RuntimeFilter {
+ public:
+  /** The scan a runtime filter is pushed into, and its output columns that make up the join key, in key order */
+  struct Target {
+    const AbstractPlanNode *scan_;
+    std::vector<uint32_t> columns_;
+  };
+
+  /**
+   * Find the scan that the left keys of a join come from.
+   * @param plan the probe side of the join
+   * @param keys the expressions of the join key over the output of `plan`
+   * @return the scan and its columns, or std::nullopt if the keys are not columns of one sequential scan that every
+   * row of `plan` comes from
+   */
+  static auto FindTarget(const AbstractPlanNode &plan, const std::vector<AbstractExpressionRef> &keys)
+      -> std::optional<Target>;
+
+  /**
+   * Hash a join key for a runtime filter. HashJoinKey::Hash is not used, as many integer keys share the same hash
+   * there, which a hash table resolves by comparing the keys but would let through a Bloom filter.
+   * @param keys the values of the key, none of them null
+   */
+  static auto HashKey(const std::vector<Value> &keys) -> hash_t;
+
+  /**
+   * @param columns the key columns of the scan
+   * @param hashes the hashes of the join keys of the build side, as computed by HashKey
+   */
+  RuntimeFilter(std::vector<uint32_t> columns, const std::vector<hash_t> &hashes);
+
+  /** @return whether a row of the scan may have a match, which it does not if one of its key columns is null */
+  auto MayMatch(const Tuple &tuple, const Schema &schema) const -> bool;
+
+  /** Unselect the rows of a batch of the scan that have no match. */
+  void Filter(TupleBatch *batch) const;
+
+  /** @return the size of the Bloom filter in bytes */
+  auto GetSize() const -> size_t { return bloom_.GetSize(); }
+
+ private:
+  std::vector<uint32_t> columns_;
+  BloomFilter bloom_;
+};
+
+/**
+ * TopNBound is the leading sort key a row needs to make it into the result of a TopN, which the TopN pushes down into
+ * the scan its leading ORDER BY column comes from. Once the TopN holds N rows, a row whose leading key sorts after
+ * the leading key of the N-th of them cannot displace any of them, so the scan drops it, and skips the pages whose
+ * zone maps rule out all of their rows. The bound only tightens while the TopN reads its child. Rows with the same
+ * leading key as the N-th row are kept, as the rest of the key may still put them first.
+ */
+class TopNBound {
+ public:
+  /**
+   * @param column the column of the scan that the leading key is read from
+   * @param descending whether the TopN sorts the column in descending order
+   */
+  TopNBound(uint32_t column, bool descending) : column_(column), descending_(descending) {}
+
+  /** Tighten the bound to the leading key of the N-th row. A null key bounds nothing and is ignored. */
+  void Tighten(const Value &key);
+
+  /** @return a number that grows whenever the bound changes, 0 while there is no bound */
+  auto GetVersion() const -> uint64_t { return version_.load(); }
+
+  /** Add the bound to the predicate of the scan, as `column <= key OR column IS NULL` or `column >= key`. */
+  void AddTo(const Schema &schema, ScanPredicate *predicate) const;
+
+ private:
+  uint32_t column_;
+  bool descending_;
+  mutable std::mutex latch_;
+  std::atomic<uint64_t> version_{0};
+  /** The leading key of the N-th row, guarded by latch_ */
+  Value key_;
+};
+
+/**
+ * RuntimeFilterRegistry holds the runtime filters and TopN bounds of a query, by the scan they are pushed into. The
+ * joins publish their filters once their hash tables are built, which is before they pull rows from their probe side,
+ * and the scans look them up when they start producing rows. It is shared by all workers of a query and is
+ * thread-safe.
+ */
+class RuntimeFilterRegistry {
+ public:
+  /**
+   * Publish a filter, replacing the one the same join published before.
+   * @param scan the plan node of the scan the filter is pushed into
+   * @param join the plan node of the join that built the filter
+   */
+  void Publish(const AbstractPlanNode *scan, const AbstractPlanNode *join, std::shared_ptr<const RuntimeFilter> filter);
+
+  /** @return the filters pushed into a scan */
+  auto Get(const AbstractPlanNode *scan) const -> std::vector<std::shared_ptr<const RuntimeFilter>>;
+
+  /**
+   * Publish a TopN bound, replacing the one the same TopN published before. A TopN publishes its bound before it
+   * pulls rows from its child, and tightens it as it goes.
+   * @param scan the plan node of the scan the bound is pushed into
+   * @param topn the plan node of the TopN
+   */
+  void PublishBound(const AbstractPlanNode *scan, const AbstractPlanNode *topn, std::shared_ptr<const TopNBound> bound);
+
+  /** @return the TopN bounds pushed into a scan */
+  auto GetBounds(const AbstractPlanNode *scan) const -> std::vector<std::shared_ptr<const TopNBound>>;
+
+ private:
+  mutable std::mutex latch_;
+  std::unordered_map<const AbstractPlanNode *,
+                     std::unordered_map<const AbstractPlanNode *, std::shared_ptr<const RuntimeFilter>>>
+      filters_;
+  std::unordered_map<const AbstractPlanNode *,
+                     std::unordered_map<const AbstractPlanNode *, std::shared_ptr<const TopNBound>>>
+      bounds_;
+};
+
+}  // namespace bustub
@@ -0,0 +1,59 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// sort_key.h
+//
+// Identification: src/include/execution/sort_key.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "binder/bound_order_by.h"
+#include "execution/expressions/abstract_expression.h"
+#include "execution/tuple_batch.h"
+#include "type/value.h"
+
+namespace bustub {
+
+/**
+ * SortKeyEncoder turns the ORDER BY values of a row into a normalized key: a byte string whose order under memcmp
+ * is the order of the rows. Sorting and merging then compare keys with a single memcmp instead of comparing Values
+ * column by column.
+ *
+ * Every value starts with a byte that orders NULL before all other values, followed by
+ * - integers and timestamps in big-endian order, with the sign bit flipped for signed types;
+ * - decimals by their IEEE 754 bits, all of them flipped for negative numbers and the sign bit for the others;
+ * - strings with every 0x00 escaped as 0x00 0xFF, terminated by 0x00 0x00, so that a prefix sorts first.
+ * The encoding of each value is prefix-free, so for DESC all of its bytes are inverted.
+ */
+class SortKeyEncoder {
+ public:
+  explicit SortKeyEncoder(const std::vector<std::pair<OrderByType, AbstractExpressionRef>> &order_bys)
+      : order_bys_(order_bys) {}
+
+  /**
+   * Compute the keys of the rows of a batch.
+   * @param batch the rows
+   * @param[out] keys the key of the i-th selected row is stored at position i
+   */
+  void EncodeBatch(const TupleBatch &batch, std::vector<std::string> *keys) const;
+
+  /**
+   * Append the normalized encoding of a value to a key.
+   * @param value the value
+   * @param descending whether the value is sorted in descending order
+   * @param[in,out] key the key
+   */
+  static void EncodeValue(const Value &value, bool descending, std::string *key);
+
+ private:
+  const std::vector<std::pair<OrderByType, AbstractExpressionRef>> &order_bys_;
+};
+
+}  // namespace bustub
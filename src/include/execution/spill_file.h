@@ -0,0 +1,157 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// spill_file.h
+//
+// Identification: src/include/execution/spill_file.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "catalog/schema.h"
+#include "common/config.h"
+#include "common/macros.h"
+#include "execution/tuple_batch.h"
+#include "storage/page/tmp_tuple_page.h"
+#include "storage/table/tuple.h"
+
+namespace bustub {
+
+/**
+ * SpillFile holds the rows an operator moves out of memory, in TmpTuplePages of the buffer pool. Rows are collected
+ * in a page-sized buffer, and a page is only allocated when the buffer is full, so writing a row does not pin a page.
+ * The pages are deleted with the file. Rows are read back in the order they were appended. A row that does not fit
+ * in a page, e.g. because of a long varchar, is split into parts over as many pages as it needs.
+ *
+ * A row may carry a key, an opaque byte string such as its sort key. Either all rows of a file have keys, or none.
+ * A file without a schema holds records, opaque byte strings such as the partial state of an aggregation, instead.
+ *
+ * A spill file is written by one thread. Once it is written, any number of threads may read it at the same time.
+ */
+class SpillFile {
+ public:
+  /**
+   * @param bpm the buffer pool manager to allocate the pages from
+   * @param schema the schema of the rows, nullptr for a file of records
+   */
+  SpillFile(BufferPoolManager *bpm, const Schema *schema);
+
+  ~SpillFile();
+
+  DISALLOW_COPY_AND_MOVE(SpillFile);
+
+  /** Append a row. Values that are stored out of line are copied into the row. */
+  void Append(const Tuple &tuple);
+
+  /** Append a row with a key, which is stored right before it. */
+  void Append(const Tuple &tuple, std::string_view key);
+
+  /** Append a record to a file without a schema. */
+  void AppendRecord(std::string_view record);
+
+  /** @return the number of rows in the file */
+  auto NumRows() const -> size_t { return num_rows_; }
+
+  /** @return the schema of the rows */
+  auto GetSchema() const -> const Schema & { return *schema_; }
+
+  /** Reader reads the rows of a spill file in the order they were appended. */
+  class Reader {
+   public:
+    explicit Reader(const SpillFile *file) : file_(file) {}
+
+    /**
+     * Fill a batch with the next rows of a file without keys.
+     * @return false if all rows were read
+     */
+    auto Next(TupleBatch *batch) -> bool;
+
+    /**
+     * Read the next row of a file without keys.
+     * @return false if all rows were read
+     */
+    auto Next(Tuple *tuple) -> bool;
+
+    /**
+     * Read the next row of a file with keys, and its key.
+     * @return false if all rows were read
+     */
+    auto Next(Tuple *tuple, std::string *key) -> bool;
+
+    /**
+     * Read the next record of a file without a schema.
+     * @return false if all records were read
+     */
+    auto NextRecord(std::string *record) -> bool;
+
+   private:
+    /** Load the next page that has rows. @return false if there is none */
+    auto LoadPage() -> bool;
+
+    /**
+     * Read the next entry, reassembling it if it was split.
+     * @return the entry as a size field followed by its bytes, valid until the next call, or nullptr if all entries
+     * were read
+     */
+    auto NextEntry() -> const char *;
+
+    /** @return the loaded page */
+    auto Page() const -> const TmpTuplePage * { return reinterpret_cast<const TmpTuplePage *>(page_.get()); }
+
+    const SpillFile *file_;
+    /** The next page to load, where page_ids_.size() stands for the buffer */
+    size_t page_idx_{0};
+    /** A copy of the loaded page, so that the page is not pinned while the reader is idle */
+    std::unique_ptr<char[]> page_;
+    /** The offsets of the entries of the loaded page that were not read yet, the next one at the back */
+    std::vector<uint32_t> offsets_;
+    /** The index of the next entry in the file */
+    size_t entry_idx_{0};
+    /** The next split entry in split_entries_ */
+    size_t split_idx_{0};
+    /** The last split entry that was read, reassembled */
+    std::string split_entry_;
+  };
+
+ private:
+  /** @return the row with its out-of-line values copied in */
+  auto Materialize(const Tuple &tuple) const -> Tuple;
+
+  /** Append a row that has no out-of-line values, and its key if key is not nullptr. */
+  void AppendInline(const Tuple &tuple, const std::string_view *key);
+
+  /** Append an entry to the buffer, split into parts if it does not fit in a page. */
+  void AppendEntry(const char *data, uint32_t size);
+
+  /** Move the buffer to a new page. */
+  void Flush();
+
+  /** @return the buffer, which is formatted as a TmpTuplePage */
+  auto Buffer() const -> const TmpTuplePage * { return reinterpret_cast<const TmpTuplePage *>(buffer_.get()); }
+  auto Buffer() -> TmpTuplePage * { return reinterpret_cast<TmpTuplePage *>(buffer_.get()); }
+
+  BufferPoolManager *bpm_;
+  const Schema *schema_;
+  /** Whether rows may hold out-of-line values that have to be copied in */
+  bool has_unlined_columns_;
+  /** Whether the rows have keys, once the first row was appended */
+  bool has_keys_{false};
+  std::vector<page_id_t> page_ids_;
+  std::unique_ptr<char[]> buffer_;
+  size_t num_rows_{0};
+  /** The number of entries in the pages and the buffer, counting each part of a split entry */
+  size_t num_entries_{0};
+  /** The entries that were split, as the index of their first part and their number of parts, in order */
+  std::vector<std::pair<size_t, size_t>> split_entries_;
+};
+
+}  // namespace bustub
@@ -0,0 +1,129 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// tuple_batch.h
+//
+// Identification: src/include/execution/tuple_batch.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "catalog/schema.h"
+#include "common/rid.h"
+#include "storage/table/column_chunk.h"
+#include "storage/table/tuple.h"
+#include "type/value.h"
+
+namespace bustub {
+
+/**
+ * TupleBatch holds up to BATCH_SIZE rows that flow between executors in one NextBatch() call.
+ *
+ * A batch is filled either with tuples (e.g. by a scan) or with rows of values (e.g. by a projection), or with tuple
+ * views, which a scan uses to filter the tuples of a page in place before it copies the ones that pass, or with rows
+ * of column chunks, which a scan of a columnar table returns without putting their tuples together. The values of
+ * a column are accessed as a column vector, which is decoded from the tuples the first time it is asked for, so
+ * columns that no operator looks at are never decoded. A selection vector marks which rows are still part of the
+ * batch, so that filters drop rows without moving any data. Unless stated otherwise, row numbers passed to the
+ * accessors count selected rows only.
+ */
+class TupleBatch {
+ public:
+  /** Maximum number of rows in a batch. */
+  static constexpr uint32_t BATCH_SIZE = 1024;
+
+  /** Clear the batch and prepare it for rows of `schema`. */
+  void Reset(const Schema *schema);
+
+  /** @return the schema of the rows */
+  auto GetSchema() const -> const Schema & { return *schema_; }
+
+  /** @return number of selected rows */
+  auto Size() const -> uint32_t { return has_selection_ ? selection_.size() : num_rows_; }
+
+  /** @return true if no row is selected */
+  auto Empty() const -> bool { return Size() == 0; }
+
+  /** @return true if no more rows can be appended */
+  auto IsFull() const -> bool { return num_rows_ >= BATCH_SIZE; }
+
+  /** @return the physical position of the i-th selected row, used to index column vectors */
+  auto RowAt(uint32_t i) const -> uint32_t { return has_selection_ ? selection_[i] : i; }
+
+  /** Append a tuple. All rows of a batch must be appended in the same way. */
+  void AppendTuple(Tuple tuple);
+
+  /**
+   * Append a tuple view. All rows of a batch must be appended in the same way. The batch is only valid as long as the
+   * view, and so are the VARCHAR values of its columns.
+   */
+  void AppendTupleView(TupleView view);
+
+  /**
+   * Append rows of a column chunk. All rows of a batch must be appended in the same way, but they may come from
+   * several chunks. The batch keeps the chunk alive.
+   * @param rows the rows of the chunk to append, in order
+   */
+  void AppendChunk(const std::shared_ptr<const ColumnChunk> &chunk, const std::vector<uint32_t> &rows);
+
+  /** Append a row of values. All rows of a batch must be appended in the same way. */
+  void AppendValues(std::vector<Value> values, RID rid = RID{});
+
+  /**
+   * Fill an empty batch with whole columns.
+   * @param columns one vector of values per column of the schema, all of the same length
+   * @param rids the RIDs of the rows
+   */
+  void SetColumns(std::vector<std::vector<Value>> columns, std::vector<RID> rids);
+
+  /**
+   * @return the values of a column, indexed by physical row position (see RowAt). Only the values of selected rows
+   * are valid.
+   */
+  auto GetColumn(uint32_t column_idx) const -> const std::vector<Value> &;
+
+  /** @return the value of a column in the i-th selected row */
+  auto GetValue(uint32_t i, uint32_t column_idx) const -> const Value & { return GetColumn(column_idx)[RowAt(i)]; }
+
+  /** @return the i-th selected row as a tuple */
+  auto GetTuple(uint32_t i) const -> Tuple;
+
+  /** @return the RID of the i-th selected row */
+  auto GetRid(uint32_t i) const -> RID;
+
+  /**
+   * Narrow down the selected rows.
+   * @param selection physical positions of the rows to keep, a subset of the currently selected rows in order
+   */
+  void Select(std::vector<uint32_t> selection);
+
+ private:
+  const Schema *schema_{nullptr};
+  uint32_t num_rows_{0};
+
+  /** The rows, if the batch was filled with tuples */
+  std::vector<Tuple> tuples_;
+  /** The rows, if the batch was filled with tuple views */
+  std::vector<TupleView> views_;
+  /** The rows, if the batch was filled with rows of column chunks, as the index of their chunk and their row in it */
+  std::vector<std::shared_ptr<const ColumnChunk>> chunks_;
+  std::vector<std::pair<uint32_t, uint32_t>> chunk_rows_;
+  /** RIDs of the rows, if the batch was filled with values */
+  std::vector<RID> rids_;
+
+  /** Column vectors, decoded from tuples_ on first use */
+  mutable std::vector<std::vector<Value>> columns_;
+  mutable std::vector<bool> decoded_;
+
+  std::vector<uint32_t> selection_;
+  bool has_selection_{false};
+};
+
+}  // namespace bustub
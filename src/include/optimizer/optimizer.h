@@ -10,6 +10,7 @@
 #include "catalog/catalog.h"
 #include "concurrency/transaction.h"
 #include "execution/expressions/abstract_expression.h"
+#include "execution/expressions/column_value_expression.h"
 #include "execution/plans/abstract_plan.h"
 
 namespace bustub {
@@ -42,12 +43,33 @@ class Optimizer {
   auto OptimizeMergeFilterNLJ(const AbstractPlanNodeRef &plan) -> AbstractPlanNodeRef;
 
   /**
-   * @brief optimize nested loop join into hash join.
-   * In the starter code, we will check NLJs with exactly one equal condition. You can further support optimizing joins
-   * with multiple eq conditions.
+   * @brief optimize nested loop join into hash join, if its predicate is a conjunction of equalities between an
+   * expression on the left child and one on the right child. Semi and anti joins without a predicate are planned as
+   * hash joins without keys.
    */
   auto OptimizeNLJAsHashJoin(const AbstractPlanNodeRef &plan) -> AbstractPlanNodeRef;
 
+  /**
+   * @brief optimize nested loop join into merge join, if both children are already sorted on the join keys, e.g. by a
+   * sort or an index scan. Should be applied after OptimizeOrderByAsIndexScan.
+   */
+  auto OptimizeNLJAsMergeJoin(const AbstractPlanNodeRef &plan) -> AbstractPlanNodeRef;
+
+  /**
+   * @brief split a join predicate of the form `<column expr> = <column expr> [AND ...]` into its join keys.
+   * @param[out] left_cols the columns of the left child, in the order of the equalities
+   * @param[out] right_cols the columns of the right child that each of left_cols is compared with
+   * @return false if the predicate has another form
+   */
+  auto ExtractEquiJoinKeys(const AbstractExpressionRef &expr, std::vector<const ColumnValueExpression *> *left_cols,
+                           std::vector<const ColumnValueExpression *> *right_cols) -> bool;
+
+  /**
+   * @brief get the columns that the output of a plan is sorted on in ascending order, most significant first. Only
+   * sorts, index scans and the plan nodes that keep the order of their child are looked at.
+   */
+  auto OutputOrdering(const AbstractPlanNodeRef &plan) -> std::vector<uint32_t>;
+
   /**
    * @brief optimize nested loop join into index join.
    */
@@ -92,6 +114,13 @@ class Optimizer {
    */
   auto OptimizeSortLimitAsTopN(const AbstractPlanNodeRef &plan) -> AbstractPlanNodeRef;
 
+  /**
+   * @brief push limits and top Ns down through projections and into the left child of left joins, so that the
+   * operators below them produce fewer rows. A limit that reaches a sort becomes a top N. Should be applied after
+   * OptimizeSortLimitAsTopN.
+   */
+  auto OptimizeLimitPushDown(const AbstractPlanNodeRef &plan) -> AbstractPlanNodeRef;
+
   /**
    * @brief get the estimated cardinality for a table based on the table name. Useful when join reordering. BusTub
    * doesn't support statistics for now, so it's the only way for you to get the table size :(
@@ -0,0 +1,87 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// plan_cache.h
+//
+// Identification: src/include/optimizer/plan_cache.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <memory>
+#include <mutex>  // NOLINT
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "catalog/schema.h"
+#include "execution/plans/abstract_plan.h"
+#include "type/value.h"
+
+namespace bustub {
+
+/** An optimized plan, with what running it needs besides the plan. */
+struct CachedPlan {
+  AbstractPlanNodeRef plan_;
+  /** The output schema of the statement, whose column names make up the header of the result */
+  SchemaRef schema_;
+  /** Whether the statement deletes or updates tuples, see ExecutorContext */
+  bool is_modify_;
+  /** The version of the catalog the plan was made for */
+  uint64_t catalog_version_;
+};
+
+/** A statement prepared with PREPARE, whose parameters are given by EXECUTE. */
+struct PreparedPlan {
+  /** The PREPARE statement, which is planned again once the catalog has changed */
+  std::string sql_;
+  /** The declared types of the parameters, which may be fewer than the parameters */
+  std::vector<TypeId> types_;
+  uint32_t num_parameters_;
+  /** The generic plan, in which the parameters are ParameterValueExpression */
+  std::shared_ptr<const CachedPlan> plan_;
+};
+
+/**
+ * Replace the parameters of a generic plan by their values. The plan is copied, so it can be bound by several queries
+ * at once, and the values become constants, so that scans push down and pipelines fold predicates on them as usual.
+ * @param parameters the value of each parameter, by its index
+ */
+auto BindPlanParameters(const AbstractPlanNodeRef &plan, const std::vector<Value> &parameters) -> AbstractPlanNodeRef;
+
+/**
+ * PlanCache keeps the optimized plans of the statements run, by their normalized text, so that a statement that is
+ * run again skips parsing, binding, planning and optimizing. A plan is dropped once the catalog has changed since it
+ * was made, since a new table or index may give a better plan. It is shared by all queries of a BusTub instance and is
+ * thread-safe.
+ */
+class PlanCache {
+ public:
+  /** The number of plans kept; the cache is emptied when it is full */
+  static constexpr size_t CAPACITY = 1024;
+
+  /** @return the key of a statement: its text, with whitespace outside of quotes collapsed and no trailing `;` */
+  static auto Normalize(const std::string &sql) -> std::string;
+
+  /** @return the plan cached under `key`, or nullptr if there is none or it is older than `catalog_version` */
+  auto Get(const std::string &key, uint64_t catalog_version) -> std::shared_ptr<const CachedPlan>;
+
+  /** Cache a plan under `key`. */
+  void Put(const std::string &key, std::shared_ptr<const CachedPlan> plan);
+
+  /** @return the number of lookups that found a plan */
+  auto GetHits() const -> size_t;
+
+  /** @return the number of lookups that found no plan */
+  auto GetMisses() const -> size_t;
+
+ private:
+  mutable std::mutex latch_;
+  std::unordered_map<std::string, std::shared_ptr<const CachedPlan>> plans_;
+  size_t hits_{0};
+  size_t misses_{0};
+};
+
+}  // namespace bustub
@@ -109,6 +109,15 @@ class Planner {
 
   auto PlanCTERef(const BoundCTERef &table_ref) -> AbstractPlanNodeRef;
 
+  /**
+   * @brief Choose the CTEs of a statement to materialize.
+   *
+   * A CTE is inlined at each reference by default. A CTE that is referenced more than once and costs more to compute
+   * than to read back, i.e. one that does more than filter and project a single table, is materialized instead: each
+   * reference is planned as a `CTEScanPlanNode`, and the CTE is computed once per query.
+   */
+  void ChooseMaterializedCTEs(const SelectStatement &statement);
+
   auto PlanExpressionListRef(const BoundExpressionListRef &table_ref) -> AbstractPlanNodeRef;
 
   void AddAggCallToContext(BoundExpression &expr);
@@ -184,6 +193,16 @@ class Planner {
 
   /** An id for all unnamed things */
   size_t universal_id_{0};
+
+  /** A CTE that is computed once and read by all its references */
+  struct MaterializedCTE {
+    uint32_t id_;
+    /** The plan of the CTE, planned at its first reference */
+    AbstractPlanNodeRef plan_;
+  };
+
+  /** The CTEs to materialize */
+  std::unordered_map<const BoundSubqueryRef *, MaterializedCTE> materialized_ctes_;
 };
 
 static constexpr const char *const UNNAMED_COLUMN = "<unnamed>";
@@ -2,13 +2,17 @@
 
 #include <algorithm>
 #include <cstddef>
+#include <cstdint>
+#include <functional>
 #include <future>  // NOLINT
 #include <map>
 #include <memory>
 #include <optional>
 #include <stdexcept>
 #include <string>
+#include <string_view>
 #include <unordered_map>
+#include <unordered_set>
 #include <utility>
 #include <vector>
 
@@ -40,14 +44,87 @@ class MoveBlocked {
   std::future<int> wait_;
 };
 
+class TrieNode;
+
+// TrieChildren is the child table of a TrieNode, laid out as an adaptive radix tree (ART) inner node. Depending on
+// the number of children, it switches between four layouts:
+//
+// - Node4:   up to 4 sorted key bytes and 4 child pointers, searched linearly.
+// - Node16:  up to 16 sorted key bytes and 16 child pointers, searched with SIMD when available.
+// - Node48:  a 256-entry index from key byte to slot, plus 48 child pointers.
+// - Node256: 256 child pointers, indexed directly by the key byte.
+//
+// A node without children does not allocate anything. Children are always visited in ascending (unsigned) byte order.
+class TrieChildren {
+ public:
+  enum class Kind : uint8_t { NODE4, NODE16, NODE48, NODE256 };
+
+  // Create an empty child table.
+  TrieChildren() = default;
+
+  TrieChildren(const TrieChildren &that);
+  TrieChildren(TrieChildren &&that) noexcept = default;
+  auto operator=(const TrieChildren &that) -> TrieChildren &;
+  auto operator=(TrieChildren &&that) noexcept -> TrieChildren & = default;
+  ~TrieChildren() = default;
+
+  // Return the child for the key byte `c`, or nullptr if there is no such child.
+  auto Find(char c) const -> const std::shared_ptr<const TrieNode> *;
+
+  // Insert or replace the child for the key byte `c`. The layout grows if necessary.
+  void Set(char c, std::shared_ptr<const TrieNode> child);
+
+  // Remove the child for the key byte `c`. The layout shrinks if it becomes sparse. Returns false if there is no such
+  // child.
+  auto Erase(char c) -> bool;
+
+  // Call `f(key, child)` on every child in ascending key order.
+  template <class F>
+  void ForEach(F &&f) const;
+
+  auto Size() const -> size_t { return size_; }
+  auto Empty() const -> bool { return size_ == 0; }
+  auto GetKind() const -> Kind { return kind_; }
+
+  // The number of heap bytes owned by this table (not including the children themselves).
+  auto MemoryUsage() const -> size_t;
+
+ private:
+  static constexpr uint8_t EMPTY_SLOT = 0xff;
+
+  static auto Capacity(Kind kind) -> size_t;
+  static auto KeyBytes(Kind kind) -> size_t;
+  static auto ChildSlots(Kind kind) -> size_t;
+
+  // The child slot for `key`, or nullptr if there is no such child.
+  auto Slot(uint8_t key) const -> std::shared_ptr<const TrieNode> *;
+
+  // Position of `c` in the sorted key array of a Node4/Node16, or the slot it should be inserted at.
+  auto LowerBound(uint8_t c) const -> size_t;
+
+  // Rebuild the table using another layout. Keeps all children.
+  void Convert(Kind kind);
+
+  Kind kind_{Kind::NODE4};
+  uint16_t size_{0};
+  // Node4/Node16: sorted key bytes. Node48: key byte -> child slot (EMPTY_SLOT if absent). Node256: unused.
+  std::unique_ptr<uint8_t[]> keys_;
+  // Node4/Node16: children, parallel to `keys_`. Node48: child slots. Node256: children indexed by key byte.
+  std::unique_ptr<std::shared_ptr<const TrieNode>[]> children_;
+};
+
 // A TrieNode is a node in a Trie.
+//
+// Chains of nodes that have no value and only one child are collapsed into a single node (path compression). The
+// bytes skipped this way are stored in `prefix_`: to reach a node, a key must first match the branch byte in its
+// parent's child table and then the whole `prefix_` of the node.
 class TrieNode {
  public:
   // Create a TrieNode with no children.
   TrieNode() = default;
 
   // Create a TrieNode with some children.
-  explicit TrieNode(std::map<char, std::shared_ptr<const TrieNode>> children) : children_(std::move(children)) {}
+  explicit TrieNode(TrieChildren children) : children_(std::move(children)) {}
 
   virtual ~TrieNode() = default;
 
@@ -58,16 +135,20 @@ class TrieNode {
   // contains a value or not.
   //
   // Note: if you want to convert `unique_ptr` into `shared_ptr`, you can use `std::shared_ptr<T>(std::move(ptr))`.
-  virtual auto Clone() const -> std::unique_ptr<TrieNode> { return std::make_unique<TrieNode>(children_); }
+  virtual auto Clone() const -> std::unique_ptr<TrieNode> {
+    auto node = std::make_unique<TrieNode>(children_);
+    node->prefix_ = prefix_;
+    return node;
+  }
+
+  // The children of this node, keyed by the next byte of the key.
+  TrieChildren children_;
 
-  // A map of children, where the key is the next character in the key, and the value is the next TrieNode.
-  std::map<char, std::shared_ptr<const TrieNode>> children_;
+  // The compressed path between the parent's branch byte and this node.
+  std::string prefix_;
 
   // Indicates if the node is the terminal node.
   bool is_value_node_{false};
-
-  // You can add additional fields and methods here. But in general, you don't need to add extra fields to
-  // complete this project.
 };
 
 // A TrieNodeWithValue is a TrieNode that also has a value of type T associated with it.
@@ -78,7 +159,7 @@ class TrieNodeWithValue : public TrieNode {
   explicit TrieNodeWithValue(std::shared_ptr<T> value) : value_(std::move(value)) { this->is_value_node_ = true; }
 
   // Create a trie node with children and a value.
-  TrieNodeWithValue(std::map<char, std::shared_ptr<const TrieNode>> children, std::shared_ptr<T> value)
+  TrieNodeWithValue(TrieChildren children, std::shared_ptr<T> value)
       : TrieNode(std::move(children)), value_(std::move(value)) {
     this->is_value_node_ = true;
   }
@@ -87,17 +168,47 @@ class TrieNodeWithValue : public TrieNode {
   //
   // Note: if you want to convert `unique_ptr` into `shared_ptr`, you can use `std::shared_ptr<T>(std::move(ptr))`.
   auto Clone() const -> std::unique_ptr<TrieNode> override {
-    return std::make_unique<TrieNodeWithValue<T>>(children_, value_);
+    auto node = std::make_unique<TrieNodeWithValue<T>>(children_, value_);
+    node->prefix_ = prefix_;
+    return node;
   }
 
   // The value associated with this trie node.
   std::shared_ptr<T> value_;
 };
 
+template <class F>
+void TrieChildren::ForEach(F &&f) const {
+  switch (kind_) {
+    case Kind::NODE4:
+    case Kind::NODE16:
+      for (size_t i = 0; i < size_; i++) {
+        f(static_cast<char>(keys_[i]), children_[i]);
+      }
+      break;
+    case Kind::NODE48:
+      for (size_t c = 0; c < 256; c++) {
+        if (keys_[c] != EMPTY_SLOT) {
+          f(static_cast<char>(c), children_[keys_[c]]);
+        }
+      }
+      break;
+    case Kind::NODE256:
+      for (size_t c = 0; c < 256; c++) {
+        if (children_[c] != nullptr) {
+          f(static_cast<char>(c), children_[c]);
+        }
+      }
+      break;
+  }
+}
+
 // A Trie is a data structure that maps strings to values of type T. All operations on a Trie should not
 // modify the trie itself. It should reuse the existing nodes as much as possible, and create new nodes to
 // represent the new trie.
 class Trie {
+  friend class TrieWriter;
+
  private:
   // The root of the trie.
   std::shared_ptr<const TrieNode> root_{nullptr};
@@ -124,6 +235,50 @@ class Trie {
   // Remove the key from the trie. If the key does not exist, return the original trie.
   // Otherwise, returns the new trie.
   auto Remove(std::string_view key) const -> Trie;
+
+  // Get the root of the trie, should only be used in test cases.
+  auto GetRoot() const -> std::shared_ptr<const TrieNode> { return root_; }
+};
+
+// A TrieWriter applies a sequence of puts and removes to a private working copy of a trie. The first operation that
+// touches a path copies it as usual, but nodes created by the writer are then updated in place by later operations,
+// so operations that share a path only pay for copying it once. The base trie is never modified.
+class TrieWriter {
+ public:
+  // Start writing on top of `base`.
+  explicit TrieWriter(Trie base) : root_(std::move(base.root_)) {}
+
+  // Put a new key-value pair into the working copy. If the key already exists, overwrite the value.
+  template <class T>
+  void Put(std::string_view key, T value) {
+    PutShared<T>(key, std::make_shared<T>(std::move(value)));
+  }
+
+  // Same as `Put`, for a value that is already owned by a `shared_ptr`.
+  template <class T>
+  void PutShared(std::string_view key, std::shared_ptr<T> value) {
+    PutNode(key, [&value](TrieChildren children) -> std::unique_ptr<TrieNode> {
+      return std::make_unique<TrieNodeWithValue<T>>(std::move(children), value);
+    });
+  }
+
+  // Remove the key from the working copy, if it exists.
+  void Remove(std::string_view key);
+
+  // Return the working copy as an immutable trie. Later operations on this writer copy-on-write again, so the
+  // returned trie is never modified.
+  auto Finish() -> Trie;
+
+ private:
+  using MakeValueNode = std::function<std::unique_ptr<TrieNode>(TrieChildren)>;
+
+  void PutNode(std::string_view key, const MakeValueNode &make_value_node);
+
+  // The root of the working copy.
+  std::shared_ptr<const TrieNode> root_;
+
+  // Nodes created by this writer since the last `Finish`. Only these can be modified in place.
+  std::unordered_set<const TrieNode *> owned_;
 };
 
 }  // namespace bustub
@@ -1,8 +1,14 @@
 #pragma once
 
+#include <condition_variable>  // NOLINT
+#include <deque>
+#include <exception>
+#include <functional>
 #include <optional>
 #include <shared_mutex>
+#include <string>
 #include <utility>
+#include <vector>
 
 #include "primer/trie.h"
 
@@ -26,6 +32,35 @@ class ValueGuard {
 // time.
 class TrieStore {
  public:
+  // A WriteBatch collects puts and removes that are committed to the store atomically by `TrieStore::Write`. Readers
+  // either see all of the operations of a batch or none of them.
+  class WriteBatch {
+   public:
+    // Record a put of the key-value pair. Operations are applied in the order they were recorded.
+    template <class T>
+    void Put(std::string_view key, T value) {
+      // Note that `T` might be a non-copyable type, so the value is moved into shared storage right away.
+      ops_.emplace_back([key = std::string(key), value = std::make_shared<T>(std::move(value))](TrieWriter &writer) {
+        writer.PutShared<T>(key, value);
+      });
+    }
+
+    // Record a removal of the key.
+    void Remove(std::string_view key) {
+      ops_.emplace_back([key = std::string(key)](TrieWriter &writer) { writer.Remove(key); });
+    }
+
+    // Record any other operation on the working copy, e.g. one that reads a key before it writes it.
+    void Apply(std::function<void(TrieWriter &)> op) { ops_.push_back(std::move(op)); }
+
+    auto Size() const -> size_t { return ops_.size(); }
+    auto Empty() const -> bool { return ops_.empty(); }
+
+   private:
+    friend class TrieStore;
+    std::vector<std::function<void(TrieWriter &)>> ops_;
+  };
+
   // This function returns a ValueGuard object that holds a reference to the value in the trie. If
   // the key does not exist in the trie, it will return std::nullopt.
   template <class T>
@@ -39,7 +74,27 @@ class TrieStore {
   // This function will remove the key-value pair from the trie.
   void Remove(std::string_view key);
 
+  // This function applies all operations of the batch to the trie and publishes the result as one new root.
+  //
+  // Writers that arrive while another commit is in progress are queued, and the first writer in the queue commits
+  // the batches of all queued writers as one group: their operations are applied to a single working copy in arrival
+  // order, and a single new root is published for the whole group. If an operation throws, none of the operations of
+  // its batch are published, and the exception is rethrown to the writer of that batch only. The other batches of the
+  // group are committed.
+  void Write(WriteBatch batch);
+
  private:
+  // A writer waiting in the commit queue.
+  struct PendingWrite {
+    WriteBatch *batch_;
+    bool done_{false};
+    // The exception that failed the batch, if any.
+    std::exception_ptr error_{nullptr};
+  };
+
+  // The maximum number of batches committed by one group commit.
+  static constexpr size_t MAX_GROUP_SIZE = 128;
+
   // This mutex protects the root. Every time you want to access the trie root or modify it, you
   // will need to take this lock.
   std::mutex root_lock_;
@@ -49,6 +104,15 @@ class TrieStore {
 
   // Stores the current root for the trie.
   Trie root_;
+
+  // This mutex protects the commit queue.
+  std::mutex queue_lock_;
+
+  // Signaled when a group commit finishes.
+  std::condition_variable queue_cv_;
+
+  // Writers waiting to commit, in arrival order. The writer at the front commits for the whole group.
+  std::deque<PendingWrite *> queue_;
 };
 
 }  // namespace bustub
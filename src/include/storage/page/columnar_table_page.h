@@ -0,0 +1,187 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// columnar_table_page.h
+//
+// Identification: src/include/storage/page/columnar_table_page.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstddef>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "catalog/schema.h"
+#include "common/config.h"
+#include "common/rid.h"
+#include "storage/table/column_encoding.h"
+#include "storage/table/scan_predicate.h"
+#include "storage/table/tuple.h"
+
+namespace bustub {
+
+static constexpr uint64_t COLUMNAR_TABLE_PAGE_HEADER_SIZE = 20;
+
+/**
+ * PAX page format: the tuples of the page are split into one minipage per column, so a scan that reads a few columns
+ * of a wide table only touches their minipages. The page holds a fixed number of tuples, its capacity, which is
+ * chosen from the schema when the page is initialized.
+ *  ------------------------------------------------------------------------------------------------
+ *  | HEADER | METAS | VARLEN SLOTS | COLUMN 0 | COLUMN 1 | ... | ... FREE SPACE ... | VARLEN DATA |
+ *  ------------------------------------------------------------------------------------------------
+ *                                                                                    ^
+ *                                                                                    varlen begin
+ *
+ *  Header format (size in bytes):
+ *  -------------------------------------------------------------------------------------------------------------
+ *  | NextPageId (4) | NumTuples (2) | NumDeletedTuples (2) | Capacity (2) | TupleLength (2) | VarlenBegin (2) |
+ *  -------------------------------------------------------------------------------------------------------------
+ *  | NumEncoded (2) | TailBegin (2) | (2) |
+ *  ---------------------------------------
+ *
+ * The minipage of a column holds the bytes the column has in the fixed-size part of the tuple format (see Tuple), one
+ * entry per slot. The variable-size part of a tuple, which holds its VARCHAR values, is stored as a whole in the
+ * varlen data at the end of the page, and its varlen slot records where. A tuple can thus be put together again
+ * byte for byte, and out-of-line VARCHAR values (see ToastStore) need no special handling.
+ *
+ * Once the page is full, Freeze compresses the tuples in it: each minipage, and the offsets and sizes of the varlen
+ * slots, is replaced by an EncodedColumn, and tuples with the same variable-size part share one copy of it. The space
+ * saved becomes more slots, whose minipages (the tail) follow the encoded columns, so the tuples keep their slots:
+ *  ---------------------------------------------------------------------------------------------------------------
+ *  | HEADER | METAS | TAIL VARLEN SLOTS | DIRECTORY | ENCODED COLUMNS | TAIL COLUMN 0 | ... | FREE | VARLEN DATA |
+ *  ---------------------------------------------------------------------------------------------------------------
+ *                                                                     ^ tail begin
+ * The directory holds the offset of each encoded column: the varlen offsets, the varlen sizes, then the columns of
+ * the schema. The encoded tuples are read only, and a page whose tail fills up is frozen again as a whole.
+ *
+ * The header starts like that of TablePage, so walks along the page chain, which only read the next page id and the
+ * number of tuples, work on both kinds of pages. Deleted tuples are only marked, columnar pages are not vacuumed.
+ */
+class ColumnarTablePage {
+ public:
+  /** Initialize the page for tuples of `schema`. */
+  void Init(const Schema &schema);
+
+  /** @return the number of tuples a page for `schema` holds, assuming that VARCHAR values half fill their column */
+  static auto Capacity(const Schema &schema) -> uint32_t;
+
+  /** @return number of tuples in this page */
+  auto GetNumTuples() const -> uint32_t { return num_tuples_; }
+
+  /** @return number of tuples in this page that are marked as deleted */
+  auto GetNumDeletedTuples() const -> uint32_t { return num_deleted_tuples_; }
+
+  /** @return the page ID of the next table page */
+  auto GetNextPageId() const -> page_id_t { return next_page_id_; }
+
+  /** Set the page id of the next page in the table. */
+  void SetNextPageId(page_id_t next_page_id) { next_page_id_ = next_page_id; }
+
+  /** @return the maximum number of tuples in this page */
+  auto GetCapacity() const -> uint32_t { return capacity_; }
+
+  /** @return the number of tuples stored in encoded columns, which come first in the page */
+  auto GetNumEncodedTuples() const -> uint32_t { return num_encoded_; }
+
+  /** @return the length of the largest tuple the page has room for, 0 if all its slots are taken */
+  auto GetFreeSpaceRemaining() const -> uint32_t;
+
+  /**
+   * Insert a tuple into the page.
+   * @return the slot of the tuple, or std::nullopt if the page is full or has no room for its VARCHAR values
+   */
+  auto InsertTuple(const TupleMeta &meta, const Tuple &tuple, const Schema &schema) -> std::optional<uint16_t>;
+
+  /** Update the meta of a tuple. */
+  void UpdateTupleMeta(const TupleMeta &meta, const RID &rid);
+
+  /** Read a tuple, putting it together from the minipages. */
+  auto GetTuple(const RID &rid, const Schema &schema) const -> std::pair<TupleMeta, Tuple>;
+
+  /** Read a tuple meta. */
+  auto GetTupleMeta(const RID &rid) const -> TupleMeta;
+
+  /**
+   * Read one column of a tuple from its minipage. A VARCHAR value points into the page, and an out-of-line one is
+   * fetched from `toast_store`.
+   */
+  auto GetValue(uint32_t slot, uint32_t column_idx, const Schema &schema, const ToastStore *toast_store) const -> Value;
+
+  /**
+   * Evaluate a predicate on every tuple of the page. The terms on encoded columns are evaluated on the encoded form,
+   * e.g. once per distinct value of a dictionary-encoded column.
+   * @param[out] keep 1 for each slot whose tuple passes, 0 for each other one
+   */
+  void Evaluate(const ScanPredicate &predicate, const Schema &schema, std::vector<uint8_t> *keep) const;
+
+  /** Update a tuple in place. Its VARCHAR values must take as much space as before, and it must not be encoded. */
+  void UpdateTupleInPlaceUnsafe(const TupleMeta &meta, const Tuple &tuple, RID rid, const Schema &schema);
+
+  /**
+   * Compress all tuples of the page into encoded columns, and make room for more tuples with the space saved.
+   * @return whether the page has room for more tuples now; if not, it is left as it was
+   */
+  auto Freeze(const Schema &schema) -> bool;
+
+  static_assert(sizeof(page_id_t) == 4);
+
+ private:
+  /** Where the variable-size part of a tuple is stored in the page */
+  struct VarlenSlot {
+    uint16_t offset_;
+    uint16_t size_;
+  };
+
+  /** @return the number of bytes a tuple takes in its fixed-size slots, not counting its VARCHAR values */
+  static auto SlotSize(const Schema &schema) -> uint32_t;
+
+  auto Metas() const -> TupleMeta * {
+    return reinterpret_cast<TupleMeta *>(const_cast<char *>(page_start_) + COLUMNAR_TABLE_PAGE_HEADER_SIZE);
+  }
+
+  /** @return the number of slots of the tail, which are stored in minipages */
+  auto TailCapacity() const -> uint32_t { return capacity_ - num_encoded_; }
+
+  /** @return the varlen slots of the tail, the one of slot `num_encoded_` first */
+  auto VarlenSlots() const -> VarlenSlot * {
+    return reinterpret_cast<VarlenSlot *>(reinterpret_cast<char *>(Metas()) + capacity_ * TUPLE_META_SIZE);
+  }
+
+  /** @return the bytes of a column of a tuple of the tail in its minipage */
+  auto ColumnData(uint32_t slot, const Column &column) const -> char * {
+    // The minipages are laid out in column order, so the one of a column starts at the tail capacity times its offset.
+    return const_cast<char *>(page_start_) + tail_begin_ + TailCapacity() * column.GetOffset() +
+           (slot - num_encoded_) * column.GetFixedLength();
+  }
+
+  /** @return the k-th encoded column, see the directory in the page layout */
+  auto Encoded(uint32_t k) const -> EncodedColumn;
+
+  /** @return the varlen slot of a tuple, encoded or not */
+  auto GetVarlenSlot(uint32_t slot) const -> VarlenSlot;
+
+  /** Copy the bytes of a column of a tuple, encoded or not, to `dest`. */
+  void CopyColumn(uint32_t slot, uint32_t column_idx, const Column &column, char *dest) const;
+
+  /** @return the number of bytes free for VARCHAR values */
+  auto GetFreeVarlenSpace() const -> uint32_t;
+
+  char page_start_[0];
+  page_id_t next_page_id_;
+  uint16_t num_tuples_;
+  uint16_t num_deleted_tuples_;
+  uint16_t capacity_;
+  uint16_t tuple_length_;
+  uint16_t varlen_begin_;
+  uint16_t num_encoded_;
+  uint16_t tail_begin_;
+  uint16_t reserved_;
+};
+
+static_assert(sizeof(ColumnarTablePage) == COLUMNAR_TABLE_PAGE_HEADER_SIZE);
+
+}  // namespace bustub
@@ -0,0 +1,102 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// free_space_map_page.h
+//
+// Identification: src/include/storage/page/free_space_map_page.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+#include <optional>
+
+#include "common/config.h"
+
+namespace bustub {
+
+static constexpr uint64_t FSM_PAGE_HEADER_SIZE = 8;
+
+/**
+ * A free space map page records the approximate free space of a run of table pages, one byte per table page.
+ *
+ * Free space map page format:
+ *  ----------------------------------------------------------------------------------------------
+ *  | HEADER | PageId_1 (4) | PageId_2 (4) | ... | Category_1 (1) | Category_2 (1) | ... |
+ *  ----------------------------------------------------------------------------------------------
+ *
+ *  Header format (size in bytes):
+ *  ---------------------------------
+ *  | NextPageId (4) | NumEntries (4) |
+ *  ---------------------------------
+ *
+ * A category is the free space of the table page divided by FSM_CATEGORY_BYTES (rounded down), so a page in category
+ * `c` has at least `c * FSM_CATEGORY_BYTES` bytes available.
+ */
+class FreeSpaceMapPage {
+ public:
+  /** Number of free bytes represented by one category step. */
+  static constexpr uint32_t FSM_CATEGORY_BYTES = BUSTUB_PAGE_SIZE / 256;
+
+  /** Maximum number of table pages tracked by one free space map page. */
+  static constexpr uint32_t FSM_PAGE_CAPACITY =
+      (BUSTUB_PAGE_SIZE - FSM_PAGE_HEADER_SIZE) / (sizeof(page_id_t) + sizeof(uint8_t));
+
+  /** Initialize an empty free space map page. */
+  void Init();
+
+  /** @return the page ID of the next free space map page */
+  auto GetNextPageId() const -> page_id_t { return next_page_id_; }
+
+  /** Set the page id of the next free space map page. */
+  void SetNextPageId(page_id_t next_page_id) { next_page_id_ = next_page_id; }
+
+  /** @return number of table pages tracked by this page */
+  auto GetNumEntries() const -> uint32_t { return num_entries_; }
+
+  /** @return true if no more table pages can be added to this page */
+  auto IsFull() const -> bool { return num_entries_ == FSM_PAGE_CAPACITY; }
+
+  /** @return the table page tracked at `index` */
+  auto PageIdAt(uint32_t index) const -> page_id_t;
+
+  /** @return the category of the table page tracked at `index` */
+  auto CategoryAt(uint32_t index) const -> uint8_t;
+
+  /**
+   * Start tracking a table page.
+   * @return the index of the new entry, or std::nullopt if this page is full
+   */
+  auto AddEntry(page_id_t page_id, uint8_t category) -> std::optional<uint32_t>;
+
+  /** Set the category of the table page tracked at `index`. */
+  void SetCategory(uint32_t index, uint8_t category);
+
+  /**
+   * Find a table page of at least category `min_category`, looking at entries [begin, end) in order.
+   * @return index of the first matching entry, or std::nullopt if there is none
+   */
+  auto FindEntry(uint8_t min_category, uint32_t begin, uint32_t end) const -> std::optional<uint32_t>;
+
+  /** @return the category of a table page with `free_bytes` bytes available */
+  static auto CategoryOf(uint32_t free_bytes) -> uint8_t;
+
+  /** @return the smallest category that guarantees `bytes` bytes are available */
+  static auto MinCategoryFor(uint32_t bytes) -> uint8_t;
+
+ private:
+  auto Categories() const -> const uint8_t * {
+    return reinterpret_cast<const uint8_t *>(page_ids_ + FSM_PAGE_CAPACITY);
+  }
+  auto Categories() -> uint8_t * { return reinterpret_cast<uint8_t *>(page_ids_ + FSM_PAGE_CAPACITY); }
+
+  page_id_t next_page_id_;
+  uint32_t num_entries_;
+  page_id_t page_ids_[0];
+};
+
+static_assert(sizeof(FreeSpaceMapPage) == FSM_PAGE_HEADER_SIZE);
+
+}  // namespace bustub
@@ -0,0 +1,68 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// overflow_page.h
+//
+// Identification: src/include/storage/page/overflow_page.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+
+#include "common/config.h"
+
+namespace bustub {
+
+static constexpr uint64_t OVERFLOW_PAGE_HEADER_SIZE = 8;
+
+/**
+ * An overflow page holds one chunk of a value that is stored out of line. The chunks of a value form a singly
+ * linked list of overflow pages.
+ *
+ * Overflow page format:
+ *  ------------------------------------------------
+ *  | NextPageId (4) | DataSize (4) | ... DATA ... |
+ *  ------------------------------------------------
+ */
+class OverflowPage {
+ public:
+  /** Maximum number of data bytes in one overflow page. */
+  static constexpr uint32_t OVERFLOW_PAGE_CAPACITY = BUSTUB_PAGE_SIZE - OVERFLOW_PAGE_HEADER_SIZE;
+
+  /** Initialize an empty overflow page. */
+  void Init() {
+    next_page_id_ = INVALID_PAGE_ID;
+    data_size_ = 0;
+  }
+
+  /** @return the page ID of the next overflow page of the value */
+  auto GetNextPageId() const -> page_id_t { return next_page_id_; }
+
+  /** Set the page id of the next overflow page of the value. */
+  void SetNextPageId(page_id_t next_page_id) { next_page_id_ = next_page_id; }
+
+  /** @return number of data bytes in this page */
+  auto GetDataSize() const -> uint32_t { return data_size_; }
+
+  /** @return the data stored in this page */
+  auto GetData() const -> const char * { return data_; }
+
+  /** Store `size` bytes (at most OVERFLOW_PAGE_CAPACITY) in this page. */
+  void SetData(const char *data, uint32_t size) {
+    memcpy(data_, data, size);
+    data_size_ = size;
+  }
+
+ private:
+  page_id_t next_page_id_;
+  uint32_t data_size_;
+  char data_[0];
+};
+
+static_assert(sizeof(OverflowPage) == OVERFLOW_PAGE_HEADER_SIZE);
+
+}  // namespace bustub
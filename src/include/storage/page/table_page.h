@@ -13,6 +13,7 @@
 #pragma once
 
 #include <cstring>
+#include <functional>
 #include <optional>
 #include <tuple>
 #include <utility>
@@ -59,12 +60,18 @@ class TablePage {
   /** @return number of tuples in this page */
   auto GetNumTuples() const -> uint32_t { return num_tuples_; }
 
+  /** @return number of tuples in this page that are marked as deleted */
+  auto GetNumDeletedTuples() const -> uint32_t { return num_deleted_tuples_; }
+
   /** @return the page ID of the next table page */
   auto GetNextPageId() const -> page_id_t { return next_page_id_; }
 
   /** Set the page id of the next page in the table. */
   void SetNextPageId(page_id_t next_page_id) { next_page_id_ = next_page_id; }
 
+  /** @return the number of bytes available for the data of the next inserted tuple */
+  auto GetFreeSpaceRemaining() const -> uint32_t;
+
   /** Get the next offset to insert, return nullopt if this tuple cannot fit in this page */
   auto GetNextTupleOffset(const TupleMeta &meta, const Tuple &tuple) const -> std::optional<uint16_t>;
 
@@ -85,6 +92,12 @@ class TablePage {
    */
   auto GetTuple(const RID &rid) const -> std::pair<TupleMeta, Tuple>;
 
+  /**
+   * Read a tuple from a table in place. The view points into the page, so it must not be used once the page is
+   * unlatched.
+   */
+  auto GetTupleView(const RID &rid) const -> std::pair<TupleMeta, TupleView>;
+
   /**
    * Read a tuple meta from a table.
    */
@@ -95,6 +108,18 @@ class TablePage {
    */
   void UpdateTupleInPlaceUnsafe(const TupleMeta &meta, const Tuple &tuple, RID rid);
 
+  /**
+   * Reclaim the space of deleted tuples. The data of every deleted tuple accepted by `can_reclaim` is dropped and the
+   * remaining tuples are packed against the end of the page. Tuples only move within the page and keep their slot, so
+   * RIDs stay valid. Trailing slots of reclaimed tuples are removed, which empties the page if all tuples are gone.
+   * @param page_id the id of this page
+   * @param can_reclaim whether a deleted tuple with the given metadata may be reclaimed
+   * @param on_reclaim if set, called with every tuple before its data is dropped
+   * @return the number of tuples whose data was reclaimed
+   */
+  auto Vacuum(page_id_t page_id, const std::function<bool(const TupleMeta &)> &can_reclaim,
+              const std::function<void(const Tuple &)> &on_reclaim = nullptr) -> uint32_t;
+
   static_assert(sizeof(page_id_t) == 4);
 
  private:
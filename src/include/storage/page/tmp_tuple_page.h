@@ -1,16 +1,19 @@
 #pragma once
 
-#include "storage/page/page.h"
+#include <cstring>
+
+#include "common/config.h"
 #include "storage/table/tmp_tuple.h"
 #include "storage/table/tuple.h"
 
 namespace bustub {
 
-// To pass the test cases for this class, you must follow the existing TmpTuplePage format and implement the
-// existing functions exactly as they are! It may be helpful to look at TablePage.
-// Remember that this task is optional, you get full credit if you finish the next task.
+static constexpr uint64_t TMP_TUPLE_PAGE_HEADER_SIZE = 12;
 
 /**
+ * A TmpTuplePage holds temporary tuples, e.g. the rows an operator spills when it runs out of memory. Tuples are
+ * appended from the end of the page towards the header, and are never updated or deleted one by one.
+ *
  * TmpTuplePage format:
  *
  * Sizes are in bytes.
@@ -18,19 +21,92 @@ namespace bustub {
  *
  * We choose this format because DeserializeExpression expects to read Size followed by Data.
  */
-class TmpTuplePage : public Page {
+class TmpTuplePage {
  public:
+  /**
+   * Initialize an empty page.
+   * @param page_id the id of the page
+   * @param page_size the size of the page, tuples end at this offset
+   */
   void Init(page_id_t page_id, uint32_t page_size) {
-    memcpy(GetData(), &page_id, sizeof(page_id_t));
-    memcpy(GetData() + sizeof(page_id_t), &page_size, sizeof(uint32_t));
+    page_id_ = page_id;
+    lsn_ = INVALID_LSN;
+    free_space_pointer_ = page_size;
   }
 
-  auto GetTablePageId() -> page_id_t { return INVALID_PAGE_ID; }
+  /** @return the id of this page */
+  auto GetTablePageId() const -> page_id_t { return page_id_; }
+
+  /** Set the id of this page, e.g. after the page was filled in a buffer outside of the buffer pool. */
+  void SetTablePageId(page_id_t page_id) { page_id_ = page_id; }
+
+  /** @return the offset of the most recently inserted tuple, the page size if the page is empty */
+  auto GetFreeSpacePointer() const -> uint32_t { return free_space_pointer_; }
 
-  auto Insert(const Tuple &tuple, TmpTuple *out) -> bool { return false; }
+  /** @return the room left for entries, counting their size fields */
+  auto GetFreeSpaceRemaining() const -> uint32_t { return free_space_pointer_ - TMP_TUPLE_PAGE_HEADER_SIZE; }
+
+  /**
+   * Insert a tuple.
+   * @param tuple the tuple to insert
+   * @param[out] out where the tuple was stored
+   * @return false if the page does not have enough room left
+   */
+  auto Insert(const Tuple &tuple, TmpTuple *out) -> bool { return Insert(tuple.GetData(), tuple.GetLength(), out); }
+
+  /**
+   * Insert raw bytes, stored in the same format as a tuple.
+   * @param data the bytes to insert
+   * @param size the number of bytes
+   * @param[out] out where the bytes were stored
+   * @return false if the page does not have enough room left
+   */
+  auto Insert(const char *data, uint32_t size, TmpTuple *out) -> bool {
+    if (GetFreeSpaceRemaining() < sizeof(uint32_t) + size) {
+      return false;
+    }
+    free_space_pointer_ -= sizeof(uint32_t) + size;
+    memcpy(PageStart() + free_space_pointer_, &size, sizeof(uint32_t));
+    memcpy(PageStart() + free_space_pointer_ + sizeof(uint32_t), data, size);
+    *out = TmpTuple(page_id_, free_space_pointer_);
+    return true;
+  }
+
+  /**
+   * Read the tuple stored at an offset. Starting at the free space pointer, the tuples of the page can be read one
+   * after the other, from the most recently inserted one to the first one.
+   * @param offset the offset of the tuple
+   * @param[out] tuple the tuple
+   * @return the offset of the tuple inserted before it, or the page size if it is the first one
+   */
+  auto ReadTuple(uint32_t offset, Tuple *tuple) const -> uint32_t {
+    tuple->DeserializeFrom(PageStart() + offset);
+    return offset + sizeof(uint32_t) + tuple->GetLength();
+  }
+
+  /**
+   * Read the bytes stored at an offset without copying them, like ReadTuple.
+   * @param offset the offset of the entry
+   * @param[out] data the bytes, which point into the page
+   * @param[out] size the number of bytes
+   * @return the offset of the entry inserted before it, or the page size if it is the first one
+   */
+  auto ReadData(uint32_t offset, const char **data, uint32_t *size) const -> uint32_t {
+    memcpy(size, PageStart() + offset, sizeof(uint32_t));
+    *data = PageStart() + offset + sizeof(uint32_t);
+    return offset + sizeof(uint32_t) + *size;
+  }
 
  private:
-  static_assert(sizeof(page_id_t) == 4);
+  auto PageStart() -> char * { return reinterpret_cast<char *>(this); }
+  auto PageStart() const -> const char * { return reinterpret_cast<const char *>(this); }
+
+  page_id_t page_id_;
+  lsn_t lsn_;
+  uint32_t free_space_pointer_;
 };
 
+static_assert(sizeof(page_id_t) == 4);
+static_assert(sizeof(TmpTuplePage) == TMP_TUPLE_PAGE_HEADER_SIZE);
+
 }  // namespace bustub
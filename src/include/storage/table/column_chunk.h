@@ -0,0 +1,69 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// column_chunk.h
+//
+// Identification: src/include/storage/table/column_chunk.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "catalog/schema.h"
+#include "common/config.h"
+#include "common/rid.h"
+#include "storage/page/columnar_table_page.h"
+#include "storage/table/tuple.h"
+
+namespace bustub {
+
+class ToastStore;
+
+/**
+ * ColumnChunk is a copy of a columnar table page that a scan read, together with the slots of the tuples it read.
+ * Copying the page is a single memcpy, after which the page is unlatched, and the columns of the tuples are then
+ * decoded from their minipages as they are asked for, so columns that nobody reads are never decoded.
+ */
+class ColumnChunk {
+ public:
+  /**
+   * @param page the page to copy
+   * @param page_id the id of the page
+   * @param slots the slots of the tuples of the chunk, in order
+   * @param schema the schema of the tuples, which must outlive the chunk
+   * @param toast_store where the out-of-line values of the table are stored, if any
+   */
+  ColumnChunk(const ColumnarTablePage &page, page_id_t page_id, std::vector<uint16_t> slots, const Schema *schema,
+              const ToastStore *toast_store);
+
+  /** @return the number of tuples in the chunk */
+  auto Size() const -> uint32_t { return slots_.size(); }
+
+  /** @return the RID of the i-th tuple */
+  auto GetRid(uint32_t i) const -> RID { return {page_id_, slots_[i]}; }
+
+  /** @return the value of a column of the i-th tuple, which for a VARCHAR points into the chunk */
+  auto GetValue(uint32_t i, uint32_t column_idx) const -> Value {
+    return GetPage()->GetValue(slots_[i], column_idx, *schema_, toast_store_);
+  }
+
+  /** @return the i-th tuple, put together from all its columns */
+  auto GetTuple(uint32_t i) const -> Tuple;
+
+ private:
+  auto GetPage() const -> const ColumnarTablePage * {
+    return reinterpret_cast<const ColumnarTablePage *>(data_.data());
+  }
+
+  std::vector<char> data_;
+  page_id_t page_id_;
+  std::vector<uint16_t> slots_;
+  const Schema *schema_;
+  const ToastStore *toast_store_;
+};
+
+}  // namespace bustub
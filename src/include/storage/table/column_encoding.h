@@ -0,0 +1,140 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// column_encoding.h
+//
+// Identification: src/include/storage/table/column_encoding.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace bustub {
+
+/** The lightweight encodings of a column of integers */
+enum class ColumnEncoding : uint8_t {
+  PLAIN,               // the values, each in `width` bytes
+  RUN_LENGTH,          // runs of equal values, as the value and the end of each run
+  DICTIONARY,          // the distinct values in ascending order, and the bit-packed index of each value among them
+  FRAME_OF_REFERENCE,  // the smallest value, and the bit-packed difference of each value to it
+};
+
+/**
+ * EncodedColumn reads a column of integers encoded by EncodedColumn::Encode, in place. The values are the bytes of
+ * fixed-width columns, sign-extended to 64 bits, so that a value is written back exactly by storing its `width` low
+ * bytes. Encode measures the column (its number of distinct values, runs and its range) and picks the encoding that
+ * takes the least space.
+ *
+ * Filter evaluates a predicate on the encoded form: once per distinct value for a dictionary, once per run for
+ * run-length encoding, and on the unpacked values otherwise.
+ *
+ * Format: | Encoding (1) | Width (1) | Bits (1) | (1) | Count (4) | payload |, where the payload is
+ *  - PLAIN: Count values of Width bytes
+ *  - RUN_LENGTH: NumRuns (4), NumRuns values (8 each), NumRuns run ends (2 each)
+ *  - DICTIONARY: NumEntries (4), NumEntries values (8 each), Count codes of Bits bits
+ *  - FRAME_OF_REFERENCE: Base (8), Count differences of Bits bits
+ * Bit-packed values are followed by 8 bytes of padding, so that each one is read with a single 64-bit load.
+ */
+class EncodedColumn {
+ public:
+  /** The largest number of bits of a bit-packed value */
+  static constexpr uint32_t MAX_PACKED_BITS = 56;
+
+  /**
+   * Encode a column.
+   * @param values the values, at most 65535 of them
+   * @param width the number of bytes of each value in its column, 1, 2, 4 or 8
+   * @return the encoded column
+   */
+  static auto Encode(const std::vector<int64_t> &values, uint32_t width) -> std::vector<char>;
+
+  /** @param data an encoded column, which must outlive the reader */
+  explicit EncodedColumn(const char *data);
+
+  auto GetEncoding() const -> ColumnEncoding { return encoding_; }
+
+  /** @return the number of values */
+  auto Size() const -> uint32_t { return count_; }
+
+  /** @return the i-th value */
+  auto Get(uint32_t i) const -> int64_t;
+
+  /** Decode all values into `out`. */
+  void Decode(std::vector<int64_t> *out) const;
+
+  /**
+   * Clear keep[i] for every value that does not pass, without decoding a dictionary or run-length column.
+   * @param pass whether a value passes
+   * @param keep one flag per value
+   */
+  template <typename Pass>
+  void Filter(const Pass &pass, uint8_t *keep) const {
+    switch (encoding_) {
+      case ColumnEncoding::DICTIONARY: {
+        std::vector<uint8_t> passing(num_entries_);
+        for (uint32_t k = 0; k < num_entries_; k++) {
+          passing[k] = pass(Load<int64_t>(entries_ + k * sizeof(int64_t))) ? 1 : 0;
+        }
+        for (uint32_t i = 0; i < count_; i++) {
+          keep[i] &= passing[Unpack(i)];
+        }
+        break;
+      }
+      case ColumnEncoding::RUN_LENGTH: {
+        uint32_t begin = 0;
+        for (uint32_t r = 0; r < num_entries_; r++) {
+          auto end = Load<uint16_t>(run_ends_ + r * sizeof(uint16_t));
+          if (!pass(Load<int64_t>(entries_ + r * sizeof(int64_t)))) {
+            std::memset(keep + begin, 0, end - begin);
+          }
+          begin = end;
+        }
+        break;
+      }
+      default:
+        for (uint32_t i = 0; i < count_; i++) {
+          keep[i] &= pass(Get(i)) ? 1 : 0;
+        }
+        break;
+    }
+  }
+
+  /** @return the number of bytes of an encoded column */
+  static auto ByteSize(const char *data) -> uint32_t;
+
+  static constexpr uint32_t HEADER_SIZE = 8;
+
+ private:
+  template <typename T>
+  static auto Load(const char *data) -> T {
+    T value;
+    std::memcpy(&value, data, sizeof(T));
+    return value;
+  }
+
+  /** @return the i-th bit-packed value */
+  auto Unpack(uint32_t i) const -> uint64_t {
+    uint64_t bit = static_cast<uint64_t>(i) * bits_;
+    return (Load<uint64_t>(packed_ + bit / 8) >> (bit % 8)) & mask_;
+  }
+
+  ColumnEncoding encoding_;
+  uint32_t width_;
+  uint32_t bits_;
+  uint32_t count_;
+  uint64_t mask_;
+  int64_t base_{0};
+  /** The run values or dictionary entries, and their number */
+  const char *entries_{nullptr};
+  uint32_t num_entries_{0};
+  const char *run_ends_{nullptr};
+  /** The plain values or the bit-packed values */
+  const char *packed_{nullptr};
+};
+
+}  // namespace bustub
@@ -0,0 +1,101 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// free_space_map.h
+//
+// Identification: src/include/storage/table/free_space_map.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <mutex>  // NOLINT
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "common/config.h"
+#include "storage/page/free_space_map_page.h"
+
+namespace bustub {
+
+/**
+ * FreeSpaceMap tracks the approximate free space of every page of a table heap, so that inserts can reuse space in
+ * any page instead of always appending to the last one. The map itself is a linked list of FreeSpaceMapPages in the
+ * buffer pool; an in-memory upper bound of the categories on each map page lets searches skip map pages that cannot
+ * contain a match.
+ *
+ * To avoid all inserters contending on the same table page, inserts are spread over NUM_SHARDS shards (usually chosen
+ * by thread). Each shard remembers the page it inserted into last, and a search prefers pages that are not currently
+ * used by another shard.
+ */
+class FreeSpaceMap {
+ public:
+  /** Number of insert shards. */
+  static constexpr size_t NUM_SHARDS = 8;
+
+  /**
+   * Create an empty free space map.
+   * @param bpm the buffer pool manager that holds the map pages
+   */
+  explicit FreeSpaceMap(BufferPoolManager *bpm);
+
+  /**
+   * Start tracking a new table page, and make it the current page of `shard`.
+   * @param page_id the table page
+   * @param free_bytes bytes available in the table page
+   * @param shard the shard that is going to insert into the page, std::nullopt to leave it to the first search
+   */
+  void AddPage(page_id_t page_id, uint32_t free_bytes, std::optional<size_t> shard);
+
+  /**
+   * Record the current free space of a tracked table page.
+   * @param page_id the table page
+   * @param free_bytes bytes available in the table page
+   */
+  void UpdatePage(page_id_t page_id, uint32_t free_bytes);
+
+  /**
+   * Find a table page that had at least `bytes` bytes available when it was last recorded, and make it the current
+   * page of `shard`. The caller must check the page again after latching it.
+   * @return the table page, or INVALID_PAGE_ID if no page is known to have enough space
+   */
+  auto FindPage(uint32_t bytes, size_t shard) -> page_id_t;
+
+  /** @return the number of table pages being tracked */
+  auto GetNumPages() -> size_t;
+
+  /** @return the id of the first free space map page */
+  auto GetFirstPageId() const -> page_id_t { return first_page_id_; }
+
+ private:
+  /** @return the position of entry number `entry` as (index into fsm_page_ids_, index within that page) */
+  static auto Locate(size_t entry) -> std::pair<size_t, uint32_t> {
+    return {entry / FreeSpaceMapPage::FSM_PAGE_CAPACITY, entry % FreeSpaceMapPage::FSM_PAGE_CAPACITY};
+  }
+
+  /** @return true if `entry` is the current page of a shard other than `shard`. Must hold latch_. */
+  auto ClaimedByOtherShard(size_t entry, size_t shard) const -> bool;
+
+  BufferPoolManager *bpm_;
+  page_id_t first_page_id_{INVALID_PAGE_ID};
+
+  /** Serializes `AddPage`. Latch order: append_latch_, then map pages, then latch_. */
+  std::mutex append_latch_;
+  /** Protects all members below. Never held while latching a page. */
+  std::mutex latch_;
+  /** Page ids of the map pages, in list order. */
+  std::vector<page_id_t> fsm_page_ids_;
+  /** Upper bound of the categories recorded on each map page. */
+  std::vector<uint8_t> max_category_;
+  /** Table page -> entry number in the map. */
+  std::unordered_map<page_id_t, size_t> entries_;
+  /** Total number of entries. */
+  size_t num_entries_{0};
+  /** The entry each shard inserted into last. */
+  std::vector<std::optional<size_t>> shard_entries_;
+};
+
+}  // namespace bustub
@@ -0,0 +1,118 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// scan_predicate.h
+//
+// Identification: src/include/storage/table/scan_predicate.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "catalog/schema.h"
+#include "type/type_id.h"
+#include "type/value.h"
+
+namespace bustub {
+
+/** The range of the values of a fixed-width column over some tuples */
+struct ColumnRange {
+  /** The bounds of an integer column, valid if num_values_ > 0 */
+  int64_t min_integer_{0};
+  int64_t max_integer_{0};
+  /** The bounds of a decimal column, valid if num_values_ > 0 */
+  double min_decimal_{0};
+  double max_decimal_{0};
+  /** The number of non-null values */
+  uint32_t num_values_{0};
+  uint32_t num_nulls_{0};
+};
+
+/**
+ * ScanPredicate is a conjunction of comparisons of fixed-width columns against constants, which a TableIterator
+ * evaluates on the tuples of a page in place, before any of them is handed to the scan.
+ *
+ * A page is evaluated one term at a time: the column of the term is gathered from all tuples into a contiguous
+ * buffer, and then compared in a loop without branches that the compiler vectorizes. Integer columns are compared as
+ * 64-bit integers, and a decimal column or constant makes the term compare as doubles. A null value only passes the
+ * terms that are added with `null_passes`.
+ */
+class ScanPredicate {
+ public:
+  enum class Op : uint8_t { Equal, NotEqual, LessThan, LessThanOrEqual, GreaterThan, GreaterThanOrEqual };
+
+  /** @return whether a column of a type can be compared in place */
+  static auto IsSupported(TypeId type) -> bool;
+
+  /**
+   * Add the term `column op constant` to the conjunction.
+   * @param schema the schema of the tuples of the table
+   * @param column_idx the column, whose type must be supported
+   * @param op the comparison
+   * @param constant a non-null value of a supported type
+   * @param null_passes whether the term is `column op constant OR column IS NULL`
+   */
+  void AddTerm(const Schema &schema, uint32_t column_idx, Op op, const Value &constant, bool null_passes = false);
+
+  /** @return whether the predicate has no terms, and so passes every tuple */
+  auto Empty() const -> bool { return terms_.empty(); }
+
+  /**
+   * Evaluate the predicate on serialized tuples.
+   * @param tuples the data of the tuples
+   * @param[out] keep 1 for each tuple that passes, 0 for each one that does not
+   */
+  void Evaluate(const std::vector<const char *> &tuples, std::vector<uint8_t> *keep);
+
+  /** @return the number of terms */
+  auto GetNumTerms() const -> size_t { return terms_.size(); }
+
+  /** @return the column of a term */
+  auto GetTermColumn(size_t term) const -> uint32_t { return terms_[term].column_idx_; }
+
+  /**
+   * Evaluate one term on one value, for columns that are not stored as serialized tuples (see ColumnarTablePage).
+   * @param term the term
+   * @param value the bytes of the column, sign-extended to 64 bits: the integer for an integer column, the bit pattern
+   * of the double for a decimal column
+   * @return whether the value passes the term
+   */
+  auto Passes(size_t term, int64_t value) const -> bool;
+
+  /**
+   * Check the predicate against a synopsis of some tuples.
+   * @param columns the range of each column over the tuples, indexed by column; only the columns of terms are read
+   * @return false if no tuple within the ranges can pass
+   */
+  auto MayMatch(const std::vector<ColumnRange> &columns) const -> bool;
+
+  /** @return the terms of the predicate */
+  auto ToString() const -> std::string;
+
+ private:
+  struct Term {
+    uint32_t column_idx_;
+    /** The offset of the column in the tuple */
+    uint32_t offset_;
+    TypeId type_;
+    Op op_;
+    /** 1 if null values pass the term, 0 if they do not */
+    uint8_t null_passes_;
+    /** Whether the term compares doubles, otherwise it compares integers */
+    bool is_decimal_;
+    int64_t integer_;
+    double decimal_;
+  };
+
+  std::vector<Term> terms_;
+  /** The column of the term being evaluated, gathered from every tuple */
+  std::vector<int64_t> integers_;
+  std::vector<double> decimals_;
+};
+
+}  // namespace bustub
@@ -19,21 +19,59 @@
 
 #include "buffer/buffer_pool_manager.h"
 #include "common/config.h"
+#include "common/enums/table_storage.h"
 #include "concurrency/lock_manager.h"
 #include "concurrency/transaction.h"
+#include "concurrency/transaction_manager.h"
 #include "recovery/log_manager.h"
+#include "storage/page/columnar_table_page.h"
+#include "storage/page/page_guard.h"
 #include "storage/page/table_page.h"
+#include "storage/table/free_space_map.h"
 #include "storage/table/table_iterator.h"
+#include "storage/table/toast_store.h"
 #include "storage/table/tuple.h"
+#include "storage/table/zone_map.h"
 
 namespace bustub {
 
+/** Statistics of one or more vacuum passes over table heaps. */
+struct VacuumStats {
+  /** Number of table pages that were vacuumed */
+  size_t pages_scanned_{0};
+  /** Number of table pages that became empty */
+  size_t pages_emptied_{0};
+  /** Number of deleted tuples whose space was reclaimed */
+  size_t tuples_reclaimed_{0};
+  /** Number of bytes returned to the free space of the pages */
+  size_t bytes_reclaimed_{0};
+
+  auto operator+=(const VacuumStats &other) -> VacuumStats & {
+    pages_scanned_ += other.pages_scanned_;
+    pages_emptied_ += other.pages_emptied_;
+    tuples_reclaimed_ += other.tuples_reclaimed_;
+    bytes_reclaimed_ += other.bytes_reclaimed_;
+    return *this;
+  }
+};
+
 /**
  * TableHeap represents a physical table on disk.
  * This is just a doubly-linked list of pages.
+ *
+ * The free space of every page is tracked in a FreeSpaceMap. Inserts go to any page with enough room, and concurrent
+ * inserters are spread over different pages by thread; a new page is only appended when no page has enough room.
+ *
+ * If the heap knows the schema of its tuples, large VARCHAR values are stored out of line in a ToastStore, so tuples
+ * may be larger than a page. It also keeps a ZoneMap of its fixed-width columns, which lets scans skip pages.
+ *
+ * The pages are either row-oriented TablePages or, for a columnar heap, ColumnarTablePages, whose tuples scans can
+ * read column by column (see TableIterator::ReadColumns). A columnar heap must know its schema. Its pages are frozen
+ * into encoded columns when they fill up (see ColumnarTablePage::Freeze), so that they hold more tuples.
  */
 class TableHeap {
   friend class TableIterator;
+  friend class MorselQueue;
 
  public:
   ~TableHeap() = default;
@@ -41,12 +79,14 @@ class TableHeap {
   /**
    * Create a table heap without a transaction. (open table)
    * @param buffer_pool_manager the buffer pool manager
-   * @param first_page_id the id of the first page
+   * @param schema the schema of the tuples, nullptr to always store tuples inline
+   * @param storage the format of the pages
    */
-  explicit TableHeap(BufferPoolManager *bpm);
+  explicit TableHeap(BufferPoolManager *bpm, const Schema *schema = nullptr, TableStorage storage = TableStorage::ROW);
 
   /**
-   * Insert a tuple into the table. If the tuple is too large (>= page_size), return std::nullopt.
+   * Insert a tuple into the table. If the tuple is too large (>= page_size) even after moving its large values out of
+   * line, return std::nullopt.
    * @param meta tuple meta
    * @param tuple tuple to insert
    * @return rid of the inserted tuple
@@ -76,15 +116,41 @@ class TableHeap {
    */
   auto GetTupleMeta(RID rid) -> TupleMeta;
 
-  /** @return the iterator of this table, use this for project 3 */
+  /**
+   * @return the iterator of this table, use this for project 3
+   *
+   * Note: inserts may reuse free space in any page, so a tuple inserted while the iterator is open can show up in a
+   * page the iterator has not reached yet. Callers that insert into the table they are scanning (e.g. updates
+   * implemented as delete + insert) must not rely on the iterator to skip those tuples.
+   */
   auto MakeIterator() -> TableIterator;
 
   /** @return the iterator of this table, use this for project 4 except updates */
   auto MakeEagerIterator() -> TableIterator;
 
+  /**
+   * Reclaim the space of deleted tuples, one page at a time. Live tuples keep their RIDs. A deleted tuple is only
+   * reclaimed once its delete can no longer be rolled back (see TransactionManager::IsDeleteFinal). Pages whose tuples
+   * are all gone are emptied in place and stay in the page chain, where the free space map hands them out to later
+   * inserts. Columnar heaps are not vacuumed.
+   * @param txn_mgr the transaction manager to check deletes against, nullptr if no transaction can be active
+   * @param txn the transaction running the vacuum, if any
+   * @return what the pass reclaimed
+   */
+  auto Vacuum(TransactionManager *txn_mgr = nullptr, const Transaction *txn = nullptr) -> VacuumStats;
+
+  /** @return whether the pages of this table are ColumnarTablePages */
+  inline auto IsColumnar() const -> bool { return storage_ == TableStorage::COLUMNAR; }
+
   /** @return the id of the first page of this table */
   inline auto GetFirstPageId() const -> page_id_t { return first_page_id_; }
 
+  /** @return the free space map of this table */
+  inline auto GetFreeSpaceMap() -> FreeSpaceMap * { return fsm_.get(); }
+
+  /** @return the zone map of this table, nullptr if the heap does not know its schema or has no fixed-width column */
+  inline auto GetZoneMap() -> ZoneMap * { return zones_.get(); }
+
   /**
    * Update a tuple in place. SHOULD NOT BE USED UNLESS YOU WANT TO OPTIMIZE FOR PROJECT 4.
    * @param meta new tuple meta
@@ -104,9 +170,31 @@ class TableHeap {
   /** Used for binder tests */
   explicit TableHeap(bool create_table_heap = false);
 
+  /**
+   * Initialize a new page in the format of the table.
+   * @param data the data of the page
+   * @return the free space of the page
+   */
+  auto InitPage(char *data) -> uint32_t;
+
+  /**
+   * Append a new page to the table and register it in the free space map as the current page of `shard`.
+   * @return the new page, write-latched
+   */
+  auto AppendPage(size_t shard) -> WritePageGuard;
+
+  /** @return the RID a scan of the table stops at, which is right after the last tuple currently in the table */
+  auto GetStopRid() -> RID;
+
   BufferPoolManager *bpm_;
+  TableStorage storage_{TableStorage::ROW};
   page_id_t first_page_id_{INVALID_PAGE_ID};
+  std::unique_ptr<FreeSpaceMap> fsm_;
+  std::unique_ptr<Schema> schema_;
+  std::unique_ptr<ToastStore> toast_;
+  std::unique_ptr<ZoneMap> zones_;
 
+  /** Serializes appending pages. Never waited for while holding a table page latch. */
   std::mutex latch_;
   page_id_t last_page_id_{INVALID_PAGE_ID}; /* protected by latch_ */
 };
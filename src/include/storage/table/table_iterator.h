@@ -13,12 +13,16 @@
 #pragma once
 
 #include <cassert>
+#include <functional>
 #include <memory>
 #include <utility>
+#include <vector>
 
 #include "common/macros.h"
 #include "common/rid.h"
 #include "concurrency/transaction.h"
+#include "storage/table/column_chunk.h"
+#include "storage/table/scan_predicate.h"
 #include "storage/table/tuple.h"
 
 namespace bustub {
@@ -32,6 +36,9 @@ class TableIterator {
   friend class Cursor;
 
  public:
+  /** Tuples read in place, with their meta */
+  using TupleViews = std::vector<std::pair<TupleMeta, TupleView>>;
+
   DISALLOW_COPY(TableIterator);
 
   TableIterator(TableHeap *table_heap, RID rid, RID stop_at_rid);
@@ -41,6 +48,28 @@ class TableIterator {
 
   auto GetTuple() -> std::pair<TupleMeta, Tuple>;
 
+  /**
+   * Read tuples in place: pass the tuples from the current position to the end of the current page, at most
+   * `max_tuples` of them, to `consume` as views into the page, then move past them. The page is read-latched only
+   * while `consume` runs, so the views, and the VARCHAR values read from them, must not be used after it returns.
+   *
+   * With a predicate, pages the zone map of the table rules out are skipped without being read, the predicate is
+   * evaluated on the rest of the page first, and only the tuples that are not deleted and pass it are passed to
+   * `consume`, which may then get no tuples at all. Only for row-oriented tables.
+   */
+  void ReadPage(size_t max_tuples, const std::function<void(const TupleViews &)> &consume,
+                ScanPredicate *predicate = nullptr);
+
+  /**
+   * Read tuples column by column from a columnar table: copy the current page, with the tuples from the current
+   * position to the end of it that are not deleted, at most `max_tuples` of them, and move past them.
+   *
+   * With a predicate, pages the zone map of the table rules out are skipped without being read, and only the tuples
+   * that pass it are read. It is evaluated on the columns of the page, on the encoded form of the compressed ones.
+   * @return the tuples read, nullptr if there were none
+   */
+  auto ReadColumns(size_t max_tuples, const ScanPredicate *predicate = nullptr) -> std::shared_ptr<const ColumnChunk>;
+
   auto GetRID() -> RID;
 
   auto IsEnd() -> bool;
@@ -48,6 +77,18 @@ class TableIterator {
   auto operator++() -> TableIterator &;
 
  private:
+  /**
+   * Move rid_ forward to the first existing slot at or after it. Vacuum may leave empty pages anywhere in the
+   * chain, so this skips over pages without tuples. Sets rid_ to invalid when the end of the scan is reached.
+   */
+  void SkipEmptyPages();
+
+  /**
+   * Move rid_ past the pages, starting with its own, whose synopsis in the zone map rules out every tuple. Unlike
+   * SkipEmptyPages, this does not fetch the pages it skips.
+   */
+  void SkipPages(const ScanPredicate &predicate);
+
   TableHeap *table_heap_;
   RID rid_;
 
@@ -55,6 +96,14 @@ class TableIterator {
   // Otherwise we will have dead loops when updating while scanning. (In project 4, update should be implemented as
   // deletion + insertion.)
   RID stop_at_rid_;
+
+  /** The tuples of the current call to ReadPage */
+  TupleViews views_;
+
+  /** The tuples a predicate is evaluated on, and the result for each of them */
+  TupleViews candidates_;
+  std::vector<const char *> candidate_data_;
+  std::vector<uint8_t> keep_;
 };
 
 }  // namespace bustub
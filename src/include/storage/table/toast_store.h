@@ -0,0 +1,88 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// toast_store.h
+//
+// Identification: src/include/storage/table/toast_store.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+
+#include "buffer/buffer_pool_manager.h"
+#include "catalog/schema.h"
+#include "common/config.h"
+#include "storage/table/tuple.h"
+#include "type/limits.h"
+#include "type/value.h"
+
+namespace bustub {
+
+/**
+ * ToastStore keeps large VARCHAR values of a table out of line, in chains of OverflowPages (in the style of
+ * PostgreSQL's TOAST). This lets a table store tuples larger than a page, and keeps table pages dense so that scans
+ * only pay for large values they actually read.
+ *
+ * In the tuple data, an out-of-line value replaces the usual `| Length (4) | DATA |` of the column with a pointer:
+ *  ---------------------------------------------------------------------------
+ *  | TOAST_MARKER (4) | RawSize (4) | StoredSize (4) | FirstOverflowPageId (4) |
+ *  ---------------------------------------------------------------------------
+ * The value is stored LZ-compressed if that saves at least 1/8 of its size, which is the case iff StoredSize <
+ * RawSize. Tuple::GetValue fetches the value through the ToastStore attached to the tuple.
+ */
+class ToastStore {
+ public:
+  /** Length word marking an out-of-line value. No real value is that long. */
+  static constexpr uint32_t TOAST_MARKER = BUSTUB_VALUE_NULL - 1;
+
+  /** Size of the pointer to an out-of-line value, including the marker. */
+  static constexpr uint32_t TOAST_POINTER_SIZE = 16;
+
+  /** Tuples larger than this have their largest values moved out of line until they fit. */
+  static constexpr uint32_t TOAST_TUPLE_THRESHOLD = BUSTUB_PAGE_SIZE / 4;
+
+  /** Values smaller than this always stay in the tuple. */
+  static constexpr uint32_t TOAST_MIN_VALUE_SIZE = 128;
+
+  /** @param bpm the buffer pool manager that holds the overflow pages */
+  explicit ToastStore(BufferPoolManager *bpm) : bpm_(bpm) {}
+
+  /**
+   * Move the largest VARCHAR values of a tuple out of line until the tuple is no larger than TOAST_TUPLE_THRESHOLD.
+   * @return the tuple with pointers to the out-of-line values, or a copy of `tuple` if it is small enough
+   */
+  auto Toast(const Tuple &tuple, const Schema &schema) -> Tuple;
+
+  /**
+   * Read an out-of-line value.
+   * @param toast_pointer the pointer stored in the tuple data, starting at the marker
+   * @param type the type of the column
+   */
+  auto Fetch(const char *toast_pointer, TypeId type) const -> Value;
+
+  /**
+   * Free the overflow pages of all out-of-line values of a tuple.
+   * @param keep a tuple whose out-of-line values must stay, e.g. the new version of an updated tuple, which shares
+   * the pointers that Toast passed through unchanged; nullptr to free all values
+   */
+  void Free(const Tuple &tuple, const Schema &schema, const Tuple *keep = nullptr);
+
+  /** @return true if the column data at `field` is a pointer to an out-of-line value */
+  static auto IsToasted(const char *field) -> bool {
+    return *reinterpret_cast<const uint32_t *>(field) == TOAST_MARKER;
+  }
+
+ private:
+  /**
+   * Write a value to a new chain of overflow pages.
+   * @return the id of the first page of the chain
+   */
+  auto WriteChain(const char *data, uint32_t size) -> page_id_t;
+
+  BufferPoolManager *bpm_;
+};
+
+}  // namespace bustub
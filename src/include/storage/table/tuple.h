@@ -42,16 +42,25 @@ struct TupleMeta {
 
 static_assert(sizeof(TupleMeta) == TUPLE_META_SIZE);
 
+class ToastStore;
+
 /**
  * Tuple format:
  * ---------------------------------------------------------------------
  * | FIXED-SIZE or VARIED-SIZED OFFSET | PAYLOAD OF VARIED-SIZED FIELD |
  * ---------------------------------------------------------------------
+ *
+ * Large VARCHAR values of tuples read from a table heap may be stored out of line (see ToastStore). They are only
+ * fetched when GetValue is called on their column.
  */
 class Tuple {
   friend class TablePage;
+  friend class ColumnarTablePage;
   friend class TableHeap;
   friend class TableIterator;
+  friend class ToastStore;
+  friend class ColumnChunk;
+  friend class TupleView;
 
  public:
   // Default constructor (to create a dummy tuple)
@@ -83,6 +92,9 @@ class Tuple {
   // return RID of current tuple
   inline auto GetRid() const -> RID { return rid_; }
 
+  // set RID of current tuple
+  inline void SetRid(RID rid) { rid_ = rid; }
+
   // Get the address of this tuple in the table's backing store
   inline auto GetData() const -> const char * { return data_.data(); }
 
@@ -96,11 +108,8 @@ class Tuple {
   // Generates a key tuple given schemas and attributes
   auto KeyFromTuple(const Schema &schema, const Schema &key_schema, const std::vector<uint32_t> &key_attrs) -> Tuple;
 
-  // Is the column value null ?
-  inline auto IsNull(const Schema *schema, uint32_t column_idx) const -> bool {
-    Value value = GetValue(schema, column_idx);
-    return value.IsNull();
-  }
+  // Is the column value null ? (never fetches out-of-line values)
+  auto IsNull(const Schema *schema, uint32_t column_idx) const -> bool;
 
   auto ToString(const Schema *schema) const -> std::string;
 
@@ -110,6 +119,44 @@ class Tuple {
 
   RID rid_{};  // if pointing to the table heap, the rid is valid
   std::vector<char> data_;
+  const ToastStore *toast_store_{nullptr};  // where out-of-line values are stored, if any
+};
+
+/**
+ * TupleView is a tuple read in place, e.g. from a latched table page, without copying its data. It has the format of
+ * Tuple, and is only valid as long as the memory it points into. The VARCHAR values it returns point into that memory
+ * as well, except for values stored out of line. A tuple that has to outlive the memory is copied with ToTuple().
+ */
+class TupleView {
+ public:
+  TupleView() = default;
+
+  TupleView(const char *data, uint32_t size, RID rid, const ToastStore *toast_store = nullptr)
+      : data_(data), size_(size), rid_(rid), toast_store_(toast_store) {}
+
+  /** @return the RID of the tuple */
+  inline auto GetRid() const -> RID { return rid_; }
+
+  /** @return the serialized tuple */
+  inline auto GetData() const -> const char * { return data_; }
+
+  /** @return the length of the serialized tuple */
+  inline auto GetLength() const -> uint32_t { return size_; }
+
+  /** @return the value of a column, which for an inline VARCHAR points into the memory of the view */
+  auto GetValue(const Schema *schema, uint32_t column_idx) const -> Value;
+
+  /** @return whether the value of a column is null (never fetches out-of-line values) */
+  auto IsNull(const Schema *schema, uint32_t column_idx) const -> bool;
+
+  /** @return a copy of the tuple that owns its data */
+  auto ToTuple() const -> Tuple;
+
+ private:
+  const char *data_{nullptr};
+  uint32_t size_{0};
+  RID rid_{};
+  const ToastStore *toast_store_{nullptr};
 };
 
 }  // namespace bustub
@@ -0,0 +1,79 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// vacuum_manager.h
+//
+// Identification: src/include/storage/table/vacuum_manager.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>  // NOLINT
+#include <mutex>               // NOLINT
+#include <shared_mutex>
+#include <string>
+#include <thread>  // NOLINT
+#include <utility>
+#include <vector>
+
+#include "catalog/catalog.h"
+#include "concurrency/transaction_manager.h"
+#include "storage/table/table_heap.h"
+
+namespace bustub {
+
+/**
+ * VacuumManager reclaims the space of deleted tuples in all tables of a catalog, either on demand or periodically
+ * from a background thread (every `vacuum_interval`). Each table is vacuumed with TableHeap::Vacuum, which works on
+ * one page at a time, so scans and inserts on the same table keep running while it is vacuumed. BustubInstance only
+ * starts the background thread if `enable_background_vacuum` is set.
+ */
+class VacuumManager {
+ public:
+  /**
+   * @param catalog the catalog whose tables are vacuumed
+   * @param txn_manager the transaction manager to check deletes against
+   * @param catalog_lock the latch protecting the catalog
+   */
+  VacuumManager(Catalog *catalog, TransactionManager *txn_manager, std::shared_mutex *catalog_lock)
+      : catalog_(catalog), txn_manager_(txn_manager), catalog_lock_(catalog_lock) {}
+
+  ~VacuumManager() { StopBackgroundVacuum(); }
+
+  /** Start vacuuming all tables in the background. */
+  void StartBackgroundVacuum();
+
+  /** Stop the background thread, waiting for the current pass to finish. */
+  void StopBackgroundVacuum();
+
+  /**
+   * Vacuum every table once.
+   * @param txn the transaction running the vacuum, if any
+   * @return the name and vacuum statistics of every table that has a table heap
+   */
+  auto VacuumAllTables(const Transaction *txn = nullptr) -> std::vector<std::pair<std::string, VacuumStats>>;
+
+  /** @return the accumulated statistics of all vacuum passes so far */
+  auto GetTotalStats() -> VacuumStats;
+
+ private:
+  void RunBackgroundVacuum();
+
+  Catalog *catalog_;
+  TransactionManager *txn_manager_;
+  std::shared_mutex *catalog_lock_;
+
+  /** Serializes vacuum passes, so that on-demand and background passes do not vacuum the same page twice. */
+  std::mutex vacuum_latch_;
+  VacuumStats total_stats_; /* protected by vacuum_latch_ */
+
+  std::mutex background_latch_;
+  std::condition_variable background_cv_;
+  bool enable_background_vacuum_{false}; /* protected by background_latch_ */
+  std::thread background_thread_;
+};
+
+}  // namespace bustub
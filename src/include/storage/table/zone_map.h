@@ -0,0 +1,88 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// zone_map.h
+//
+// Identification: src/include/storage/table/zone_map.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <mutex>  // NOLINT
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+#include "catalog/schema.h"
+#include "common/config.h"
+#include "storage/table/scan_predicate.h"
+
+namespace bustub {
+
+/**
+ * ZoneMap keeps a synopsis of every page of a table heap: the minimum and maximum value and the number of nulls of
+ * each fixed-width column over the tuples written to the page. A scan with a ScanPredicate checks the synopsis of a
+ * page before it fetches the page, and skips the pages that cannot have a matching tuple, which on append-ordered
+ * columns, such as timestamps or ids, is most of them.
+ *
+ * A synopsis only ever grows when tuples are written, and deleting a tuple does not shrink it, so it may cover values
+ * that are no longer in the page but never misses one that is. Vacuum rebuilds the synopses of the pages it compacts.
+ * The map also records the order of the pages in the heap, so that skipping a page does not have to read it to find
+ * the next one.
+ */
+class ZoneMap {
+ public:
+  /** @param schema the schema of the tuples of the table */
+  explicit ZoneMap(const Schema &schema);
+
+  /** @return whether a schema has a column the map keeps a synopsis of */
+  static auto HasSynopses(const Schema &schema) -> bool;
+
+  /**
+   * Start tracking a page, which was appended to the end of the heap.
+   * @param page_id the new page
+   */
+  void AddPage(page_id_t page_id);
+
+  /**
+   * Widen the synopsis of a page by a tuple written to it. The caller must hold the write latch of the page.
+   * @param page_id the page
+   * @param data the serialized tuple
+   */
+  void Update(page_id_t page_id, const char *data);
+
+  /** Forget the values of a page, before its synopsis is rebuilt by calling Update for each of its tuples. */
+  void ResetPage(page_id_t page_id);
+
+  /**
+   * @param page_id the page
+   * @param predicate the predicate of a scan
+   * @return false if no tuple of the page can pass the predicate
+   */
+  auto MayMatch(page_id_t page_id, const ScanPredicate &predicate) const -> bool;
+
+  /** @return the page after a page in the heap, INVALID_PAGE_ID if it is the last one or is not tracked */
+  auto GetNextPageId(page_id_t page_id) const -> page_id_t;
+
+  /** @return the synopsis of a page, one range per column, or std::nullopt if the page is not tracked */
+  auto GetSynopsis(page_id_t page_id) const -> std::optional<std::vector<ColumnRange>>;
+
+ private:
+  struct Zone {
+    /** The range of each column; only the fixed-width ones are maintained */
+    std::vector<ColumnRange> columns_;
+    page_id_t next_page_id_{INVALID_PAGE_ID};
+  };
+
+  Schema schema_;
+  /** The columns with a synopsis */
+  std::vector<uint32_t> columns_;
+
+  mutable std::mutex latch_;
+  std::unordered_map<page_id_t, Zone> zones_;
+  page_id_t last_page_id_{INVALID_PAGE_ID};
+};
+
+}  // namespace bustub
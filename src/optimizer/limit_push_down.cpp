@@ -0,0 +1,132 @@
+#include <algorithm>
+#include <memory>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "execution/expressions/column_value_expression.h"
+#include "execution/plans/abstract_plan.h"
+#include "execution/plans/hash_join_plan.h"
+#include "execution/plans/limit_plan.h"
+#include "execution/plans/merge_join_plan.h"
+#include "execution/plans/nested_loop_join_plan.h"
+#include "execution/plans/projection_plan.h"
+#include "execution/plans/sort_plan.h"
+#include "execution/plans/topn_plan.h"
+#include "optimizer/optimizer.h"
+
+namespace bustub {
+
+namespace {
+
+using OrderBys = std::vector<std::pair<OrderByType, AbstractExpressionRef>>;
+
+/** @return whether a plan is a join that returns every row of its left child at least once */
+auto PreservesLeftRows(const AbstractPlanNode &plan) -> bool {
+  switch (plan.GetType()) {
+    case PlanType::HashJoin:
+      return dynamic_cast<const HashJoinPlanNode &>(plan).GetJoinType() == JoinType::LEFT;
+    case PlanType::NestedLoopJoin:
+      return dynamic_cast<const NestedLoopJoinPlanNode &>(plan).GetJoinType() == JoinType::LEFT;
+    case PlanType::MergeJoin:
+      return dynamic_cast<const MergeJoinPlanNode &>(plan).GetJoinType() == JoinType::LEFT;
+    default:
+      return false;
+  }
+}
+
+/**
+ * @return the order bys over the child of a projection that sort its rows as `order_bys` sort the rows of the
+ * projection, or std::nullopt if an order by is not a column that the projection passes through unchanged
+ */
+auto OrderBysBelowProjection(const ProjectionPlanNode &projection, const OrderBys &order_bys)
+    -> std::optional<OrderBys> {
+  OrderBys child_order_bys;
+  for (const auto &[order_by_type, expr] : order_bys) {
+    const auto *column = dynamic_cast<const ColumnValueExpression *>(expr.get());
+    if (column == nullptr || column->GetTupleIdx() != 0) {
+      return std::nullopt;
+    }
+    const auto &child_expr = projection.GetExpressions()[column->GetColIdx()];
+    if (dynamic_cast<const ColumnValueExpression *>(child_expr.get()) == nullptr) {
+      return std::nullopt;
+    }
+    child_order_bys.emplace_back(order_by_type, child_expr);
+  }
+  return child_order_bys;
+}
+
+/** @return whether all order bys are columns of the left child of a join */
+auto OrderBysOnLeft(const AbstractPlanNode &join, const OrderBys &order_bys) -> bool {
+  auto num_left_columns = join.GetChildAt(0)->OutputSchema().GetColumnCount();
+  return std::all_of(order_bys.begin(), order_bys.end(), [&](const auto &order_by) {
+    const auto *column = dynamic_cast<const ColumnValueExpression *>(order_by.second.get());
+    return column != nullptr && column->GetTupleIdx() == 0 && column->GetColIdx() < num_left_columns;
+  });
+}
+
+/** @return a plan that returns `limit` rows of `plan`, with the limit pushed down as far as it goes */
+auto PushLimit(const AbstractPlanNodeRef &plan, size_t limit) -> AbstractPlanNodeRef;
+
+/** @return a plan that returns the first `n` rows of `plan` by `order_bys`, pushed down as far as it goes */
+auto PushTopN(const AbstractPlanNodeRef &plan, const OrderBys &order_bys, size_t n) -> AbstractPlanNodeRef {
+  if (plan->GetType() == PlanType::Projection) {
+    // A projection maps every row to one row, so it only needs to compute the rows that are kept.
+    const auto &projection = dynamic_cast<const ProjectionPlanNode &>(*plan);
+    if (auto child_order_bys = OrderBysBelowProjection(projection, order_bys); child_order_bys.has_value()) {
+      return plan->CloneWithChildren({PushTopN(projection.GetChildPlan(), *child_order_bys, n)});
+    }
+  } else if (PreservesLeftRows(*plan) && plan->GetType() != PlanType::MergeJoin &&
+             OrderBysOnLeft(*plan, order_bys)) {
+    // The rows of the join come from the first n left rows, and every left row gives at least one of them. A merge
+    // join needs its left rows in the order of its keys, which a top N below it would not keep.
+    auto join = plan->CloneWithChildren({PushTopN(plan->GetChildAt(0), order_bys, n), plan->GetChildAt(1)});
+    return std::make_shared<TopNPlanNode>(plan->output_schema_, std::move(join), order_bys, n);
+  }
+  return std::make_shared<TopNPlanNode>(plan->output_schema_, plan, order_bys, n);
+}
+
+auto PushLimit(const AbstractPlanNodeRef &plan, size_t limit) -> AbstractPlanNodeRef {
+  switch (plan->GetType()) {
+    case PlanType::Projection:
+      return plan->CloneWithChildren({PushLimit(plan->GetChildAt(0), limit)});
+    case PlanType::Sort: {
+      const auto &sort = dynamic_cast<const SortPlanNode &>(*plan);
+      return PushTopN(sort.GetChildPlan(), sort.GetOrderBy(), limit);
+    }
+    case PlanType::Limit: {
+      const auto &child_limit = dynamic_cast<const LimitPlanNode &>(*plan);
+      return PushLimit(child_limit.GetChildPlan(), std::min(limit, child_limit.GetLimit()));
+    }
+    default:
+      break;
+  }
+  if (PreservesLeftRows(*plan)) {
+    // Any `limit` rows of the join are rows of the join of `limit` left rows, as every left row gives at least one.
+    auto join = plan->CloneWithChildren({PushLimit(plan->GetChildAt(0), limit), plan->GetChildAt(1)});
+    return std::make_shared<LimitPlanNode>(plan->output_schema_, std::move(join), limit);
+  }
+  return std::make_shared<LimitPlanNode>(plan->output_schema_, plan, limit);
+}
+
+}  // namespace
+
+auto Optimizer::OptimizeLimitPushDown(const AbstractPlanNodeRef &plan) -> AbstractPlanNodeRef {
+  std::vector<AbstractPlanNodeRef> children;
+  for (const auto &child : plan->GetChildren()) {
+    children.emplace_back(OptimizeLimitPushDown(child));
+  }
+  auto optimized_plan = plan->CloneWithChildren(std::move(children));
+
+  if (optimized_plan->GetType() == PlanType::Limit) {
+    const auto &limit_plan = dynamic_cast<const LimitPlanNode &>(*optimized_plan);
+    return PushLimit(limit_plan.GetChildPlan(), limit_plan.GetLimit());
+  }
+  if (optimized_plan->GetType() == PlanType::TopN) {
+    const auto &topn_plan = dynamic_cast<const TopNPlanNode &>(*optimized_plan);
+    return PushTopN(topn_plan.GetChildPlan(), topn_plan.GetOrderBy(), topn_plan.GetN());
+  }
+  return optimized_plan;
+}
+
+}  // namespace bustub
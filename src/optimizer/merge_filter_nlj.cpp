@@ -60,7 +60,9 @@ auto Optimizer::OptimizeMergeFilterNLJ(const AbstractPlanNodeRef &plan) -> Abstr
       // Has exactly two children
       BUSTUB_ENSURE(child_plan->GetChildren().size() == 2, "NLJ should have exactly 2 children.");
 
-      if (IsPredicateTrue(nlj_plan.Predicate())) {
+      // A filter above a semi or anti join is on the left rows only, and an anti join would emit the rows it rejects.
+      if (IsPredicateTrue(nlj_plan.Predicate()) && nlj_plan.GetJoinType() != JoinType::SEMI &&
+          nlj_plan.GetJoinType() != JoinType::ANTI) {
         // Only rewrite when NLJ has always true predicate.
         return std::make_shared<NestedLoopJoinPlanNode>(
             filter_plan.output_schema_, nlj_plan.GetLeftPlan(), nlj_plan.GetRightPlan(),
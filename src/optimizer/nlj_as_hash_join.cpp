@@ -1,5 +1,8 @@
 #include <algorithm>
 #include <memory>
+#include <set>
+#include <utility>
+#include <vector>
 #include "catalog/column.h"
 #include "catalog/schema.h"
 #include "common/exception.h"
@@ -7,6 +10,7 @@
 #include "execution/expressions/column_value_expression.h"
 #include "execution/expressions/comparison_expression.h"
 #include "execution/expressions/constant_value_expression.h"
+#include "execution/expressions/logic_expression.h"
 #include "execution/plans/abstract_plan.h"
 #include "execution/plans/filter_plan.h"
 #include "execution/plans/hash_join_plan.h"
@@ -17,12 +21,101 @@
 
 namespace bustub {
 
+namespace {
+
+/** Collect the tuples the columns of an expression are read from: 0 for the left child of a join, 1 for the right. */
+void CollectTupleIdxs(const AbstractExpressionRef &expr, std::set<uint32_t> *tuple_idxs) {
+  if (const auto *column_value_expr = dynamic_cast<const ColumnValueExpression *>(expr.get());
+      column_value_expr != nullptr) {
+    tuple_idxs->insert(column_value_expr->GetTupleIdx());
+  }
+  for (const auto &child : expr->GetChildren()) {
+    CollectTupleIdxs(child, tuple_idxs);
+  }
+}
+
+/** @return the expression, reading its columns from the only tuple it is evaluated on */
+auto ReadFromTuple0(const AbstractExpressionRef &expr) -> AbstractExpressionRef {
+  if (const auto *column_value_expr = dynamic_cast<const ColumnValueExpression *>(expr.get());
+      column_value_expr != nullptr) {
+    return std::make_shared<ColumnValueExpression>(0, column_value_expr->GetColIdx(),
+                                                   column_value_expr->GetReturnType());
+  }
+  std::vector<AbstractExpressionRef> children;
+  for (const auto &child : expr->GetChildren()) {
+    children.emplace_back(ReadFromTuple0(child));
+  }
+  return expr->CloneWithChildren(std::move(children));
+}
+
+/**
+ * Split a join predicate into equalities of an expression on the left child with one on the right child.
+ * @return false if the predicate has another form
+ */
+auto ExtractJoinKeys(const AbstractExpressionRef &expr, std::vector<AbstractExpressionRef> *left_keys,
+                     std::vector<AbstractExpressionRef> *right_keys) -> bool {
+  if (const auto *logic_expr = dynamic_cast<const LogicExpression *>(expr.get()); logic_expr != nullptr) {
+    return logic_expr->logic_type_ == LogicType::And &&
+           ExtractJoinKeys(logic_expr->GetChildAt(0), left_keys, right_keys) &&
+           ExtractJoinKeys(logic_expr->GetChildAt(1), left_keys, right_keys);
+  }
+  const auto *cmp_expr = dynamic_cast<const ComparisonExpression *>(expr.get());
+  if (cmp_expr == nullptr || cmp_expr->comp_type_ != ComparisonType::Equal) {
+    return false;
+  }
+  auto lhs = cmp_expr->GetChildAt(0);
+  auto rhs = cmp_expr->GetChildAt(1);
+  std::set<uint32_t> lhs_tuple_idxs;
+  std::set<uint32_t> rhs_tuple_idxs;
+  CollectTupleIdxs(lhs, &lhs_tuple_idxs);
+  CollectTupleIdxs(rhs, &rhs_tuple_idxs);
+  if (lhs_tuple_idxs.size() != 1 || rhs_tuple_idxs.size() != 1 || lhs_tuple_idxs == rhs_tuple_idxs) {
+    return false;
+  }
+  if (*lhs_tuple_idxs.begin() == 1) {
+    std::swap(lhs, rhs);
+  }
+  // Keys are hashed and compared as they are, so values of different types would never match.
+  if (lhs->GetReturnType() != rhs->GetReturnType()) {
+    return false;
+  }
+  left_keys->push_back(ReadFromTuple0(lhs));
+  right_keys->push_back(ReadFromTuple0(rhs));
+  return true;
+}
+
+}  // namespace
+
 auto Optimizer::OptimizeNLJAsHashJoin(const AbstractPlanNodeRef &plan) -> AbstractPlanNodeRef {
-  // TODO(student): implement NestedLoopJoin -> HashJoin optimizer rule
-  // Note for 2023 Spring: You should at least support join keys of the form:
-  // 1. <column expr> = <column expr>
-  // 2. <column expr> = <column expr> AND <column expr> = <column expr>
-  return plan;
+  std::vector<AbstractPlanNodeRef> children;
+  for (const auto &child : plan->GetChildren()) {
+    children.emplace_back(OptimizeNLJAsHashJoin(child));
+  }
+  auto optimized_plan = plan->CloneWithChildren(std::move(children));
+
+  if (optimized_plan->GetType() != PlanType::NestedLoopJoin) {
+    return optimized_plan;
+  }
+  const auto &nlj_plan = dynamic_cast<const NestedLoopJoinPlanNode &>(*optimized_plan);
+  BUSTUB_ENSURE(nlj_plan.children_.size() == 2, "NLJ should have exactly 2 children.");
+
+  // Joins whose predicate is a conjunction of equalities between the two sides are planned as hash joins, of any join
+  // type. The semi and anti joins that subqueries in WHERE are decorrelated into are planned as hash joins even if the
+  // subquery is not correlated, so that it is run once rather than for every row of the outer query: such a join has
+  // no keys at all, and all of its right rows match every left row. Other joins without keys are cross products, which
+  // a hash join has no advantage on.
+  auto is_semi_or_anti = nlj_plan.GetJoinType() == JoinType::SEMI || nlj_plan.GetJoinType() == JoinType::ANTI;
+  std::vector<AbstractExpressionRef> left_keys;
+  std::vector<AbstractExpressionRef> right_keys;
+  if (IsPredicateTrue(nlj_plan.Predicate())) {
+    if (!is_semi_or_anti) {
+      return optimized_plan;
+    }
+  } else if (!ExtractJoinKeys(nlj_plan.Predicate(), &left_keys, &right_keys)) {
+    return optimized_plan;
+  }
+  return std::make_shared<HashJoinPlanNode>(nlj_plan.output_schema_, nlj_plan.GetLeftPlan(), nlj_plan.GetRightPlan(),
+                                            std::move(left_keys), std::move(right_keys), nlj_plan.GetJoinType());
 }
 
 }  // namespace bustub
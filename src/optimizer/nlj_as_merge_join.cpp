@@ -0,0 +1,150 @@
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "binder/bound_order_by.h"
+#include "catalog/catalog.h"
+#include "common/macros.h"
+#include "execution/expressions/column_value_expression.h"
+#include "execution/expressions/comparison_expression.h"
+#include "execution/expressions/logic_expression.h"
+#include "execution/plans/abstract_plan.h"
+#include "execution/plans/index_scan_plan.h"
+#include "execution/plans/merge_join_plan.h"
+#include "execution/plans/nested_loop_join_plan.h"
+#include "execution/plans/projection_plan.h"
+#include "execution/plans/sort_plan.h"
+#include "optimizer/optimizer.h"
+
+namespace bustub {
+
+auto Optimizer::ExtractEquiJoinKeys(const AbstractExpressionRef &expr,
+                                    std::vector<const ColumnValueExpression *> *left_cols,
+                                    std::vector<const ColumnValueExpression *> *right_cols) -> bool {
+  if (const auto *logic_expr = dynamic_cast<const LogicExpression *>(expr.get()); logic_expr != nullptr) {
+    return logic_expr->logic_type_ == LogicType::And &&
+           ExtractEquiJoinKeys(logic_expr->GetChildAt(0), left_cols, right_cols) &&
+           ExtractEquiJoinKeys(logic_expr->GetChildAt(1), left_cols, right_cols);
+  }
+  const auto *cmp_expr = dynamic_cast<const ComparisonExpression *>(expr.get());
+  if (cmp_expr == nullptr || cmp_expr->comp_type_ != ComparisonType::Equal) {
+    return false;
+  }
+  const auto *lhs = dynamic_cast<const ColumnValueExpression *>(cmp_expr->GetChildAt(0).get());
+  const auto *rhs = dynamic_cast<const ColumnValueExpression *>(cmp_expr->GetChildAt(1).get());
+  if (lhs == nullptr || rhs == nullptr || lhs->GetTupleIdx() == rhs->GetTupleIdx()) {
+    return false;
+  }
+  if (lhs->GetTupleIdx() == 1) {
+    std::swap(lhs, rhs);
+  }
+  left_cols->push_back(lhs);
+  right_cols->push_back(rhs);
+  return true;
+}
+
+auto Optimizer::OutputOrdering(const AbstractPlanNodeRef &plan) -> std::vector<uint32_t> {
+  std::vector<uint32_t> ordering;
+  switch (plan->GetType()) {
+    case PlanType::Sort: {
+      for (const auto &[order_type, expr] : dynamic_cast<const SortPlanNode &>(*plan).GetOrderBy()) {
+        const auto *column_value_expr = dynamic_cast<const ColumnValueExpression *>(expr.get());
+        if (!(order_type == OrderByType::ASC || order_type == OrderByType::DEFAULT) || column_value_expr == nullptr) {
+          break;
+        }
+        ordering.push_back(column_value_expr->GetColIdx());
+      }
+      return ordering;
+    }
+    case PlanType::IndexScan: {
+      const auto *index_info = catalog_.GetIndex(dynamic_cast<const IndexScanPlanNode &>(*plan).GetIndexOid());
+      return index_info->index_->GetKeyAttrs();
+    }
+    case PlanType::Filter:
+      return OutputOrdering(plan->GetChildAt(0));
+    case PlanType::Projection: {
+      // The output is sorted on the columns that pass a prefix of the child's sort columns through unchanged.
+      const auto &exprs = dynamic_cast<const ProjectionPlanNode &>(*plan).GetExpressions();
+      for (auto child_col : OutputOrdering(plan->GetChildAt(0))) {
+        uint32_t col = 0;
+        while (col < exprs.size()) {
+          const auto *column_value_expr = dynamic_cast<const ColumnValueExpression *>(exprs[col].get());
+          if (column_value_expr != nullptr && column_value_expr->GetColIdx() == child_col) {
+            break;
+          }
+          col++;
+        }
+        if (col == exprs.size()) {
+          break;
+        }
+        ordering.push_back(col);
+      }
+      return ordering;
+    }
+    case PlanType::MergeJoin: {
+      // Inner and left joins produce the left rows in order. Unmatched right rows would interleave nulls.
+      auto join_type = dynamic_cast<const MergeJoinPlanNode &>(*plan).GetJoinType();
+      if (join_type == JoinType::INNER || join_type == JoinType::LEFT) {
+        return OutputOrdering(plan->GetChildAt(0));
+      }
+      return ordering;
+    }
+    default:
+      return ordering;
+  }
+}
+
+auto Optimizer::OptimizeNLJAsMergeJoin(const AbstractPlanNodeRef &plan) -> AbstractPlanNodeRef {
+  std::vector<AbstractPlanNodeRef> children;
+  for (const auto &child : plan->GetChildren()) {
+    children.emplace_back(OptimizeNLJAsMergeJoin(child));
+  }
+  auto optimized_plan = plan->CloneWithChildren(std::move(children));
+
+  if (optimized_plan->GetType() != PlanType::NestedLoopJoin) {
+    return optimized_plan;
+  }
+  const auto &nlj_plan = dynamic_cast<const NestedLoopJoinPlanNode &>(*optimized_plan);
+  BUSTUB_ENSURE(nlj_plan.children_.size() == 2, "NLJ should have exactly 2 children.");
+  // Semi and anti joins are left to OptimizeNLJAsHashJoin.
+  if (nlj_plan.GetJoinType() == JoinType::SEMI || nlj_plan.GetJoinType() == JoinType::ANTI) {
+    return optimized_plan;
+  }
+
+  std::vector<const ColumnValueExpression *> left_cols;
+  std::vector<const ColumnValueExpression *> right_cols;
+  if (!ExtractEquiJoinKeys(nlj_plan.Predicate(), &left_cols, &right_cols)) {
+    return optimized_plan;
+  }
+  auto left_ordering = OutputOrdering(nlj_plan.GetLeftPlan());
+  auto right_ordering = OutputOrdering(nlj_plan.GetRightPlan());
+  if (left_ordering.size() < left_cols.size() || right_ordering.size() < right_cols.size()) {
+    return optimized_plan;
+  }
+
+  // Each position of the sort orders must be covered by a pair of join keys, which are then compared in that order.
+  std::vector<AbstractExpressionRef> left_keys;
+  std::vector<AbstractExpressionRef> right_keys;
+  std::vector<bool> used(left_cols.size(), false);
+  for (size_t pos = 0; pos < left_cols.size(); pos++) {
+    size_t key = 0;
+    while (key < left_cols.size() &&
+           (used[key] || left_cols[key]->GetColIdx() != left_ordering[pos] ||
+            right_cols[key]->GetColIdx() != right_ordering[pos] ||
+            left_cols[key]->GetReturnType() != right_cols[key]->GetReturnType())) {
+      key++;
+    }
+    if (key == left_cols.size()) {
+      return optimized_plan;
+    }
+    used[key] = true;
+    left_keys.push_back(
+        std::make_shared<ColumnValueExpression>(0, left_cols[key]->GetColIdx(), left_cols[key]->GetReturnType()));
+    right_keys.push_back(
+        std::make_shared<ColumnValueExpression>(0, right_cols[key]->GetColIdx(), right_cols[key]->GetReturnType()));
+  }
+  return std::make_shared<MergeJoinPlanNode>(nlj_plan.output_schema_, nlj_plan.GetLeftPlan(), nlj_plan.GetRightPlan(),
+                                             std::move(left_keys), std::move(right_keys), nlj_plan.GetJoinType());
+}
+
+}  // namespace bustub
@@ -11,9 +11,12 @@ auto Optimizer::OptimizeCustom(const AbstractPlanNodeRef &plan) -> AbstractPlanN
   auto p = plan;
   p = OptimizeMergeProjection(p);
   p = OptimizeMergeFilterNLJ(p);
-  p = OptimizeNLJAsHashJoin(p);
+  p = OptimizeMergeFilterScan(p);
   p = OptimizeOrderByAsIndexScan(p);
+  p = OptimizeNLJAsMergeJoin(p);
+  p = OptimizeNLJAsHashJoin(p);
   p = OptimizeSortLimitAsTopN(p);
+  p = OptimizeLimitPushDown(p);
   return p;
 }
 
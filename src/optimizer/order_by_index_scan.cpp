@@ -54,6 +54,10 @@ auto Optimizer::OptimizeOrderByAsIndexScan(const AbstractPlanNodeRef &plan) -> A
 
     if (child_plan->GetType() == PlanType::SeqScan) {
       const auto &seq_scan = dynamic_cast<const SeqScanPlanNode &>(*child_plan);
+      // An index scan returns every row of the table, so it cannot replace a scan that filters them.
+      if (seq_scan.filter_predicate_ != nullptr) {
+        return optimized_plan;
+      }
       const auto *table_info = catalog_.GetTable(seq_scan.GetTableOid());
       const auto indices = catalog_.GetTableIndexes(table_info->name_);
 
@@ -0,0 +1,197 @@
+#include "optimizer/plan_cache.h"
+
+#include <cctype>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "execution/expressions/constant_value_expression.h"
+#include "execution/expressions/parameter_value_expression.h"
+#include "execution/plans/aggregation_plan.h"
+#include "execution/plans/filter_plan.h"
+#include "execution/plans/hash_join_plan.h"
+#include "execution/plans/merge_join_plan.h"
+#include "execution/plans/nested_index_join_plan.h"
+#include "execution/plans/nested_loop_join_plan.h"
+#include "execution/plans/projection_plan.h"
+#include "execution/plans/seq_scan_plan.h"
+#include "execution/plans/sort_plan.h"
+#include "execution/plans/topn_plan.h"
+#include "execution/plans/update_plan.h"
+#include "execution/plans/values_plan.h"
+
+namespace bustub {
+
+namespace {
+
+auto BindExpressionParameters(const AbstractExpressionRef &expr, const std::vector<Value> &parameters)
+    -> AbstractExpressionRef {
+  if (expr == nullptr) {
+    return nullptr;
+  }
+  if (const auto *parameter = dynamic_cast<const ParameterValueExpression *>(expr.get()); parameter != nullptr) {
+    return std::make_shared<ConstantValueExpression>(parameters.at(parameter->index_));
+  }
+  if (expr->GetChildren().empty()) {
+    return expr;
+  }
+  std::vector<AbstractExpressionRef> children;
+  for (const auto &child : expr->GetChildren()) {
+    children.emplace_back(BindExpressionParameters(child, parameters));
+  }
+  return expr->CloneWithChildren(std::move(children));
+}
+
+void BindExpressionsParameters(std::vector<AbstractExpressionRef> *exprs, const std::vector<Value> &parameters) {
+  for (auto &expr : *exprs) {
+    expr = BindExpressionParameters(expr, parameters);
+  }
+}
+
+void BindOrderByParameters(std::vector<std::pair<OrderByType, AbstractExpressionRef>> *order_bys,
+                           const std::vector<Value> &parameters) {
+  for (auto &[type, expr] : *order_bys) {
+    expr = BindExpressionParameters(expr, parameters);
+  }
+}
+
+}  // namespace
+
+auto BindPlanParameters(const AbstractPlanNodeRef &plan, const std::vector<Value> &parameters) -> AbstractPlanNodeRef {
+  std::vector<AbstractPlanNodeRef> children;
+  for (const auto &child : plan->GetChildren()) {
+    children.emplace_back(BindPlanParameters(child, parameters));
+  }
+  auto bound_plan = plan->CloneWithChildren(std::move(children));
+
+  switch (bound_plan->GetType()) {
+    case PlanType::SeqScan: {
+      auto &seq_scan_plan = dynamic_cast<SeqScanPlanNode &>(*bound_plan);
+      seq_scan_plan.filter_predicate_ = BindExpressionParameters(seq_scan_plan.filter_predicate_, parameters);
+      break;
+    }
+    case PlanType::Filter: {
+      auto &filter_plan = dynamic_cast<FilterPlanNode &>(*bound_plan);
+      filter_plan.predicate_ = BindExpressionParameters(filter_plan.predicate_, parameters);
+      break;
+    }
+    case PlanType::Projection: {
+      BindExpressionsParameters(&dynamic_cast<ProjectionPlanNode &>(*bound_plan).expressions_, parameters);
+      break;
+    }
+    case PlanType::Update: {
+      BindExpressionsParameters(&dynamic_cast<UpdatePlanNode &>(*bound_plan).target_expressions_, parameters);
+      break;
+    }
+    case PlanType::Aggregation: {
+      auto &aggregation_plan = dynamic_cast<AggregationPlanNode &>(*bound_plan);
+      BindExpressionsParameters(&aggregation_plan.group_bys_, parameters);
+      BindExpressionsParameters(&aggregation_plan.aggregates_, parameters);
+      break;
+    }
+    case PlanType::NestedLoopJoin: {
+      auto &nlj_plan = dynamic_cast<NestedLoopJoinPlanNode &>(*bound_plan);
+      nlj_plan.predicate_ = BindExpressionParameters(nlj_plan.predicate_, parameters);
+      break;
+    }
+    case PlanType::NestedIndexJoin: {
+      auto &nested_index_join_plan = dynamic_cast<NestedIndexJoinPlanNode &>(*bound_plan);
+      nested_index_join_plan.key_predicate_ =
+          BindExpressionParameters(nested_index_join_plan.key_predicate_, parameters);
+      break;
+    }
+    case PlanType::HashJoin: {
+      auto &hash_join_plan = dynamic_cast<HashJoinPlanNode &>(*bound_plan);
+      BindExpressionsParameters(&hash_join_plan.left_key_expressions_, parameters);
+      BindExpressionsParameters(&hash_join_plan.right_key_expressions_, parameters);
+      break;
+    }
+    case PlanType::MergeJoin: {
+      auto &merge_join_plan = dynamic_cast<MergeJoinPlanNode &>(*bound_plan);
+      BindExpressionsParameters(&merge_join_plan.left_key_expressions_, parameters);
+      BindExpressionsParameters(&merge_join_plan.right_key_expressions_, parameters);
+      break;
+    }
+    case PlanType::Values: {
+      for (auto &row : dynamic_cast<ValuesPlanNode &>(*bound_plan).values_) {
+        BindExpressionsParameters(&row, parameters);
+      }
+      break;
+    }
+    case PlanType::Sort: {
+      BindOrderByParameters(&dynamic_cast<SortPlanNode &>(*bound_plan).order_bys_, parameters);
+      break;
+    }
+    case PlanType::TopN: {
+      BindOrderByParameters(&dynamic_cast<TopNPlanNode &>(*bound_plan).order_bys_, parameters);
+      break;
+    }
+    default:
+      break;
+  }
+  return bound_plan;
+}
+
+auto PlanCache::Normalize(const std::string &sql) -> std::string {
+  std::string key;
+  key.reserve(sql.size());
+  char quote = 0;
+  bool space = false;
+  for (auto c : sql) {
+    if (quote == 0 && std::isspace(static_cast<unsigned char>(c)) != 0) {
+      space = true;
+      continue;
+    }
+    if (space && !key.empty()) {
+      key.push_back(' ');
+    }
+    space = false;
+    key.push_back(c);
+    if (quote != 0) {
+      quote = c == quote ? 0 : quote;
+    } else if (c == '\'' || c == '"') {
+      quote = c;
+    }
+  }
+  while (quote == 0 && !key.empty() && (key.back() == ';' || key.back() == ' ')) {
+    key.pop_back();
+  }
+  return key;
+}
+
+auto PlanCache::Get(const std::string &key, uint64_t catalog_version) -> std::shared_ptr<const CachedPlan> {
+  std::scoped_lock<std::mutex> guard(latch_);
+  auto it = plans_.find(key);
+  if (it == plans_.end()) {
+    misses_++;
+    return nullptr;
+  }
+  if (it->second->catalog_version_ != catalog_version) {
+    plans_.erase(it);
+    misses_++;
+    return nullptr;
+  }
+  hits_++;
+  return it->second;
+}
+
+void PlanCache::Put(const std::string &key, std::shared_ptr<const CachedPlan> plan) {
+  std::scoped_lock<std::mutex> guard(latch_);
+  if (plans_.size() >= CAPACITY) {
+    plans_.clear();
+  }
+  plans_[key] = std::move(plan);
+}
+
+auto PlanCache::GetHits() const -> size_t {
+  std::scoped_lock<std::mutex> guard(latch_);
+  return hits_;
+}
+
+auto PlanCache::GetMisses() const -> size_t {
+  std::scoped_lock<std::mutex> guard(latch_);
+  return misses_;
+}
+
+}  // namespace bustub
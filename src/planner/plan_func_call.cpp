@@ -36,9 +36,14 @@ auto Planner::PlanFuncCall(const BoundFuncCall &expr, const std::vector<Abstract
 // NOLINTNEXTLINE
 auto Planner::GetFuncCallFromFactory(const std::string &func_name, std::vector<AbstractExpressionRef> args)
     -> AbstractExpressionRef {
-  // 1. check if the parsed function name is "lower" or "upper".
-  // 2. verify the number of args (should be 1), refer to the test cases for when you should throw an `Exception`.
-  // 3. return a `StringExpression` std::shared_ptr.
+  if (func_name == "lower" || func_name == "upper") {
+    if (args.size() != 1) {
+      throw Exception(fmt::format("{} expects 1 argument, got {}", func_name, args.size()));
+    }
+    // The constructor of StringExpression rejects arguments that are not strings.
+    auto expr_type = func_name == "lower" ? StringExpressionType::Lower : StringExpressionType::Upper;
+    return std::make_shared<StringExpression>(std::move(args[0]), expr_type);
+  }
   throw Exception(fmt::format("func call {} not supported in planner yet", func_name));
 }
 
@@ -36,6 +36,7 @@ auto Planner::PlanSelect(const SelectStatement &statement) -> AbstractPlanNodeRe
   auto ctx_guard = NewContext();
   if (!statement.ctes_.empty()) {
     ctx_.cte_list_ = &statement.ctes_;
+    ChooseMaterializedCTEs(statement);
   }
 
   AbstractPlanNodeRef plan = nullptr;
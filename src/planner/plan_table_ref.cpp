@@ -1,5 +1,8 @@
 #include <memory>
+#include <string>
+#include <unordered_map>
 #include <utility>
+#include <vector>
 
 #include "binder/bound_order_by.h"
 #include "binder/bound_statement.h"
@@ -18,6 +21,7 @@
 #include "common/util/string_util.h"
 #include "execution/expressions/column_value_expression.h"
 #include "execution/expressions/constant_value_expression.h"
+#include "execution/plans/cte_scan_plan.h"
 #include "execution/plans/mock_scan_plan.h"
 #include "execution/plans/nested_loop_join_plan.h"
 #include "execution/plans/projection_plan.h"
@@ -122,19 +126,118 @@ auto Planner::PlanCrossProductRef(const BoundCrossProductRef &table_ref) -> Abst
 auto Planner::PlanCTERef(const BoundCTERef &table_ref) -> AbstractPlanNodeRef {
   for (const auto &cte : *ctx_.cte_list_) {
     if (cte->alias_ == table_ref.cte_name_) {
-      return PlanSubquery(*cte, table_ref.alias_);
+      auto it = materialized_ctes_.find(cte.get());
+      if (it == materialized_ctes_.end()) {
+        return PlanSubquery(*cte, table_ref.alias_);
+      }
+      auto &materialized = it->second;
+      if (materialized.plan_ == nullptr) {
+        materialized.plan_ = PlanSelect(*cte->subquery_);
+      }
+      std::vector<std::string> output_column_names;
+      for (const auto &name : cte->select_list_name_) {
+        output_column_names.emplace_back(fmt::format("{}.{}", table_ref.alias_, fmt::join(name, ".")));
+      }
+      return std::make_shared<CTEScanPlanNode>(
+          std::make_shared<Schema>(
+              ProjectionPlanNode::RenameSchema(materialized.plan_->OutputSchema(), output_column_names)),
+          materialized.plan_, materialized.id_, cte->alias_);
     }
   }
   UNREACHABLE("CTE not found");
 }
 
+namespace {
+
+void CountCTERefs(const SelectStatement &statement, std::unordered_map<std::string, size_t> *refs);
+
+/** Count the references to the CTEs in `refs` in a table ref, including those in the subqueries it reads. */
+void CountCTERefs(const BoundTableRef &table_ref, std::unordered_map<std::string, size_t> *refs) {
+  switch (table_ref.type_) {
+    case TableReferenceType::CROSS_PRODUCT: {
+      const auto &cross_product = dynamic_cast<const BoundCrossProductRef &>(table_ref);
+      CountCTERefs(*cross_product.left_, refs);
+      CountCTERefs(*cross_product.right_, refs);
+      break;
+    }
+    case TableReferenceType::JOIN: {
+      const auto &join = dynamic_cast<const BoundJoinRef &>(table_ref);
+      CountCTERefs(*join.left_, refs);
+      CountCTERefs(*join.right_, refs);
+      break;
+    }
+    case TableReferenceType::SUBQUERY:
+      CountCTERefs(*dynamic_cast<const BoundSubqueryRef &>(table_ref).subquery_, refs);
+      break;
+    case TableReferenceType::CTE: {
+      auto it = refs->find(dynamic_cast<const BoundCTERef &>(table_ref).cte_name_);
+      if (it != refs->end()) {
+        it->second++;
+      }
+      break;
+    }
+    default:
+      break;
+  }
+}
+
+void CountCTERefs(const SelectStatement &statement, std::unordered_map<std::string, size_t> *refs) {
+  // A statement with CTEs of its own does not see those of the statements around it.
+  if (statement.ctes_.empty()) {
+    CountCTERefs(*statement.table_, refs);
+  }
+}
+
+/** @return whether computing a query again costs about as much as reading its rows back */
+auto IsCheapToRecompute(const SelectStatement &statement) -> bool {
+  switch (statement.table_->type_) {
+    case TableReferenceType::BASE_TABLE:
+    case TableReferenceType::CTE:
+    case TableReferenceType::EMPTY:
+    case TableReferenceType::EXPRESSION_LIST:
+      break;
+    default:
+      return false;
+  }
+  for (const auto &expr : statement.select_list_) {
+    if (expr->HasAggregation()) {
+      return false;
+    }
+  }
+  return statement.group_by_.empty() && statement.having_->IsInvalid() && !statement.is_distinct_ &&
+         statement.sort_.empty() && statement.limit_count_->IsInvalid() && statement.limit_offset_->IsInvalid();
+}
+
+}  // namespace
+
+void Planner::ChooseMaterializedCTEs(const SelectStatement &statement) {
+  std::unordered_map<std::string, size_t> refs;
+  for (const auto &cte : statement.ctes_) {
+    refs[cte->alias_] = 0;
+  }
+  CountCTERefs(*statement.table_, &refs);
+  for (const auto &cte : statement.ctes_) {
+    CountCTERefs(*cte->subquery_, &refs);
+  }
+
+  for (const auto &cte : statement.ctes_) {
+    if (refs[cte->alias_] > 1 && !IsCheapToRecompute(*cte->subquery_)) {
+      auto id = static_cast<uint32_t>(materialized_ctes_.size());
+      materialized_ctes_.emplace(cte.get(), MaterializedCTE{id, nullptr});
+    }
+  }
+}
+
 auto Planner::PlanJoinRef(const BoundJoinRef &table_ref) -> AbstractPlanNodeRef {
   auto left = PlanTableRef(*table_ref.left_);
   auto right = PlanTableRef(*table_ref.right_);
   auto [_, join_condition] = PlanExpression(*table_ref.condition_, {left, right});
-  auto nlj_node = std::make_shared<NestedLoopJoinPlanNode>(
-      std::make_shared<Schema>(NestedLoopJoinPlanNode::InferJoinSchema(*left, *right)), std::move(left),
-      std::move(right), std::move(join_condition), table_ref.join_type_);
+  // Semi and anti joins only produce the left rows.
+  auto schema = table_ref.join_type_ == JoinType::SEMI || table_ref.join_type_ == JoinType::ANTI
+                    ? std::make_shared<Schema>(left->OutputSchema())
+                    : std::make_shared<Schema>(NestedLoopJoinPlanNode::InferJoinSchema(*left, *right));
+  auto nlj_node = std::make_shared<NestedLoopJoinPlanNode>(std::move(schema), std::move(left), std::move(right),
+                                                           std::move(join_condition), table_ref.join_type_);
   return nlj_node;
 }
 
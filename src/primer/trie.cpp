@@ -1,33 +1,468 @@
 #include "primer/trie.h"
 #include <string_view>
+#include <unordered_set>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
 #include "common/exception.h"
 
 namespace bustub {
 
+/**
+ * TrieChildren (adaptive radix tree layouts)
+ */
+
+auto TrieChildren::Capacity(Kind kind) -> size_t {
+  switch (kind) {
+    case Kind::NODE4:
+      return 4;
+    case Kind::NODE16:
+      return 16;
+    case Kind::NODE48:
+      return 48;
+    case Kind::NODE256:
+      return 256;
+  }
+  return 0;
+}
+
+auto TrieChildren::KeyBytes(Kind kind) -> size_t {
+  switch (kind) {
+    case Kind::NODE4:
+      return 4;
+    case Kind::NODE16:
+      return 16;
+    case Kind::NODE48:
+      return 256;
+    case Kind::NODE256:
+      return 0;
+  }
+  return 0;
+}
+
+auto TrieChildren::ChildSlots(Kind kind) -> size_t { return Capacity(kind); }
+
+TrieChildren::TrieChildren(const TrieChildren &that) : kind_(that.kind_), size_(that.size_) {
+  if (that.keys_ != nullptr) {
+    keys_ = std::make_unique<uint8_t[]>(KeyBytes(kind_));
+    std::copy_n(that.keys_.get(), KeyBytes(kind_), keys_.get());
+  }
+  if (that.children_ != nullptr) {
+    children_ = std::make_unique<std::shared_ptr<const TrieNode>[]>(ChildSlots(kind_));
+    std::copy_n(that.children_.get(), ChildSlots(kind_), children_.get());
+  }
+}
+
+auto TrieChildren::operator=(const TrieChildren &that) -> TrieChildren & {
+  if (this != &that) {
+    TrieChildren copy(that);
+    *this = std::move(copy);
+  }
+  return *this;
+}
+
+auto TrieChildren::MemoryUsage() const -> size_t {
+  size_t bytes = 0;
+  if (keys_ != nullptr) {
+    bytes += KeyBytes(kind_);
+  }
+  if (children_ != nullptr) {
+    bytes += ChildSlots(kind_) * sizeof(std::shared_ptr<const TrieNode>);
+  }
+  return bytes;
+}
+
+auto TrieChildren::LowerBound(uint8_t c) const -> size_t {
+  size_t pos = 0;
+  while (pos < size_ && keys_[pos] < c) {
+    pos++;
+  }
+  return pos;
+}
+
+auto TrieChildren::Find(char c) const -> const std::shared_ptr<const TrieNode> * {
+  return Slot(static_cast<uint8_t>(c));
+}
+
+auto TrieChildren::Slot(uint8_t key) const -> std::shared_ptr<const TrieNode> * {
+  switch (kind_) {
+    case Kind::NODE4:
+      for (size_t i = 0; i < size_; i++) {
+        if (keys_[i] == key) {
+          return &children_[i];
+        }
+      }
+      return nullptr;
+    case Kind::NODE16: {
+#if defined(__SSE2__)
+      // Compare all 16 keys at once and keep the matches that fall within the used part of the array.
+      auto cmp = _mm_cmpeq_epi8(_mm_set1_epi8(static_cast<char>(key)),
+                                _mm_loadu_si128(reinterpret_cast<const __m128i *>(keys_.get())));
+      auto mask = static_cast<uint32_t>(_mm_movemask_epi8(cmp)) & ((1U << size_) - 1);
+      if (mask != 0) {
+        return &children_[__builtin_ctz(mask)];
+      }
+      return nullptr;
+#else
+      auto pos = LowerBound(key);
+      if (pos < size_ && keys_[pos] == key) {
+        return &children_[pos];
+      }
+      return nullptr;
+#endif
+    }
+    case Kind::NODE48:
+      if (keys_[key] == EMPTY_SLOT) {
+        return nullptr;
+      }
+      return &children_[keys_[key]];
+    case Kind::NODE256:
+      if (children_[key] == nullptr) {
+        return nullptr;
+      }
+      return &children_[key];
+  }
+  return nullptr;
+}
+
+void TrieChildren::Convert(Kind kind) {
+  TrieChildren table;
+  table.kind_ = kind;
+  table.size_ = size_;
+  if (KeyBytes(kind) != 0) {
+    table.keys_ = std::make_unique<uint8_t[]>(KeyBytes(kind));
+    std::fill_n(table.keys_.get(), KeyBytes(kind), kind == Kind::NODE48 ? EMPTY_SLOT : 0);
+  }
+  table.children_ = std::make_unique<std::shared_ptr<const TrieNode>[]>(ChildSlots(kind));
+
+  size_t slot = 0;
+  for (size_t c = 0; c < 256; c++) {
+    auto *child = Slot(static_cast<uint8_t>(c));
+    if (child == nullptr) {
+      continue;
+    }
+    if (kind == Kind::NODE256) {
+      table.children_[c] = std::move(*child);
+      continue;
+    }
+    if (kind == Kind::NODE48) {
+      table.keys_[c] = static_cast<uint8_t>(slot);
+    } else {
+      table.keys_[slot] = static_cast<uint8_t>(c);
+    }
+    table.children_[slot++] = std::move(*child);
+  }
+  *this = std::move(table);
+}
+
+void TrieChildren::Set(char c, std::shared_ptr<const TrieNode> child) {
+  if (auto *existing = Slot(static_cast<uint8_t>(c)); existing != nullptr) {
+    *existing = std::move(child);
+    return;
+  }
+  if (children_ == nullptr) {
+    // Leaves do not allocate a child table until their first child is added.
+    keys_ = std::make_unique<uint8_t[]>(KeyBytes(Kind::NODE4));
+    children_ = std::make_unique<std::shared_ptr<const TrieNode>[]>(ChildSlots(Kind::NODE4));
+    kind_ = Kind::NODE4;
+  } else if (size_ == Capacity(kind_)) {
+    Convert(static_cast<Kind>(static_cast<uint8_t>(kind_) + 1));
+  }
+
+  auto key = static_cast<uint8_t>(c);
+  switch (kind_) {
+    case Kind::NODE4:
+    case Kind::NODE16: {
+      auto pos = LowerBound(key);
+      for (size_t i = size_; i > pos; i--) {
+        keys_[i] = keys_[i - 1];
+        children_[i] = std::move(children_[i - 1]);
+      }
+      keys_[pos] = key;
+      children_[pos] = std::move(child);
+      break;
+    }
+    case Kind::NODE48: {
+      // Slots are compacted on erase, so the first free slot is always `size_`.
+      keys_[key] = static_cast<uint8_t>(size_);
+      children_[size_] = std::move(child);
+      break;
+    }
+    case Kind::NODE256:
+      children_[key] = std::move(child);
+      break;
+  }
+  size_++;
+}
+
+auto TrieChildren::Erase(char c) -> bool {
+  if (Slot(static_cast<uint8_t>(c)) == nullptr) {
+    return false;
+  }
+  auto key = static_cast<uint8_t>(c);
+  switch (kind_) {
+    case Kind::NODE4:
+    case Kind::NODE16: {
+      auto pos = LowerBound(key);
+      for (size_t i = pos; i + 1 < size_; i++) {
+        keys_[i] = keys_[i + 1];
+        children_[i] = std::move(children_[i + 1]);
+      }
+      children_[size_ - 1] = nullptr;
+      break;
+    }
+    case Kind::NODE48: {
+      // Move the last slot into the hole so that used slots stay contiguous.
+      auto slot = keys_[key];
+      auto last = static_cast<uint8_t>(size_ - 1);
+      if (slot != last) {
+        children_[slot] = std::move(children_[last]);
+        for (size_t k = 0; k < 256; k++) {
+          if (keys_[k] == last) {
+            keys_[k] = slot;
+            break;
+          }
+        }
+      }
+      children_[last] = nullptr;
+      keys_[key] = EMPTY_SLOT;
+      break;
+    }
+    case Kind::NODE256:
+      children_[key] = nullptr;
+      break;
+  }
+  size_--;
+
+  // Shrink with some hysteresis so that alternating insert/erase at a boundary does not convert back and forth.
+  if (size_ == 0) {
+    *this = TrieChildren();
+  } else if (kind_ == Kind::NODE256 && size_ <= 37) {
+    Convert(Kind::NODE48);
+  } else if (kind_ == Kind::NODE48 && size_ <= 12) {
+    Convert(Kind::NODE16);
+  } else if (kind_ == Kind::NODE16 && size_ <= 3) {
+    Convert(Kind::NODE4);
+  }
+  return true;
+}
+
+/**
+ * Trie
+ */
+
+namespace {
+
+// Length of the longest common prefix of `a` and `b`.
+auto CommonPrefixLength(std::string_view a, std::string_view b) -> size_t {
+  size_t len = 0;
+  while (len < a.size() && len < b.size() && a[len] == b[len]) {
+    len++;
+  }
+  return len;
+}
+
+// The set of nodes created by a TrieWriter that have not been published yet, or nullptr for plain copy-on-write
+// operations. Stale addresses of nodes freed during the write are harmless: nodes of the base trie are alive for the
+// whole write, so the only nodes that can reuse those addresses are new nodes of the same writer.
+using OwnedNodes = std::unordered_set<const TrieNode *>;
+
+auto IsOwned(const std::shared_ptr<const TrieNode> &node, const OwnedNodes *owned) -> bool {
+  return owned != nullptr && owned->count(node.get()) != 0;
+}
+
+// Take ownership of a freshly created node.
+auto Adopt(std::unique_ptr<TrieNode> node, OwnedNodes *owned) -> std::shared_ptr<TrieNode> {
+  std::shared_ptr<TrieNode> adopted(std::move(node));
+  if (owned != nullptr) {
+    owned->insert(adopted.get());
+  }
+  return adopted;
+}
+
+// Return a node that can be modified: `node` itself if it is owned by the current writer, or a clone of it.
+auto Mutable(const std::shared_ptr<const TrieNode> &node, OwnedNodes *owned) -> std::shared_ptr<TrieNode> {
+  if (IsOwned(node, owned)) {
+    return std::const_pointer_cast<TrieNode>(node);
+  }
+  return Adopt(node->Clone(), owned);
+}
+
+// Return the children of `node` for a node that replaces it. Children of an owned node are moved instead of copied.
+auto TakeChildren(const std::shared_ptr<const TrieNode> &node, const OwnedNodes *owned) -> TrieChildren {
+  if (IsOwned(node, owned)) {
+    return std::move(std::const_pointer_cast<TrieNode>(node)->children_);
+  }
+  return node->children_;
+}
+
+// Restore the path compression invariant on a freshly modified node: a node without a value is removed if it has no
+// children, and merged into its only child if it has exactly one.
+auto Compact(std::shared_ptr<TrieNode> node, OwnedNodes *owned) -> std::shared_ptr<const TrieNode> {
+  if (node->is_value_node_) {
+    return node;
+  }
+  if (node->children_.Empty()) {
+    return nullptr;
+  }
+  if (node->children_.Size() == 1) {
+    std::shared_ptr<TrieNode> merged;
+    node->children_.ForEach([&](char c, const std::shared_ptr<const TrieNode> &child) {
+      auto prefix = node->prefix_ + c + child->prefix_;
+      merged = Mutable(child, owned);
+      merged->prefix_ = std::move(prefix);
+    });
+    return merged;
+  }
+  return node;
+}
+
+// Put the value node created by `make_value_node` at `key` below `node`, returning the new subtree.
+template <class MakeValueNode>
+auto PutNode(const std::shared_ptr<const TrieNode> &node, std::string_view key, const MakeValueNode &make_value_node,
+             OwnedNodes *owned) -> std::shared_ptr<const TrieNode> {
+  if (node == nullptr) {
+    auto leaf = Adopt(make_value_node(TrieChildren()), owned);
+    leaf->prefix_ = std::string(key);
+    return leaf;
+  }
+
+  auto common = CommonPrefixLength(node->prefix_, key);
+  if (common < node->prefix_.size()) {
+    // The key diverges inside the compressed path (or ends within it): split the path at `common`.
+    auto split_prefix = node->prefix_.substr(0, common);
+    auto branch = node->prefix_[common];
+    auto tail = Mutable(node, owned);
+    tail->prefix_.erase(0, common + 1);
+    TrieChildren children;
+    children.Set(branch, std::move(tail));
+
+    std::shared_ptr<TrieNode> split;
+    if (common == key.size()) {
+      split = Adopt(make_value_node(std::move(children)), owned);
+    } else {
+      auto leaf = Adopt(make_value_node(TrieChildren()), owned);
+      leaf->prefix_ = std::string(key.substr(common + 1));
+      children.Set(key[common], std::move(leaf));
+      split = Adopt(std::make_unique<TrieNode>(std::move(children)), owned);
+    }
+    split->prefix_ = std::move(split_prefix);
+    return split;
+  }
+
+  key.remove_prefix(common);
+  if (key.empty()) {
+    auto replaced = Adopt(make_value_node(TakeChildren(node, owned)), owned);
+    replaced->prefix_ = node->prefix_;
+    return replaced;
+  }
+
+  const auto *child = node->children_.Find(key[0]);
+  auto new_child = PutNode(child == nullptr ? nullptr : *child, key.substr(1), make_value_node, owned);
+  auto new_node = Mutable(node, owned);
+  new_node->children_.Set(key[0], std::move(new_child));
+  return new_node;
+}
+
+// Remove `key` below `node`. Returns std::nullopt if the key does not exist, so that the caller can keep sharing the
+// original subtree; otherwise returns the new subtree, which is nullptr if it became empty.
+auto RemoveNode(const std::shared_ptr<const TrieNode> &node, std::string_view key, OwnedNodes *owned)
+    -> std::optional<std::shared_ptr<const TrieNode>> {
+  if (key.substr(0, node->prefix_.size()) != node->prefix_) {
+    return std::nullopt;
+  }
+  key.remove_prefix(node->prefix_.size());
+
+  if (key.empty()) {
+    if (!node->is_value_node_) {
+      return std::nullopt;
+    }
+    auto plain = Adopt(std::make_unique<TrieNode>(TakeChildren(node, owned)), owned);
+    plain->prefix_ = node->prefix_;
+    return Compact(std::move(plain), owned);
+  }
+
+  const auto *child = node->children_.Find(key[0]);
+  if (child == nullptr) {
+    return std::nullopt;
+  }
+  auto new_child = RemoveNode(*child, key.substr(1), owned);
+  if (!new_child.has_value()) {
+    return std::nullopt;
+  }
+  auto new_node = Mutable(node, owned);
+  if (*new_child == nullptr) {
+    new_node->children_.Erase(key[0]);
+  } else {
+    new_node->children_.Set(key[0], std::move(*new_child));
+  }
+  return Compact(std::move(new_node), owned);
+}
+
+}  // namespace
+
 template <class T>
 auto Trie::Get(std::string_view key) const -> const T * {
-  throw NotImplementedException("Trie::Get is not implemented.");
-
-  // You should walk through the trie to find the node corresponding to the key. If the node doesn't exist, return
-  // nullptr. After you find the node, you should use `dynamic_cast` to cast it to `const TrieNodeWithValue<T> *`. If
-  // dynamic_cast returns `nullptr`, it means the type of the value is mismatched, and you should return nullptr.
-  // Otherwise, return the value.
+  const TrieNode *node = root_.get();
+  while (node != nullptr) {
+    if (key.substr(0, node->prefix_.size()) != node->prefix_) {
+      return nullptr;
+    }
+    key.remove_prefix(node->prefix_.size());
+    if (key.empty()) {
+      const auto *value_node = dynamic_cast<const TrieNodeWithValue<T> *>(node);
+      return value_node == nullptr ? nullptr : value_node->value_.get();
+    }
+    const auto *child = node->children_.Find(key[0]);
+    node = child == nullptr ? nullptr : child->get();
+    key.remove_prefix(1);
+  }
+  return nullptr;
 }
 
 template <class T>
 auto Trie::Put(std::string_view key, T value) const -> Trie {
   // Note that `T` might be a non-copyable type. Always use `std::move` when creating `shared_ptr` on that value.
-  throw NotImplementedException("Trie::Put is not implemented.");
-
-  // You should walk through the trie and create new nodes if necessary. If the node corresponding to the key already
-  // exists, you should create a new `TrieNodeWithValue`.
+  auto shared_value = std::make_shared<T>(std::move(value));
+  auto make_value_node = [&shared_value](TrieChildren children) -> std::unique_ptr<TrieNode> {
+    return std::make_unique<TrieNodeWithValue<T>>(std::move(children), shared_value);
+  };
+  return Trie(PutNode(root_, key, make_value_node, nullptr));
 }
 
 auto Trie::Remove(std::string_view key) const -> Trie {
-  throw NotImplementedException("Trie::Remove is not implemented.");
+  if (root_ == nullptr) {
+    return *this;
+  }
+  auto new_root = RemoveNode(root_, key, nullptr);
+  if (!new_root.has_value()) {
+    return *this;
+  }
+  return Trie(std::move(*new_root));
+}
+
+/**
+ * TrieWriter
+ */
+
+void TrieWriter::PutNode(std::string_view key, const MakeValueNode &make_value_node) {
+  root_ = bustub::PutNode(root_, key, make_value_node, &owned_);
+}
+
+void TrieWriter::Remove(std::string_view key) {
+  if (root_ == nullptr) {
+    return;
+  }
+  if (auto new_root = RemoveNode(root_, key, &owned_); new_root.has_value()) {
+    root_ = std::move(*new_root);
+  }
+}
 
-  // You should walk through the trie and remove nodes if necessary. If the node doesn't contain a value any more,
-  // you should convert it to `TrieNode`. If a node doesn't have children any more, you should remove it.
+auto TrieWriter::Finish() -> Trie {
+  owned_.clear();
+  return Trie(root_);
 }
 
 // Below are explicit instantiation of template functions.
@@ -1,30 +1,98 @@
 #include "primer/trie_store.h"
+
+#include <exception>
+
 #include "common/exception.h"
 
 namespace bustub {
 
 template <class T>
 auto TrieStore::Get(std::string_view key) -> std::optional<ValueGuard<T>> {
-  // Pseudo-code:
-  // (1) Take the root lock, get the root, and release the root lock. Don't lookup the value in the
-  //     trie while holding the root lock.
-  // (2) Lookup the value in the trie.
-  // (3) If the value is found, return a ValueGuard object that holds a reference to the value and the
-  //     root. Otherwise, return std::nullopt.
-  throw NotImplementedException("TrieStore::Get is not implemented.");
+  // Take a snapshot of the root, and look up the value without holding the root lock.
+  std::unique_lock<std::mutex> root_guard(root_lock_);
+  auto root = root_;
+  root_guard.unlock();
+
+  const T *value = root.Get<T>(key);
+  if (value == nullptr) {
+    return std::nullopt;
+  }
+  return ValueGuard<T>(std::move(root), *value);
 }
 
 template <class T>
 void TrieStore::Put(std::string_view key, T value) {
-  // You will need to ensure there is only one writer at a time. Think of how you can achieve this.
-  // The logic should be somehow similar to `TrieStore::Get`.
-  throw NotImplementedException("TrieStore::Put is not implemented.");
+  WriteBatch batch;
+  batch.Put<T>(key, std::move(value));
+  Write(std::move(batch));
 }
 
 void TrieStore::Remove(std::string_view key) {
-  // You will need to ensure there is only one writer at a time. Think of how you can achieve this.
-  // The logic should be somehow similar to `TrieStore::Get`.
-  throw NotImplementedException("TrieStore::Remove is not implemented.");
+  WriteBatch batch;
+  batch.Remove(key);
+  Write(std::move(batch));
+}
+
+void TrieStore::Write(WriteBatch batch) {
+  if (batch.Empty()) {
+    return;
+  }
+
+  PendingWrite pending{&batch};
+  std::unique_lock<std::mutex> queue_guard(queue_lock_);
+  queue_.push_back(&pending);
+  queue_cv_.wait(queue_guard, [&] { return pending.done_ || queue_.front() == &pending; });
+  if (pending.done_) {
+    // Another writer has committed this batch as part of its group, or dropped it because it threw.
+    if (pending.error_ != nullptr) {
+      std::rethrow_exception(pending.error_);
+    }
+    return;
+  }
+
+  // This writer is at the front of the queue: commit its batch together with the batches queued behind it.
+  auto group_size = std::min(queue_.size(), MAX_GROUP_SIZE);
+  std::vector<PendingWrite *> group(queue_.begin(), queue_.begin() + group_size);
+  queue_guard.unlock();
+
+  {
+    std::lock_guard<std::mutex> write_guard(write_lock_);
+    std::unique_lock<std::mutex> root_guard(root_lock_);
+    auto checkpoint = root_;
+    root_guard.unlock();
+
+    // Each batch is applied on top of the checkpoint left by the batches before it, so that a batch that throws is
+    // dropped on its own and the rest of the group still commits. Finish() makes the checkpoint immutable, so a
+    // failed batch cannot have modified it in place.
+    TrieWriter writer(checkpoint);
+    for (auto *write : group) {
+      try {
+        for (auto &op : write->batch_->ops_) {
+          op(writer);
+        }
+        checkpoint = writer.Finish();
+      } catch (...) {
+        write->error_ = std::current_exception();
+        writer = TrieWriter(checkpoint);
+      }
+    }
+
+    root_guard.lock();
+    std::swap(root_, checkpoint);
+    root_guard.unlock();
+    // The old root (now in `checkpoint`) is released here, outside of the root lock.
+  }
+
+  queue_guard.lock();
+  for (auto *write : group) {
+    queue_.pop_front();
+    write->done_ = true;
+  }
+  queue_guard.unlock();
+  queue_cv_.notify_all();
+  if (pending.error_ != nullptr) {
+    std::rethrow_exception(pending.error_);
+  }
 }
 
 // Below are explicit instantiation of template functions.
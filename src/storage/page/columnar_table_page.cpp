@@ -0,0 +1,348 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// columnar_table_page.cpp
+//
+// Identification: src/storage/page/columnar_table_page.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/page/columnar_table_page.h"
+
+#include <algorithm>
+#include <cstring>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "common/exception.h"
+#include "common/macros.h"
+#include "storage/table/toast_store.h"
+
+namespace bustub {
+
+namespace {
+
+/** @return whether the fixed-size part of a column can be encoded, see ColumnarTablePage::CopyColumn */
+auto IsEncodable(const Column &column) -> bool {
+  auto width = column.GetFixedLength();
+  return width == 1 || width == 2 || width == 4 || width == 8 || !column.IsInlined();
+}
+
+/** @return the number of bytes of a column that are encoded; a VARCHAR column holds a 4-byte offset */
+auto EncodedWidth(const Column &column) -> uint32_t {
+  return column.IsInlined() ? column.GetFixedLength() : sizeof(uint32_t);
+}
+
+/** @return the value of a fixed-size column at `data`, sign-extended to 64 bits */
+auto LoadRaw(const char *data, uint32_t width) -> int64_t {
+  switch (width) {
+    case 1:
+      return static_cast<int8_t>(*data);
+    case 2: {
+      int16_t value;
+      memcpy(&value, data, sizeof(value));
+      return value;
+    }
+    case 4: {
+      int32_t value;
+      memcpy(&value, data, sizeof(value));
+      return value;
+    }
+    default: {
+      int64_t value;
+      memcpy(&value, data, sizeof(value));
+      return value;
+    }
+  }
+}
+
+}  // namespace
+
+auto ColumnarTablePage::SlotSize(const Schema &schema) -> uint32_t {
+  return TUPLE_META_SIZE + sizeof(VarlenSlot) + schema.GetLength();
+}
+
+auto ColumnarTablePage::Capacity(const Schema &schema) -> uint32_t {
+  uint32_t tuple_size = SlotSize(schema);
+  for (auto column_idx : schema.GetUnlinedColumns()) {
+    tuple_size += sizeof(uint32_t) + schema.GetColumn(column_idx).GetVariableLength() / 2;
+  }
+  auto capacity = (BUSTUB_PAGE_SIZE - COLUMNAR_TABLE_PAGE_HEADER_SIZE) / tuple_size;
+  BUSTUB_ENSURE(capacity > 0, "tuples of the schema are too large for a columnar page");
+  return capacity;
+}
+
+void ColumnarTablePage::Init(const Schema &schema) {
+  next_page_id_ = INVALID_PAGE_ID;
+  num_tuples_ = 0;
+  num_deleted_tuples_ = 0;
+  capacity_ = Capacity(schema);
+  tuple_length_ = schema.GetLength();
+  varlen_begin_ = BUSTUB_PAGE_SIZE;
+  num_encoded_ = 0;
+  tail_begin_ = COLUMNAR_TABLE_PAGE_HEADER_SIZE + capacity_ * (TUPLE_META_SIZE + sizeof(VarlenSlot));
+  reserved_ = 0;
+}
+
+auto ColumnarTablePage::GetFreeVarlenSpace() const -> uint32_t {
+  return varlen_begin_ - (tail_begin_ + TailCapacity() * tuple_length_);
+}
+
+auto ColumnarTablePage::Encoded(uint32_t k) const -> EncodedColumn {
+  const char *directory = reinterpret_cast<const char *>(VarlenSlots() + TailCapacity());
+  uint16_t offset;
+  memcpy(&offset, directory + k * sizeof(uint16_t), sizeof(offset));
+  return EncodedColumn(page_start_ + offset);
+}
+
+auto ColumnarTablePage::GetVarlenSlot(uint32_t slot) const -> VarlenSlot {
+  if (slot >= num_encoded_) {
+    return VarlenSlots()[slot - num_encoded_];
+  }
+  return VarlenSlot{static_cast<uint16_t>(Encoded(0).Get(slot)), static_cast<uint16_t>(Encoded(1).Get(slot))};
+}
+
+void ColumnarTablePage::CopyColumn(uint32_t slot, uint32_t column_idx, const Column &column, char *dest) const {
+  if (slot >= num_encoded_) {
+    memcpy(dest, ColumnData(slot, column), column.GetFixedLength());
+    return;
+  }
+  // Little-endian, so the low bytes of the value are the bytes of the column. The offset of a VARCHAR value is
+  // followed by zeros, see Freeze.
+  auto value = Encoded(2 + column_idx).Get(slot);
+  auto width = EncodedWidth(column);
+  memcpy(dest, &value, width);
+  memset(dest + width, 0, column.GetFixedLength() - width);
+}
+
+auto ColumnarTablePage::GetFreeSpaceRemaining() const -> uint32_t {
+  if (num_tuples_ == capacity_) {
+    return 0;
+  }
+  return tuple_length_ + GetFreeVarlenSpace();
+}
+
+auto ColumnarTablePage::InsertTuple(const TupleMeta &meta, const Tuple &tuple, const Schema &schema)
+    -> std::optional<uint16_t> {
+  auto varlen_size = tuple.GetLength() - tuple_length_;
+  if (num_tuples_ == capacity_ || varlen_size > GetFreeVarlenSpace()) {
+    return std::nullopt;
+  }
+  auto tuple_id = num_tuples_;
+  varlen_begin_ -= varlen_size;
+  memcpy(page_start_ + varlen_begin_, tuple.GetData() + tuple_length_, varlen_size);
+  VarlenSlots()[tuple_id - num_encoded_] = VarlenSlot{varlen_begin_, static_cast<uint16_t>(varlen_size)};
+  Metas()[tuple_id] = meta;
+  for (const auto &column : schema.GetColumns()) {
+    memcpy(ColumnData(tuple_id, column), tuple.GetData() + column.GetOffset(), column.GetFixedLength());
+  }
+  num_tuples_++;
+  return tuple_id;
+}
+
+void ColumnarTablePage::UpdateTupleMeta(const TupleMeta &meta, const RID &rid) {
+  auto tuple_id = rid.GetSlotNum();
+  if (tuple_id >= num_tuples_) {
+    throw bustub::Exception("Tuple ID out of range");
+  }
+  if (!Metas()[tuple_id].is_deleted_ && meta.is_deleted_) {
+    num_deleted_tuples_++;
+  }
+  Metas()[tuple_id] = meta;
+}
+
+auto ColumnarTablePage::GetTuple(const RID &rid, const Schema &schema) const -> std::pair<TupleMeta, Tuple> {
+  auto tuple_id = rid.GetSlotNum();
+  if (tuple_id >= num_tuples_) {
+    throw bustub::Exception("Tuple ID out of range");
+  }
+  auto varlen = GetVarlenSlot(tuple_id);
+  Tuple tuple{rid};
+  tuple.data_.resize(tuple_length_ + varlen.size_);
+  for (uint32_t column_idx = 0; column_idx < schema.GetColumnCount(); column_idx++) {
+    const auto &column = schema.GetColumn(column_idx);
+    CopyColumn(tuple_id, column_idx, column, tuple.data_.data() + column.GetOffset());
+  }
+  memcpy(tuple.data_.data() + tuple_length_, page_start_ + varlen.offset_, varlen.size_);
+  return std::make_pair(Metas()[tuple_id], std::move(tuple));
+}
+
+auto ColumnarTablePage::GetTupleMeta(const RID &rid) const -> TupleMeta {
+  auto tuple_id = rid.GetSlotNum();
+  if (tuple_id >= num_tuples_) {
+    throw bustub::Exception("Tuple ID out of range");
+  }
+  return Metas()[tuple_id];
+}
+
+auto ColumnarTablePage::GetValue(uint32_t slot, uint32_t column_idx, const Schema &schema,
+                                 const ToastStore *toast_store) const -> Value {
+  const auto &column = schema.GetColumn(column_idx);
+  const char *data_ptr;
+  char encoded[sizeof(int64_t) + sizeof(uint32_t)];
+  if (slot >= num_encoded_) {
+    data_ptr = ColumnData(slot, column);
+  } else {
+    CopyColumn(slot, column_idx, column, encoded);
+    data_ptr = encoded;
+  }
+  if (column.IsInlined()) {
+    return Value::DeserializeFrom(data_ptr, column.GetType());
+  }
+  // The column holds the offset of the value in the tuple, which is past the fixed-size part of it.
+  uint32_t tuple_offset;
+  memcpy(&tuple_offset, data_ptr, sizeof(tuple_offset));
+  data_ptr = page_start_ + GetVarlenSlot(slot).offset_ + (tuple_offset - tuple_length_);
+  if (ToastStore::IsToasted(data_ptr)) {
+    BUSTUB_ENSURE(toast_store != nullptr, "out-of-line value outside of its table");
+    return toast_store->Fetch(data_ptr, column.GetType());
+  }
+  auto len = *reinterpret_cast<const uint32_t *>(data_ptr);
+  if (len == BUSTUB_VALUE_NULL) {
+    return {column.GetType(), nullptr, len, false};
+  }
+  return {column.GetType(), data_ptr + sizeof(uint32_t), len, false};
+}
+
+void ColumnarTablePage::UpdateTupleInPlaceUnsafe(const TupleMeta &meta, const Tuple &tuple, RID rid,
+                                                 const Schema &schema) {
+  auto tuple_id = rid.GetSlotNum();
+  if (tuple_id >= num_tuples_) {
+    throw bustub::Exception("Tuple ID out of range");
+  }
+  if (tuple_id < num_encoded_) {
+    throw bustub::Exception("Tuple is compressed");
+  }
+  const auto &varlen = VarlenSlots()[tuple_id - num_encoded_];
+  if (tuple_length_ + varlen.size_ != tuple.GetLength()) {
+    throw bustub::Exception("Tuple size mismatch");
+  }
+  UpdateTupleMeta(meta, rid);
+  for (const auto &column : schema.GetColumns()) {
+    memcpy(ColumnData(tuple_id, column), tuple.GetData() + column.GetOffset(), column.GetFixedLength());
+  }
+  memcpy(page_start_ + varlen.offset_, tuple.GetData() + tuple_length_, varlen.size_);
+}
+
+void ColumnarTablePage::Evaluate(const ScanPredicate &predicate, const Schema &schema,
+                                 std::vector<uint8_t> *keep) const {
+  keep->assign(num_tuples_, 1);
+  for (size_t term = 0; term < predicate.GetNumTerms(); term++) {
+    auto column_idx = predicate.GetTermColumn(term);
+    const auto &column = schema.GetColumn(column_idx);
+    auto pass = [&](int64_t value) { return predicate.Passes(term, value); };
+    if (num_encoded_ > 0) {
+      Encoded(2 + column_idx).Filter(pass, keep->data());
+    }
+    for (uint32_t slot = num_encoded_; slot < num_tuples_; slot++) {
+      (*keep)[slot] &= pass(LoadRaw(ColumnData(slot, column), column.GetFixedLength())) ? 1 : 0;
+    }
+  }
+}
+
+auto ColumnarTablePage::Freeze(const Schema &schema) -> bool {
+  if (num_tuples_ == 0) {
+    return false;
+  }
+  for (const auto &column : schema.GetColumns()) {
+    if (!IsEncodable(column)) {
+      return false;
+    }
+  }
+  std::vector<Tuple> tuples;
+  tuples.reserve(num_tuples_);
+  for (uint32_t slot = 0; slot < num_tuples_; slot++) {
+    tuples.push_back(GetTuple(RID(INVALID_PAGE_ID, slot), schema).second);
+  }
+
+  // Store each distinct variable-size part once, from the end of the page.
+  std::unordered_map<std::string, uint16_t> varlen_offsets;
+  std::vector<int64_t> offsets(num_tuples_);
+  std::vector<int64_t> sizes(num_tuples_);
+  std::vector<const Tuple *> varlen_data;
+  uint32_t varlen_begin = BUSTUB_PAGE_SIZE;
+  uint32_t varlen_total = 0;
+  for (uint32_t slot = 0; slot < num_tuples_; slot++) {
+    const auto &tuple = tuples[slot];
+    auto size = tuple.GetLength() - tuple_length_;
+    auto [it, inserted] =
+        varlen_offsets.emplace(std::string(tuple.GetData() + tuple_length_, size), varlen_begin - size);
+    if (inserted) {
+      varlen_begin -= size;
+      varlen_data.push_back(&tuple);
+    }
+    offsets[slot] = it->second;
+    sizes[slot] = size;
+    varlen_total += size;
+  }
+
+  // Encode the varlen slots and the minipages.
+  std::vector<std::vector<char>> encoded;
+  encoded.push_back(EncodedColumn::Encode(offsets, sizeof(uint32_t)));
+  encoded.push_back(EncodedColumn::Encode(sizes, sizeof(uint32_t)));
+  std::vector<int64_t> values(num_tuples_);
+  for (const auto &column : schema.GetColumns()) {
+    auto width = EncodedWidth(column);
+    for (uint32_t slot = 0; slot < num_tuples_; slot++) {
+      const char *data = tuples[slot].GetData() + column.GetOffset();
+      // Only the offset of a VARCHAR value is encoded, the rest of its bytes must be zero.
+      if (std::any_of(data + width, data + column.GetFixedLength(), [](char c) { return c != 0; })) {
+        return false;
+      }
+      values[slot] = LoadRaw(data, width);
+    }
+    encoded.push_back(EncodedColumn::Encode(values, width));
+  }
+  uint32_t encoded_size = encoded.size() * sizeof(uint16_t);
+  for (const auto &column : encoded) {
+    encoded_size += column.size();
+  }
+
+  // Size the tail for tuples like the ones in the page.
+  uint32_t num_encoded = num_tuples_;
+  uint32_t used = COLUMNAR_TABLE_PAGE_HEADER_SIZE + num_encoded * TUPLE_META_SIZE + encoded_size +
+                  (BUSTUB_PAGE_SIZE - varlen_begin);
+  if (used >= BUSTUB_PAGE_SIZE) {
+    return false;
+  }
+  uint32_t tail_slot_size = TUPLE_META_SIZE + sizeof(VarlenSlot) + tuple_length_ + varlen_total / num_encoded;
+  auto tail_capacity = std::min<uint32_t>((BUSTUB_PAGE_SIZE - used) / tail_slot_size, UINT16_MAX - num_encoded);
+  if (tail_capacity == 0) {
+    return false;
+  }
+
+  // Lay the page out again in a copy, see the page layout.
+  std::vector<char> copy(BUSTUB_PAGE_SIZE, 0);
+  auto page = reinterpret_cast<ColumnarTablePage *>(copy.data());
+  page->next_page_id_ = next_page_id_;
+  page->num_tuples_ = num_tuples_;
+  page->num_deleted_tuples_ = num_deleted_tuples_;
+  page->capacity_ = num_encoded + tail_capacity;
+  page->tuple_length_ = tuple_length_;
+  page->varlen_begin_ = varlen_begin;
+  page->num_encoded_ = num_encoded;
+  memcpy(page->Metas(), Metas(), num_encoded * TUPLE_META_SIZE);
+  char *directory = reinterpret_cast<char *>(page->VarlenSlots() + page->TailCapacity());
+  char *next = directory + encoded.size() * sizeof(uint16_t);
+  for (size_t k = 0; k < encoded.size(); k++) {
+    auto offset = static_cast<uint16_t>(next - copy.data());
+    memcpy(directory + k * sizeof(uint16_t), &offset, sizeof(offset));
+    memcpy(next, encoded[k].data(), encoded[k].size());
+    next += encoded[k].size();
+  }
+  page->tail_begin_ = next - copy.data();
+  for (const auto *tuple : varlen_data) {
+    auto size = tuple->GetLength() - tuple_length_;
+    auto offset = varlen_offsets[std::string(tuple->GetData() + tuple_length_, size)];
+    memcpy(copy.data() + offset, tuple->GetData() + tuple_length_, size);
+  }
+  BUSTUB_ASSERT(page->GetFreeVarlenSpace() <= BUSTUB_PAGE_SIZE, "frozen page overflows");
+  memcpy(page_start_, copy.data(), BUSTUB_PAGE_SIZE);
+  return true;
+}
+
+}  // namespace bustub
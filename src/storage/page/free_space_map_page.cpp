@@ -0,0 +1,76 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// free_space_map_page.cpp
+//
+// Identification: src/storage/page/free_space_map_page.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/page/free_space_map_page.h"
+
+#include <algorithm>
+
+#include "common/exception.h"
+
+namespace bustub {
+
+void FreeSpaceMapPage::Init() {
+  next_page_id_ = INVALID_PAGE_ID;
+  num_entries_ = 0;
+}
+
+auto FreeSpaceMapPage::PageIdAt(uint32_t index) const -> page_id_t {
+  if (index >= num_entries_) {
+    throw bustub::Exception("FSM entry out of range");
+  }
+  return page_ids_[index];
+}
+
+auto FreeSpaceMapPage::CategoryAt(uint32_t index) const -> uint8_t {
+  if (index >= num_entries_) {
+    throw bustub::Exception("FSM entry out of range");
+  }
+  return Categories()[index];
+}
+
+auto FreeSpaceMapPage::AddEntry(page_id_t page_id, uint8_t category) -> std::optional<uint32_t> {
+  if (IsFull()) {
+    return std::nullopt;
+  }
+  auto index = num_entries_;
+  page_ids_[index] = page_id;
+  Categories()[index] = category;
+  num_entries_++;
+  return index;
+}
+
+void FreeSpaceMapPage::SetCategory(uint32_t index, uint8_t category) {
+  if (index >= num_entries_) {
+    throw bustub::Exception("FSM entry out of range");
+  }
+  Categories()[index] = category;
+}
+
+auto FreeSpaceMapPage::FindEntry(uint8_t min_category, uint32_t begin, uint32_t end) const
+    -> std::optional<uint32_t> {
+  end = std::min(end, num_entries_);
+  const auto *categories = Categories();
+  for (uint32_t i = begin; i < end; i++) {
+    if (categories[i] >= min_category) {
+      return i;
+    }
+  }
+  return std::nullopt;
+}
+
+auto FreeSpaceMapPage::CategoryOf(uint32_t free_bytes) -> uint8_t {
+  return static_cast<uint8_t>(std::min<uint32_t>(free_bytes / FSM_CATEGORY_BYTES, UINT8_MAX));
+}
+
+auto FreeSpaceMapPage::MinCategoryFor(uint32_t bytes) -> uint8_t {
+  return static_cast<uint8_t>(std::min<uint32_t>((bytes + FSM_CATEGORY_BYTES - 1) / FSM_CATEGORY_BYTES, UINT8_MAX));
+}
+
+}  // namespace bustub
@@ -14,6 +14,7 @@
 
 #include <cassert>
 #include <cstring>
+#include <functional>
 #include <optional>
 #include <tuple>
 #include "common/config.h"
@@ -28,6 +29,21 @@ void TablePage::Init() {
   num_deleted_tuples_ = 0;
 }
 
+auto TablePage::GetFreeSpaceRemaining() const -> uint32_t {
+  size_t slot_end_offset;
+  if (num_tuples_ > 0) {
+    auto &[offset, size, meta] = tuple_info_[num_tuples_ - 1];
+    slot_end_offset = offset;
+  } else {
+    slot_end_offset = BUSTUB_PAGE_SIZE;
+  }
+  auto offset_size = TABLE_PAGE_HEADER_SIZE + TUPLE_INFO_SIZE * (num_tuples_ + 1);
+  if (slot_end_offset < offset_size) {
+    return 0;
+  }
+  return slot_end_offset - offset_size;
+}
+
 auto TablePage::GetNextTupleOffset(const TupleMeta &meta, const Tuple &tuple) const -> std::optional<uint16_t> {
   size_t slot_end_offset;
   if (num_tuples_ > 0) {
@@ -36,12 +52,12 @@ auto TablePage::GetNextTupleOffset(const TupleMeta &meta, const Tuple &tuple) co
   } else {
     slot_end_offset = BUSTUB_PAGE_SIZE;
   }
-  auto tuple_offset = slot_end_offset - tuple.GetLength();
   auto offset_size = TABLE_PAGE_HEADER_SIZE + TUPLE_INFO_SIZE * (num_tuples_ + 1);
-  if (tuple_offset < offset_size) {
+  // Compare before subtracting, as the offset would wrap around for a tuple larger than what is left of the page.
+  if (slot_end_offset < offset_size + tuple.GetLength()) {
     return std::nullopt;
   }
-  return tuple_offset;
+  return slot_end_offset - tuple.GetLength();
 }
 
 auto TablePage::InsertTuple(const TupleMeta &meta, const Tuple &tuple) -> std::optional<uint16_t> {
@@ -81,6 +97,15 @@ auto TablePage::GetTuple(const RID &rid) const -> std::pair<TupleMeta, Tuple> {
   return std::make_pair(meta, std::move(tuple));
 }
 
+auto TablePage::GetTupleView(const RID &rid) const -> std::pair<TupleMeta, TupleView> {
+  auto tuple_id = rid.GetSlotNum();
+  if (tuple_id >= num_tuples_) {
+    throw bustub::Exception("Tuple ID out of range");
+  }
+  auto &[offset, size, meta] = tuple_info_[tuple_id];
+  return std::make_pair(meta, TupleView{page_start_ + offset, size, rid});
+}
+
 auto TablePage::GetTupleMeta(const RID &rid) const -> TupleMeta {
   auto tuple_id = rid.GetSlotNum();
   if (tuple_id >= num_tuples_) {
@@ -106,4 +131,42 @@ void TablePage::UpdateTupleInPlaceUnsafe(const TupleMeta &meta, const Tuple &tup
   memcpy(page_start_ + offset, tuple.data_.data(), tuple.GetLength());
 }
 
+auto TablePage::Vacuum(page_id_t page_id, const std::function<bool(const TupleMeta &)> &can_reclaim,
+                       const std::function<void(const Tuple &)> &on_reclaim) -> uint32_t {
+  uint32_t reclaimed = 0;
+  for (uint16_t tuple_id = 0; tuple_id < num_tuples_; tuple_id++) {
+    auto &[offset, size, meta] = tuple_info_[tuple_id];
+    if (meta.is_deleted_ && size > 0 && can_reclaim(meta)) {
+      if (on_reclaim) {
+        on_reclaim(GetTuple(RID(page_id, tuple_id)).second);
+      }
+      size = 0;
+      reclaimed++;
+    }
+  }
+
+  // A reclaimed slot at the end of the page can go away entirely, as nobody can refer to it anymore.
+  while (num_tuples_ > 0) {
+    auto &[offset, size, meta] = tuple_info_[num_tuples_ - 1];
+    if (!meta.is_deleted_ || size > 0 || !can_reclaim(meta)) {
+      break;
+    }
+    num_tuples_--;
+    num_deleted_tuples_--;
+  }
+
+  // Tuples are stored at decreasing offsets in slot order. Packing them in the same order only moves data towards the
+  // end of the page, so a tuple never overwrites one that has not been moved yet.
+  size_t free_offset = BUSTUB_PAGE_SIZE;
+  for (uint16_t tuple_id = 0; tuple_id < num_tuples_; tuple_id++) {
+    auto &[offset, size, meta] = tuple_info_[tuple_id];
+    free_offset -= size;
+    if (offset != free_offset) {
+      memmove(page_start_ + free_offset, page_start_ + offset, size);
+      offset = free_offset;
+    }
+  }
+  return reclaimed;
+}
+
 }  // namespace bustub
@@ -0,0 +1,32 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// column_chunk.cpp
+//
+// Identification: src/storage/table/column_chunk.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/table/column_chunk.h"
+
+#include <utility>
+#include <vector>
+
+namespace bustub {
+
+ColumnChunk::ColumnChunk(const ColumnarTablePage &page, page_id_t page_id, std::vector<uint16_t> slots,
+                         const Schema *schema, const ToastStore *toast_store)
+    : data_(reinterpret_cast<const char *>(&page), reinterpret_cast<const char *>(&page) + BUSTUB_PAGE_SIZE),
+      page_id_(page_id),
+      slots_(std::move(slots)),
+      schema_(schema),
+      toast_store_(toast_store) {}
+
+auto ColumnChunk::GetTuple(uint32_t i) const -> Tuple {
+  auto tuple = GetPage()->GetTuple(GetRid(i), *schema_).second;
+  tuple.toast_store_ = toast_store_;
+  return tuple;
+}
+
+}  // namespace bustub
@@ -0,0 +1,250 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// column_encoding.cpp
+//
+// Identification: src/storage/table/column_encoding.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/table/column_encoding.h"
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+#include "common/macros.h"
+
+namespace bustub {
+
+namespace {
+
+/** @return the number of bits needed for values up to `max` */
+auto BitsFor(uint64_t max) -> uint32_t {
+  uint32_t bits = 0;
+  while (bits < 64 && (max >> bits) != 0) {
+    bits++;
+  }
+  return bits;
+}
+
+/** @return the number of bytes of `count` bit-packed values of `bits` bits, with the padding behind them */
+auto PackedSize(size_t count, uint32_t bits) -> size_t { return (count * bits + 7) / 8 + sizeof(uint64_t); }
+
+template <typename T>
+void Append(std::vector<char> *out, T value) {
+  auto offset = out->size();
+  out->resize(offset + sizeof(T));
+  std::memcpy(out->data() + offset, &value, sizeof(T));
+}
+
+/** Append the values bit-packed, with `bits` bits each. */
+void AppendPacked(std::vector<char> *out, const std::vector<uint64_t> &values, uint32_t bits) {
+  auto offset = out->size();
+  out->resize(offset + PackedSize(values.size(), bits), 0);
+  char *packed = out->data() + offset;
+  for (size_t i = 0; i < values.size(); i++) {
+    uint64_t bit = i * bits;
+    uint64_t word;
+    std::memcpy(&word, packed + bit / 8, sizeof(word));
+    word |= values[i] << (bit % 8);
+    std::memcpy(packed + bit / 8, &word, sizeof(word));
+  }
+}
+
+}  // namespace
+
+auto EncodedColumn::Encode(const std::vector<int64_t> &values, uint32_t width) -> std::vector<char> {
+  BUSTUB_ASSERT(values.size() <= UINT16_MAX, "too many values");
+  BUSTUB_ASSERT(width == 1 || width == 2 || width == 4 || width == 8, "unsupported width");
+
+  // Measure the column.
+  std::vector<int64_t> entries(values);
+  std::sort(entries.begin(), entries.end());
+  entries.erase(std::unique(entries.begin(), entries.end()), entries.end());
+  size_t num_runs = 0;
+  for (size_t i = 0; i < values.size(); i++) {
+    num_runs += i == 0 || values[i] != values[i - 1] ? 1 : 0;
+  }
+  uint32_t range_bits = 64;
+  if (!entries.empty()) {
+    range_bits = BitsFor(static_cast<uint64_t>(entries.back()) - static_cast<uint64_t>(entries.front()));
+  }
+  uint32_t code_bits = entries.empty() ? 0 : BitsFor(entries.size() - 1);
+
+  // Pick the smallest encoding.
+  auto encoding = ColumnEncoding::PLAIN;
+  size_t size = values.size() * width;
+  auto consider = [&](ColumnEncoding candidate, size_t candidate_size) {
+    if (candidate_size < size) {
+      encoding = candidate;
+      size = candidate_size;
+    }
+  };
+  consider(ColumnEncoding::RUN_LENGTH, sizeof(uint32_t) + num_runs * (sizeof(int64_t) + sizeof(uint16_t)));
+  if (code_bits <= MAX_PACKED_BITS) {
+    consider(ColumnEncoding::DICTIONARY, sizeof(uint32_t) + entries.size() * sizeof(int64_t) +
+                                             PackedSize(values.size(), code_bits));
+  }
+  if (range_bits <= MAX_PACKED_BITS) {
+    consider(ColumnEncoding::FRAME_OF_REFERENCE, sizeof(int64_t) + PackedSize(values.size(), range_bits));
+  }
+
+  std::vector<char> out;
+  out.reserve(HEADER_SIZE + size);
+  auto bits = encoding == ColumnEncoding::DICTIONARY ? code_bits
+                                                     : encoding == ColumnEncoding::FRAME_OF_REFERENCE ? range_bits : 0;
+  Append<uint8_t>(&out, static_cast<uint8_t>(encoding));
+  Append<uint8_t>(&out, width);
+  Append<uint8_t>(&out, bits);
+  Append<uint8_t>(&out, 0);
+  Append<uint32_t>(&out, values.size());
+  switch (encoding) {
+    case ColumnEncoding::PLAIN:
+      for (auto value : values) {
+        // Little-endian, so the low bytes of the value come first.
+        auto offset = out.size();
+        out.resize(offset + width);
+        std::memcpy(out.data() + offset, &value, width);
+      }
+      break;
+    case ColumnEncoding::RUN_LENGTH: {
+      Append<uint32_t>(&out, num_runs);
+      std::vector<uint16_t> ends;
+      for (size_t i = 0; i < values.size(); i++) {
+        if (i == 0 || values[i] != values[i - 1]) {
+          Append<int64_t>(&out, values[i]);
+          if (i > 0) {
+            ends.push_back(i);
+          }
+        }
+      }
+      ends.push_back(values.size());
+      for (auto end : ends) {
+        Append<uint16_t>(&out, end);
+      }
+      break;
+    }
+    case ColumnEncoding::DICTIONARY: {
+      Append<uint32_t>(&out, entries.size());
+      for (auto entry : entries) {
+        Append<int64_t>(&out, entry);
+      }
+      std::vector<uint64_t> codes(values.size());
+      for (size_t i = 0; i < values.size(); i++) {
+        codes[i] = std::lower_bound(entries.begin(), entries.end(), values[i]) - entries.begin();
+      }
+      AppendPacked(&out, codes, code_bits);
+      break;
+    }
+    case ColumnEncoding::FRAME_OF_REFERENCE: {
+      auto base = entries.front();
+      Append<int64_t>(&out, base);
+      std::vector<uint64_t> deltas(values.size());
+      for (size_t i = 0; i < values.size(); i++) {
+        deltas[i] = static_cast<uint64_t>(values[i]) - static_cast<uint64_t>(base);
+      }
+      AppendPacked(&out, deltas, range_bits);
+      break;
+    }
+  }
+  return out;
+}
+
+EncodedColumn::EncodedColumn(const char *data)
+    : encoding_(static_cast<ColumnEncoding>(Load<uint8_t>(data))),
+      width_(Load<uint8_t>(data + 1)),
+      bits_(Load<uint8_t>(data + 2)),
+      count_(Load<uint32_t>(data + 4)),
+      mask_(bits_ == 0 ? 0 : (~uint64_t{0} >> (64 - bits_))) {
+  const char *payload = data + HEADER_SIZE;
+  switch (encoding_) {
+    case ColumnEncoding::PLAIN:
+      packed_ = payload;
+      break;
+    case ColumnEncoding::RUN_LENGTH:
+      num_entries_ = Load<uint32_t>(payload);
+      entries_ = payload + sizeof(uint32_t);
+      run_ends_ = entries_ + num_entries_ * sizeof(int64_t);
+      break;
+    case ColumnEncoding::DICTIONARY:
+      num_entries_ = Load<uint32_t>(payload);
+      entries_ = payload + sizeof(uint32_t);
+      packed_ = entries_ + num_entries_ * sizeof(int64_t);
+      break;
+    case ColumnEncoding::FRAME_OF_REFERENCE:
+      base_ = Load<int64_t>(payload);
+      packed_ = payload + sizeof(int64_t);
+      break;
+  }
+}
+
+auto EncodedColumn::ByteSize(const char *data) -> uint32_t {
+  EncodedColumn column(data);
+  switch (column.encoding_) {
+    case ColumnEncoding::PLAIN:
+      return HEADER_SIZE + column.count_ * column.width_;
+    case ColumnEncoding::RUN_LENGTH:
+      return HEADER_SIZE + sizeof(uint32_t) + column.num_entries_ * (sizeof(int64_t) + sizeof(uint16_t));
+    case ColumnEncoding::DICTIONARY:
+      return HEADER_SIZE + sizeof(uint32_t) + column.num_entries_ * sizeof(int64_t) +
+             PackedSize(column.count_, column.bits_);
+    case ColumnEncoding::FRAME_OF_REFERENCE:
+      return HEADER_SIZE + sizeof(int64_t) + PackedSize(column.count_, column.bits_);
+  }
+  UNREACHABLE("unknown encoding");
+}
+
+auto EncodedColumn::Get(uint32_t i) const -> int64_t {
+  switch (encoding_) {
+    case ColumnEncoding::PLAIN:
+      switch (width_) {
+        case 1:
+          return Load<int8_t>(packed_ + i);
+        case 2:
+          return Load<int16_t>(packed_ + i * 2);
+        case 4:
+          return Load<int32_t>(packed_ + i * 4);
+        default:
+          return Load<int64_t>(packed_ + i * 8);
+      }
+    case ColumnEncoding::RUN_LENGTH: {
+      // The first run that ends after i.
+      uint32_t low = 0;
+      uint32_t high = num_entries_ - 1;
+      while (low < high) {
+        auto mid = (low + high) / 2;
+        if (Load<uint16_t>(run_ends_ + mid * sizeof(uint16_t)) > i) {
+          high = mid;
+        } else {
+          low = mid + 1;
+        }
+      }
+      return Load<int64_t>(entries_ + low * sizeof(int64_t));
+    }
+    case ColumnEncoding::DICTIONARY:
+      return Load<int64_t>(entries_ + Unpack(i) * sizeof(int64_t));
+    case ColumnEncoding::FRAME_OF_REFERENCE:
+      return static_cast<int64_t>(static_cast<uint64_t>(base_) + Unpack(i));
+  }
+  UNREACHABLE("unknown encoding");
+}
+
+void EncodedColumn::Decode(std::vector<int64_t> *out) const {
+  out->resize(count_);
+  if (encoding_ == ColumnEncoding::RUN_LENGTH) {
+    uint32_t begin = 0;
+    for (uint32_t r = 0; r < num_entries_; r++) {
+      auto end = Load<uint16_t>(run_ends_ + r * sizeof(uint16_t));
+      std::fill(out->begin() + begin, out->begin() + end, Load<int64_t>(entries_ + r * sizeof(int64_t)));
+      begin = end;
+    }
+    return;
+  }
+  for (uint32_t i = 0; i < count_; i++) {
+    (*out)[i] = Get(i);
+  }
+}
+
+}  // namespace bustub
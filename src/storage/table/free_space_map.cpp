@@ -0,0 +1,162 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// free_space_map.cpp
+//
+// Identification: src/storage/table/free_space_map.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/table/free_space_map.h"
+
+#include <algorithm>
+
+#include "common/exception.h"
+#include "common/macros.h"
+#include "storage/page/page_guard.h"
+
+namespace bustub {
+
+FreeSpaceMap::FreeSpaceMap(BufferPoolManager *bpm) : bpm_(bpm), shard_entries_(NUM_SHARDS) {
+  auto guard = bpm_->NewPageGuarded(&first_page_id_);
+  auto page = guard.AsMut<FreeSpaceMapPage>();
+  BUSTUB_ASSERT(page != nullptr, "Couldn't create a page for the free space map.");
+  page->Init();
+  fsm_page_ids_.push_back(first_page_id_);
+  max_category_.push_back(0);
+}
+
+void FreeSpaceMap::AddPage(page_id_t page_id, uint32_t free_bytes, std::optional<size_t> shard) {
+  auto category = FreeSpaceMapPage::CategoryOf(free_bytes);
+  std::scoped_lock append_guard(append_latch_);
+
+  std::unique_lock<std::mutex> guard(latch_);
+  auto entry = num_entries_;
+  auto [fsm_page_idx, index] = Locate(entry);
+  auto last_fsm_page_id = fsm_page_ids_.back();
+  guard.unlock();
+
+  if (fsm_page_idx == fsm_page_ids_.size()) {
+    // The last map page is full, link a new one.
+    page_id_t new_page_id;
+    auto new_guard = bpm_->NewPageGuarded(&new_page_id);
+    BUSTUB_ENSURE(new_page_id != INVALID_PAGE_ID, "cannot allocate page");
+    new_guard.AsMut<FreeSpaceMapPage>()->Init();
+    new_guard.Drop();
+    auto last_guard = bpm_->FetchPageWrite(last_fsm_page_id);
+    last_guard.AsMut<FreeSpaceMapPage>()->SetNextPageId(new_page_id);
+    last_guard.Drop();
+
+    guard.lock();
+    fsm_page_ids_.push_back(new_page_id);
+    max_category_.push_back(0);
+    guard.unlock();
+  }
+
+  auto page_guard = bpm_->FetchPageWrite(fsm_page_ids_[fsm_page_idx]);
+  auto added = page_guard.AsMut<FreeSpaceMapPage>()->AddEntry(page_id, category);
+  BUSTUB_ENSURE(added == index, "free space map entries out of order");
+
+  guard.lock();
+  num_entries_++;
+  entries_[page_id] = entry;
+  max_category_[fsm_page_idx] = std::max(max_category_[fsm_page_idx], category);
+  if (shard.has_value()) {
+    shard_entries_[*shard % NUM_SHARDS] = entry;
+  }
+}
+
+void FreeSpaceMap::UpdatePage(page_id_t page_id, uint32_t free_bytes) {
+  auto category = FreeSpaceMapPage::CategoryOf(free_bytes);
+  std::unique_lock<std::mutex> guard(latch_);
+  auto it = entries_.find(page_id);
+  if (it == entries_.end()) {
+    return;
+  }
+  auto [fsm_page_idx, index] = Locate(it->second);
+  auto fsm_page_id = fsm_page_ids_[fsm_page_idx];
+  guard.unlock();
+
+  // The bound is raised while the map page is still latched, so that a concurrent search cannot lower it based on
+  // the old category.
+  auto page_guard = bpm_->FetchPageWrite(fsm_page_id);
+  page_guard.AsMut<FreeSpaceMapPage>()->SetCategory(index, category);
+  guard.lock();
+  max_category_[fsm_page_idx] = std::max(max_category_[fsm_page_idx], category);
+}
+
+auto FreeSpaceMap::ClaimedByOtherShard(size_t entry, size_t shard) const -> bool {
+  for (size_t i = 0; i < NUM_SHARDS; i++) {
+    if (i != shard && shard_entries_[i] == entry) {
+      return true;
+    }
+  }
+  return false;
+}
+
+auto FreeSpaceMap::FindPage(uint32_t bytes, size_t shard) -> page_id_t {
+  shard %= NUM_SHARDS;
+  auto min_category = FreeSpaceMapPage::MinCategoryFor(bytes);
+
+  std::unique_lock<std::mutex> guard(latch_);
+  auto num_fsm_pages = fsm_page_ids_.size();
+  auto start = shard_entries_[shard].value_or(0);
+  guard.unlock();
+
+  // Visit the map pages starting from the one holding the shard's current page, wrapping around once. Within the
+  // starting map page, entries before the current page are visited last.
+  auto [start_fsm_page_idx, start_index] = Locate(start);
+  for (size_t step = 0; step <= num_fsm_pages; step++) {
+    auto fsm_page_idx = (start_fsm_page_idx + step) % num_fsm_pages;
+    uint32_t begin = 0;
+    uint32_t end = FreeSpaceMapPage::FSM_PAGE_CAPACITY;
+    if (step == 0) {
+      begin = start_index;
+    } else if (step == num_fsm_pages) {
+      end = start_index;
+    }
+
+    guard.lock();
+    auto fsm_page_id = fsm_page_ids_[fsm_page_idx];
+    auto skip = max_category_[fsm_page_idx] < min_category;
+    guard.unlock();
+    if (skip || begin >= end) {
+      continue;
+    }
+
+    auto page_guard = bpm_->FetchPageRead(fsm_page_id);
+    auto page = page_guard.As<FreeSpaceMapPage>();
+    for (auto index = page->FindEntry(min_category, begin, end); index.has_value();
+         index = page->FindEntry(min_category, *index + 1, end)) {
+      auto entry = fsm_page_idx * FreeSpaceMapPage::FSM_PAGE_CAPACITY + *index;
+      guard.lock();
+      if (!ClaimedByOtherShard(entry, shard)) {
+        shard_entries_[shard] = entry;
+        guard.unlock();
+        return page->PageIdAt(*index);
+      }
+      guard.unlock();
+    }
+
+    if (begin == 0 && end == FreeSpaceMapPage::FSM_PAGE_CAPACITY) {
+      // The whole map page was searched: tighten its bound while the page is still latched, so that no update can
+      // slip in between.
+      uint8_t max_seen = 0;
+      for (uint32_t i = 0; i < page->GetNumEntries(); i++) {
+        max_seen = std::max(max_seen, page->CategoryAt(i));
+      }
+      guard.lock();
+      max_category_[fsm_page_idx] = max_seen;
+      guard.unlock();
+    }
+  }
+  return INVALID_PAGE_ID;
+}
+
+auto FreeSpaceMap::GetNumPages() -> size_t {
+  std::scoped_lock guard(latch_);
+  return num_entries_;
+}
+
+}  // namespace bustub
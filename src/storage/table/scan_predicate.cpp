@@ -0,0 +1,289 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// scan_predicate.cpp
+//
+// Identification: src/storage/table/scan_predicate.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/table/scan_predicate.h"
+
+#include <cstring>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "common/macros.h"
+#include "fmt/format.h"
+#include "type/limits.h"
+
+namespace bustub {
+
+namespace {
+
+/** @return the value of type T at `data`, which need not be aligned */
+template <typename T>
+auto Load(const char *data) -> T {
+  T value;
+  std::memcpy(&value, data, sizeof(T));
+  return value;
+}
+
+/** Gather the column at `offset` of every tuple into `out`, widened to U. */
+template <typename T, typename U>
+void Gather(const std::vector<const char *> &tuples, uint32_t offset, std::vector<U> *out) {
+  out->resize(tuples.size());
+  for (size_t i = 0; i < tuples.size(); i++) {
+    (*out)[i] = static_cast<U>(Load<T>(tuples[i] + offset));
+  }
+}
+
+/**
+ * keep[i] &= values[i] is not null and `values[i] cmp constant`, or values[i] is null and null_passes, over all
+ * values, without branches.
+ */
+template <typename U, typename Cmp>
+void Compare(const std::vector<U> &values, U constant, U null, uint8_t null_passes, Cmp cmp, uint8_t *keep) {
+  const size_t size = values.size();
+  const U *data = values.data();
+  for (size_t i = 0; i < size; i++) {
+    keep[i] &= (static_cast<uint8_t>(data[i] != null) & static_cast<uint8_t>(cmp(data[i], constant))) |
+               (static_cast<uint8_t>(data[i] == null) & null_passes);
+  }
+}
+
+template <typename U>
+void CompareOp(ScanPredicate::Op op, const std::vector<U> &values, U constant, U null, uint8_t null_passes,
+               uint8_t *keep) {
+  // The comparison is dispatched once per page, so that each loop is specialized for it.
+  switch (op) {
+    case ScanPredicate::Op::Equal:
+      Compare(values, constant, null, null_passes, [](U a, U b) { return a == b; }, keep);
+      break;
+    case ScanPredicate::Op::NotEqual:
+      Compare(values, constant, null, null_passes, [](U a, U b) { return a != b; }, keep);
+      break;
+    case ScanPredicate::Op::LessThan:
+      Compare(values, constant, null, null_passes, [](U a, U b) { return a < b; }, keep);
+      break;
+    case ScanPredicate::Op::LessThanOrEqual:
+      Compare(values, constant, null, null_passes, [](U a, U b) { return a <= b; }, keep);
+      break;
+    case ScanPredicate::Op::GreaterThan:
+      Compare(values, constant, null, null_passes, [](U a, U b) { return a > b; }, keep);
+      break;
+    case ScanPredicate::Op::GreaterThanOrEqual:
+      Compare(values, constant, null, null_passes, [](U a, U b) { return a >= b; }, keep);
+      break;
+  }
+}
+
+/** Gather a column of a supported type into `out`, widened to U. @return the null value of the type, widened to U */
+template <typename U>
+auto GatherColumn(TypeId type, const std::vector<const char *> &tuples, uint32_t offset, std::vector<U> *out) -> U {
+  switch (type) {
+    case TypeId::TINYINT:
+      Gather<int8_t>(tuples, offset, out);
+      return static_cast<U>(BUSTUB_INT8_NULL);
+    case TypeId::SMALLINT:
+      Gather<int16_t>(tuples, offset, out);
+      return static_cast<U>(BUSTUB_INT16_NULL);
+    case TypeId::INTEGER:
+      Gather<int32_t>(tuples, offset, out);
+      return static_cast<U>(BUSTUB_INT32_NULL);
+    case TypeId::BIGINT:
+      Gather<int64_t>(tuples, offset, out);
+      return static_cast<U>(BUSTUB_INT64_NULL);
+    case TypeId::DECIMAL:
+      Gather<double>(tuples, offset, out);
+      return static_cast<U>(BUSTUB_DECIMAL_NULL);
+    default:
+      UNREACHABLE("unsupported column type");
+  }
+}
+
+/** @return whether `v op constant` holds for some v in [min, max] */
+template <typename U>
+auto RangeMayMatch(ScanPredicate::Op op, U min, U max, U constant) -> bool {
+  switch (op) {
+    case ScanPredicate::Op::Equal:
+      return min <= constant && constant <= max;
+    case ScanPredicate::Op::NotEqual:
+      return min != constant || max != constant;
+    case ScanPredicate::Op::LessThan:
+      return min < constant;
+    case ScanPredicate::Op::LessThanOrEqual:
+      return min <= constant;
+    case ScanPredicate::Op::GreaterThan:
+      return max > constant;
+    case ScanPredicate::Op::GreaterThanOrEqual:
+      return max >= constant;
+  }
+  return true;
+}
+
+template <typename U>
+auto CompareValue(ScanPredicate::Op op, U value, U constant) -> bool {
+  switch (op) {
+    case ScanPredicate::Op::Equal:
+      return value == constant;
+    case ScanPredicate::Op::NotEqual:
+      return value != constant;
+    case ScanPredicate::Op::LessThan:
+      return value < constant;
+    case ScanPredicate::Op::LessThanOrEqual:
+      return value <= constant;
+    case ScanPredicate::Op::GreaterThan:
+      return value > constant;
+    case ScanPredicate::Op::GreaterThanOrEqual:
+      return value >= constant;
+  }
+  return false;
+}
+
+auto OpToString(ScanPredicate::Op op) -> const char * {
+  switch (op) {
+    case ScanPredicate::Op::Equal:
+      return "=";
+    case ScanPredicate::Op::NotEqual:
+      return "!=";
+    case ScanPredicate::Op::LessThan:
+      return "<";
+    case ScanPredicate::Op::LessThanOrEqual:
+      return "<=";
+    case ScanPredicate::Op::GreaterThan:
+      return ">";
+    case ScanPredicate::Op::GreaterThanOrEqual:
+      return ">=";
+  }
+  return "?";
+}
+
+}  // namespace
+
+auto ScanPredicate::IsSupported(TypeId type) -> bool {
+  return type == TypeId::TINYINT || type == TypeId::SMALLINT || type == TypeId::INTEGER || type == TypeId::BIGINT ||
+         type == TypeId::DECIMAL;
+}
+
+void ScanPredicate::AddTerm(const Schema &schema, uint32_t column_idx, Op op, const Value &constant,
+                            bool null_passes) {
+  const auto &column = schema.GetColumn(column_idx);
+  BUSTUB_ASSERT(IsSupported(column.GetType()) && IsSupported(constant.GetTypeId()) && !constant.IsNull(),
+                "term cannot be evaluated in place");
+  Term term{column_idx, column.GetOffset(), column.GetType(), op, null_passes, false, 0, 0};
+  switch (constant.GetTypeId()) {
+    case TypeId::TINYINT:
+      term.integer_ = constant.GetAs<int8_t>();
+      break;
+    case TypeId::SMALLINT:
+      term.integer_ = constant.GetAs<int16_t>();
+      break;
+    case TypeId::INTEGER:
+      term.integer_ = constant.GetAs<int32_t>();
+      break;
+    case TypeId::BIGINT:
+      term.integer_ = constant.GetAs<int64_t>();
+      break;
+    default:
+      term.decimal_ = constant.GetAs<double>();
+      term.is_decimal_ = true;
+      break;
+  }
+  if (column.GetType() == TypeId::DECIMAL && !term.is_decimal_) {
+    term.decimal_ = static_cast<double>(term.integer_);
+    term.is_decimal_ = true;
+  }
+  terms_.push_back(term);
+}
+
+void ScanPredicate::Evaluate(const std::vector<const char *> &tuples, std::vector<uint8_t> *keep) {
+  keep->assign(tuples.size(), 1);
+  for (const auto &term : terms_) {
+    if (term.is_decimal_) {
+      auto null = GatherColumn(term.type_, tuples, term.offset_, &decimals_);
+      CompareOp(term.op_, decimals_, term.decimal_, null, term.null_passes_, keep->data());
+    } else {
+      auto null = GatherColumn(term.type_, tuples, term.offset_, &integers_);
+      CompareOp(term.op_, integers_, term.integer_, null, term.null_passes_, keep->data());
+    }
+  }
+}
+
+auto ScanPredicate::Passes(size_t term_idx, int64_t value) const -> bool {
+  const auto &term = terms_[term_idx];
+  switch (term.type_) {
+    case TypeId::TINYINT:
+      if (value == BUSTUB_INT8_NULL) {
+        return term.null_passes_ != 0;
+      }
+      break;
+    case TypeId::SMALLINT:
+      if (value == BUSTUB_INT16_NULL) {
+        return term.null_passes_ != 0;
+      }
+      break;
+    case TypeId::INTEGER:
+      if (value == BUSTUB_INT32_NULL) {
+        return term.null_passes_ != 0;
+      }
+      break;
+    case TypeId::BIGINT:
+      if (value == BUSTUB_INT64_NULL) {
+        return term.null_passes_ != 0;
+      }
+      break;
+    case TypeId::DECIMAL: {
+      double decimal;
+      std::memcpy(&decimal, &value, sizeof(decimal));
+      return decimal == BUSTUB_DECIMAL_NULL ? term.null_passes_ != 0 : CompareValue(term.op_, decimal, term.decimal_);
+    }
+    default:
+      UNREACHABLE("unsupported column type");
+  }
+  return term.is_decimal_ ? CompareValue(term.op_, static_cast<double>(value), term.decimal_)
+                          : CompareValue(term.op_, value, term.integer_);
+}
+
+auto ScanPredicate::MayMatch(const std::vector<ColumnRange> &columns) const -> bool {
+  for (const auto &term : terms_) {
+    const auto &range = columns[term.column_idx_];
+    if (term.null_passes_ != 0 && range.num_nulls_ > 0) {
+      continue;
+    }
+    // Otherwise a null value never passes, so a column without values rules out every tuple.
+    if (range.num_values_ == 0) {
+      return false;
+    }
+    bool may_match;
+    if (term.type_ == TypeId::DECIMAL) {
+      may_match = RangeMayMatch(term.op_, range.min_decimal_, range.max_decimal_, term.decimal_);
+    } else if (term.is_decimal_) {
+      may_match = RangeMayMatch(term.op_, static_cast<double>(range.min_integer_),
+                                static_cast<double>(range.max_integer_), term.decimal_);
+    } else {
+      may_match = RangeMayMatch(term.op_, range.min_integer_, range.max_integer_, term.integer_);
+    }
+    if (!may_match) {
+      return false;
+    }
+  }
+  return true;
+}
+
+auto ScanPredicate::ToString() const -> std::string {
+  std::vector<std::string> terms;
+  terms.reserve(terms_.size());
+  for (const auto &term : terms_) {
+    auto comparison = term.is_decimal_
+                          ? fmt::format("#0.{}{}{}", term.column_idx_, OpToString(term.op_), term.decimal_)
+                          : fmt::format("#0.{}{}{}", term.column_idx_, OpToString(term.op_), term.integer_);
+    terms.push_back(term.null_passes_ != 0 ? fmt::format("({} OR #0.{} IS NULL)", comparison, term.column_idx_)
+                                      : std::move(comparison));
+  }
+  return fmt::format("{}", fmt::join(terms, " AND "));
+}
+
+}  // namespace bustub
@@ -11,7 +11,9 @@
 //===----------------------------------------------------------------------===//
 
 #include <cassert>
+#include <functional>
 #include <mutex>  // NOLINT
+#include <thread>  // NOLINT
 #include <utility>
 
 #include "common/config.h"
@@ -26,103 +28,253 @@
 
 namespace bustub {
 
-TableHeap::TableHeap(BufferPoolManager *bpm) : bpm_(bpm) {
+TableHeap::TableHeap(BufferPoolManager *bpm, const Schema *schema, TableStorage storage)
+    : bpm_(bpm), storage_(storage) {
+  BUSTUB_ASSERT(schema != nullptr || storage == TableStorage::ROW, "a columnar heap must know its schema");
+  if (schema != nullptr) {
+    schema_ = std::make_unique<Schema>(*schema);
+    if (!schema->GetUnlinedColumns().empty()) {
+      toast_ = std::make_unique<ToastStore>(bpm_);
+    }
+  }
+
   // Initialize the first table page.
   auto guard = bpm->NewPageGuarded(&first_page_id_);
   last_page_id_ = first_page_id_;
-  auto first_page = guard.AsMut<TablePage>();
+  auto first_page = guard.GetDataMut();
   BUSTUB_ASSERT(first_page != nullptr,
                 "Couldn't create a page for the table heap. Have you completed the buffer pool manager project?");
-  first_page->Init();
+  auto free_space = InitPage(first_page);
+
+  fsm_ = std::make_unique<FreeSpaceMap>(bpm_);
+  // The first page belongs to no shard yet, so that whichever thread inserts first finds it.
+  fsm_->AddPage(first_page_id_, free_space, std::nullopt);
+
+  if (schema != nullptr && ZoneMap::HasSynopses(*schema)) {
+    zones_ = std::make_unique<ZoneMap>(*schema);
+    zones_->AddPage(first_page_id_);
+  }
 }
 
 TableHeap::TableHeap(bool create_table_heap) : bpm_(nullptr) {}
 
-auto TableHeap::InsertTuple(const TupleMeta &meta, const Tuple &tuple, LockManager *lock_mgr, Transaction *txn,
-                            table_oid_t oid) -> std::optional<RID> {
+auto TableHeap::InitPage(char *data) -> uint32_t {
+  if (IsColumnar()) {
+    auto page = reinterpret_cast<ColumnarTablePage *>(data);
+    page->Init(*schema_);
+    return page->GetFreeSpaceRemaining();
+  }
+  auto page = reinterpret_cast<TablePage *>(data);
+  page->Init();
+  return page->GetFreeSpaceRemaining();
+}
+
+auto TableHeap::AppendPage(size_t shard) -> WritePageGuard {
   std::unique_lock<std::mutex> guard(latch_);
-  auto page_guard = bpm_->FetchPageWrite(last_page_id_);
-  while (true) {
-    auto page = page_guard.AsMut<TablePage>();
-    if (page->GetNextTupleOffset(meta, tuple) != std::nullopt) {
-      break;
-    }
+  page_id_t next_page_id = INVALID_PAGE_ID;
+  auto npg = bpm_->NewPage(&next_page_id);
+  BUSTUB_ENSURE(next_page_id != INVALID_PAGE_ID, "cannot allocate page");
 
-    // if there's no tuple in the page, and we can't insert the tuple, then this tuple is too large.
-    BUSTUB_ENSURE(page->GetNumTuples() != 0, "tuple is too large, cannot insert");
+  // acquire latch here as TSAN complains. Nobody else knows about the page before it is linked.
+  npg->WLatch();
+  auto next_page_guard = WritePageGuard{bpm_, npg};
+  auto free_space = InitPage(next_page_guard.GetDataMut());
 
-    page_id_t next_page_id = INVALID_PAGE_ID;
-    auto npg = bpm_->NewPage(&next_page_id);
-    BUSTUB_ENSURE(next_page_id != INVALID_PAGE_ID, "cannot allocate page");
+  auto last_page_guard = bpm_->FetchPageWrite(last_page_id_);
+  if (IsColumnar()) {
+    last_page_guard.AsMut<ColumnarTablePage>()->SetNextPageId(next_page_id);
+  } else {
+    last_page_guard.AsMut<TablePage>()->SetNextPageId(next_page_id);
+  }
+  last_page_guard.Drop();
+  last_page_id_ = next_page_id;
+  if (zones_ != nullptr) {
+    // Under latch_, so that the zone map sees the pages in the order of the chain.
+    zones_->AddPage(next_page_id);
+  }
+  guard.unlock();
 
-    page->SetNextPageId(next_page_id);
+  fsm_->AddPage(next_page_id, free_space, shard);
+  return next_page_guard;
+}
 
-    auto next_page = reinterpret_cast<TablePage *>(npg->GetData());
-    next_page->Init();
+auto TableHeap::InsertTuple(const TupleMeta &meta, const Tuple &input_tuple, LockManager *lock_mgr, Transaction *txn,
+                            table_oid_t oid) -> std::optional<RID> {
+  std::optional<Tuple> toasted;
+  if (toast_ != nullptr && input_tuple.GetLength() > ToastStore::TOAST_TUPLE_THRESHOLD) {
+    toasted = toast_->Toast(input_tuple, *schema_);
+  }
+  const auto &tuple = toasted.has_value() ? *toasted : input_tuple;
+  auto shard = std::hash<std::thread::id>{}(std::this_thread::get_id()) % FreeSpaceMap::NUM_SHARDS;
 
+  WritePageGuard page_guard;
+  std::optional<uint16_t> slot_id;
+  while (!slot_id.has_value()) {
+    // Release a page that turned out to be too full first: AppendPage latches the last page, which may be this one,
+    // and no page may be latched while waiting for latch_.
     page_guard.Drop();
+    auto page_id = fsm_->FindPage(tuple.GetLength(), shard);
+    if (page_id == INVALID_PAGE_ID) {
+      page_guard = AppendPage(shard);
+    } else {
+      page_guard = bpm_->FetchPageWrite(page_id);
+    }
 
-    // acquire latch here as TSAN complains. Given we only have one insertion thread, this is fine.
-    npg->WLatch();
-    auto next_page_guard = WritePageGuard{bpm_, npg};
+    // The free space map is approximate, so the page may not have enough room after all.
+    uint32_t free_space;
+    uint32_t num_tuples;
+    if (IsColumnar()) {
+      auto page = page_guard.AsMut<ColumnarTablePage>();
+      slot_id = page->InsertTuple(meta, tuple, *schema_);
+      // Compress the page once it has no room for another tuple like this one.
+      if (slot_id.has_value() && page->GetFreeSpaceRemaining() < tuple.GetLength()) {
+        page->Freeze(*schema_);
+      }
+      free_space = page->GetFreeSpaceRemaining();
+      num_tuples = page->GetNumTuples();
+    } else {
+      auto page = page_guard.AsMut<TablePage>();
+      slot_id = page->InsertTuple(meta, tuple);
+      free_space = page->GetFreeSpaceRemaining();
+      num_tuples = page->GetNumTuples();
+    }
+    fsm_->UpdatePage(page_guard.PageId(), free_space);
+    if (slot_id.has_value() && zones_ != nullptr) {
+      zones_->Update(page_guard.PageId(), tuple.GetData());
+    }
 
-    last_page_id_ = next_page_id;
-    page_guard = std::move(next_page_guard);
+    // if there's no tuple in the page, and we can't insert the tuple, then this tuple is too large.
+    BUSTUB_ENSURE(slot_id.has_value() || num_tuples != 0, "tuple is too large, cannot insert");
   }
-  auto last_page_id = last_page_id_;
-
-  auto page = page_guard.AsMut<TablePage>();
-  auto slot_id = *page->InsertTuple(meta, tuple);
-
-  // only allow one insertion at a time, otherwise it will deadlock.
-  guard.unlock();
+  auto rid = RID(page_guard.PageId(), *slot_id);
 
+  // keep the page latched until the row is locked, so that nobody can see the tuple before that.
   if (lock_mgr != nullptr) {
-    BUSTUB_ENSURE(lock_mgr->LockRow(txn, LockManager::LockMode::EXCLUSIVE, oid, RID{last_page_id, slot_id}),
+    BUSTUB_ENSURE(lock_mgr->LockRow(txn, LockManager::LockMode::EXCLUSIVE, oid, rid),
                   "failed to lock when inserting new tuple");
   }
 
   page_guard.Drop();
 
-  return RID(last_page_id, slot_id);
+  return rid;
 }
 
 void TableHeap::UpdateTupleMeta(const TupleMeta &meta, RID rid) {
   auto page_guard = bpm_->FetchPageWrite(rid.GetPageId());
+  if (IsColumnar()) {
+    page_guard.AsMut<ColumnarTablePage>()->UpdateTupleMeta(meta, rid);
+    return;
+  }
   auto page = page_guard.AsMut<TablePage>();
   page->UpdateTupleMeta(meta, rid);
 }
 
 auto TableHeap::GetTuple(RID rid) -> std::pair<TupleMeta, Tuple> {
   auto page_guard = bpm_->FetchPageRead(rid.GetPageId());
-  auto page = page_guard.As<TablePage>();
-  auto [meta, tuple] = page->GetTuple(rid);
+  auto [meta, tuple] = IsColumnar() ? page_guard.As<ColumnarTablePage>()->GetTuple(rid, *schema_)
+                                    : page_guard.As<TablePage>()->GetTuple(rid);
   tuple.rid_ = rid;
+  tuple.toast_store_ = toast_.get();
   return std::make_pair(meta, std::move(tuple));
 }
 
 auto TableHeap::GetTupleMeta(RID rid) -> TupleMeta {
   auto page_guard = bpm_->FetchPageRead(rid.GetPageId());
+  if (IsColumnar()) {
+    return page_guard.As<ColumnarTablePage>()->GetTupleMeta(rid);
+  }
   auto page = page_guard.As<TablePage>();
   return page->GetTupleMeta(rid);
 }
 
-auto TableHeap::MakeIterator() -> TableIterator {
+auto TableHeap::GetStopRid() -> RID {
   std::unique_lock<std::mutex> guard(latch_);
   auto last_page_id = last_page_id_;
   guard.unlock();
 
+  // Both kinds of pages start with the same header, see ColumnarTablePage.
   auto page_guard = bpm_->FetchPageRead(last_page_id);
   auto page = page_guard.As<TablePage>();
-  return {this, {first_page_id_, 0}, {last_page_id, page->GetNumTuples()}};
+  return {last_page_id, page->GetNumTuples()};
 }
 
+auto TableHeap::MakeIterator() -> TableIterator { return {this, {first_page_id_, 0}, GetStopRid()}; }
+
 auto TableHeap::MakeEagerIterator() -> TableIterator { return {this, {first_page_id_, 0}, {INVALID_PAGE_ID, 0}}; }
 
+auto TableHeap::Vacuum(TransactionManager *txn_mgr, const Transaction *txn) -> VacuumStats {
+  if (IsColumnar()) {
+    return {};
+  }
+  auto can_reclaim = [txn_mgr, txn](const TupleMeta &meta) {
+    return txn_mgr == nullptr || txn_mgr->IsDeleteFinal(meta, txn);
+  };
+  std::function<void(const Tuple &)> on_reclaim = nullptr;
+  if (toast_ != nullptr) {
+    on_reclaim = [this](const Tuple &tuple) { toast_->Free(tuple, *schema_); };
+  }
+
+  VacuumStats stats;
+  auto page_id = first_page_id_;
+  while (page_id != INVALID_PAGE_ID) {
+    auto page_guard = bpm_->FetchPageWrite(page_id);
+    auto page = page_guard.AsMut<TablePage>();
+    if (page->GetNumDeletedTuples() > 0) {
+      auto had_tuples = page->GetNumTuples() > 0;
+      auto free_before = page->GetFreeSpaceRemaining();
+      stats.tuples_reclaimed_ += page->Vacuum(page_id, can_reclaim, on_reclaim);
+      auto free_after = page->GetFreeSpaceRemaining();
+      stats.pages_scanned_++;
+      stats.bytes_reclaimed_ += free_after - free_before;
+      if (had_tuples && page->GetNumTuples() == 0) {
+        stats.pages_emptied_++;
+      }
+      if (free_after != free_before) {
+        fsm_->UpdatePage(page_id, free_after);
+      }
+      if (zones_ != nullptr) {
+        // Tighten the synopsis to the tuples that are left, including deleted ones a transaction may still restore.
+        zones_->ResetPage(page_id);
+        for (uint32_t slot = 0; slot < page->GetNumTuples(); slot++) {
+          auto [meta, view] = page->GetTupleView(RID(page_id, slot));
+          if (view.GetLength() > 0) {
+            zones_->Update(page_id, view.GetData());
+          }
+        }
+      }
+    }
+    page_id = page->GetNextPageId();
+  }
+  return stats;
+}
+
 void TableHeap::UpdateTupleInPlaceUnsafe(const TupleMeta &meta, const Tuple &tuple, RID rid) {
   auto page_guard = bpm_->FetchPageWrite(rid.GetPageId());
+  if (zones_ != nullptr) {
+    zones_->Update(rid.GetPageId(), tuple.GetData());
+  }
+  if (IsColumnar()) {
+    auto page = page_guard.AsMut<ColumnarTablePage>();
+    if (toast_ == nullptr) {
+      page->UpdateTupleInPlaceUnsafe(meta, tuple, rid, *schema_);
+      return;
+    }
+    auto [old_meta, old_tuple] = page->GetTuple(rid, *schema_);
+    auto new_tuple = toast_->Toast(tuple, *schema_);
+    page->UpdateTupleInPlaceUnsafe(meta, new_tuple, rid, *schema_);
+    toast_->Free(old_tuple, *schema_, &new_tuple);
+    return;
+  }
   auto page = page_guard.AsMut<TablePage>();
-  page->UpdateTupleInPlaceUnsafe(meta, tuple, rid);
+  if (toast_ == nullptr) {
+    page->UpdateTupleInPlaceUnsafe(meta, tuple, rid);
+    return;
+  }
+  auto [old_meta, old_tuple] = page->GetTuple(rid);
+  auto new_tuple = toast_->Toast(tuple, *schema_);
+  page->UpdateTupleInPlaceUnsafe(meta, new_tuple, rid);
+  // The new tuple may still point to values of the old one, e.g. if it was built from the stored bytes.
+  toast_->Free(old_tuple, *schema_, &new_tuple);
 }
 
 }  // namespace bustub
@@ -10,8 +10,12 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
 #include <cassert>
+#include <memory>
 #include <optional>
+#include <utility>
+#include <vector>
 
 #include "common/config.h"
 #include "common/exception.h"
@@ -24,22 +28,125 @@ TableIterator::TableIterator(TableHeap *table_heap, RID rid, RID stop_at_rid)
     : table_heap_(table_heap), rid_(rid), stop_at_rid_(stop_at_rid) {
   // If the rid doesn't correspond to a tuple (i.e., the table has just been initialized), then
   // we set rid_ to invalid.
+  SkipEmptyPages();
+}
+
+auto TableIterator::GetTuple() -> std::pair<TupleMeta, Tuple> {
   auto page_guard = table_heap_->bpm_->FetchPageRead(rid_.GetPageId());
   auto page = page_guard.As<TablePage>();
+  // Vacuum may have removed the slot since the iterator moved here. It only does so for deleted tuples.
   if (rid_.GetSlotNum() >= page->GetNumTuples()) {
-    rid_ = RID{INVALID_PAGE_ID, 0};
+    Tuple tuple;
+    tuple.rid_ = rid_;
+    return std::make_pair(TupleMeta{INVALID_TXN_ID, INVALID_TXN_ID, true}, std::move(tuple));
   }
+  auto [meta, tuple] = table_heap_->IsColumnar()
+                           ? page_guard.As<ColumnarTablePage>()->GetTuple(rid_, *table_heap_->schema_)
+                           : page->GetTuple(rid_);
+  tuple.rid_ = rid_;
+  tuple.toast_store_ = table_heap_->toast_.get();
+  return std::make_pair(meta, std::move(tuple));
 }
 
-auto TableIterator::GetTuple() -> std::pair<TupleMeta, Tuple> { return table_heap_->GetTuple(rid_); }
+void TableIterator::ReadPage(size_t max_tuples, const std::function<void(const TupleViews &)> &consume,
+                             ScanPredicate *predicate) {
+  BUSTUB_ASSERT(!table_heap_->IsColumnar(), "columnar tables are read with ReadColumns");
+  views_.clear();
+  if (predicate != nullptr) {
+    SkipPages(*predicate);
+    if (IsEnd()) {
+      consume(views_);
+      return;
+    }
+  }
+  auto slot = rid_.GetSlotNum();
+  {
+    auto page_guard = table_heap_->bpm_->FetchPageRead(rid_.GetPageId());
+    auto page = page_guard.As<TablePage>();
+    // Vacuum may have removed trailing slots since the iterator moved here, and the scan must not pass its stop RID.
+    uint32_t end = page->GetNumTuples();
+    if (rid_.GetPageId() == stop_at_rid_.GetPageId()) {
+      end = std::min(end, stop_at_rid_.GetSlotNum());
+    }
+    if (predicate == nullptr) {
+      for (; slot < end && views_.size() < max_tuples; slot++) {
+        auto [meta, view] = page->GetTupleView(RID{rid_.GetPageId(), slot});
+        views_.emplace_back(meta,
+                            TupleView{view.GetData(), view.GetLength(), view.GetRid(), table_heap_->toast_.get()});
+      }
+    } else {
+      candidates_.clear();
+      candidate_data_.clear();
+      for (uint32_t s = slot; s < end; s++) {
+        auto [meta, view] = page->GetTupleView(RID{rid_.GetPageId(), s});
+        if (!meta.is_deleted_) {
+          candidate_data_.push_back(view.GetData());
+          candidates_.emplace_back(
+              meta, TupleView{view.GetData(), view.GetLength(), view.GetRid(), table_heap_->toast_.get()});
+        }
+      }
+      predicate->Evaluate(candidate_data_, &keep_);
+      // Stop after the last tuple passed on if the batch is full, so that the next call resumes behind it.
+      slot = end;
+      for (size_t i = 0; i < candidates_.size(); i++) {
+        if (keep_[i] == 0) {
+          continue;
+        }
+        if (views_.size() == max_tuples) {
+          slot = candidates_[i].second.GetRid().GetSlotNum();
+          break;
+        }
+        views_.push_back(candidates_[i]);
+      }
+    }
+    consume(views_);
+  }
+  rid_ = RID{rid_.GetPageId(), slot};
+  SkipEmptyPages();
+}
+
+auto TableIterator::ReadColumns(size_t max_tuples, const ScanPredicate *predicate)
+    -> std::shared_ptr<const ColumnChunk> {
+  BUSTUB_ASSERT(table_heap_->IsColumnar(), "row-oriented tables are read with ReadPage");
+  if (predicate != nullptr) {
+    SkipPages(*predicate);
+    if (IsEnd()) {
+      return nullptr;
+    }
+  }
+  auto slot = rid_.GetSlotNum();
+  std::shared_ptr<const ColumnChunk> chunk;
+  {
+    auto page_guard = table_heap_->bpm_->FetchPageRead(rid_.GetPageId());
+    auto page = page_guard.As<ColumnarTablePage>();
+    uint32_t end = page->GetNumTuples();
+    if (rid_.GetPageId() == stop_at_rid_.GetPageId()) {
+      end = std::min(end, stop_at_rid_.GetSlotNum());
+    }
+    if (predicate != nullptr) {
+      page->Evaluate(*predicate, *table_heap_->schema_, &keep_);
+    }
+    std::vector<uint16_t> slots;
+    for (; slot < end && slots.size() < max_tuples; slot++) {
+      if ((predicate == nullptr || keep_[slot] != 0) && !page->GetTupleMeta(RID{rid_.GetPageId(), slot}).is_deleted_) {
+        slots.push_back(slot);
+      }
+    }
+    if (!slots.empty()) {
+      chunk = std::make_shared<ColumnChunk>(*page, rid_.GetPageId(), std::move(slots), table_heap_->schema_.get(),
+                                            table_heap_->toast_.get());
+    }
+  }
+  rid_ = RID{rid_.GetPageId(), slot};
+  SkipEmptyPages();
+  return chunk;
+}
 
 auto TableIterator::GetRID() -> RID { return rid_; }
 
 auto TableIterator::IsEnd() -> bool { return rid_.GetPageId() == INVALID_PAGE_ID; }
 
 auto TableIterator::operator++() -> TableIterator & {
-  auto page_guard = table_heap_->bpm_->FetchPageRead(rid_.GetPageId());
-  auto page = page_guard.As<TablePage>();
   auto next_tuple_id = rid_.GetSlotNum() + 1;
 
   if (stop_at_rid_.GetPageId() != INVALID_PAGE_ID) {
@@ -51,20 +158,48 @@ auto TableIterator::operator++() -> TableIterator & {
   }
 
   rid_ = RID{rid_.GetPageId(), next_tuple_id};
+  SkipEmptyPages();
+  return *this;
+}
 
-  if (rid_ == stop_at_rid_) {
-    rid_ = RID{INVALID_PAGE_ID, 0};
-  } else if (next_tuple_id < page->GetNumTuples()) {
-    // that's fine
-  } else {
-    auto next_page_id = page->GetNextPageId();
-    // if next page is invalid, RID is set to invalid page; otherwise, it's the first tuple in that page.
-    rid_ = RID{next_page_id, 0};
+void TableIterator::SkipPages(const ScanPredicate &predicate) {
+  const auto *zones = table_heap_->zones_.get();
+  if (zones == nullptr) {
+    return;
   }
+  bool skipped = false;
+  while (rid_.GetPageId() != INVALID_PAGE_ID && !(rid_ == stop_at_rid_) &&
+         !zones->MayMatch(rid_.GetPageId(), predicate)) {
+    if (rid_.GetPageId() == stop_at_rid_.GetPageId()) {
+      rid_ = RID{INVALID_PAGE_ID, 0};
+      return;
+    }
+    rid_ = RID{zones->GetNextPageId(rid_.GetPageId()), 0};
+    skipped = true;
+  }
+  if (skipped) {
+    SkipEmptyPages();
+  }
+}
 
-  page_guard.Drop();
-
-  return *this;
+void TableIterator::SkipEmptyPages() {
+  while (rid_.GetPageId() != INVALID_PAGE_ID) {
+    if (rid_ == stop_at_rid_) {
+      break;
+    }
+    // Both kinds of pages start with the same header, see ColumnarTablePage.
+    auto page_guard = table_heap_->bpm_->FetchPageRead(rid_.GetPageId());
+    auto page = page_guard.As<TablePage>();
+    if (rid_.GetSlotNum() < page->GetNumTuples()) {
+      return;
+    }
+    if (rid_.GetPageId() == stop_at_rid_.GetPageId()) {
+      break;
+    }
+    // if next page is invalid, RID is set to invalid page; otherwise, it's the first tuple in that page.
+    rid_ = RID{page->GetNextPageId(), 0};
+  }
+  rid_ = RID{INVALID_PAGE_ID, 0};
 }
 
 }  // namespace bustub
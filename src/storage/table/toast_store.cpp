@@ -0,0 +1,191 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// toast_store.cpp
+//
+// Identification: src/storage/table/toast_store.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/table/toast_store.h"
+
+#include <algorithm>
+#include <cstring>
+#include <utility>
+#include <vector>
+
+#include "common/exception.h"
+#include "common/macros.h"
+#include "common/util/compression_util.h"
+#include "storage/page/overflow_page.h"
+#include "storage/page/page_guard.h"
+
+namespace bustub {
+
+namespace {
+
+struct ToastPointer {
+  uint32_t marker_;
+  uint32_t raw_size_;
+  uint32_t stored_size_;
+  page_id_t first_page_id_;
+};
+
+static_assert(sizeof(ToastPointer) == ToastStore::TOAST_POINTER_SIZE);
+
+auto ReadPointer(const char *field) -> ToastPointer {
+  ToastPointer pointer;
+  memcpy(&pointer, field, sizeof(pointer));
+  return pointer;
+}
+
+}  // namespace
+
+auto ToastStore::Toast(const Tuple &tuple, const Schema &schema) -> Tuple {
+  if (tuple.GetLength() <= TOAST_TUPLE_THRESHOLD) {
+    return tuple;
+  }
+
+  // Pick the largest values until the rest of the tuple fits.
+  std::vector<std::pair<uint32_t, uint32_t>> candidates;  // (size, column)
+  for (auto column_idx : schema.GetUnlinedColumns()) {
+    auto field = tuple.GetDataPtr(&schema, column_idx);
+    auto len = *reinterpret_cast<const uint32_t *>(field);
+    if (len != BUSTUB_VALUE_NULL && len != TOAST_MARKER && len >= TOAST_MIN_VALUE_SIZE) {
+      candidates.emplace_back(len, column_idx);
+    }
+  }
+  std::sort(candidates.begin(), candidates.end(), std::greater<>());
+  std::vector<bool> toast(schema.GetColumnCount(), false);
+  auto tuple_size = tuple.GetLength();
+  for (const auto &[len, column_idx] : candidates) {
+    if (tuple_size <= TOAST_TUPLE_THRESHOLD) {
+      break;
+    }
+    toast[column_idx] = true;
+    tuple_size -= sizeof(uint32_t) + len - TOAST_POINTER_SIZE;
+  }
+
+  // Rebuild the tuple in the same layout as Tuple's constructor, with pointers in place of the chosen values.
+  Tuple result;
+  result.rid_ = tuple.rid_;
+  result.data_.resize(tuple_size);
+  memcpy(result.data_.data(), tuple.data_.data(), schema.GetLength());
+  uint32_t offset = schema.GetLength();
+  for (uint32_t column_idx = 0; column_idx < schema.GetColumnCount(); column_idx++) {
+    const auto &col = schema.GetColumn(column_idx);
+    if (col.IsInlined()) {
+      continue;
+    }
+    *reinterpret_cast<uint32_t *>(result.data_.data() + col.GetOffset()) = offset;
+    auto field = tuple.GetDataPtr(&schema, column_idx);
+    auto len = *reinterpret_cast<const uint32_t *>(field);
+    if (!toast[column_idx]) {
+      auto field_size = sizeof(uint32_t);
+      if (len == TOAST_MARKER) {
+        field_size = TOAST_POINTER_SIZE;
+      } else if (len != BUSTUB_VALUE_NULL) {
+        field_size += len;
+      }
+      memcpy(result.data_.data() + offset, field, field_size);
+      offset += field_size;
+      continue;
+    }
+
+    auto data = field + sizeof(uint32_t);
+    ToastPointer pointer{TOAST_MARKER, len, len, INVALID_PAGE_ID};
+    auto compressed = CompressionUtil::LzCompress(data, len);
+    if (compressed.size() <= len - len / 8) {
+      pointer.stored_size_ = compressed.size();
+      pointer.first_page_id_ = WriteChain(compressed.data(), compressed.size());
+    } else {
+      pointer.first_page_id_ = WriteChain(data, len);
+    }
+    memcpy(result.data_.data() + offset, &pointer, sizeof(pointer));
+    offset += TOAST_POINTER_SIZE;
+  }
+  BUSTUB_ASSERT(offset == tuple_size, "toasted tuple size mismatch");
+  return result;
+}
+
+auto ToastStore::WriteChain(const char *data, uint32_t size) -> page_id_t {
+  // The chain is not reachable before the tuple pointing to it is inserted, so the pages need no latches.
+  page_id_t first_page_id = INVALID_PAGE_ID;
+  BasicPageGuard prev_guard;
+  uint32_t written = 0;
+  do {
+    page_id_t page_id = INVALID_PAGE_ID;
+    auto guard = bpm_->NewPageGuarded(&page_id);
+    BUSTUB_ENSURE(page_id != INVALID_PAGE_ID, "cannot allocate overflow page");
+    auto page = guard.AsMut<OverflowPage>();
+    page->Init();
+    auto chunk = std::min(size - written, OverflowPage::OVERFLOW_PAGE_CAPACITY);
+    page->SetData(data + written, chunk);
+    written += chunk;
+
+    if (first_page_id == INVALID_PAGE_ID) {
+      first_page_id = page_id;
+    } else {
+      prev_guard.AsMut<OverflowPage>()->SetNextPageId(page_id);
+    }
+    prev_guard = std::move(guard);
+  } while (written < size);
+  return first_page_id;
+}
+
+auto ToastStore::Fetch(const char *toast_pointer, TypeId type) const -> Value {
+  auto pointer = ReadPointer(toast_pointer);
+  std::vector<char> stored(pointer.stored_size_);
+  uint32_t read = 0;
+  auto page_id = pointer.first_page_id_;
+  while (read < pointer.stored_size_) {
+    BUSTUB_ENSURE(page_id != INVALID_PAGE_ID, "overflow chain is too short");
+    auto guard = bpm_->FetchPageRead(page_id);
+    auto page = guard.As<OverflowPage>();
+    memcpy(stored.data() + read, page->GetData(), page->GetDataSize());
+    read += page->GetDataSize();
+    page_id = page->GetNextPageId();
+  }
+
+  if (pointer.stored_size_ == pointer.raw_size_) {
+    return {type, stored.data(), pointer.raw_size_, true};
+  }
+  std::vector<char> raw(pointer.raw_size_);
+  if (!CompressionUtil::LzDecompress(stored.data(), stored.size(), raw.data(), raw.size())) {
+    throw Exception(ExceptionType::INVALID, "corrupt out-of-line value");
+  }
+  return {type, raw.data(), pointer.raw_size_, true};
+}
+
+void ToastStore::Free(const Tuple &tuple, const Schema &schema, const Tuple *keep) {
+  std::vector<page_id_t> kept_chains;
+  if (keep != nullptr) {
+    for (auto column_idx : schema.GetUnlinedColumns()) {
+      auto field = keep->GetDataPtr(&schema, column_idx);
+      if (IsToasted(field)) {
+        kept_chains.push_back(ReadPointer(field).first_page_id_);
+      }
+    }
+  }
+
+  for (auto column_idx : schema.GetUnlinedColumns()) {
+    auto field = tuple.GetDataPtr(&schema, column_idx);
+    if (!IsToasted(field)) {
+      continue;
+    }
+    auto page_id = ReadPointer(field).first_page_id_;
+    if (std::find(kept_chains.begin(), kept_chains.end(), page_id) != kept_chains.end()) {
+      continue;
+    }
+    while (page_id != INVALID_PAGE_ID) {
+      auto guard = bpm_->FetchPageRead(page_id);
+      auto next_page_id = guard.As<OverflowPage>()->GetNextPageId();
+      guard.Drop();
+      bpm_->DeletePage(page_id);
+      page_id = next_page_id;
+    }
+  }
+}
+
+}  // namespace bustub
@@ -16,10 +16,28 @@
 #include <string>
 #include <vector>
 
+#include "common/macros.h"
+#include "storage/table/toast_store.h"
 #include "storage/table/tuple.h"
 
 namespace bustub {
 
+namespace {
+
+/** @return the start of the data of a column in a serialized tuple */
+auto ColumnData(const char *data, const Schema *schema, uint32_t column_idx) -> const char * {
+  assert(schema);
+  const auto &col = schema->GetColumn(column_idx);
+  // For inline type, data is stored where it is.
+  if (col.IsInlined()) {
+    return data + col.GetOffset();
+  }
+  // We read the relative offset from the tuple data, and return the beginning address of the real data for VARCHAR.
+  return data + *reinterpret_cast<const int32_t *>(data + col.GetOffset());
+}
+
+}  // namespace
+
 // TODO(Amadou): It does not look like nulls are supported. Add a null bitmap?
 Tuple::Tuple(std::vector<Value> values, const Schema *schema) {
   assert(values.size() == schema->GetColumnCount());
@@ -64,10 +82,21 @@ auto Tuple::GetValue(const Schema *schema, const uint32_t column_idx) const -> V
   assert(schema);
   const TypeId column_type = schema->GetColumn(column_idx).GetType();
   const char *data_ptr = GetDataPtr(schema, column_idx);
+  if (!schema->GetColumn(column_idx).IsInlined() && ToastStore::IsToasted(data_ptr)) {
+    BUSTUB_ENSURE(toast_store_ != nullptr, "out-of-line value outside of its table");
+    return toast_store_->Fetch(data_ptr, column_type);
+  }
   // the third parameter "is_inlined" is unused
   return Value::DeserializeFrom(data_ptr, column_type);
 }
 
+auto Tuple::IsNull(const Schema *schema, const uint32_t column_idx) const -> bool {
+  if (!schema->GetColumn(column_idx).IsInlined()) {
+    return *reinterpret_cast<const uint32_t *>(GetDataPtr(schema, column_idx)) == BUSTUB_VALUE_NULL;
+  }
+  return GetValue(schema, column_idx).IsNull();
+}
+
 auto Tuple::KeyFromTuple(const Schema &schema, const Schema &key_schema, const std::vector<uint32_t> &key_attrs)
     -> Tuple {
   std::vector<Value> values;
@@ -79,17 +108,7 @@ auto Tuple::KeyFromTuple(const Schema &schema, const Schema &key_schema, const s
 }
 
 auto Tuple::GetDataPtr(const Schema *schema, const uint32_t column_idx) const -> const char * {
-  assert(schema);
-  const auto &col = schema->GetColumn(column_idx);
-  bool is_inlined = col.IsInlined();
-  // For inline type, data is stored where it is.
-  if (is_inlined) {
-    return (data_.data() + col.GetOffset());
-  }
-  // We read the relative offset from the tuple data.
-  int32_t offset = *reinterpret_cast<const int32_t *>(data_.data() + col.GetOffset());
-  // And return the beginning address of the real data for the VARCHAR type.
-  return (data_.data() + offset);
+  return ColumnData(data_.data(), schema, column_idx);
 }
 
 auto Tuple::ToString(const Schema *schema) const -> std::string {
@@ -129,4 +148,36 @@ void Tuple::DeserializeFrom(const char *storage) {
   memcpy(this->data_.data(), storage + sizeof(int32_t), size);
 }
 
+auto TupleView::GetValue(const Schema *schema, const uint32_t column_idx) const -> Value {
+  const auto &col = schema->GetColumn(column_idx);
+  const char *data_ptr = ColumnData(data_, schema, column_idx);
+  if (col.IsInlined()) {
+    return Value::DeserializeFrom(data_ptr, col.GetType());
+  }
+  if (ToastStore::IsToasted(data_ptr)) {
+    BUSTUB_ENSURE(toast_store_ != nullptr, "out-of-line value outside of its table");
+    return toast_store_->Fetch(data_ptr, col.GetType());
+  }
+  // Read the value in place instead of copying it as Value::DeserializeFrom does.
+  auto len = *reinterpret_cast<const uint32_t *>(data_ptr);
+  if (len == BUSTUB_VALUE_NULL) {
+    return {col.GetType(), nullptr, len, false};
+  }
+  return {col.GetType(), data_ptr + sizeof(uint32_t), len, false};
+}
+
+auto TupleView::IsNull(const Schema *schema, const uint32_t column_idx) const -> bool {
+  if (!schema->GetColumn(column_idx).IsInlined()) {
+    return *reinterpret_cast<const uint32_t *>(ColumnData(data_, schema, column_idx)) == BUSTUB_VALUE_NULL;
+  }
+  return GetValue(schema, column_idx).IsNull();
+}
+
+auto TupleView::ToTuple() const -> Tuple {
+  Tuple tuple{rid_};
+  tuple.data_.assign(data_, data_ + size_);
+  tuple.toast_store_ = toast_store_;
+  return tuple;
+}
+
 }  // namespace bustub
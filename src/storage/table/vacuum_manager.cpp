@@ -0,0 +1,81 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// vacuum_manager.cpp
+//
+// Identification: src/storage/table/vacuum_manager.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/table/vacuum_manager.h"
+
+#include <mutex>  // NOLINT
+#include <shared_mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "common/config.h"
+
+namespace bustub {
+
+void VacuumManager::StartBackgroundVacuum() {
+  std::scoped_lock guard(background_latch_);
+  if (enable_background_vacuum_) {
+    return;
+  }
+  enable_background_vacuum_ = true;
+  background_thread_ = std::thread(&VacuumManager::RunBackgroundVacuum, this);
+}
+
+void VacuumManager::StopBackgroundVacuum() {
+  {
+    std::scoped_lock guard(background_latch_);
+    enable_background_vacuum_ = false;
+  }
+  background_cv_.notify_all();
+  if (background_thread_.joinable()) {
+    background_thread_.join();
+  }
+}
+
+auto VacuumManager::VacuumAllTables(const Transaction *txn) -> std::vector<std::pair<std::string, VacuumStats>> {
+  // Tables are never dropped, so the table infos stay valid after the catalog latch is released.
+  std::vector<TableInfo *> tables;
+  {
+    std::shared_lock<std::shared_mutex> guard(*catalog_lock_);
+    for (const auto &name : catalog_->GetTableNames()) {
+      tables.push_back(catalog_->GetTable(name));
+    }
+  }
+
+  std::scoped_lock guard(vacuum_latch_);
+  std::vector<std::pair<std::string, VacuumStats>> result;
+  for (auto *table_info : tables) {
+    // Mock tables don't have any pages.
+    if (table_info->table_->GetFirstPageId() == INVALID_PAGE_ID) {
+      continue;
+    }
+    auto stats = table_info->table_->Vacuum(txn_manager_, txn);
+    total_stats_ += stats;
+    result.emplace_back(table_info->name_, stats);
+  }
+  return result;
+}
+
+auto VacuumManager::GetTotalStats() -> VacuumStats {
+  std::scoped_lock guard(vacuum_latch_);
+  return total_stats_;
+}
+
+void VacuumManager::RunBackgroundVacuum() {
+  std::unique_lock<std::mutex> guard(background_latch_);
+  while (!background_cv_.wait_for(guard, vacuum_interval, [this] { return !enable_background_vacuum_; })) {
+    guard.unlock();
+    VacuumAllTables();
+    guard.lock();
+  }
+}
+
+}  // namespace bustub
@@ -0,0 +1,136 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// zone_map.cpp
+//
+// Identification: src/storage/table/zone_map.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/table/zone_map.h"
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+#include "type/limits.h"
+
+namespace bustub {
+
+namespace {
+
+/** @return the value of type T at `data`, which need not be aligned */
+template <typename T>
+auto Load(const char *data) -> T {
+  T value;
+  std::memcpy(&value, data, sizeof(T));
+  return value;
+}
+
+/** Widen an integer range by a value, unless it is the null value of its type. */
+template <typename T>
+void WidenInteger(ColumnRange *range, const char *data, T null) {
+  auto value = Load<T>(data);
+  if (value == null) {
+    range->num_nulls_++;
+    return;
+  }
+  auto widened = static_cast<int64_t>(value);
+  range->min_integer_ = range->num_values_ == 0 ? widened : std::min(range->min_integer_, widened);
+  range->max_integer_ = range->num_values_ == 0 ? widened : std::max(range->max_integer_, widened);
+  range->num_values_++;
+}
+
+}  // namespace
+
+ZoneMap::ZoneMap(const Schema &schema) : schema_(schema) {
+  for (uint32_t i = 0; i < schema_.GetColumnCount(); i++) {
+    if (ScanPredicate::IsSupported(schema_.GetColumn(i).GetType())) {
+      columns_.push_back(i);
+    }
+  }
+}
+
+auto ZoneMap::HasSynopses(const Schema &schema) -> bool {
+  return std::any_of(schema.GetColumns().begin(), schema.GetColumns().end(),
+                     [](const Column &column) { return ScanPredicate::IsSupported(column.GetType()); });
+}
+
+void ZoneMap::AddPage(page_id_t page_id) {
+  std::scoped_lock<std::mutex> guard(latch_);
+  zones_[page_id].columns_.resize(schema_.GetColumnCount());
+  if (last_page_id_ != INVALID_PAGE_ID) {
+    zones_[last_page_id_].next_page_id_ = page_id;
+  }
+  last_page_id_ = page_id;
+}
+
+void ZoneMap::Update(page_id_t page_id, const char *data) {
+  std::scoped_lock<std::mutex> guard(latch_);
+  auto it = zones_.find(page_id);
+  if (it == zones_.end()) {
+    return;
+  }
+  for (auto column_idx : columns_) {
+    const auto &column = schema_.GetColumn(column_idx);
+    auto &range = it->second.columns_[column_idx];
+    const char *value = data + column.GetOffset();
+    switch (column.GetType()) {
+      case TypeId::TINYINT:
+        WidenInteger<int8_t>(&range, value, BUSTUB_INT8_NULL);
+        break;
+      case TypeId::SMALLINT:
+        WidenInteger<int16_t>(&range, value, BUSTUB_INT16_NULL);
+        break;
+      case TypeId::INTEGER:
+        WidenInteger<int32_t>(&range, value, BUSTUB_INT32_NULL);
+        break;
+      case TypeId::BIGINT:
+        WidenInteger<int64_t>(&range, value, BUSTUB_INT64_NULL);
+        break;
+      default: {
+        auto decimal = Load<double>(value);
+        if (decimal == BUSTUB_DECIMAL_NULL) {
+          range.num_nulls_++;
+          break;
+        }
+        range.min_decimal_ = range.num_values_ == 0 ? decimal : std::min(range.min_decimal_, decimal);
+        range.max_decimal_ = range.num_values_ == 0 ? decimal : std::max(range.max_decimal_, decimal);
+        range.num_values_++;
+        break;
+      }
+    }
+  }
+}
+
+void ZoneMap::ResetPage(page_id_t page_id) {
+  std::scoped_lock<std::mutex> guard(latch_);
+  auto it = zones_.find(page_id);
+  if (it != zones_.end()) {
+    it->second.columns_.assign(schema_.GetColumnCount(), ColumnRange{});
+  }
+}
+
+auto ZoneMap::MayMatch(page_id_t page_id, const ScanPredicate &predicate) const -> bool {
+  std::scoped_lock<std::mutex> guard(latch_);
+  auto it = zones_.find(page_id);
+  return it == zones_.end() || predicate.MayMatch(it->second.columns_);
+}
+
+auto ZoneMap::GetNextPageId(page_id_t page_id) const -> page_id_t {
+  std::scoped_lock<std::mutex> guard(latch_);
+  auto it = zones_.find(page_id);
+  return it == zones_.end() ? INVALID_PAGE_ID : it->second.next_page_id_;
+}
+
+auto ZoneMap::GetSynopsis(page_id_t page_id) const -> std::optional<std::vector<ColumnRange>> {
+  std::scoped_lock<std::mutex> guard(latch_);
+  auto it = zones_.find(page_id);
+  if (it == zones_.end()) {
+    return std::nullopt;
+  }
+  return it->second.columns_;
+}
+
+}  // namespace bustub
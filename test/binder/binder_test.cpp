@@ -13,6 +13,11 @@
 #include "binder/binder.h"
 #include <memory>
 #include "binder/bound_statement.h"
+#include "binder/statement/create_statement.h"
+#include "binder/statement/prepare_statement.h"
+#include "binder/statement/select_statement.h"
+#include "binder/table_ref/bound_join_ref.h"
+#include "binder/table_ref/bound_subquery_ref.h"
 #include "catalog/catalog.h"
 #include "gtest/gtest.h"
 
@@ -173,6 +178,50 @@ TEST(BinderTest, BindBinaryOp) {
   PrintStatements(statements);
 }
 
+TEST(BinderTest, BindCreateColumnar) {
+  auto statements = TryBind("create table t (x int, y varchar(10)) with (storage = columnar)");
+  PrintStatements(statements);
+  ASSERT_EQ(dynamic_cast<const CreateStatement &>(*statements[0]).storage_, TableStorage::COLUMNAR);
+  statements = TryBind("create table t (x int) with (storage = 'row')");
+  ASSERT_EQ(dynamic_cast<const CreateStatement &>(*statements[0]).storage_, TableStorage::ROW);
+  ASSERT_THROW(TryBind("create table t (x int) with (fillfactor = 10)"), NotImplementedException);
+}
+
+TEST(BinderTest, BindPrepare) {
+  auto statements = TryBind("prepare q (int8) as select ?, x from y where z = ? and a > $1; execute q(1, 'a')");
+  PrintStatements(statements);
+  const auto &prepare = dynamic_cast<const PrepareStatement &>(*statements[0]);
+  ASSERT_EQ(prepare.name_, "q");
+  ASSERT_EQ(prepare.num_parameters_, 2);
+  ASSERT_EQ(prepare.types_, std::vector<TypeId>{TypeId::BIGINT});
+  ASSERT_EQ(prepare.sql_, "prepare q (int8) as select ?, x from y where z = ? and a > $1");
+  const auto &select = dynamic_cast<const SelectStatement &>(*prepare.statement_);
+  ASSERT_EQ(select.select_list_[0]->ToString(), "$1");
+  ASSERT_EQ(select.where_->ToString(), "((y.z=$2)and(y.a>$1))");
+  const auto &execute = dynamic_cast<const ExecuteStatement &>(*statements[1]);
+  ASSERT_EQ(execute.parameters_.size(), 2);
+  ASSERT_EQ(execute.parameters_[1].ToString(), "a");
+  ASSERT_THROW(TryBind("select x from y where z = $1"), Exception);
+}
+
+TEST(BinderTest, BindWhereSubquery) {
+  auto statements = TryBind(
+      "select x from y where z in (select x from a) and not exists (select * from b where b.y = y.a and b.x > 1)");
+  PrintStatements(statements);
+  const auto &select = dynamic_cast<const SelectStatement &>(*statements[0]);
+  ASSERT_TRUE(select.where_->IsInvalid());
+  const auto &anti_join = dynamic_cast<const BoundJoinRef &>(*select.table_);
+  ASSERT_EQ(anti_join.join_type_, JoinType::ANTI);
+  ASSERT_EQ(anti_join.condition_->ToString(), "(__subquery#1.__corr#2=y.a)");
+  const auto &subquery = dynamic_cast<const BoundSubqueryRef &>(*anti_join.right_);
+  ASSERT_EQ(subquery.subquery_->where_->ToString(), "(b.x>1)");
+  const auto &semi_join = dynamic_cast<const BoundJoinRef &>(*anti_join.left_);
+  ASSERT_EQ(semi_join.join_type_, JoinType::SEMI);
+  ASSERT_EQ(semi_join.condition_->ToString(), "(y.z=__subquery#0.a.x)");
+  ASSERT_THROW(TryBind("select x from y where exists (select y.a from b)"), Exception);
+  ASSERT_THROW(TryBind("select x from y where z not in (select x from a)"), NotImplementedException);
+}
+
 // TODO(chi): subquery is not supported yet
 TEST(BinderTest, DISABLED_BindUncorrelatedSubquery) {
   auto statements = TryBind("select * from (select * from a) INNER JOIN (select * from b) ON a.x = b.y");
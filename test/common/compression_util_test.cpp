@@ -0,0 +1,75 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// compression_util_test.cpp
+//
+// Identification: test/common/compression_util_test.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include <random>
+#include <string>
+#include <vector>
+
+#include "common/util/compression_util.h"
+#include "gtest/gtest.h"
+
+namespace bustub {
+
+namespace {
+
+void CheckRoundTrip(const std::string &input) {
+  auto compressed = CompressionUtil::LzCompress(input.data(), input.size());
+  std::string output(input.size(), '\0');
+  ASSERT_TRUE(CompressionUtil::LzDecompress(compressed.data(), compressed.size(), output.data(), output.size()));
+  ASSERT_EQ(output, input);
+}
+
+}  // namespace
+
+// NOLINTNEXTLINE
+TEST(CompressionUtilTest, RoundTripTest) {
+  CheckRoundTrip("");
+  CheckRoundTrip("a");
+  CheckRoundTrip("abcd");
+  CheckRoundTrip(std::string(100000, 'x'));
+  CheckRoundTrip("the quick brown fox jumps over the lazy dog, the quick brown fox jumps over the lazy cat");
+
+  std::mt19937 gen(15445);
+  std::string random(70000, '\0');
+  for (auto &c : random) {
+    c = static_cast<char>(gen());
+  }
+  CheckRoundTrip(random);
+
+  // Random words, long enough for offsets beyond the match window.
+  std::string text;
+  while (text.size() < 200000) {
+    text += "word" + std::to_string(gen() % 500) + " ";
+  }
+  CheckRoundTrip(text);
+}
+
+// NOLINTNEXTLINE
+TEST(CompressionUtilTest, CompressesRedundantDataTest) {
+  std::string input;
+  for (int i = 0; i < 1000; i++) {
+    input += "row " + std::to_string(i % 10) + " of a rather repetitive varchar value; ";
+  }
+  auto compressed = CompressionUtil::LzCompress(input.data(), input.size());
+  ASSERT_LT(compressed.size(), input.size() / 10);
+}
+
+// NOLINTNEXTLINE
+TEST(CompressionUtilTest, CorruptInputTest) {
+  std::string input(1000, 'y');
+  auto compressed = CompressionUtil::LzCompress(input.data(), input.size());
+  std::string output(input.size(), '\0');
+  // Wrong expected size.
+  ASSERT_FALSE(CompressionUtil::LzDecompress(compressed.data(), compressed.size(), output.data(), 999));
+  // Truncated block.
+  ASSERT_FALSE(CompressionUtil::LzDecompress(compressed.data(), compressed.size() - 1, output.data(), output.size()));
+}
+
+}  // namespace bustub
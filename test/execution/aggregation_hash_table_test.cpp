@@ -0,0 +1,159 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// aggregation_hash_table_test.cpp
+//
+// Identification: test/execution/aggregation_hash_table_test.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "execution/aggregation_hash_table.h"
+#include "gtest/gtest.h"
+#include "storage/disk/disk_manager_memory.h"
+#include "type/value_factory.h"
+
+namespace bustub {
+
+namespace {
+
+/** Add rows [start, start + num_rows) to a table: row i is in group i % num_groups, or the null group if i % 7 == 0. */
+void InsertRows(AggregationHashTable *table, size_t num_aggs, int32_t start, int32_t num_rows, int32_t num_groups) {
+  std::vector<std::vector<Value>> keys(1);
+  std::vector<std::vector<Value>> vals(num_aggs);
+  for (int32_t i = start; i < start + num_rows; i++) {
+    keys[0].push_back(i % 7 == 0 ? ValueFactory::GetNullValueByType(TypeId::INTEGER)
+                                 : ValueFactory::GetIntegerValue(i % num_groups));
+    auto input = i % 11 == 0 ? ValueFactory::GetNullValueByType(TypeId::INTEGER) : ValueFactory::GetIntegerValue(i);
+    for (size_t agg = 0; agg < num_aggs; agg++) {
+      vals[agg].push_back(agg == 3 ? ValueFactory::GetVarcharValue(std::to_string(i)) : input);
+    }
+  }
+  table->InsertBatch(keys, vals, num_rows);
+}
+
+/** @return the groups of a finalized table, its aggregates by its group-by value */
+auto ReadGroups(AggregationHashTable *table) -> std::map<std::string, std::vector<std::string>> {
+  std::map<std::string, std::vector<std::string>> groups;
+  std::vector<Value> values;
+  while (table->Next(&values)) {
+    auto &aggregates = groups[values[0].ToString()];
+    EXPECT_TRUE(aggregates.empty()) << "group " << values[0].ToString() << " was read twice";
+    for (size_t i = 1; i < values.size(); i++) {
+      aggregates.push_back(values[i].ToString());
+    }
+  }
+  return groups;
+}
+
+}  // namespace
+
+// NOLINTNEXTLINE
+TEST(AggregationHashTableTest, GroupTest) {
+  std::vector<AggregationType> agg_types{AggregationType::CountStarAggregate, AggregationType::CountAggregate,
+                                         AggregationType::SumAggregate, AggregationType::MinAggregate,
+                                         AggregationType::MaxAggregate};
+  // Without a buffer pool the table never spills, so the memory limit does not matter.
+  AggregationHashTable left(agg_types, nullptr, 0);
+  AggregationHashTable right(agg_types, nullptr, 0);
+
+  // Group i % 1000 gets the rows i, with a null input for every eleventh row. Group 1000 has a null key.
+  const int32_t num_groups = 1000;
+  for (int32_t start = 0; start < 20000; start += 500) {
+    std::vector<std::vector<Value>> keys(1);
+    std::vector<std::vector<Value>> vals(agg_types.size());
+    for (int32_t i = start; i < start + 500; i++) {
+      keys[0].push_back(i % 7 == 0 ? ValueFactory::GetNullValueByType(TypeId::INTEGER)
+                                   : ValueFactory::GetIntegerValue(i % num_groups));
+      auto input = i % 11 == 0 ? ValueFactory::GetNullValueByType(TypeId::INTEGER) : ValueFactory::GetIntegerValue(i);
+      vals[0].push_back(input);
+      vals[1].push_back(input);
+      vals[2].push_back(input);
+      vals[3].push_back(ValueFactory::GetVarcharValue(std::to_string(i)));
+      vals[4].push_back(input);
+    }
+    // Half of the rows go to each table, which are merged as the partial results of parallel workers would be.
+    (start % 1000 == 0 ? left : right).InsertBatch(keys, vals, 500);
+  }
+  left.Merge(&right);
+  ASSERT_TRUE(right.Empty());
+  left.Finalize();
+
+  struct Expected {
+    int32_t count_star_{0};
+    int32_t count_{0};
+    int32_t sum_{0};
+    std::string min_;
+    int32_t max_{0};
+  };
+  std::map<int32_t, Expected> expected;
+  for (int32_t i = 0; i < 20000; i++) {
+    auto &group = expected[i % 7 == 0 ? -1 : i % num_groups];
+    group.count_star_++;
+    auto name = std::to_string(i);
+    if (group.min_.empty() || name < group.min_) {
+      group.min_ = name;
+    }
+    if (i % 11 != 0) {
+      group.count_++;
+      group.sum_ += i;
+      group.max_ = std::max(group.max_, i);
+    }
+  }
+
+  std::vector<Value> values;
+  size_t num_read = 0;
+  while (left.Next(&values)) {
+    ASSERT_EQ(values.size(), 6);
+    auto key = values[0].IsNull() ? -1 : values[0].GetAs<int32_t>();
+    const auto &group = expected.at(key);
+    EXPECT_EQ(values[1].GetAs<int32_t>(), group.count_star_) << key;
+    EXPECT_EQ(values[2].GetAs<int32_t>(), group.count_) << key;
+    EXPECT_EQ(values[3].GetAs<int32_t>(), group.sum_) << key;
+    EXPECT_EQ(values[4].ToString(), group.min_) << key;
+    EXPECT_EQ(values[5].GetAs<int32_t>(), group.max_) << key;
+    num_read++;
+  }
+  ASSERT_EQ(num_read, expected.size());
+}
+
+// NOLINTNEXTLINE
+TEST(AggregationHashTableTest, DISABLED_SpillTest) {
+  std::vector<AggregationType> agg_types{AggregationType::CountStarAggregate, AggregationType::CountAggregate,
+                                         AggregationType::SumAggregate, AggregationType::MinAggregate,
+                                         AggregationType::MaxAggregate};
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(64, disk_manager.get());
+  // Small enough that the groups spill many times, and the partitions spill again when they are merged a level down.
+  const size_t memory_limit = 128 * 1024;
+  AggregationHashTable unbounded(agg_types, nullptr, 0);
+  AggregationHashTable left(agg_types, bpm.get(), memory_limit);
+  AggregationHashTable right(agg_types, bpm.get(), memory_limit);
+
+  const int32_t num_groups = 20000;
+  for (int32_t start = 0; start < 100000; start += 500) {
+    InsertRows(&unbounded, agg_types.size(), start, 500, num_groups);
+    // Half of the rows go to each table, which are merged as the partial results of parallel workers would be.
+    InsertRows(start % 1000 == 0 ? &left : &right, agg_types.size(), start, 500, num_groups);
+  }
+  ASSERT_FALSE(left.Empty());
+  ASSERT_FALSE(right.Empty());
+  left.Merge(&right);
+  ASSERT_TRUE(right.Empty());
+  unbounded.Finalize();
+  left.Finalize();
+
+  auto expected = ReadGroups(&unbounded);
+  ASSERT_EQ(expected.size(), num_groups + 1);
+  auto spilled = ReadGroups(&left);
+  ASSERT_EQ(spilled.size(), expected.size());
+  ASSERT_EQ(spilled, expected);
+}
+
+}  // namespace bustub
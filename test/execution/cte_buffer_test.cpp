@@ -0,0 +1,109 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// cte_buffer_test.cpp
+//
+// Identification: test/execution/cte_buffer_test.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "execution/cte_buffer.h"
+#include "execution/tuple_batch.h"
+#include "gtest/gtest.h"
+#include "storage/disk/disk_manager_memory.h"
+#include "type/value_factory.h"
+
+namespace bustub {
+
+namespace {
+
+auto RowSchema() -> Schema { return Schema({Column{"id", TypeId::INTEGER}, Column{"name", TypeId::VARCHAR, 64}}); }
+
+/** Append `num_rows` rows in batches of `batch_size` rows, so that the batches do not line up with the reads. */
+void AppendRows(CTEBuffer *buffer, const Schema *schema, int32_t num_rows, int32_t batch_size) {
+  TupleBatch batch;
+  for (int32_t start = 0; start < num_rows; start += batch_size) {
+    batch.Reset(schema);
+    for (int32_t i = start; i < std::min(start + batch_size, num_rows); i++) {
+      batch.AppendValues({ValueFactory::GetIntegerValue(i), ValueFactory::GetVarcharValue("row-" + std::to_string(i))});
+    }
+    buffer->Append(batch);
+  }
+}
+
+/** Read one batch, and append its ids to `ids`. */
+auto ReadBatch(CTEBuffer::Reader *reader, const Schema *schema, std::vector<int32_t> *ids) -> bool {
+  TupleBatch batch;
+  if (!reader->Next(schema, &batch)) {
+    return false;
+  }
+  for (uint32_t i = 0; i < batch.Size(); i++) {
+    auto id = batch.GetValue(i, 0).GetAs<int32_t>();
+    EXPECT_EQ(batch.GetValue(i, 1).ToString(), "row-" + std::to_string(id));
+    ids->push_back(id);
+  }
+  return true;
+}
+
+}  // namespace
+
+// NOLINTNEXTLINE
+TEST(CTEBufferTest, DISABLED_SpillTest) {
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(16, disk_manager.get());
+  auto schema = RowSchema();
+  const int32_t num_rows = 10000;
+
+  // A few batches fit in memory, and the rest of the rows are spilled.
+  CTEBuffer unbounded(nullptr, &schema, 0);
+  CTEBuffer buffer(bpm.get(), &schema, 64 * 1024);
+  AppendRows(&unbounded, &schema, num_rows, 700);
+  AppendRows(&buffer, &schema, num_rows, 700);
+  ASSERT_EQ(unbounded.NumRows(), num_rows);
+  ASSERT_EQ(unbounded.NumSpilledRows(), 0);
+  ASSERT_EQ(buffer.NumRows(), num_rows);
+  ASSERT_GT(buffer.NumSpilledRows(), 0);
+  ASSERT_LT(buffer.NumSpilledRows(), num_rows);
+
+  std::vector<int32_t> expected;
+  CTEBuffer::Reader unbounded_reader(&unbounded);
+  while (ReadBatch(&unbounded_reader, &schema, &expected)) {
+  }
+  ASSERT_EQ(expected.size(), num_rows);
+
+  // The fast consumer starts first and reads three batches for every batch of the slow one, so the two are at
+  // different rows of the memory part and of the spill file, and the fast one finishes long before the slow one.
+  std::vector<int32_t> fast_ids;
+  std::vector<int32_t> slow_ids;
+  CTEBuffer::Reader fast(&buffer);
+  ASSERT_TRUE(ReadBatch(&fast, &schema, &fast_ids));
+  ASSERT_TRUE(ReadBatch(&fast, &schema, &fast_ids));
+  CTEBuffer::Reader slow(&buffer);
+  bool fast_done = false;
+  bool slow_done = false;
+  while (!slow_done) {
+    for (int i = 0; i < 3 && !fast_done; i++) {
+      fast_done = !ReadBatch(&fast, &schema, &fast_ids);
+    }
+    slow_done = !ReadBatch(&slow, &schema, &slow_ids);
+  }
+  ASSERT_TRUE(fast_done);
+  ASSERT_EQ(fast_ids, expected);
+  ASSERT_EQ(slow_ids, expected);
+
+  // A consumer that starts after the others are done reads the rows again.
+  std::vector<int32_t> late_ids;
+  CTEBuffer::Reader late(&buffer);
+  while (ReadBatch(&late, &schema, &late_ids)) {
+  }
+  ASSERT_EQ(late_ids, expected);
+}
+
+}  // namespace bustub
@@ -0,0 +1,110 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// execution_engine_test.cpp
+//
+// Identification: test/execution/execution_engine_test.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "common/bustub_instance.h"
+#include "execution/execution_engine.h"
+#include "execution/executors/mock_scan_executor.h"
+#include "execution/plans/mock_scan_plan.h"
+#include "gtest/gtest.h"
+
+namespace bustub {
+
+namespace {
+
+auto MockScan(const std::string &table) -> AbstractPlanNodeRef {
+  return std::make_shared<MockScanPlanNode>(std::make_shared<Schema>(GetMockTableSchemaOf(table)), table);
+}
+
+auto MakeExecutorContext() -> std::unique_ptr<ExecutorContext> {
+  auto exec_ctx = std::make_unique<ExecutorContext>(nullptr, nullptr, nullptr, nullptr, nullptr, false);
+  exec_ctx->InitCheckOptions(std::make_shared<CheckOptions>());
+  return exec_ctx;
+}
+
+}  // namespace
+
+// NOLINTNEXTLINE
+TEST(ExecutionEngineTest, StreamTest) {
+  ExecutionEngine engine(nullptr, nullptr, nullptr);
+  auto plan = MockScan("__mock_agg_input_big");
+  auto exec_ctx = MakeExecutorContext();
+
+  // The 10000 rows arrive in full batches, and then the rest.
+  std::vector<uint32_t> batch_sizes;
+  ASSERT_TRUE(engine.Execute(
+      plan, [&](const TupleBatch &batch) { batch_sizes.push_back(batch.Size()); }, nullptr, exec_ctx.get()));
+  ASSERT_EQ(batch_sizes.size(), 10);
+  for (size_t i = 0; i + 1 < batch_sizes.size(); i++) {
+    ASSERT_EQ(batch_sizes[i], TupleBatch::BATCH_SIZE);
+  }
+  ASSERT_EQ(batch_sizes.back(), 10000 - 9 * TupleBatch::BATCH_SIZE);
+
+  std::vector<Tuple> result_set;
+  exec_ctx = MakeExecutorContext();
+  ASSERT_TRUE(engine.Execute(plan, &result_set, nullptr, exec_ctx.get()));
+  ASSERT_EQ(result_set.size(), 10000);
+}
+
+// NOLINTNEXTLINE
+TEST(ExecutionEngineTest, StreamErrorTest) {
+  ExecutionEngine engine(nullptr, nullptr, nullptr);
+  auto plan = MockScan("__mock_table_fail");
+  auto exec_ctx = MakeExecutorContext();
+
+  // The scan throws at row 2500. The two batches before it were consumed before the error, and the query fails.
+  std::vector<int32_t> rows;
+  ASSERT_FALSE(engine.Execute(
+      plan,
+      [&](const TupleBatch &batch) {
+        for (uint32_t i = 0; i < batch.Size(); i++) {
+          rows.push_back(batch.GetValue(i, 0).GetAs<int32_t>());
+        }
+      },
+      nullptr, exec_ctx.get()));
+  ASSERT_EQ(rows.size(), 2 * TupleBatch::BATCH_SIZE);
+  for (size_t i = 0; i < rows.size(); i++) {
+    ASSERT_EQ(rows[i], i);
+  }
+
+  // The vector overload does not return the part of the result that was produced before the error.
+  std::vector<Tuple> result_set;
+  exec_ctx = MakeExecutorContext();
+  ASSERT_FALSE(engine.Execute(plan, &result_set, nullptr, exec_ctx.get()));
+  ASSERT_TRUE(result_set.empty());
+}
+
+// NOLINTNEXTLINE
+TEST(ExecutionEngineTest, StreamErrorSqlTest) {
+  BustubInstance bustub;
+  bustub.GenerateMockTable();
+
+  // The rows streamed to the writer before the error stay written, and the query is reported as failed.
+  std::stringstream result;
+  SimpleStreamWriter writer(result, true);
+  ASSERT_FALSE(bustub.ExecuteSql("select colA from __mock_table_fail;", writer));
+  std::string line;
+  size_t num_lines = 0;
+  while (std::getline(result, line)) {
+    ASSERT_EQ(line, std::to_string(num_lines) + "\t");
+    num_lines++;
+  }
+  ASSERT_EQ(num_lines, 2 * TupleBatch::BATCH_SIZE);
+
+  std::stringstream ok_result;
+  SimpleStreamWriter ok_writer(ok_result, true);
+  ASSERT_TRUE(bustub.ExecuteSql("select count(*) from __mock_table_1;", ok_writer));
+}
+
+}  // namespace bustub
@@ -0,0 +1,159 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// expression_program_test.cpp
+//
+// Identification: test/execution/expression_program_test.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "execution/expression_program.h"
+#include "execution/expressions/arithmetic_expression.h"
+#include "execution/expressions/column_value_expression.h"
+#include "execution/expressions/comparison_expression.h"
+#include "execution/expressions/constant_value_expression.h"
+#include "execution/expressions/logic_expression.h"
+#include "execution/expressions/string_expression.h"
+#include "gtest/gtest.h"
+#include "type/value_factory.h"
+
+namespace bustub {
+
+namespace {
+
+auto Col(uint32_t idx, TypeId type) -> AbstractExpressionRef {
+  return std::make_shared<ColumnValueExpression>(0, idx, type);
+}
+auto Int(int32_t value) -> AbstractExpressionRef {
+  return std::make_shared<ConstantValueExpression>(ValueFactory::GetIntegerValue(value));
+}
+auto Cmp(AbstractExpressionRef lhs, AbstractExpressionRef rhs, ComparisonType type) -> AbstractExpressionRef {
+  return std::make_shared<ComparisonExpression>(std::move(lhs), std::move(rhs), type);
+}
+auto Logic(AbstractExpressionRef lhs, AbstractExpressionRef rhs, LogicType type) -> AbstractExpressionRef {
+  return std::make_shared<LogicExpression>(std::move(lhs), std::move(rhs), type);
+}
+
+/** Check that the program of an expression computes what the expression tree computes. */
+void ExpectSameAsTree(const AbstractExpressionRef &expr, const TupleBatch &batch) {
+  auto program = ExpressionProgram::Compile(expr);
+  ASSERT_NE(program, nullptr) << expr->ToString();
+  std::vector<Value> expected;
+  std::vector<Value> actual;
+  expr->EvaluateBatch(batch, &expected);
+  program->EvaluateBatch(batch, &actual);
+  ASSERT_EQ(expected.size(), actual.size());
+  for (size_t i = 0; i < expected.size(); i++) {
+    EXPECT_EQ(expected[i].IsNull(), actual[i].IsNull()) << expr->ToString() << " row " << i;
+    if (!expected[i].IsNull() && !actual[i].IsNull()) {
+      EXPECT_EQ(expected[i].GetTypeId(), actual[i].GetTypeId()) << expr->ToString() << " row " << i;
+      EXPECT_EQ(expected[i].ToString(), actual[i].ToString()) << expr->ToString() << " row " << i;
+    }
+  }
+}
+
+}  // namespace
+
+// NOLINTNEXTLINE
+TEST(ExpressionProgramTest, SameAsTreeTest) {
+  Schema schema({Column{"a", TypeId::INTEGER}, Column{"b", TypeId::INTEGER}, Column{"c", TypeId::VARCHAR, 16},
+                 Column{"d", TypeId::DECIMAL}, Column{"e", TypeId::BIGINT}});
+  TupleBatch batch;
+  batch.Reset(&schema);
+  for (int32_t i = 0; i < 100; i++) {
+    std::vector<Value> values{
+        i % 7 == 0 ? ValueFactory::GetNullValueByType(TypeId::INTEGER) : ValueFactory::GetIntegerValue(i),
+        ValueFactory::GetIntegerValue(50 - i),
+        i % 5 == 0 ? ValueFactory::GetNullValueByType(TypeId::VARCHAR)
+                   : ValueFactory::GetVarcharValue(std::string(i % 3 + 1, static_cast<char>('a' + i % 4))),
+        ValueFactory::GetDecimalValue(i * 0.5),
+        ValueFactory::GetBigIntValue(static_cast<int64_t>(i) << 33)};
+    batch.AppendTuple(Tuple{values, &schema});
+  }
+  // Drop some rows, so that the selected rows differ from the physical ones.
+  std::vector<uint32_t> selection;
+  for (uint32_t i = 0; i < 100; i++) {
+    if (i % 4 != 3) {
+      selection.push_back(i);
+    }
+  }
+  batch.Select(selection);
+
+  auto a = Col(0, TypeId::INTEGER);
+  auto b = Col(1, TypeId::INTEGER);
+  auto c = Col(2, TypeId::VARCHAR);
+  auto d = Col(3, TypeId::DECIMAL);
+  auto e = Col(4, TypeId::BIGINT);
+  auto str = [](const char *value) {
+    return std::make_shared<ConstantValueExpression>(ValueFactory::GetVarcharValue(value));
+  };
+  auto upper = std::make_shared<StringExpression>(c, StringExpressionType::Upper);
+
+  for (auto type : {ComparisonType::Equal, ComparisonType::NotEqual, ComparisonType::LessThan,
+                    ComparisonType::LessThanOrEqual, ComparisonType::GreaterThan, ComparisonType::GreaterThanOrEqual}) {
+    ExpectSameAsTree(Cmp(a, b, type), batch);
+    ExpectSameAsTree(Cmp(c, str("bb"), type), batch);
+    ExpectSameAsTree(Cmp(a, d, type), batch);
+    ExpectSameAsTree(Cmp(e, a, type), batch);
+  }
+  ExpectSameAsTree(std::make_shared<ArithmeticExpression>(a, b, ArithmeticType::Minus), batch);
+  ExpectSameAsTree(Cmp(std::make_shared<ArithmeticExpression>(a, Int(3), ArithmeticType::Plus), b,
+                       ComparisonType::GreaterThan),
+                   batch);
+  ExpectSameAsTree(upper, batch);
+  ExpectSameAsTree(std::make_shared<StringExpression>(upper, StringExpressionType::Lower), batch);
+
+  // AND and OR with nulls on either side, nested in each other.
+  auto a_small = Cmp(a, Int(30), ComparisonType::LessThan);
+  auto c_is_a = Cmp(c, str("a"), ComparisonType::Equal);
+  auto b_large = Cmp(b, Int(10), ComparisonType::GreaterThanOrEqual);
+  ExpectSameAsTree(Logic(a_small, c_is_a, LogicType::And), batch);
+  ExpectSameAsTree(Logic(c_is_a, a_small, LogicType::Or), batch);
+  ExpectSameAsTree(Logic(Logic(a_small, c_is_a, LogicType::Or), b_large, LogicType::And), batch);
+  ExpectSameAsTree(Logic(b_large, Logic(c_is_a, a_small, LogicType::And), LogicType::Or), batch);
+  // The right side is never evaluated when the left side decides all rows.
+  ExpectSameAsTree(Logic(Cmp(b, Int(100), ComparisonType::GreaterThan), c_is_a, LogicType::And), batch);
+
+  // Select returns the rows for which the predicate is true.
+  auto predicate = Logic(a_small, b_large, LogicType::And);
+  auto program = ExpressionProgram::Compile(predicate);
+  std::vector<Value> expected;
+  predicate->EvaluateBatch(batch, &expected);
+  std::vector<uint32_t> rows;
+  program->Select(batch, &rows);
+  size_t num_true = 0;
+  for (uint32_t i = 0; i < expected.size(); i++) {
+    if (!expected[i].IsNull() && expected[i].GetAs<bool>()) {
+      ASSERT_LT(num_true, rows.size());
+      EXPECT_EQ(rows[num_true++], batch.RowAt(i));
+    }
+  }
+  EXPECT_EQ(num_true, rows.size());
+}
+
+// NOLINTNEXTLINE
+TEST(ExpressionProgramTest, CompileTest) {
+  auto a = Col(0, TypeId::INTEGER);
+
+  // Constant subtrees are folded, and a constant side of AND decides it or drops out.
+  auto folded = Logic(Cmp(a, std::make_shared<ArithmeticExpression>(Int(1), Int(2), ArithmeticType::Plus),
+                          ComparisonType::LessThan),
+                      Cmp(Int(1), Int(1), ComparisonType::Equal), LogicType::And);
+  auto program = ExpressionProgram::Compile(folded);
+  ASSERT_NE(program, nullptr);
+  EXPECT_EQ(program->ToString(), "0: [s0] r0 = load #0.0 INTEGER\n1: [s0] r1 = const 3\n2: [s0] r2 = r0 <int r1\n");
+
+  auto never = Logic(Cmp(a, Int(1), ComparisonType::Equal), Cmp(Int(1), Int(2), ComparisonType::Equal),
+                     LogicType::And);
+  EXPECT_EQ(ExpressionProgram::Compile(never)->ToString(), "0: [s0] r0 = const false\n");
+
+  // The right side of a join cannot be read from a batch.
+  EXPECT_EQ(ExpressionProgram::Compile(std::make_shared<ColumnValueExpression>(1, 0, TypeId::INTEGER)), nullptr);
+}
+
+}  // namespace bustub
@@ -0,0 +1,216 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// join_hash_table_test.cpp
+//
+// Identification: test/execution/join_hash_table_test.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "execution/executor_context.h"
+#include "execution/executors/hash_join_executor.h"
+#include "execution/executors/mock_scan_executor.h"
+#include "execution/expressions/column_value_expression.h"
+#include "execution/join_hash_table.h"
+#include "execution/plans/hash_join_plan.h"
+#include "execution/plans/mock_scan_plan.h"
+#include "execution/plans/nested_loop_join_plan.h"
+#include "gtest/gtest.h"
+#include "storage/disk/disk_manager_memory.h"
+#include "type/value_factory.h"
+
+namespace bustub {
+
+namespace {
+
+auto CountMatches(const JoinHashTable &table, int32_t key_value) -> size_t {
+  HashJoinKey key{{ValueFactory::GetIntegerValue(key_value)}};
+  auto hash = key.Hash();
+  const auto &leaf = table.GetLeaf(hash);
+  EXPECT_FALSE(leaf.IsSpilled());
+  size_t matches = 0;
+  auto pos = leaf.StartSlot(hash);
+  while (auto row = leaf.NextMatch(hash, key, &pos)) {
+    EXPECT_EQ(leaf.keys_[*row].keys_[0].GetAs<int32_t>(), key_value);
+    matches++;
+  }
+  return matches;
+}
+
+/** A join hash table, with the tables that its spilled partitions were reloaded into, as the hash join does. */
+struct ReloadedTable {
+  std::unique_ptr<JoinHashTable> table_;
+  std::unordered_map<const JoinHashTable::Partition *, std::unique_ptr<ReloadedTable>> children_;
+};
+
+/** Reload the spilled partitions of a table into tables one level down, until no partition is spilled. */
+auto Reload(BufferPoolManager *bpm, const Schema *schema, size_t memory_limit, std::unique_ptr<JoinHashTable> table)
+    -> std::unique_ptr<ReloadedTable> {
+  auto result = std::make_unique<ReloadedTable>();
+  for (const auto *partition : table->GetSpilledPartitions()) {
+    auto child = std::make_unique<JoinHashTable>(bpm, schema, memory_limit, partition->level_);
+    SpillFile::Reader reader(partition->spill_.get());
+    Tuple row;
+    while (reader.Next(&row)) {
+      HashJoinKey key{{row.GetValue(schema, 0)}};
+      auto hash = key.Hash();
+      child->Insert(std::move(row), std::move(key), hash);
+    }
+    child->Finalize();
+    result->children_[partition] = Reload(bpm, schema, memory_limit, std::move(child));
+  }
+  result->table_ = std::move(table);
+  return result;
+}
+
+/** @return the number of rows of a key, looked up in the table its partition was reloaded into if it was spilled */
+auto CountReloadedMatches(const ReloadedTable &table, int32_t key_value) -> size_t {
+  HashJoinKey key{{ValueFactory::GetIntegerValue(key_value)}};
+  const auto &leaf = table.table_->GetLeaf(key.Hash());
+  if (leaf.IsSpilled()) {
+    return CountReloadedMatches(*table.children_.at(&leaf), key_value);
+  }
+  return CountMatches(*table.table_, key_value);
+}
+
+/** @return the number of rows in memory in a table and the tables reloaded from it, and their deepest level */
+auto CountReloadedRows(const ReloadedTable &table, uint32_t *max_level) -> size_t {
+  *max_level = std::max(*max_level, table.table_->GetLevel());
+  auto rows = table.table_->NumRows();
+  for (const auto &[partition, child] : table.children_) {
+    rows += CountReloadedRows(*child, max_level);
+  }
+  return rows;
+}
+
+/** @return the rows of a hash join of two mock tables, as strings in sorted order */
+auto RunHashJoin(BufferPoolManager *bpm, size_t memory_limit, JoinType join_type) -> std::vector<std::string> {
+  auto left = std::make_shared<MockScanPlanNode>(
+      std::make_shared<Schema>(GetMockTableSchemaOf("__mock_agg_input_big")), "__mock_agg_input_big");
+  auto right = std::make_shared<MockScanPlanNode>(
+      std::make_shared<Schema>(GetMockTableSchemaOf("__mock_agg_input_big")), "__mock_agg_input_big");
+  // v2 of the left rows is unique, and v3 of the right rows is 0, 1, ..., 99, each in 100 rows.
+  auto plan = std::make_shared<HashJoinPlanNode>(
+      std::make_shared<Schema>(NestedLoopJoinPlanNode::InferJoinSchema(*left, *right)), left, right,
+      std::vector<AbstractExpressionRef>{std::make_shared<ColumnValueExpression>(0, 1, TypeId::INTEGER)},
+      std::vector<AbstractExpressionRef>{std::make_shared<ColumnValueExpression>(0, 2, TypeId::INTEGER)}, join_type);
+
+  ExecutorContext exec_ctx(nullptr, nullptr, bpm, nullptr, nullptr, false);
+  exec_ctx.SetMemoryLimit(memory_limit);
+  HashJoinExecutor executor(&exec_ctx, plan.get(), std::make_unique<MockScanExecutor>(&exec_ctx, left.get()),
+                            std::make_unique<MockScanExecutor>(&exec_ctx, right.get()));
+  executor.Init();
+  std::vector<std::string> rows;
+  Tuple tuple;
+  RID rid;
+  while (executor.Next(&tuple, &rid)) {
+    rows.push_back(tuple.ToString(&plan->OutputSchema()));
+  }
+  std::sort(rows.begin(), rows.end());
+  return rows;
+}
+
+}  // namespace
+
+// NOLINTNEXTLINE
+TEST(JoinHashTableTest, PartitionTest) {
+  Schema schema({Column{"key", TypeId::INTEGER}, Column{"payload", TypeId::INTEGER}});
+  // Without a buffer pool the table never spills, so the memory limit does not matter.
+  JoinHashTable table(nullptr, &schema, 0);
+
+  // Enough rows that partitions exceed the cache size and are split again.
+  const int32_t num_keys = 100000;
+  size_t num_rows = 1;
+  for (int32_t i = 0; i < num_keys; i++) {
+    for (int32_t copy = 0; copy < i % 3 + 1; copy++, num_rows++) {
+      std::vector<Value> values{ValueFactory::GetIntegerValue(i), ValueFactory::GetIntegerValue(copy)};
+      HashJoinKey key{{values[0]}};
+      auto hash = key.Hash();
+      table.Insert(Tuple{values, &schema}, std::move(key), hash);
+    }
+  }
+  HashJoinKey null_key{{ValueFactory::GetNullValueByType(TypeId::INTEGER)}};
+  std::vector<Value> null_values{null_key.keys_[0], ValueFactory::GetIntegerValue(0)};
+  table.Insert(Tuple{null_values, &schema}, null_key, null_key.Hash());
+  table.Finalize();
+
+  ASSERT_TRUE(table.GetSpilledPartitions().empty());
+  ASSERT_GT(table.GetLeaves().size(), JoinHashTable::FANOUT);
+  size_t rows = 0;
+  for (const auto *leaf : table.GetLeaves()) {
+    ASSERT_EQ(leaf->row_offset_, rows);
+    rows += leaf->rows_.size();
+  }
+  ASSERT_EQ(rows, table.NumRows());
+  ASSERT_EQ(rows, num_rows);
+
+  for (int32_t i = 0; i < num_keys; i += 7) {
+    ASSERT_EQ(CountMatches(table, i), i % 3 + 1);
+  }
+  ASSERT_EQ(CountMatches(table, num_keys), 0);
+  ASSERT_EQ(CountMatches(table, -1), 0);
+
+  // A null key does not even match itself.
+  auto hash = null_key.Hash();
+  const auto &leaf = table.GetLeaf(hash);
+  auto pos = leaf.StartSlot(hash);
+  ASSERT_FALSE(leaf.NextMatch(hash, null_key, &pos).has_value());
+}
+
+// NOLINTNEXTLINE
+TEST(JoinHashTableTest, DISABLED_SpillTest) {
+  Schema schema({Column{"key", TypeId::INTEGER}, Column{"payload", TypeId::INTEGER}});
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(64, disk_manager.get());
+  // Small enough that the partitions spill, and most of them again when they are reloaded one level down.
+  const size_t memory_limit = 64 * 1024;
+  auto table = std::make_unique<JoinHashTable>(bpm.get(), &schema, memory_limit);
+
+  const int32_t num_keys = 100000;
+  size_t num_rows = 0;
+  for (int32_t i = 0; i < num_keys; i++) {
+    for (int32_t copy = 0; copy < i % 3 + 1; copy++, num_rows++) {
+      std::vector<Value> values{ValueFactory::GetIntegerValue(i), ValueFactory::GetIntegerValue(copy)};
+      HashJoinKey key{{values[0]}};
+      auto hash = key.Hash();
+      table->Insert(Tuple{values, &schema}, std::move(key), hash);
+    }
+  }
+  table->Finalize();
+  ASSERT_FALSE(table->GetSpilledPartitions().empty());
+  ASSERT_LT(table->NumRows(), num_rows);
+
+  // Every row comes back from the spill files, and the reloaded partitions are split by the next bits of the hash.
+  auto reloaded = Reload(bpm.get(), &schema, memory_limit, std::move(table));
+  uint32_t max_level = 0;
+  ASSERT_EQ(CountReloadedRows(*reloaded, &max_level), num_rows);
+  ASSERT_GE(max_level, 2);
+  for (int32_t i = 0; i < num_keys; i += 7) {
+    ASSERT_EQ(CountReloadedMatches(*reloaded, i), i % 3 + 1) << i;
+  }
+  ASSERT_EQ(CountReloadedMatches(*reloaded, num_keys), 0);
+}
+
+// NOLINTNEXTLINE
+TEST(JoinHashTableTest, DISABLED_SpillJoinTest) {
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(64, disk_manager.get());
+  for (auto join_type : {JoinType::INNER, JoinType::LEFT, JoinType::OUTER}) {
+    // Both the build rows and the probe rows of the spilled partitions go through spill files.
+    auto in_memory = RunHashJoin(nullptr, 0, join_type);
+    auto spilled = RunHashJoin(bpm.get(), 16 * 1024, join_type);
+    ASSERT_EQ(in_memory.size(), join_type == JoinType::INNER ? 10000 : 19900);
+    ASSERT_EQ(spilled, in_memory);
+  }
+}
+
+}  // namespace bustub
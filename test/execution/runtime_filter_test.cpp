@@ -0,0 +1,287 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// runtime_filter_test.cpp
+//
+// Identification: test/execution/runtime_filter_test.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "catalog/catalog.h"
+#include "execution/executor_context.h"
+#include "execution/executors/hash_join_executor.h"
+#include "execution/executors/init_check_executor.h"
+#include "execution/executors/seq_scan_executor.h"
+#include "execution/expressions/column_value_expression.h"
+#include "execution/plans/filter_plan.h"
+#include "execution/plans/hash_join_plan.h"
+#include "execution/plans/mock_scan_plan.h"
+#include "execution/plans/nested_loop_join_plan.h"
+#include "execution/plans/projection_plan.h"
+#include "execution/plans/seq_scan_plan.h"
+#include "execution/runtime_filter.h"
+#include "gtest/gtest.h"
+#include "storage/disk/disk_manager_memory.h"
+#include "type/value_factory.h"
+
+namespace bustub {
+
+namespace {
+
+auto Col(uint32_t idx) -> AbstractExpressionRef {
+  return std::make_shared<ColumnValueExpression>(0, idx, TypeId::INTEGER);
+}
+
+auto IntSchema(size_t num_columns) -> SchemaRef {
+  std::vector<Column> columns;
+  for (size_t i = 0; i < num_columns; i++) {
+    columns.emplace_back("c" + std::to_string(i), TypeId::INTEGER);
+  }
+  return std::make_shared<Schema>(columns);
+}
+
+auto HashOf(int32_t value) -> hash_t { return RuntimeFilter::HashKey({ValueFactory::GetIntegerValue(value)}); }
+
+}  // namespace
+
+// NOLINTNEXTLINE
+TEST(RuntimeFilterTest, BloomFilterTest) {
+  BloomFilter filter(10000);
+  for (int32_t i = 0; i < 10000; i++) {
+    filter.Insert(HashOf(i * 2));
+  }
+  // No false negatives, and few false positives.
+  size_t false_positives = 0;
+  for (int32_t i = 0; i < 10000; i++) {
+    ASSERT_TRUE(filter.MayContain(HashOf(i * 2)));
+    false_positives += filter.MayContain(HashOf(i * 2 + 1)) ? 1 : 0;
+  }
+  EXPECT_LT(false_positives, 100);
+  EXPECT_EQ(filter.GetSize(), 32768);
+
+  BloomFilter empty(0);
+  EXPECT_FALSE(empty.MayContain(HashOf(1)));
+
+  // Equal keys of different integer types have the same hash, unlike unequal keys.
+  EXPECT_EQ(RuntimeFilter::HashKey({ValueFactory::GetBigIntValue(7), ValueFactory::GetVarcharValue("a")}),
+            RuntimeFilter::HashKey({ValueFactory::GetSmallIntValue(7), ValueFactory::GetVarcharValue("a")}));
+  EXPECT_NE(RuntimeFilter::HashKey({ValueFactory::GetIntegerValue(7), ValueFactory::GetVarcharValue("a")}),
+            RuntimeFilter::HashKey({ValueFactory::GetIntegerValue(7), ValueFactory::GetVarcharValue("b")}));
+  EXPECT_EQ(RuntimeFilter::HashKey({ValueFactory::GetDecimalValue(0.0)}),
+            RuntimeFilter::HashKey({ValueFactory::GetDecimalValue(-0.0)}));
+}
+
+// NOLINTNEXTLINE
+TEST(RuntimeFilterTest, FindTargetTest) {
+  auto scan = std::make_shared<SeqScanPlanNode>(IntSchema(3), 0, "t");
+  auto filter = std::make_shared<FilterPlanNode>(IntSchema(3), Col(0), scan);
+  // The projection swaps the first two columns and computes nothing else.
+  auto projection = std::make_shared<ProjectionPlanNode>(IntSchema(2), std::vector{Col(1), Col(0)}, filter);
+
+  auto target = RuntimeFilter::FindTarget(*projection, {Col(1)});
+  ASSERT_TRUE(target.has_value());
+  EXPECT_EQ(target->scan_, scan.get());
+  EXPECT_EQ(target->columns_, std::vector<uint32_t>({0}));
+
+  // Through an inner join, to either side.
+  auto other = std::make_shared<SeqScanPlanNode>(IntSchema(2), 1, "u");
+  auto join = std::make_shared<HashJoinPlanNode>(IntSchema(4), projection, other, std::vector{Col(0)},
+                                                 std::vector{Col(0)}, JoinType::INNER);
+  target = RuntimeFilter::FindTarget(*join, {Col(0), Col(1)});
+  ASSERT_TRUE(target.has_value());
+  EXPECT_EQ(target->scan_, scan.get());
+  EXPECT_EQ(target->columns_, std::vector<uint32_t>({1, 0}));
+  target = RuntimeFilter::FindTarget(*join, {Col(3)});
+  ASSERT_TRUE(target.has_value());
+  EXPECT_EQ(target->scan_, other.get());
+  EXPECT_EQ(target->columns_, std::vector<uint32_t>({1}));
+
+  // Keys from both sides of a join, from a left join, or from anything but a sequential scan have no target.
+  EXPECT_FALSE(RuntimeFilter::FindTarget(*join, {Col(0), Col(2)}).has_value());
+  auto left_join = std::make_shared<HashJoinPlanNode>(IntSchema(4), projection, other, std::vector{Col(0)},
+                                                      std::vector{Col(0)}, JoinType::LEFT);
+  EXPECT_FALSE(RuntimeFilter::FindTarget(*left_join, {Col(3)}).has_value());
+  auto mock = std::make_shared<MockScanPlanNode>(IntSchema(2), "__mock_table_1");
+  EXPECT_FALSE(RuntimeFilter::FindTarget(*mock, {Col(0)}).has_value());
+}
+
+// NOLINTNEXTLINE
+TEST(RuntimeFilterTest, FilterTest) {
+  auto schema = IntSchema(2);
+  std::vector<hash_t> hashes;
+  for (int32_t i = 0; i < 100; i += 10) {
+    hashes.push_back(HashOf(i));
+  }
+  RuntimeFilter filter({1}, hashes);
+
+  TupleBatch batch;
+  batch.Reset(schema.get());
+  for (int32_t i = 0; i < 100; i++) {
+    auto key = i == 50 ? ValueFactory::GetNullValueByType(TypeId::INTEGER) : ValueFactory::GetIntegerValue(i);
+    batch.AppendValues({ValueFactory::GetIntegerValue(-i), key});
+  }
+  filter.Filter(&batch);
+  // Every row with a key of the build side is kept, the null key is not, and few others get through.
+  std::vector<int32_t> kept;
+  for (uint32_t i = 0; i < batch.Size(); i++) {
+    kept.push_back(batch.GetValue(i, 1).GetAs<int32_t>());
+  }
+  for (int32_t i = 0; i < 100; i += 10) {
+    if (i != 50) {
+      EXPECT_NE(std::find(kept.begin(), kept.end(), i), kept.end()) << i;
+    }
+  }
+  EXPECT_EQ(std::find(kept.begin(), kept.end(), 50), kept.end());
+  EXPECT_LT(kept.size(), 15);
+
+  Tuple tuple{{ValueFactory::GetIntegerValue(0), ValueFactory::GetIntegerValue(20)}, schema.get()};
+  EXPECT_TRUE(filter.MayMatch(tuple, *schema));
+  Tuple null_key{{ValueFactory::GetIntegerValue(0), ValueFactory::GetNullValueByType(TypeId::INTEGER)}, schema.get()};
+  EXPECT_FALSE(filter.MayMatch(null_key, *schema));
+}
+
+// NOLINTNEXTLINE
+TEST(RuntimeFilterTest, TopNBoundTest) {
+  auto schema = IntSchema(2);
+  auto scan = std::make_shared<SeqScanPlanNode>(schema, 0, "t");
+  RuntimeFilterRegistry registry;
+  auto ascending = std::make_shared<TopNBound>(1, false);
+  auto descending = std::make_shared<TopNBound>(0, true);
+  registry.PublishBound(scan.get(), scan.get(), ascending);
+  EXPECT_EQ(registry.GetBounds(scan.get()).size(), 1);
+
+  // There is no bound until the TopN holds N rows, and a null key bounds nothing.
+  ScanPredicate predicate;
+  ascending->AddTo(*schema, &predicate);
+  EXPECT_TRUE(predicate.Empty());
+  ascending->Tighten(ValueFactory::GetNullValueByType(TypeId::INTEGER));
+  EXPECT_EQ(ascending->GetVersion(), 0);
+
+  ascending->Tighten(ValueFactory::GetIntegerValue(50));
+  auto version = ascending->GetVersion();
+  EXPECT_GT(version, 0);
+  ascending->Tighten(ValueFactory::GetIntegerValue(20));
+  EXPECT_GT(ascending->GetVersion(), version);
+  descending->Tighten(ValueFactory::GetIntegerValue(7));
+  ascending->AddTo(*schema, &predicate);
+  descending->AddTo(*schema, &predicate);
+  // Nulls sort first in ascending order, so they may still make it into the TopN.
+  EXPECT_EQ(predicate.ToString(), "(#0.1<=20 OR #0.1 IS NULL) AND #0.0>=7");
+}
+
+// NOLINTNEXTLINE
+TEST(RuntimeFilterTest, DISABLED_SeqScanBoundTest) {
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(32, disk_manager.get());
+  Catalog catalog(bpm.get(), nullptr, nullptr);
+  auto schema = IntSchema(2);
+  auto *table_info = catalog.CreateTable(nullptr, "t", *schema);
+  for (int32_t i = 0; i < 1000; i++) {
+    // The keys come in descending order, so the bound keeps tightening during the scan.
+    Tuple tuple{{ValueFactory::GetIntegerValue(999 - i), ValueFactory::GetIntegerValue(i)}, schema.get()};
+    table_info->table_->InsertTuple(TupleMeta{INVALID_TXN_ID, INVALID_TXN_ID, false}, tuple);
+  }
+
+  auto scan = std::make_shared<SeqScanPlanNode>(schema, table_info->oid_, "t");
+  ExecutorContext exec_ctx(nullptr, &catalog, bpm.get(), nullptr, nullptr, false);
+  exec_ctx.SetRuntimeFilters(std::make_shared<RuntimeFilterRegistry>());
+  auto bound = std::make_shared<TopNBound>(0, false);
+  exec_ctx.GetRuntimeFilters()->PublishBound(scan.get(), scan.get(), bound);
+
+  // The tuple at a time path applies the bound as it tightens, like the batch path does.
+  SeqScanExecutor executor(&exec_ctx, scan.get());
+  executor.Init();
+  Tuple tuple;
+  RID rid;
+  size_t num_tuples = 0;
+  while (executor.Next(&tuple, &rid)) {
+    EXPECT_TRUE(num_tuples < 500 || tuple.GetValue(schema.get(), 0).GetAs<int32_t>() <= 100);
+    num_tuples++;
+    if (num_tuples == 500) {
+      bound->Tighten(ValueFactory::GetIntegerValue(100));
+    }
+  }
+  // The first 500 tuples are 999 down to 500, and of the rest only 100 down to 0 pass.
+  EXPECT_EQ(num_tuples, 601);
+
+  bound->Tighten(ValueFactory::GetIntegerValue(9));
+  executor.Init();
+  num_tuples = 0;
+  while (executor.Next(&tuple, &rid)) {
+    EXPECT_LE(tuple.GetValue(schema.get(), 0).GetAs<int32_t>(), 9);
+    num_tuples++;
+  }
+  EXPECT_EQ(num_tuples, 10);
+}
+
+// NOLINTNEXTLINE
+TEST(RuntimeFilterTest, DISABLED_StarJoinTest) {
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(32, disk_manager.get());
+  Catalog catalog(bpm.get(), nullptr, nullptr);
+  auto insert = [&](TableInfo *table_info, std::vector<Value> values) {
+    Tuple tuple{std::move(values), &table_info->schema_};
+    table_info->table_->InsertTuple(TupleMeta{INVALID_TXN_ID, INVALID_TXN_ID, false}, tuple);
+  };
+  // The fact table references both dimensions, which hold only a few of its keys.
+  auto *fact = catalog.CreateTable(nullptr, "fact", *IntSchema(2));
+  for (int32_t i = 0; i < 10000; i++) {
+    insert(fact, {ValueFactory::GetIntegerValue(i % 100), ValueFactory::GetIntegerValue(i % 50)});
+  }
+  auto *dim1 = catalog.CreateTable(nullptr, "dim1", *IntSchema(1));
+  for (int32_t i = 0; i < 10; i++) {
+    insert(dim1, {ValueFactory::GetIntegerValue(i)});
+  }
+  auto *dim2 = catalog.CreateTable(nullptr, "dim2", *IntSchema(1));
+  for (int32_t i = 0; i < 50; i += 2) {
+    insert(dim2, {ValueFactory::GetIntegerValue(i)});
+  }
+
+  // fact join dim1 on fact.c0 = dim1.c0 join dim2 on fact.c1 = dim2.c0, with the fact table on the probe side of both.
+  auto fact_scan = std::make_shared<SeqScanPlanNode>(IntSchema(2), fact->oid_, "fact");
+  auto dim1_scan = std::make_shared<SeqScanPlanNode>(IntSchema(1), dim1->oid_, "dim1");
+  auto dim2_scan = std::make_shared<SeqScanPlanNode>(IntSchema(1), dim2->oid_, "dim2");
+  auto join1 = std::make_shared<HashJoinPlanNode>(
+      std::make_shared<Schema>(NestedLoopJoinPlanNode::InferJoinSchema(*fact_scan, *dim1_scan)), fact_scan, dim1_scan,
+      std::vector{Col(0)}, std::vector{Col(0)}, JoinType::INNER);
+  auto join2 = std::make_shared<HashJoinPlanNode>(
+      std::make_shared<Schema>(NestedLoopJoinPlanNode::InferJoinSchema(*join1, *dim2_scan)), join1, dim2_scan,
+      std::vector{Col(1)}, std::vector{Col(0)}, JoinType::INNER);
+
+  ExecutorContext exec_ctx(nullptr, &catalog, bpm.get(), nullptr, nullptr, false);
+  exec_ctx.SetRuntimeFilters(std::make_shared<RuntimeFilterRegistry>());
+  auto counted_fact_scan = std::make_unique<InitCheckExecutor>(
+      &exec_ctx, fact_scan, std::make_unique<SeqScanExecutor>(&exec_ctx, fact_scan.get()));
+  const auto *fact_rows = counted_fact_scan.get();
+  auto dim1_executor = std::make_unique<SeqScanExecutor>(&exec_ctx, dim1_scan.get());
+  auto join1_executor = std::make_unique<HashJoinExecutor>(&exec_ctx, join1.get(), std::move(counted_fact_scan),
+                                                           std::move(dim1_executor));
+  HashJoinExecutor join2_executor(&exec_ctx, join2.get(), std::move(join1_executor),
+                                  std::make_unique<SeqScanExecutor>(&exec_ctx, dim2_scan.get()));
+  join2_executor.Init();
+  size_t num_rows = 0;
+  Tuple tuple;
+  RID rid;
+  while (join2_executor.Next(&tuple, &rid)) {
+    auto k1 = tuple.GetValue(&join2->OutputSchema(), 0).GetAs<int32_t>();
+    auto k2 = tuple.GetValue(&join2->OutputSchema(), 1).GetAs<int32_t>();
+    EXPECT_TRUE(k1 < 10 && k2 % 2 == 0) << k1 << " " << k2;
+    num_rows++;
+  }
+  // The rows with k1 in 0, 2, 4, 6, 8 match both dimensions.
+  EXPECT_EQ(num_rows, 500);
+
+  // Both joins pushed a filter into the fact scan, which drops most rows that would not have matched.
+  EXPECT_EQ(exec_ctx.GetRuntimeFilters()->Get(fact_scan.get()).size(), 2);
+  EXPECT_GE(fact_rows->GetNextCount(), 500);
+  EXPECT_LT(fact_rows->GetNextCount(), 1000);
+}
+
+}  // namespace bustub
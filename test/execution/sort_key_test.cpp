@@ -0,0 +1,206 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// sort_key_test.cpp
+//
+// Identification: test/execution/sort_key_test.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <memory>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "execution/executor_context.h"
+#include "execution/executors/sort_executor.h"
+#include "execution/expressions/column_value_expression.h"
+#include "execution/loser_tree.h"
+#include "execution/plans/mock_scan_plan.h"
+#include "execution/sort_key.h"
+#include "gtest/gtest.h"
+#include "storage/disk/disk_manager_memory.h"
+#include "type/limits.h"
+#include "type/value_factory.h"
+
+namespace bustub {
+
+namespace {
+
+auto Encode(const Value &value, bool descending = false) -> std::string {
+  std::string key;
+  SortKeyEncoder::EncodeValue(value, descending, &key);
+  return key;
+}
+
+/** Check that the keys of values sorted in ascending order are in the same order, and in reverse for DESC. */
+void ExpectOrdered(const std::vector<Value> &values) {
+  for (size_t i = 1; i < values.size(); i++) {
+    EXPECT_LT(Encode(values[i - 1]), Encode(values[i])) << i;
+    EXPECT_GT(Encode(values[i - 1], true), Encode(values[i], true)) << i;
+  }
+}
+
+/** Produces the rows of a vector, one at a time. */
+class RowsExecutor : public AbstractExecutor {
+ public:
+  RowsExecutor(ExecutorContext *exec_ctx, const Schema *schema, const std::vector<Tuple> *rows)
+      : AbstractExecutor(exec_ctx), schema_(schema), rows_(rows) {}
+
+  void Init() override { next_ = 0; }
+
+  auto Next(Tuple *tuple, RID *rid) -> bool override {
+    if (next_ == rows_->size()) {
+      return false;
+    }
+    *tuple = (*rows_)[next_++];
+    return true;
+  }
+
+  auto GetOutputSchema() const -> const Schema & override { return *schema_; }
+
+ private:
+  const Schema *schema_;
+  const std::vector<Tuple> *rows_;
+  size_t next_{0};
+};
+
+/** @return the rows sorted by a SortExecutor with a sort memory budget, and a buffer pool to spill to if not null */
+auto RunSort(BufferPoolManager *bpm, size_t budget, const SortPlanNode &plan, const std::vector<Tuple> &rows)
+    -> std::vector<Tuple> {
+  ExecutorContext exec_ctx(nullptr, nullptr, bpm, nullptr, nullptr, false);
+  exec_ctx.SetSortMemoryBudget(budget);
+  SortExecutor executor(&exec_ctx, &plan, std::make_unique<RowsExecutor>(&exec_ctx, &plan.OutputSchema(), &rows));
+  executor.Init();
+  std::vector<Tuple> sorted;
+  Tuple tuple;
+  RID rid;
+  while (executor.Next(&tuple, &rid)) {
+    sorted.push_back(tuple);
+  }
+  return sorted;
+}
+
+}  // namespace
+
+// NOLINTNEXTLINE
+TEST(SortKeyTest, EncodeValueTest) {
+  ExpectOrdered({ValueFactory::GetNullValueByType(TypeId::INTEGER), ValueFactory::GetIntegerValue(BUSTUB_INT32_MIN),
+                 ValueFactory::GetIntegerValue(-256), ValueFactory::GetIntegerValue(-1),
+                 ValueFactory::GetIntegerValue(0), ValueFactory::GetIntegerValue(1), ValueFactory::GetIntegerValue(255),
+                 ValueFactory::GetIntegerValue(256), ValueFactory::GetIntegerValue(BUSTUB_INT32_MAX)});
+  ExpectOrdered({ValueFactory::GetBigIntValue(-(1LL << 40)), ValueFactory::GetBigIntValue(-3),
+                 ValueFactory::GetBigIntValue(7), ValueFactory::GetBigIntValue(1LL << 40)});
+  ExpectOrdered({ValueFactory::GetNullValueByType(TypeId::DECIMAL), ValueFactory::GetDecimalValue(-1e10),
+                 ValueFactory::GetDecimalValue(-2.5), ValueFactory::GetDecimalValue(-0.5),
+                 ValueFactory::GetDecimalValue(0), ValueFactory::GetDecimalValue(0.25),
+                 ValueFactory::GetDecimalValue(3), ValueFactory::GetDecimalValue(1e10)});
+  ExpectOrdered({ValueFactory::GetNullValueByType(TypeId::VARCHAR), ValueFactory::GetVarcharValue(""),
+                 ValueFactory::GetVarcharValue("a"), ValueFactory::GetVarcharValue(std::string("a\0", 2)),
+                 ValueFactory::GetVarcharValue("ab"), ValueFactory::GetVarcharValue("b"),
+                 ValueFactory::GetVarcharValue("\xff")});
+  ExpectOrdered({ValueFactory::GetBooleanValue(false), ValueFactory::GetBooleanValue(true)});
+
+  // Keys of several columns compare column by column, as the encoding of each value is prefix-free.
+  std::string ab;
+  SortKeyEncoder::EncodeValue(ValueFactory::GetVarcharValue("a"), false, &ab);
+  SortKeyEncoder::EncodeValue(ValueFactory::GetVarcharValue("b"), false, &ab);
+  std::string a_z;
+  SortKeyEncoder::EncodeValue(ValueFactory::GetVarcharValue(std::string("a\0z", 3)), false, &a_z);
+  SortKeyEncoder::EncodeValue(ValueFactory::GetVarcharValue(""), false, &a_z);
+  EXPECT_LT(ab, a_z);
+}
+
+// NOLINTNEXTLINE
+TEST(SortKeyTest, LoserTreeMergeTest) {
+  std::mt19937 generator(42);
+  for (size_t num_runs : {1, 2, 3, 5, 8, 13}) {
+    std::vector<std::vector<int>> runs(num_runs);
+    std::vector<int> expected;
+    for (auto &run : runs) {
+      run.resize(generator() % 50);
+      for (auto &x : run) {
+        x = static_cast<int>(generator() % 100);
+      }
+      std::sort(run.begin(), run.end());
+      expected.insert(expected.end(), run.begin(), run.end());
+    }
+    std::sort(expected.begin(), expected.end());
+
+    std::vector<size_t> pos(num_runs, 0);
+    auto less = [&](size_t a, size_t b) {
+      bool done_a = pos[a] == runs[a].size();
+      bool done_b = pos[b] == runs[b].size();
+      if (done_a || done_b) {
+        return !done_a && done_b;
+      }
+      return runs[a][pos[a]] < runs[b][pos[b]] || (runs[a][pos[a]] == runs[b][pos[b]] && a < b);
+    };
+    LoserTree<decltype(less)> tree(num_runs, less);
+    std::vector<int> merged;
+    while (pos[tree.Winner()] < runs[tree.Winner()].size()) {
+      auto winner = tree.Winner();
+      merged.push_back(runs[winner][pos[winner]++]);
+      tree.Replay(winner);
+    }
+    ASSERT_EQ(merged, expected) << num_runs;
+  }
+}
+
+// NOLINTNEXTLINE
+TEST(SortKeyTest, DISABLED_ExternalSortTest) {
+  auto schema = std::make_shared<Schema>(std::vector{Column{"a", TypeId::INTEGER}, Column{"b", TypeId::VARCHAR, 16},
+                                                     Column{"seq", TypeId::INTEGER}});
+  // Few distinct keys, so that many rows tie on both order bys, and some nulls.
+  std::vector<Tuple> rows;
+  for (int32_t i = 0; i < 6000; i++) {
+    auto a =
+        i % 7 == 0 ? ValueFactory::GetNullValueByType(TypeId::INTEGER) : ValueFactory::GetIntegerValue(i * 37 % 50);
+    rows.emplace_back(std::vector{a, ValueFactory::GetVarcharValue("v" + std::to_string(i % 13)),
+                                  ValueFactory::GetIntegerValue(i)},
+                      schema.get());
+  }
+  // The rows come from a RowsExecutor, the child plan only gives the sort plan its shape.
+  auto child = std::make_shared<MockScanPlanNode>(schema, "rows");
+  SortPlanNode plan(schema, child,
+                    {{OrderByType::DESC, std::make_shared<ColumnValueExpression>(0, 0, TypeId::INTEGER)},
+                     {OrderByType::ASC, std::make_shared<ColumnValueExpression>(0, 1, TypeId::VARCHAR)}});
+
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(32, disk_manager.get());
+  auto in_memory = RunSort(nullptr, 0, plan, rows);
+  // A budget of 3 pages: the rows make dozens of runs, which are merged 3 at a time in several passes.
+  auto spilled = RunSort(bpm.get(), 3 * BUSTUB_PAGE_SIZE, plan, rows);
+  ASSERT_EQ(in_memory.size(), rows.size());
+  ASSERT_EQ(spilled.size(), rows.size());
+
+  auto same = [](const Value &a, const Value &b) {
+    return a.IsNull() ? b.IsNull() : !b.IsNull() && a.CompareEquals(b) == CmpBool::CmpTrue;
+  };
+  for (size_t i = 0; i < rows.size(); i++) {
+    ASSERT_EQ(spilled[i].ToString(schema.get()), in_memory[i].ToString(schema.get())) << i;
+    if (i == 0) {
+      continue;
+    }
+    // Nulls sort last in descending order, and ties keep the order of the input.
+    auto prev_a = spilled[i - 1].GetValue(schema.get(), 0);
+    auto a = spilled[i].GetValue(schema.get(), 0);
+    ASSERT_TRUE(a.IsNull() || (!prev_a.IsNull() && prev_a.CompareGreaterThanEquals(a) == CmpBool::CmpTrue)) << i;
+    if (same(prev_a, a)) {
+      auto prev_b = spilled[i - 1].GetValue(schema.get(), 1);
+      auto b = spilled[i].GetValue(schema.get(), 1);
+      ASSERT_EQ(prev_b.CompareLessThanEquals(b), CmpBool::CmpTrue) << i;
+      if (same(prev_b, b)) {
+        ASSERT_LT(spilled[i - 1].GetValue(schema.get(), 2).GetAs<int32_t>(),
+                  spilled[i].GetValue(schema.get(), 2).GetAs<int32_t>())
+            << i;
+      }
+    }
+  }
+}
+
+}  // namespace bustub
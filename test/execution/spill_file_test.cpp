@@ -0,0 +1,121 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// spill_file_test.cpp
+//
+// Identification: test/execution/spill_file_test.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "execution/spill_file.h"
+#include "gtest/gtest.h"
+#include "storage/disk/disk_manager_memory.h"
+#include "type/value_factory.h"
+
+namespace bustub {
+
+namespace {
+
+auto RowSchema() -> Schema {
+  return Schema({Column{"id", TypeId::INTEGER}, Column{"name", TypeId::VARCHAR, 4 * BUSTUB_PAGE_SIZE}});
+}
+
+/** Rows of a few bytes, with a row over one page, over three pages, and of almost one page in between. */
+auto NameSizes() -> std::vector<size_t> {
+  return {10, BUSTUB_PAGE_SIZE + 100, 10, 10, 3 * BUSTUB_PAGE_SIZE, BUSTUB_PAGE_SIZE - 100, 10, 2 * BUSTUB_PAGE_SIZE};
+}
+
+auto Name(int32_t id, size_t size) -> std::string {
+  std::string name(size, 'a' + id % 26);
+  name.replace(0, std::to_string(id).size(), std::to_string(id));
+  return name;
+}
+
+}  // namespace
+
+// NOLINTNEXTLINE
+TEST(SpillFileTest, DISABLED_LargeRowTest) {
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(8, disk_manager.get());
+  auto schema = RowSchema();
+  auto sizes = NameSizes();
+
+  SpillFile file(bpm.get(), &schema);
+  for (int32_t id = 0; id < static_cast<int32_t>(sizes.size()); id++) {
+    file.Append({{ValueFactory::GetIntegerValue(id), ValueFactory::GetVarcharValue(Name(id, sizes[id]))}, &schema});
+  }
+  ASSERT_EQ(file.NumRows(), sizes.size());
+
+  SpillFile::Reader reader(&file);
+  Tuple tuple;
+  for (int32_t id = 0; id < static_cast<int32_t>(sizes.size()); id++) {
+    ASSERT_TRUE(reader.Next(&tuple));
+    ASSERT_EQ(tuple.GetValue(&schema, 0).GetAs<int32_t>(), id);
+    ASSERT_EQ(tuple.GetValue(&schema, 1).ToString(), Name(id, sizes[id]));
+  }
+  ASSERT_FALSE(reader.Next(&tuple));
+}
+
+// NOLINTNEXTLINE
+TEST(SpillFileTest, DISABLED_LargeKeyTest) {
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(8, disk_manager.get());
+  auto schema = RowSchema();
+  auto sizes = NameSizes();
+
+  // Both the key and the row may be split, and a key that is not split may end up on another page than its row.
+  SpillFile file(bpm.get(), &schema);
+  for (int32_t id = 0; id < static_cast<int32_t>(sizes.size()); id++) {
+    auto key_size = sizes[(id + 1) % sizes.size()];
+    file.Append({{ValueFactory::GetIntegerValue(id), ValueFactory::GetVarcharValue(Name(id, sizes[id]))}, &schema},
+                Name(id, key_size));
+  }
+
+  SpillFile::Reader reader(&file);
+  Tuple tuple;
+  std::string key;
+  for (int32_t id = 0; id < static_cast<int32_t>(sizes.size()); id++) {
+    ASSERT_TRUE(reader.Next(&tuple, &key));
+    ASSERT_EQ(key, Name(id, sizes[(id + 1) % sizes.size()]));
+    ASSERT_EQ(tuple.GetValue(&schema, 0).GetAs<int32_t>(), id);
+    ASSERT_EQ(tuple.GetValue(&schema, 1).ToString(), Name(id, sizes[id]));
+  }
+  ASSERT_FALSE(reader.Next(&tuple, &key));
+}
+
+// NOLINTNEXTLINE
+TEST(SpillFileTest, DISABLED_LargeRecordTest) {
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(8, disk_manager.get());
+  auto sizes = NameSizes();
+
+  SpillFile file(bpm.get(), nullptr);
+  for (int32_t id = 0; id < static_cast<int32_t>(sizes.size()); id++) {
+    file.AppendRecord(Name(id, sizes[id]));
+  }
+
+  // Two readers at different entries do not disturb each other.
+  SpillFile::Reader first(&file);
+  SpillFile::Reader second(&file);
+  std::string record;
+  ASSERT_TRUE(first.NextRecord(&record));
+  ASSERT_TRUE(first.NextRecord(&record));
+  for (int32_t id = 0; id < static_cast<int32_t>(sizes.size()); id++) {
+    ASSERT_TRUE(second.NextRecord(&record));
+    ASSERT_EQ(record, Name(id, sizes[id]));
+    if (id + 2 < static_cast<int32_t>(sizes.size())) {
+      ASSERT_TRUE(first.NextRecord(&record));
+      ASSERT_EQ(record, Name(id + 2, sizes[id + 2]));
+    }
+  }
+  ASSERT_FALSE(first.NextRecord(&record));
+  ASSERT_FALSE(second.NextRecord(&record));
+}
+
+}  // namespace bustub
@@ -0,0 +1,100 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// tuple_batch_test.cpp
+//
+// Identification: test/execution/tuple_batch_test.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "execution/expressions/arithmetic_expression.h"
+#include "execution/expressions/column_value_expression.h"
+#include "execution/expressions/comparison_expression.h"
+#include "execution/expressions/constant_value_expression.h"
+#include "execution/tuple_batch.h"
+#include "gtest/gtest.h"
+#include "type/value_factory.h"
+
+namespace bustub {
+
+// NOLINTNEXTLINE
+TEST(TupleBatchTest, SelectionTest) {
+  Schema schema({Column{"id", TypeId::INTEGER}, Column{"name", TypeId::VARCHAR, 32}});
+  TupleBatch batch;
+  batch.Reset(&schema);
+  for (int32_t i = 0; i < 10; i++) {
+    std::vector<Value> values{ValueFactory::GetIntegerValue(i), ValueFactory::GetVarcharValue(std::to_string(i))};
+    Tuple tuple{values, &schema};
+    tuple.SetRid(RID(0, i));
+    batch.AppendTuple(std::move(tuple));
+  }
+  ASSERT_EQ(batch.Size(), 10);
+
+  // Keep the rows with id >= 3, then compute id - 3 on them.
+  auto id = std::make_shared<ColumnValueExpression>(0, 0, TypeId::INTEGER);
+  auto three = std::make_shared<ConstantValueExpression>(ValueFactory::GetIntegerValue(3));
+  auto zero = std::make_shared<ConstantValueExpression>(ValueFactory::GetIntegerValue(0));
+  auto minus = std::make_shared<ArithmeticExpression>(id, three, ArithmeticType::Minus);
+  auto pred = std::make_shared<ComparisonExpression>(id, three, ComparisonType::GreaterThanOrEqual);
+
+  std::vector<Value> result;
+  pred->EvaluateBatch(batch, &result);
+  ASSERT_EQ(result.size(), 10);
+  std::vector<uint32_t> selection;
+  for (uint32_t i = 0; i < result.size(); i++) {
+    if (result[i].GetAs<bool>()) {
+      selection.push_back(batch.RowAt(i));
+    }
+  }
+  batch.Select(std::move(selection));
+  ASSERT_EQ(batch.Size(), 7);
+
+  minus->EvaluateBatch(batch, &result);
+  ASSERT_EQ(result.size(), 7);
+  for (uint32_t i = 0; i < batch.Size(); i++) {
+    ASSERT_EQ(result[i].GetAs<int32_t>(), static_cast<int32_t>(i));
+    ASSERT_EQ(batch.GetValue(i, 1).ToString(), std::to_string(i + 3));
+    ASSERT_EQ(batch.GetRid(i), RID(0, i + 3));
+    ASSERT_EQ(batch.GetTuple(i).GetValue(&schema, 0).GetAs<int32_t>(), static_cast<int32_t>(i + 3));
+  }
+
+  // An equality against a constant that no row matches.
+  auto eq = std::make_shared<ComparisonExpression>(id, zero, ComparisonType::Equal);
+  eq->EvaluateBatch(batch, &result);
+  for (const auto &value : result) {
+    ASSERT_FALSE(value.GetAs<bool>());
+  }
+
+  batch.Reset(&schema);
+  ASSERT_TRUE(batch.Empty());
+}
+
+// NOLINTNEXTLINE
+TEST(TupleBatchTest, ColumnsTest) {
+  Schema schema({Column{"a", TypeId::INTEGER}, Column{"b", TypeId::INTEGER}});
+  TupleBatch batch;
+  batch.Reset(&schema);
+  batch.AppendValues({ValueFactory::GetIntegerValue(1), ValueFactory::GetIntegerValue(2)});
+  batch.AppendValues({ValueFactory::GetIntegerValue(3), ValueFactory::GetNullValueByType(TypeId::INTEGER)});
+  ASSERT_EQ(batch.Size(), 2);
+
+  auto a = std::make_shared<ColumnValueExpression>(0, 0, TypeId::INTEGER);
+  auto b = std::make_shared<ColumnValueExpression>(0, 1, TypeId::INTEGER);
+  auto sum = std::make_shared<ArithmeticExpression>(a, b, ArithmeticType::Plus);
+  std::vector<Value> result;
+  sum->EvaluateBatch(batch, &result);
+  ASSERT_EQ(result[0].GetAs<int32_t>(), 3);
+  ASSERT_TRUE(result[1].IsNull());
+
+  auto tuple = batch.GetTuple(1);
+  ASSERT_EQ(tuple.GetValue(&schema, 0).GetAs<int32_t>(), 3);
+  ASSERT_TRUE(tuple.GetValue(&schema, 1).IsNull());
+  ASSERT_FALSE(batch.IsFull());
+}
+
+}  // namespace bustub
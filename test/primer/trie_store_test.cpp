@@ -1,5 +1,8 @@
 #include <fmt/format.h>
+#include <atomic>
+#include <chrono>  // NOLINT
 #include <functional>
+#include <future>  // NOLINT
 #include <memory>
 #include <numeric>
 #include <optional>
@@ -121,4 +124,112 @@ TEST(TrieStoreTest, MixedConcurrentTest) {
   }
 }
 
+TEST(TrieStoreTest, WriteBatchTest) {
+  auto store = TrieStore();
+  store.Put<uint32_t>("removed", 1);
+
+  TrieStore::WriteBatch batch;
+  batch.Put<uint32_t>("a", 1);
+  batch.Put<std::string>("b", "2");
+  batch.Put<uint32_t>("a", 3);
+  batch.Remove("removed");
+  batch.Put<Integer>("c", std::make_unique<uint32_t>(4));
+  ASSERT_EQ(batch.Size(), 5);
+
+  auto snapshot = store.Get<uint32_t>("removed");
+  store.Write(std::move(batch));
+
+  ASSERT_EQ(**store.Get<uint32_t>("a"), 3);
+  ASSERT_EQ(**store.Get<std::string>("b"), "2");
+  ASSERT_EQ(***store.Get<Integer>("c"), 4);
+  ASSERT_EQ(store.Get<uint32_t>("removed"), std::nullopt);
+  ASSERT_EQ(**snapshot, 1);
+}
+
+TEST(TrieStoreTest, ConcurrentWriteBatchTest) {
+  auto store = TrieStore();
+  const int num_writers = 4;
+  const uint32_t rounds = 2000;
+
+  std::vector<std::thread> writers;
+  for (int tid = 0; tid < num_writers; tid++) {
+    writers.emplace_back([&store, tid] {
+      for (uint32_t i = 1; i <= rounds; i++) {
+        TrieStore::WriteBatch batch;
+        batch.Put<uint32_t>(fmt::format("{}-first", tid), i);
+        batch.Put<uint32_t>(fmt::format("{}-second", tid), i);
+        batch.Remove(fmt::format("{}-{}", tid, i - 1));
+        batch.Put<uint32_t>(fmt::format("{}-{}", tid, i), i);
+        store.Write(std::move(batch));
+      }
+    });
+  }
+  for (auto &t : writers) {
+    t.join();
+  }
+
+  for (int tid = 0; tid < num_writers; tid++) {
+    ASSERT_EQ(**store.Get<uint32_t>(fmt::format("{}-first", tid)), rounds);
+    ASSERT_EQ(**store.Get<uint32_t>(fmt::format("{}-second", tid)), rounds);
+    ASSERT_EQ(**store.Get<uint32_t>(fmt::format("{}-{}", tid, rounds)), rounds);
+    ASSERT_EQ(store.Get<uint32_t>(fmt::format("{}-{}", tid, rounds - 1)), std::nullopt);
+  }
+}
+
+TEST(TrieStoreTest, FailedWriteBatchTest) {
+  auto store = TrieStore();
+  store.Put<uint32_t>("kept", 1);
+
+  // A failed batch publishes none of its operations.
+  TrieStore::WriteBatch failing;
+  failing.Put<uint32_t>("kept", 2);
+  failing.Apply([](TrieWriter &) { throw Exception("failed op"); });
+  ASSERT_THROW(store.Write(std::move(failing)), Exception);
+  ASSERT_EQ(**store.Get<uint32_t>("kept"), 1);
+
+  // A batch that fails in a group commit fails only its own writer, and the other batches of the group are committed.
+  std::promise<void> release;
+  auto released = release.get_future().share();
+  std::thread blocker([&] {
+    TrieStore::WriteBatch batch;
+    batch.Apply([released](TrieWriter &) { released.wait(); });
+    store.Write(std::move(batch));
+  });
+  std::vector<std::thread> writers;
+  std::atomic<int> num_failed{0};
+  // One int per writer, as the bits of a std::vector<bool> cannot be written concurrently.
+  std::vector<int> committed(4, 0);
+  for (int tid = 0; tid < 4; tid++) {
+    writers.emplace_back([&, tid] {
+      TrieStore::WriteBatch batch;
+      batch.Put<uint32_t>(fmt::format("{}", tid), tid);
+      if (tid == 0) {
+        batch.Apply([](TrieWriter &) { throw Exception("failed op"); });
+      }
+      try {
+        store.Write(std::move(batch));
+        committed[tid] = 1;
+      } catch (const Exception &) {
+        num_failed++;
+      }
+    });
+  }
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  release.set_value();
+  blocker.join();
+  for (auto &t : writers) {
+    t.join();
+  }
+
+  ASSERT_EQ(num_failed.load(), 1);
+  ASSERT_EQ(committed[0], 0);
+  ASSERT_EQ(store.Get<uint32_t>("0"), std::nullopt);
+  for (int tid = 1; tid < 4; tid++) {
+    ASSERT_EQ(committed[tid], 1) << tid;
+    ASSERT_EQ(**store.Get<uint32_t>(fmt::format("{}", tid)), tid) << tid;
+  }
+  store.Put<uint32_t>("after", 3);
+  ASSERT_EQ(**store.Get<uint32_t>("after"), 3);
+}
+
 }  // namespace bustub
@@ -250,4 +250,121 @@ TEST(TrieTest, PointerStability) {
   ASSERT_EQ(reinterpret_cast<uint64_t>(ptr_before), reinterpret_cast<uint64_t>(ptr_after));
 }
 
+TEST(TrieTest, AdaptiveNodeTest) {
+  auto trie = Trie();
+  std::vector<Trie> snapshots;
+  // Grow the root through every node layout, one child at a time.
+  for (uint32_t i = 0; i < 256; i++) {
+    std::string key = {static_cast<char>(i), 'x'};
+    trie = trie.Put<uint32_t>(key, i);
+    snapshots.push_back(trie);
+  }
+  ASSERT_EQ(snapshots[3].GetRoot()->children_.GetKind(), TrieChildren::Kind::NODE4);
+  ASSERT_EQ(snapshots[15].GetRoot()->children_.GetKind(), TrieChildren::Kind::NODE16);
+  ASSERT_EQ(snapshots[47].GetRoot()->children_.GetKind(), TrieChildren::Kind::NODE48);
+  ASSERT_EQ(snapshots[255].GetRoot()->children_.GetKind(), TrieChildren::Kind::NODE256);
+  for (uint32_t i = 0; i < 256; i++) {
+    std::string key = {static_cast<char>(i), 'x'};
+    ASSERT_EQ(*trie.Get<uint32_t>(key), i);
+    ASSERT_EQ(snapshots[i].Get<uint32_t>(std::string{static_cast<char>(i)}), nullptr);
+    if (i + 1 < 256) {
+      ASSERT_EQ(snapshots[i].Get<uint32_t>(std::string{static_cast<char>(i + 1), 'x'}), nullptr);
+    }
+  }
+
+  // Children are visited in unsigned byte order regardless of the layout.
+  int last = -1;
+  trie.GetRoot()->children_.ForEach([&](char c, const std::shared_ptr<const TrieNode> &child) {
+    ASSERT_LT(last, static_cast<int>(static_cast<uint8_t>(c)));
+    last = static_cast<uint8_t>(c);
+  });
+
+  // Shrink it back down.
+  for (uint32_t i = 0; i < 256; i += 2) {
+    trie = trie.Remove(std::string{static_cast<char>(i), 'x'});
+  }
+  ASSERT_EQ(trie.GetRoot()->children_.GetKind(), TrieChildren::Kind::NODE256);
+  for (uint32_t i = 1; i < 240; i += 2) {
+    trie = trie.Remove(std::string{static_cast<char>(i), 'x'});
+  }
+  ASSERT_EQ(trie.GetRoot()->children_.Size(), 8);
+  ASSERT_EQ(trie.GetRoot()->children_.GetKind(), TrieChildren::Kind::NODE16);
+  for (uint32_t i = 0; i < 256; i++) {
+    std::string key = {static_cast<char>(i), 'x'};
+    if (i % 2 == 1 && i >= 240) {
+      ASSERT_EQ(*trie.Get<uint32_t>(key), i);
+    } else {
+      ASSERT_EQ(trie.Get<uint32_t>(key), nullptr);
+    }
+    ASSERT_EQ(*snapshots[255].Get<uint32_t>(key), i);
+  }
+}
+
+TEST(TrieTest, PathCompressionTest) {
+  auto trie = Trie();
+  trie = trie.Put<uint32_t>("compression", 1);
+  // A single key is stored in a single node.
+  ASSERT_EQ(trie.GetRoot()->prefix_, "compression");
+  ASSERT_TRUE(trie.GetRoot()->children_.Empty());
+
+  // Splitting the path in the middle.
+  trie = trie.Put<uint32_t>("compute", 2);
+  ASSERT_EQ(trie.GetRoot()->prefix_, "comp");
+  ASSERT_EQ(trie.GetRoot()->children_.Size(), 2);
+  ASSERT_EQ((*trie.GetRoot()->children_.Find('r'))->prefix_, "ession");
+  ASSERT_EQ((*trie.GetRoot()->children_.Find('u'))->prefix_, "te");
+
+  // A key that ends inside a compressed path.
+  trie = trie.Put<uint32_t>("com", 3);
+  ASSERT_EQ(*trie.Get<uint32_t>("com"), 3);
+  ASSERT_EQ(trie.Get<uint32_t>("co"), nullptr);
+  ASSERT_EQ(trie.Get<uint32_t>("comp"), nullptr);
+  ASSERT_EQ(trie.Get<uint32_t>("compressio"), nullptr);
+  ASSERT_EQ(trie.Get<uint32_t>("compressions"), nullptr);
+
+  // Removing keys merges the paths back together.
+  trie = trie.Remove("com");
+  trie = trie.Remove("compute");
+  ASSERT_EQ(trie.GetRoot()->prefix_, "compression");
+  ASSERT_EQ(*trie.Get<uint32_t>("compression"), 1);
+  trie = trie.Remove("compression");
+  ASSERT_EQ(trie.GetRoot(), nullptr);
+}
+
+TEST(TrieTest, WriterTest) {
+  auto base = Trie();
+  base = base.Put<uint32_t>("test", 1);
+  base = base.Put<uint32_t>("te", 2);
+
+  TrieWriter writer(base);
+  for (uint32_t i = 0; i < 1000; i++) {
+    writer.Put<uint32_t>(fmt::format("test-{}", i), i);
+  }
+  writer.Put<std::string>("te", "overwritten");
+  writer.Remove("test");
+  writer.Remove("test-999");
+  auto trie = writer.Finish();
+
+  // The base trie is untouched.
+  ASSERT_EQ(*base.Get<uint32_t>("test"), 1);
+  ASSERT_EQ(*base.Get<uint32_t>("te"), 2);
+  ASSERT_EQ(base.Get<uint32_t>("test-0"), nullptr);
+
+  ASSERT_EQ(trie.Get<uint32_t>("test"), nullptr);
+  ASSERT_EQ(*trie.Get<std::string>("te"), "overwritten");
+  for (uint32_t i = 0; i < 999; i++) {
+    ASSERT_EQ(*trie.Get<uint32_t>(fmt::format("test-{}", i)), i);
+  }
+  ASSERT_EQ(trie.Get<uint32_t>("test-999"), nullptr);
+
+  // Writing after `Finish` must not modify the published trie.
+  writer.Remove("test-0");
+  writer.Put<uint32_t>("test-1", 233);
+  auto trie2 = writer.Finish();
+  ASSERT_EQ(*trie.Get<uint32_t>("test-0"), 0);
+  ASSERT_EQ(*trie.Get<uint32_t>("test-1"), 1);
+  ASSERT_EQ(trie2.Get<uint32_t>("test-0"), nullptr);
+  ASSERT_EQ(*trie2.Get<uint32_t>("test-1"), 233);
+}
+
 }  // namespace bustub
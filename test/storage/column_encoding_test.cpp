@@ -0,0 +1,81 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// column_encoding_test.cpp
+//
+// Identification: test/storage/column_encoding_test.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include <random>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "storage/table/column_encoding.h"
+
+namespace bustub {
+
+namespace {
+
+/** Encode the values, and check that they are read back and filtered correctly. */
+void CheckColumn(const std::vector<int64_t> &values, uint32_t width, ColumnEncoding expected) {
+  auto data = EncodedColumn::Encode(values, width);
+  ASSERT_EQ(EncodedColumn::ByteSize(data.data()), data.size());
+  EncodedColumn column(data.data());
+  ASSERT_EQ(column.GetEncoding(), expected);
+  ASSERT_EQ(column.Size(), values.size());
+  for (size_t i = 0; i < values.size(); i++) {
+    ASSERT_EQ(column.Get(i), values[i]) << i;
+  }
+  std::vector<int64_t> decoded;
+  column.Decode(&decoded);
+  ASSERT_EQ(decoded, values);
+
+  auto pivot = values[values.size() / 2];
+  std::vector<uint8_t> keep(values.size(), 1);
+  keep[0] = 0;
+  column.Filter([&](int64_t value) { return value >= pivot; }, keep.data());
+  for (size_t i = 0; i < values.size(); i++) {
+    ASSERT_EQ(keep[i], i > 0 && values[i] >= pivot ? 1 : 0) << i;
+  }
+}
+
+}  // namespace
+
+// NOLINTNEXTLINE
+TEST(ColumnEncodingTest, EncodingTest) {
+  std::mt19937_64 rng(42);
+  std::vector<int64_t> values(1000);
+
+  // Sorted keys with long runs.
+  for (size_t i = 0; i < values.size(); i++) {
+    values[i] = static_cast<int64_t>(i / 100) - 3;
+  }
+  CheckColumn(values, 4, ColumnEncoding::RUN_LENGTH);
+
+  // A few distinct values far apart, including the null of INTEGER.
+  const int64_t entries[] = {INT32_MIN, -7, 1000000, INT32_MAX};
+  for (auto &value : values) {
+    value = entries[rng() % 4];
+  }
+  CheckColumn(values, 4, ColumnEncoding::DICTIONARY);
+
+  // Values close to each other.
+  for (auto &value : values) {
+    value = int64_t{1} << 40 | static_cast<int64_t>(rng() % 5000);
+  }
+  CheckColumn(values, 8, ColumnEncoding::FRAME_OF_REFERENCE);
+
+  // Values over the whole range.
+  for (auto &value : values) {
+    value = static_cast<int16_t>(rng());
+  }
+  CheckColumn(values, 2, ColumnEncoding::PLAIN);
+  for (auto &value : values) {
+    value = static_cast<int64_t>(rng());
+  }
+  CheckColumn(values, 8, ColumnEncoding::PLAIN);
+}
+
+}  // namespace bustub
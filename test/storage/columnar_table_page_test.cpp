@@ -0,0 +1,205 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// columnar_table_page_test.cpp
+//
+// Identification: test/storage/columnar_table_page_test.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "execution/tuple_batch.h"
+#include "gtest/gtest.h"
+#include "storage/page/columnar_table_page.h"
+#include "storage/page/page.h"
+#include "storage/page/table_page.h"
+#include "storage/table/column_chunk.h"
+#include "storage/table/scan_predicate.h"
+#include "type/value_factory.h"
+
+namespace bustub {
+
+namespace {
+
+auto MakeTuple(const Schema &schema, int32_t id) -> Tuple {
+  std::vector<Value> values{ValueFactory::GetIntegerValue(id),
+                            id % 3 == 0 ? ValueFactory::GetNullValueByType(TypeId::VARCHAR)
+                                        : ValueFactory::GetVarcharValue(std::string(id % 7, 'a' + id % 26)),
+                            ValueFactory::GetBigIntValue(int64_t{id} * 1000), ValueFactory::GetDecimalValue(id / 4.0)};
+  return {values, &schema};
+}
+
+/** A row of a table shaped like the line items of TPC-H */
+auto MakeLineItem(const Schema &schema, int64_t i, std::mt19937 *rng) -> Tuple {
+  static const char *modes[] = {"AIR", "FOB", "MAIL", "RAIL", "REG AIR", "SHIP", "TRUCK"};
+  std::vector<Value> values{ValueFactory::GetBigIntValue(i / 4),
+                            ValueFactory::GetIntegerValue(static_cast<int32_t>((*rng)() % 200000)),
+                            ValueFactory::GetDecimalValue(static_cast<double>(1 + (*rng)() % 50)),
+                            ValueFactory::GetIntegerValue(static_cast<int32_t>(8000 + (*rng)() % 2500)),
+                            ValueFactory::GetVarcharValue(std::string(1, "ANR"[(*rng)() % 3])),
+                            ValueFactory::GetVarcharValue(modes[(*rng)() % 7])};
+  return {values, &schema};
+}
+
+}  // namespace
+
+// NOLINTNEXTLINE
+TEST(ColumnarTablePageTest, InsertReadTest) {
+  Schema schema({Column{"id", TypeId::INTEGER}, Column{"name", TypeId::VARCHAR, 16}, Column{"ts", TypeId::BIGINT},
+                 Column{"score", TypeId::DECIMAL}});
+  Page raw_page;
+  auto page = reinterpret_cast<ColumnarTablePage *>(raw_page.GetData());
+  page->Init(schema);
+  ASSERT_EQ(page->GetCapacity(), ColumnarTablePage::Capacity(schema));
+  ASSERT_GT(page->GetCapacity(), 50);
+
+  const TupleMeta live{INVALID_TXN_ID, INVALID_TXN_ID, false};
+  std::vector<Tuple> tuples;
+  while (true) {
+    auto tuple = MakeTuple(schema, tuples.size());
+    auto fits = tuple.GetLength() <= page->GetFreeSpaceRemaining();
+    auto slot = page->InsertTuple(live, tuple, schema);
+    ASSERT_EQ(slot.has_value(), fits);
+    if (!slot.has_value()) {
+      break;
+    }
+    ASSERT_EQ(*slot, tuples.size());
+    tuples.push_back(tuple);
+  }
+  ASSERT_EQ(page->GetNumTuples(), tuples.size());
+
+  // The page chain is walked through the header of TablePage.
+  page->SetNextPageId(42);
+  ASSERT_EQ(reinterpret_cast<const TablePage *>(page)->GetNextPageId(), 42);
+  ASSERT_EQ(reinterpret_cast<const TablePage *>(page)->GetNumTuples(), tuples.size());
+
+  // Tuples are put together byte for byte, and columns are read one at a time.
+  for (uint32_t slot = 0; slot < tuples.size(); slot++) {
+    auto [meta, tuple] = page->GetTuple(RID(0, slot), schema);
+    ASSERT_EQ(std::string(tuple.GetData(), tuple.GetLength()),
+              std::string(tuples[slot].GetData(), tuples[slot].GetLength()));
+    for (uint32_t column = 0; column < schema.GetColumnCount(); column++) {
+      ASSERT_EQ(page->GetValue(slot, column, schema, nullptr).ToString(),
+                tuples[slot].GetValue(&schema, column).ToString())
+          << slot << " " << column;
+    }
+  }
+
+  page->UpdateTupleMeta(TupleMeta{INVALID_TXN_ID, INVALID_TXN_ID, true}, RID(0, 4));
+  ASSERT_EQ(page->GetNumDeletedTuples(), 1);
+  ASSERT_TRUE(page->GetTupleMeta(RID(0, 4)).is_deleted_);
+
+  // An update in place must keep the size of the VARCHAR values.
+  page->UpdateTupleInPlaceUnsafe(live, MakeTuple(schema, 21), RID(0, 0), schema);
+  ASSERT_EQ(page->GetValue(0, 0, schema, nullptr).GetAs<int32_t>(), 21);
+  ASSERT_THROW(page->UpdateTupleInPlaceUnsafe(live, MakeTuple(schema, 1), RID(0, 2), schema), Exception);
+}
+
+// NOLINTNEXTLINE
+TEST(ColumnarTablePageTest, FreezeTest) {
+  Schema schema({Column{"orderkey", TypeId::BIGINT}, Column{"partkey", TypeId::INTEGER},
+                 Column{"quantity", TypeId::DECIMAL}, Column{"shipdate", TypeId::INTEGER},
+                 Column{"returnflag", TypeId::VARCHAR, 1}, Column{"shipmode", TypeId::VARCHAR, 10}});
+  const TupleMeta live{INVALID_TXN_ID, INVALID_TXN_ID, false};
+  std::mt19937 rng(7);
+
+  // Fill a page as it is, and one that is frozen whenever it fills up, as TableHeap does.
+  Page plain_data;
+  auto plain = reinterpret_cast<ColumnarTablePage *>(plain_data.GetData());
+  plain->Init(schema);
+  Page frozen_data;
+  auto frozen = reinterpret_cast<ColumnarTablePage *>(frozen_data.GetData());
+  frozen->Init(schema);
+  std::vector<Tuple> tuples;
+  bool plain_full = false;
+  while (true) {
+    auto tuple = MakeLineItem(schema, tuples.size(), &rng);
+    plain_full = plain_full || !plain->InsertTuple(live, tuple, schema).has_value();
+    auto slot = frozen->InsertTuple(live, tuple, schema);
+    if (!slot.has_value()) {
+      break;
+    }
+    ASSERT_EQ(*slot, tuples.size());
+    tuples.push_back(tuple);
+    if (frozen->GetFreeSpaceRemaining() < tuple.GetLength() && !frozen->Freeze(schema)) {
+      break;
+    }
+  }
+  // The frozen page holds more than twice the tuples of the plain one, which filled up long before it.
+  ASSERT_TRUE(plain_full);
+  ASSERT_GT(frozen->GetNumEncodedTuples(), 0);
+  ASSERT_GT(frozen->GetNumTuples(), 2 * plain->GetNumTuples());
+
+  // Encoded tuples are put together byte for byte, and their meta is kept.
+  frozen->UpdateTupleMeta(TupleMeta{INVALID_TXN_ID, INVALID_TXN_ID, true}, RID(0, 3));
+  frozen->Freeze(schema);
+  ASSERT_TRUE(frozen->GetTupleMeta(RID(0, 3)).is_deleted_);
+  ASSERT_EQ(frozen->GetNumDeletedTuples(), 1);
+  for (uint32_t slot = 0; slot < tuples.size(); slot++) {
+    auto [meta, tuple] = frozen->GetTuple(RID(0, slot), schema);
+    ASSERT_EQ(std::string(tuple.GetData(), tuple.GetLength()),
+              std::string(tuples[slot].GetData(), tuples[slot].GetLength()));
+    for (uint32_t column = 0; column < schema.GetColumnCount(); column++) {
+      ASSERT_EQ(frozen->GetValue(slot, column, schema, nullptr).ToString(),
+                tuples[slot].GetValue(&schema, column).ToString())
+          << slot << " " << column;
+    }
+  }
+  ASSERT_THROW(frozen->UpdateTupleInPlaceUnsafe(live, tuples[0], RID(0, 0), schema), Exception);
+
+  // Predicates are evaluated on the encoded columns, and give the same result as on the plain page.
+  ScanPredicate predicate;
+  predicate.AddTerm(schema, 3, ScanPredicate::Op::LessThan, ValueFactory::GetIntegerValue(9000));
+  predicate.AddTerm(schema, 2, ScanPredicate::Op::GreaterThanOrEqual, ValueFactory::GetIntegerValue(25));
+  predicate.AddTerm(schema, 0, ScanPredicate::Op::NotEqual, ValueFactory::GetBigIntValue(10));
+  std::vector<uint8_t> keep;
+  frozen->Evaluate(predicate, schema, &keep);
+  ASSERT_EQ(keep.size(), tuples.size());
+  for (uint32_t slot = 0; slot < tuples.size(); slot++) {
+    auto expected = tuples[slot].GetValue(&schema, 3).GetAs<int32_t>() < 9000 &&
+                    tuples[slot].GetValue(&schema, 2).GetAs<double>() >= 25 &&
+                    tuples[slot].GetValue(&schema, 0).GetAs<int64_t>() != 10;
+    ASSERT_EQ(keep[slot], expected ? 1 : 0) << slot;
+  }
+}
+
+// NOLINTNEXTLINE
+TEST(ColumnarTablePageTest, ColumnChunkTest) {
+  Schema schema({Column{"id", TypeId::INTEGER}, Column{"name", TypeId::VARCHAR, 16}, Column{"ts", TypeId::BIGINT},
+                 Column{"score", TypeId::DECIMAL}});
+  auto page_data = std::make_unique<Page>();
+  auto page = reinterpret_cast<ColumnarTablePage *>(page_data->GetData());
+  page->Init(schema);
+  const TupleMeta live{INVALID_TXN_ID, INVALID_TXN_ID, false};
+  for (int32_t i = 0; i < 20; i++) {
+    ASSERT_TRUE(page->InsertTuple(live, MakeTuple(schema, i), schema).has_value());
+  }
+
+  // The chunk is a copy, so it outlives the page.
+  auto chunk = std::make_shared<ColumnChunk>(*page, 7, std::vector<uint16_t>{2, 5, 11, 15}, &schema, nullptr);
+  page_data.reset();
+  ASSERT_EQ(chunk->Size(), 4);
+  ASSERT_EQ(chunk->GetRid(2), RID(7, 11));
+  ASSERT_EQ(chunk->GetValue(1, 1).ToString(), "fffff");
+  ASSERT_TRUE(chunk->GetValue(3, 1).IsNull());
+
+  TupleBatch batch;
+  batch.Reset(&schema);
+  batch.AppendChunk(chunk, {0, 1, 2, 3});
+  batch.AppendChunk(chunk, {3});
+  batch.Select({1, 3, 4});
+  ASSERT_EQ(batch.Size(), 3);
+  ASSERT_EQ(batch.GetValue(0, 2).GetAs<int64_t>(), 5000);
+  ASSERT_EQ(batch.GetValue(1, 0).GetAs<int32_t>(), 15);
+  ASSERT_EQ(batch.GetRid(2), RID(7, 15));
+  auto tuple = batch.GetTuple(0);
+  ASSERT_EQ(tuple.GetRid(), RID(7, 5));
+  ASSERT_EQ(tuple.GetValue(&schema, 3).GetAs<double>(), 1.25);
+}
+
+}  // namespace bustub
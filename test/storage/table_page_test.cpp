@@ -0,0 +1,225 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// table_page_test.cpp
+//
+// Identification: test/storage/table_page_test.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "concurrency/transaction_manager.h"
+#include "gtest/gtest.h"
+#include "storage/page/page.h"
+#include "storage/page/table_page.h"
+#include "storage/table/scan_predicate.h"
+#include "type/value_factory.h"
+
+namespace bustub {
+
+namespace {
+
+auto MakeTuple(const Schema &schema, int32_t id, const std::string &payload) -> Tuple {
+  std::vector<Value> values{ValueFactory::GetIntegerValue(id), ValueFactory::GetVarcharValue(payload)};
+  return {values, &schema};
+}
+
+auto GetId(const TablePage *page, const Schema &schema, uint32_t slot) -> int32_t {
+  auto [meta, tuple] = page->GetTuple(RID(0, slot));
+  return tuple.GetValue(&schema, 0).GetAs<int32_t>();
+}
+
+}  // namespace
+
+// NOLINTNEXTLINE
+TEST(TablePageTest, VacuumTest) {
+  Schema schema({Column{"id", TypeId::INTEGER}, Column{"payload", TypeId::VARCHAR, 128}});
+  Page raw_page;
+  auto page = reinterpret_cast<TablePage *>(raw_page.GetData());
+  page->Init();
+
+  // No locks are taken, so the transactions need no lock manager.
+  TransactionManager txn_manager(nullptr);
+  std::unique_ptr<Transaction> committed(txn_manager.Begin());
+  std::unique_ptr<Transaction> running(txn_manager.Begin());
+  txn_manager.Commit(committed.get());
+
+  const TupleMeta live{INVALID_TXN_ID, INVALID_TXN_ID, false};
+  const TupleMeta deleted{INVALID_TXN_ID, INVALID_TXN_ID, true};
+  for (int32_t i = 0; i < 10; i++) {
+    ASSERT_EQ(page->InsertTuple(live, MakeTuple(schema, i, std::string(100, 'a' + i))), i);
+  }
+  for (uint32_t slot : {1, 4, 8, 9}) {
+    page->UpdateTupleMeta({INVALID_TXN_ID, committed->GetTransactionId(), true}, RID(0, slot));
+  }
+  page->UpdateTupleMeta({INVALID_TXN_ID, running->GetTransactionId(), true}, RID(0, 5));
+  auto free_before = page->GetFreeSpaceRemaining();
+
+  // A delete without a transaction id may come from any running transaction, except the one asking.
+  ASSERT_FALSE(txn_manager.IsDeleteFinal(deleted));
+  ASSERT_TRUE(txn_manager.IsDeleteFinal(deleted, running.get()));
+
+  // Slot 5 was deleted by a transaction that may still roll back, so it must keep its data.
+  auto reclaimed = page->Vacuum(0, [&](const TupleMeta &meta) { return txn_manager.IsDeleteFinal(meta); });
+  ASSERT_EQ(reclaimed, 4);
+  ASSERT_EQ(page->GetNumTuples(), 8);
+  ASSERT_EQ(page->GetNumDeletedTuples(), 3);
+  ASSERT_GT(page->GetFreeSpaceRemaining(), free_before);
+
+  // Live tuples keep their slots and their data.
+  for (int32_t i : {0, 2, 3, 6, 7}) {
+    auto [meta, tuple] = page->GetTuple(RID(0, i));
+    ASSERT_FALSE(meta.is_deleted_);
+    ASSERT_EQ(tuple.GetValue(&schema, 0).GetAs<int32_t>(), i);
+    ASSERT_EQ(tuple.GetValue(&schema, 1).ToString(), std::string(100, 'a' + i));
+  }
+  ASSERT_EQ(GetId(page, schema, 5), 5);
+  ASSERT_TRUE(page->GetTupleMeta(RID(0, 1)).is_deleted_);
+
+  // The reclaimed space can be used again.
+  ASSERT_EQ(page->InsertTuple(live, MakeTuple(schema, 42, std::string(100, 'z'))), 8);
+  ASSERT_EQ(GetId(page, schema, 8), 42);
+  ASSERT_EQ(GetId(page, schema, 7), 7);
+
+  // Once every tuple is gone, the page is empty again.
+  for (uint32_t slot = 0; slot < page->GetNumTuples(); slot++) {
+    page->UpdateTupleMeta(deleted, RID(0, slot));
+  }
+  txn_manager.Commit(running.get());
+  ASSERT_TRUE(txn_manager.IsDeleteFinal(deleted));
+  page->Vacuum(0, [&](const TupleMeta &meta) { return txn_manager.IsDeleteFinal(meta); });
+  ASSERT_EQ(page->GetNumTuples(), 0);
+  ASSERT_EQ(page->GetNumDeletedTuples(), 0);
+  ASSERT_EQ(page->GetFreeSpaceRemaining(), BUSTUB_PAGE_SIZE - TABLE_PAGE_HEADER_SIZE - 16);
+}
+
+// NOLINTNEXTLINE
+TEST(TablePageTest, TupleViewTest) {
+  Schema schema({Column{"id", TypeId::INTEGER}, Column{"payload", TypeId::VARCHAR, 128}});
+  Page raw_page;
+  auto page = reinterpret_cast<TablePage *>(raw_page.GetData());
+  page->Init();
+
+  const TupleMeta live{INVALID_TXN_ID, INVALID_TXN_ID, false};
+  for (int32_t i = 0; i < 10; i++) {
+    ASSERT_EQ(page->InsertTuple(live, MakeTuple(schema, i, std::string(i + 1, 'a' + i))), i);
+  }
+  std::vector<Value> values{ValueFactory::GetIntegerValue(10), ValueFactory::GetNullValueByType(TypeId::VARCHAR)};
+  ASSERT_EQ(page->InsertTuple(live, Tuple{values, &schema}), 10);
+
+  for (uint32_t slot = 0; slot < 11; slot++) {
+    auto [meta, view] = page->GetTupleView(RID(0, slot));
+    auto [copy_meta, copy] = page->GetTuple(RID(0, slot));
+    ASSERT_EQ(view.GetRid(), RID(0, slot));
+    ASSERT_EQ(view.GetValue(&schema, 0).GetAs<int32_t>(), static_cast<int32_t>(slot));
+    ASSERT_EQ(view.IsNull(&schema, 1), slot == 10);
+    if (slot < 10) {
+      // The value is read in place.
+      auto payload = view.GetValue(&schema, 1);
+      ASSERT_EQ(payload.ToString(), std::string(slot + 1, 'a' + slot));
+      ASSERT_GE(payload.GetData(), raw_page.GetData());
+      ASSERT_LT(payload.GetData(), raw_page.GetData() + BUSTUB_PAGE_SIZE);
+    }
+
+    // A copy owns its data, which is the same as that of the tuple read by GetTuple.
+    auto owned = view.ToTuple();
+    ASSERT_EQ(owned.GetRid(), RID(0, slot));
+    ASSERT_EQ(std::string(owned.GetData(), owned.GetLength()), std::string(copy.GetData(), copy.GetLength()));
+    ASSERT_NE(owned.GetData(), view.GetData());
+  }
+}
+
+// NOLINTNEXTLINE
+TEST(TablePageTest, ScanPredicateTest) {
+  Schema schema({Column{"a", TypeId::INTEGER}, Column{"payload", TypeId::VARCHAR, 128}, Column{"b", TypeId::BIGINT},
+                 Column{"c", TypeId::DECIMAL}, Column{"d", TypeId::SMALLINT}});
+  Page raw_page;
+  auto page = reinterpret_cast<TablePage *>(raw_page.GetData());
+  page->Init();
+
+  const TupleMeta live{INVALID_TXN_ID, INVALID_TXN_ID, false};
+  std::vector<Tuple> tuples;
+  for (int32_t i = 0; i < 40; i++) {
+    std::vector<Value> values{
+        i % 7 == 0 ? ValueFactory::GetNullValueByType(TypeId::INTEGER) : ValueFactory::GetIntegerValue(i),
+        ValueFactory::GetVarcharValue(std::string(i % 5, 'x')), ValueFactory::GetBigIntValue(-i * 1000000000LL),
+        i % 6 == 0 ? ValueFactory::GetNullValueByType(TypeId::DECIMAL) : ValueFactory::GetDecimalValue(i * 0.5),
+        ValueFactory::GetSmallIntValue(static_cast<int16_t>(i % 4))};
+    tuples.emplace_back(values, &schema);
+    ASSERT_EQ(page->InsertTuple(live, tuples.back()), i);
+  }
+  std::vector<const char *> data;
+  for (uint32_t slot = 0; slot < 40; slot++) {
+    data.push_back(page->GetTupleView(RID(0, slot)).second.GetData());
+  }
+
+  using Op = ScanPredicate::Op;
+  // Check a single term against the comparison of the values read from the copies of the tuples.
+  auto check = [&](uint32_t column, Op op, const Value &constant) {
+    ScanPredicate predicate;
+    predicate.AddTerm(schema, column, op, constant);
+    std::vector<uint8_t> keep;
+    predicate.Evaluate(data, &keep);
+    ASSERT_EQ(keep.size(), tuples.size());
+    for (size_t i = 0; i < tuples.size(); i++) {
+      auto value = tuples[i].GetValue(&schema, column);
+      CmpBool expected = CmpBool::CmpFalse;
+      switch (op) {
+        case Op::Equal:
+          expected = value.CompareEquals(constant);
+          break;
+        case Op::NotEqual:
+          expected = value.CompareNotEquals(constant);
+          break;
+        case Op::LessThan:
+          expected = value.CompareLessThan(constant);
+          break;
+        case Op::LessThanOrEqual:
+          expected = value.CompareLessThanEquals(constant);
+          break;
+        case Op::GreaterThan:
+          expected = value.CompareGreaterThan(constant);
+          break;
+        case Op::GreaterThanOrEqual:
+          expected = value.CompareGreaterThanEquals(constant);
+          break;
+      }
+      ASSERT_EQ(keep[i] != 0, expected == CmpBool::CmpTrue) << predicate.ToString() << " row " << i;
+    }
+  };
+  for (auto op :
+       {Op::Equal, Op::NotEqual, Op::LessThan, Op::LessThanOrEqual, Op::GreaterThan, Op::GreaterThanOrEqual}) {
+    check(0, op, ValueFactory::GetIntegerValue(14));
+    check(0, op, ValueFactory::GetDecimalValue(14.5));
+    check(2, op, ValueFactory::GetBigIntValue(-20000000000LL));
+    check(3, op, ValueFactory::GetDecimalValue(7.5));
+    check(3, op, ValueFactory::GetIntegerValue(7));
+    check(4, op, ValueFactory::GetIntegerValue(2));
+  }
+
+  // Terms are ANDed.
+  ScanPredicate predicate;
+  predicate.AddTerm(schema, 0, Op::GreaterThanOrEqual, ValueFactory::GetIntegerValue(10));
+  predicate.AddTerm(schema, 4, Op::Equal, ValueFactory::GetIntegerValue(1));
+  std::vector<uint8_t> keep;
+  predicate.Evaluate(data, &keep);
+  for (int32_t i = 0; i < 40; i++) {
+    ASSERT_EQ(keep[i] != 0, i >= 10 && i % 7 != 0 && i % 4 == 1) << i;
+  }
+  ASSERT_EQ(predicate.ToString(), "#0.0>=10 AND #0.4=1");
+
+  // A term may also pass nulls.
+  ScanPredicate or_null;
+  or_null.AddTerm(schema, 3, Op::LessThan, ValueFactory::GetDecimalValue(5), true);
+  or_null.Evaluate(data, &keep);
+  for (int32_t i = 0; i < 40; i++) {
+    ASSERT_EQ(keep[i] != 0, i % 6 == 0 || i < 10) << i;
+  }
+  ASSERT_EQ(or_null.ToString(), "(#0.3<5 OR #0.3 IS NULL)");
+}
+
+}  // namespace bustub
@@ -0,0 +1,87 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// zone_map_test.cpp
+//
+// Identification: test/storage/zone_map_test.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "storage/table/tuple.h"
+#include "storage/table/zone_map.h"
+#include "type/value_factory.h"
+
+namespace bustub {
+
+// NOLINTNEXTLINE
+TEST(ZoneMapTest, SkipTest) {
+  Schema schema({Column{"ts", TypeId::BIGINT}, Column{"name", TypeId::VARCHAR, 16}, Column{"score", TypeId::DECIMAL},
+                 Column{"flag", TypeId::INTEGER}});
+  ASSERT_TRUE(ZoneMap::HasSynopses(schema));
+  ASSERT_FALSE(ZoneMap::HasSynopses(Schema({Column{"name", TypeId::VARCHAR, 16}})));
+
+  ZoneMap zones(schema);
+  // Pages 3, 1 and 7 are appended in this order, each with ten rows of increasing ts.
+  std::vector<page_id_t> pages{3, 1, 7};
+  for (size_t p = 0; p < pages.size(); p++) {
+    zones.AddPage(pages[p]);
+    for (int64_t i = 0; i < 10; i++) {
+      auto ts = static_cast<int64_t>(p) * 100 + i;
+      std::vector<Value> values{ValueFactory::GetBigIntValue(ts), ValueFactory::GetVarcharValue("x"),
+                                ValueFactory::GetDecimalValue(static_cast<double>(ts) / 2),
+                                ValueFactory::GetNullValueByType(TypeId::INTEGER)};
+      zones.Update(pages[p], Tuple{values, &schema}.GetData());
+    }
+  }
+  ASSERT_EQ(zones.GetNextPageId(3), 1);
+  ASSERT_EQ(zones.GetNextPageId(1), 7);
+  ASSERT_EQ(zones.GetNextPageId(7), INVALID_PAGE_ID);
+
+  auto synopsis = zones.GetSynopsis(1);
+  ASSERT_TRUE(synopsis.has_value());
+  ASSERT_EQ((*synopsis)[0].min_integer_, 100);
+  ASSERT_EQ((*synopsis)[0].max_integer_, 109);
+  ASSERT_EQ((*synopsis)[2].max_decimal_, 54.5);
+  ASSERT_EQ((*synopsis)[3].num_values_, 0);
+  ASSERT_EQ((*synopsis)[3].num_nulls_, 10);
+  ASSERT_FALSE(zones.GetSynopsis(2).has_value());
+
+  auto may_match = [&](uint32_t column, ScanPredicate::Op op, const Value &constant, bool null_passes = false) {
+    ScanPredicate predicate;
+    predicate.AddTerm(schema, column, op, constant, null_passes);
+    std::vector<page_id_t> matched;
+    for (auto page_id : pages) {
+      if (zones.MayMatch(page_id, predicate)) {
+        matched.push_back(page_id);
+      }
+    }
+    return matched;
+  };
+  using Op = ScanPredicate::Op;
+  using Pages = std::vector<page_id_t>;
+  ASSERT_EQ(may_match(0, Op::GreaterThan, ValueFactory::GetBigIntValue(150)), Pages({7}));
+  ASSERT_EQ(may_match(0, Op::GreaterThanOrEqual, ValueFactory::GetIntegerValue(109)), Pages({1, 7}));
+  ASSERT_EQ(may_match(0, Op::LessThan, ValueFactory::GetIntegerValue(100)), Pages({3}));
+  ASSERT_EQ(may_match(0, Op::Equal, ValueFactory::GetIntegerValue(205)), Pages({7}));
+  ASSERT_EQ(may_match(0, Op::Equal, ValueFactory::GetIntegerValue(50)), Pages());
+  ASSERT_EQ(may_match(0, Op::NotEqual, ValueFactory::GetIntegerValue(50)), Pages({3, 1, 7}));
+  ASSERT_EQ(may_match(0, Op::LessThanOrEqual, ValueFactory::GetDecimalValue(100.5)), Pages({3, 1}));
+  ASSERT_EQ(may_match(2, Op::GreaterThan, ValueFactory::GetIntegerValue(60)), Pages({7}));
+  // A column with only nulls matches nothing.
+  ASSERT_EQ(may_match(3, Op::NotEqual, ValueFactory::GetIntegerValue(0)), Pages());
+  // Unless nulls pass the term.
+  ASSERT_EQ(may_match(3, Op::NotEqual, ValueFactory::GetIntegerValue(0), true), Pages({3, 1, 7}));
+  ASSERT_EQ(may_match(0, Op::LessThan, ValueFactory::GetIntegerValue(100), true), Pages({3}));
+
+  // A reset page has no values until its tuples are added again.
+  zones.ResetPage(1);
+  ASSERT_EQ(may_match(0, Op::NotEqual, ValueFactory::GetIntegerValue(0)), Pages({3, 7}));
+  ASSERT_EQ(zones.GetNextPageId(1), 7);
+}
+
+}  // namespace bustub
@@ -19,8 +19,10 @@
 #include "buffer/buffer_pool_manager.h"
 #include "gtest/gtest.h"
 #include "logging/common.h"
+#include "storage/disk/disk_manager_memory.h"
 #include "storage/table/table_heap.h"
 #include "storage/table/tuple.h"
+#include "type/value_factory.h"
 
 namespace bustub {
 // NOLINTNEXTLINE
@@ -61,4 +63,41 @@ TEST(TupleTest, DISABLED_TableHeapTest) {
   delete disk_manager;
 }
 
+// NOLINTNEXTLINE
+TEST(TupleTest, DISABLED_ToastUpdateTest) {
+  Schema schema{
+      {Column{"id", TypeId::INTEGER}, Column{"a", TypeId::VARCHAR, 8192}, Column{"b", TypeId::VARCHAR, 8192}}};
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(50, disk_manager.get());
+  TableHeap table(bpm.get(), &schema);
+
+  // Both values are too large to stay in the tuple, and `a` does not compress.
+  std::string a(3 * BUSTUB_PAGE_SIZE, 'x');
+  for (size_t i = 0; i < a.size(); i++) {
+    a[i] = static_cast<char>('a' + (i * 7919) % 26);
+  }
+  std::string b(2 * BUSTUB_PAGE_SIZE, 'b');
+  Tuple tuple{{ValueFactory::GetIntegerValue(1), ValueFactory::GetVarcharValue(a), ValueFactory::GetVarcharValue(b)},
+              &schema};
+  auto rid = table.InsertTuple(TupleMeta{INVALID_TXN_ID, INVALID_TXN_ID, false}, tuple);
+  ASSERT_TRUE(rid.has_value());
+
+  // Writing back the stored bytes keeps the pointers to the out-of-line values, which must not be freed.
+  auto [meta, stored] = table.GetTuple(*rid);
+  ASSERT_LE(stored.GetLength(), ToastStore::TOAST_TUPLE_THRESHOLD);
+  table.UpdateTupleInPlaceUnsafe(meta, stored, *rid);
+  auto [meta1, updated] = table.GetTuple(*rid);
+  EXPECT_EQ(updated.GetValue(&schema, 1).ToString(), a);
+  EXPECT_EQ(updated.GetValue(&schema, 2).ToString(), b);
+
+  // A tuple built from values gets new chains, and the ones of the stored tuple are freed.
+  std::string c(2 * BUSTUB_PAGE_SIZE, 'c');
+  Tuple partial{{ValueFactory::GetIntegerValue(1), updated.GetValue(&schema, 1), ValueFactory::GetVarcharValue(c)},
+                &schema};
+  table.UpdateTupleInPlaceUnsafe(meta1, partial, *rid);
+  auto [meta2, replaced] = table.GetTuple(*rid);
+  EXPECT_EQ(replaced.GetValue(&schema, 1).ToString(), a);
+  EXPECT_EQ(replaced.GetValue(&schema, 2).ToString(), c);
+}
+
 }  // namespace bustub
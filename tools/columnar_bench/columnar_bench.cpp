@@ -0,0 +1,127 @@
+#include <algorithm>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "argparse/argparse.hpp"
+#include "fmt/core.h"
+#include "storage/page/columnar_table_page.h"
+#include "storage/page/page.h"
+#include "storage/table/scan_predicate.h"
+#include "type/value_factory.h"
+
+#include <sys/time.h>
+
+auto ClockMs() -> uint64_t {
+  struct timeval tm;
+  gettimeofday(&tm, nullptr);
+  return static_cast<uint64_t>(tm.tv_sec * 1000) + static_cast<uint64_t>(tm.tv_usec / 1000);
+}
+
+namespace bustub {
+
+/** A row of a table shaped like the line items of TPC-H */
+auto MakeLineItem(const Schema &schema, int64_t i, std::mt19937 *rng) -> Tuple {
+  static const char *modes[] = {"AIR", "FOB", "MAIL", "RAIL", "REG AIR", "SHIP", "TRUCK"};
+  std::vector<Value> values{ValueFactory::GetBigIntValue(i / 4),
+                            ValueFactory::GetIntegerValue(static_cast<int32_t>((*rng)() % 200000)),
+                            ValueFactory::GetDecimalValue(static_cast<double>(1 + (*rng)() % 50)),
+                            ValueFactory::GetIntegerValue(static_cast<int32_t>(8000 + (*rng)() % 2500)),
+                            ValueFactory::GetVarcharValue(std::string(1, "ANR"[(*rng)() % 3])),
+                            ValueFactory::GetVarcharValue(modes[(*rng)() % 7])};
+  return {values, &schema};
+}
+
+/** Fill a page with line items, freezing it whenever it fills up if `freeze` is set. */
+void FillPage(ColumnarTablePage *page, const Schema &schema, bool freeze) {
+  const TupleMeta live{INVALID_TXN_ID, INVALID_TXN_ID, false};
+  std::mt19937 rng(15445);
+  page->Init(schema);
+  for (int64_t i = 0;; i++) {
+    auto tuple = MakeLineItem(schema, i, &rng);
+    if (page->InsertTuple(live, tuple, schema).has_value()) {
+      continue;
+    }
+    if (!freeze || !page->Freeze(schema) || !page->InsertTuple(live, tuple, schema).has_value()) {
+      return;
+    }
+  }
+}
+
+/** Evaluate the predicate and read a column of every tuple that passes it, `rounds` times. @return the sum read */
+auto ScanPage(const ColumnarTablePage *page, const Schema &schema, const ScanPredicate &predicate, size_t rounds)
+    -> int64_t {
+  std::vector<uint8_t> keep;
+  int64_t sum = 0;
+  for (size_t round = 0; round < rounds; round++) {
+    page->Evaluate(predicate, schema, &keep);
+    for (uint32_t slot = 0; slot < page->GetNumTuples(); slot++) {
+      sum += keep[slot] != 0 ? page->GetValue(slot, 1, schema, nullptr).GetAs<int32_t>() : 0;
+    }
+  }
+  return sum;
+}
+
+}  // namespace bustub
+
+// NOLINTNEXTLINE
+auto main(int argc, char **argv) -> int {
+  argparse::ArgumentParser program("bustub-columnar-bench");
+  program.add_argument("--rounds").help("scan each page n times");
+
+  try {
+    program.parse_args(argc, argv);
+  } catch (const std::runtime_error &err) {
+    std::cerr << err.what() << std::endl;
+    std::cerr << program;
+    return 1;
+  }
+
+  size_t rounds = 10000;
+  if (program.present("--rounds")) {
+    rounds = std::stoul(program.get("--rounds"));
+  }
+
+  bustub::Schema schema({bustub::Column{"orderkey", bustub::TypeId::BIGINT},
+                         bustub::Column{"partkey", bustub::TypeId::INTEGER},
+                         bustub::Column{"quantity", bustub::TypeId::DECIMAL},
+                         bustub::Column{"shipdate", bustub::TypeId::INTEGER},
+                         bustub::Column{"returnflag", bustub::TypeId::VARCHAR, 1},
+                         bustub::Column{"shipmode", bustub::TypeId::VARCHAR, 10}});
+  bustub::ScanPredicate predicate;
+  predicate.AddTerm(schema, 3, bustub::ScanPredicate::Op::LessThan, bustub::ValueFactory::GetIntegerValue(9000));
+  predicate.AddTerm(schema, 2, bustub::ScanPredicate::Op::GreaterThanOrEqual,
+                    bustub::ValueFactory::GetIntegerValue(25));
+
+  bustub::Page plain_data;
+  auto plain = reinterpret_cast<bustub::ColumnarTablePage *>(plain_data.GetData());
+  bustub::FillPage(plain, schema, false);
+  bustub::Page frozen_data;
+  auto frozen = reinterpret_cast<bustub::ColumnarTablePage *>(frozen_data.GetData());
+  bustub::FillPage(frozen, schema, true);
+
+  fmt::print(stderr, "[info] rounds={}, tuples_per_page: plain={}, frozen={}\n", rounds, plain->GetNumTuples(),
+             frozen->GetNumTuples());
+
+  auto start = ClockMs();
+  auto plain_sum = bustub::ScanPage(plain, schema, predicate, rounds);
+  auto plain_done = ClockMs();
+  auto frozen_sum = bustub::ScanPage(frozen, schema, predicate, rounds);
+  auto end = ClockMs();
+
+  auto tuples_per_second = [rounds](const bustub::ColumnarTablePage *page, uint64_t ms) {
+    return page->GetNumTuples() * rounds / static_cast<double>(std::max<uint64_t>(ms, 1)) * 1000;
+  };
+  fmt::print("<<< BEGIN\n");
+  fmt::print("plain: {} tuples per second\n", tuples_per_second(plain, plain_done - start));
+  fmt::print("frozen: {} tuples per second\n", tuples_per_second(frozen, end - plain_done));
+  fmt::print(">>> END\n");
+
+  // Keep the scans from being optimized away.
+  if (plain_sum == -1 || frozen_sum == -1) {
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,218 @@
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "argparse/argparse.hpp"
+#include "execution/compiled_pipeline.h"
+#include "execution/executor_context.h"
+#include "execution/executors/abstract_executor.h"
+#include "execution/executors/aggregation_executor.h"
+#include "execution/executors/compiled_pipeline_executor.h"
+#include "execution/executors/filter_executor.h"
+#include "execution/executors/projection_executor.h"
+#include "execution/expressions/arithmetic_expression.h"
+#include "execution/expressions/column_value_expression.h"
+#include "execution/expressions/comparison_expression.h"
+#include "execution/expressions/constant_value_expression.h"
+#include "execution/plans/aggregation_plan.h"
+#include "execution/plans/filter_plan.h"
+#include "execution/plans/mock_scan_plan.h"
+#include "execution/plans/projection_plan.h"
+#include "fmt/core.h"
+#include "type/value_factory.h"
+
+#include <sys/time.h>
+
+auto ClockMs() -> uint64_t {
+  struct timeval tm;
+  gettimeofday(&tm, nullptr);
+  return static_cast<uint64_t>(tm.tv_sec * 1000) + static_cast<uint64_t>(tm.tv_usec / 1000);
+}
+
+namespace bustub {
+
+/** Produces rows (a, b, c) of random integers for the pipelines to consume. */
+class RandomRowsExecutor : public AbstractExecutor {
+ public:
+  RandomRowsExecutor(ExecutorContext *exec_ctx, const Schema *schema, size_t num_rows)
+      : AbstractExecutor(exec_ctx), schema_(schema), num_rows_(num_rows) {}
+
+  void Init() override {
+    generator_.seed(15445);
+    produced_ = 0;
+  }
+
+  auto Next(Tuple *tuple, RID *rid) -> bool override { return NextFromBatch(tuple, rid); }
+
+  auto NextBatch(TupleBatch *batch) -> bool override {
+    batch->Reset(schema_);
+    while (!batch->IsFull() && produced_ < num_rows_) {
+      batch->AppendValues({ValueFactory::GetIntegerValue(generator_() % 1000),
+                           ValueFactory::GetIntegerValue(generator_() % 1000000),
+                           ValueFactory::GetIntegerValue(generator_() % 16)});
+      produced_++;
+    }
+    return !batch->Empty();
+  }
+
+  auto SupportsBatch() const -> bool override { return true; }
+
+  auto GetOutputSchema() const -> const Schema & override { return *schema_; }
+
+ private:
+  const Schema *schema_;
+  size_t num_rows_;
+  size_t produced_{0};
+  std::mt19937 generator_;
+};
+
+auto Col(uint32_t idx) -> AbstractExpressionRef {
+  return std::make_shared<ColumnValueExpression>(0, idx, TypeId::INTEGER);
+}
+auto Int(int32_t value) -> AbstractExpressionRef {
+  return std::make_shared<ConstantValueExpression>(ValueFactory::GetIntegerValue(value));
+}
+auto Arith(AbstractExpressionRef lhs, AbstractExpressionRef rhs, ArithmeticType type) -> AbstractExpressionRef {
+  return std::make_shared<ArithmeticExpression>(std::move(lhs), std::move(rhs), type);
+}
+auto Cmp(AbstractExpressionRef lhs, AbstractExpressionRef rhs, ComparisonType type) -> AbstractExpressionRef {
+  return std::make_shared<ComparisonExpression>(std::move(lhs), std::move(rhs), type);
+}
+
+/** @return the number of rows the executor produces, and the sum of their first column */
+auto Drain(AbstractExecutor *executor) -> std::pair<size_t, int64_t> {
+  executor->Init();
+  TupleBatch batch;
+  size_t count = 0;
+  int64_t sum = 0;
+  while (executor->NextBatch(&batch)) {
+    for (uint32_t i = 0; i < batch.Size(); i++) {
+      const auto &value = batch.GetValue(i, 0);
+      sum += value.IsNull() ? 0 : value.CastAs(TypeId::BIGINT).GetAs<int64_t>();
+      count++;
+    }
+  }
+  return {count, sum};
+}
+
+}  // namespace bustub
+
+// NOLINTNEXTLINE
+auto main(int argc, char **argv) -> int {
+  using bustub::AbstractExecutor;
+  using bustub::AbstractPlanNodeRef;
+
+  argparse::ArgumentParser program("bustub-pipeline-bench");
+  program.add_argument("--rows").help("run the pipelines over n rows");
+
+  try {
+    program.parse_args(argc, argv);
+  } catch (const std::runtime_error &err) {
+    std::cerr << err.what() << std::endl;
+    std::cerr << program;
+    return 1;
+  }
+
+  size_t num_rows = 10000000;
+  if (program.present("--rows")) {
+    num_rows = std::stoul(program.get("--rows"));
+  }
+
+  using bustub::Col;
+  using bustub::Int;
+  using bustub::Column;
+  using bustub::TypeId;
+  auto input_schema = std::make_shared<bustub::Schema>(
+      std::vector<Column>{Column{"a", TypeId::INTEGER}, Column{"b", TypeId::INTEGER}, Column{"c", TypeId::INTEGER}});
+  auto projected_schema = std::make_shared<bustub::Schema>(
+      std::vector<Column>{Column{"c", TypeId::INTEGER}, Column{"ab", TypeId::INTEGER}, Column{"ba", TypeId::INTEGER}});
+  auto agg_schema = std::make_shared<bustub::Schema>(std::vector<Column>{
+      Column{"c", TypeId::INTEGER}, Column{"min", TypeId::INTEGER}, Column{"count", TypeId::INTEGER},
+      Column{"max", TypeId::INTEGER}});
+
+  // SELECT c, min(ab), count(ba), max(ba) FROM (SELECT c, a + b AS ab, b - a AS ba FROM t WHERE a > 100)
+  // WHERE ab > 500000 GROUP BY c
+  AbstractPlanNodeRef source = std::make_shared<bustub::MockScanPlanNode>(input_schema, "random_rows");
+  AbstractPlanNodeRef lower_filter = std::make_shared<bustub::FilterPlanNode>(
+      input_schema, bustub::Cmp(Col(0), Int(100), bustub::ComparisonType::GreaterThan), source);
+  AbstractPlanNodeRef projection = std::make_shared<bustub::ProjectionPlanNode>(
+      projected_schema,
+      std::vector<bustub::AbstractExpressionRef>{Col(2), bustub::Arith(Col(0), Col(1), bustub::ArithmeticType::Plus),
+                                                 bustub::Arith(Col(1), Col(0), bustub::ArithmeticType::Minus)},
+      lower_filter);
+  AbstractPlanNodeRef upper_filter = std::make_shared<bustub::FilterPlanNode>(
+      projected_schema, bustub::Cmp(Col(1), Int(500000), bustub::ComparisonType::GreaterThan), projection);
+  AbstractPlanNodeRef aggregation = std::make_shared<bustub::AggregationPlanNode>(
+      agg_schema, upper_filter, std::vector<bustub::AbstractExpressionRef>{Col(0)},
+      std::vector<bustub::AbstractExpressionRef>{Col(1), Col(2), Col(2)},
+      std::vector<bustub::AggregationType>{bustub::AggregationType::MinAggregate,
+                                           bustub::AggregationType::CountAggregate,
+                                           bustub::AggregationType::MaxAggregate});
+
+  // Nothing spills, so no buffer pool is needed.
+  bustub::ExecutorContext exec_ctx(nullptr, nullptr, nullptr, nullptr, nullptr, false);
+  auto make_source = [&]() {
+    return std::make_unique<bustub::RandomRowsExecutor>(&exec_ctx, input_schema.get(), num_rows);
+  };
+  auto make_chain = [&]() -> std::unique_ptr<AbstractExecutor> {
+    auto filter = std::make_unique<bustub::FilterExecutor>(
+        &exec_ctx, dynamic_cast<const bustub::FilterPlanNode *>(lower_filter.get()), make_source());
+    auto project = std::make_unique<bustub::ProjectionExecutor>(
+        &exec_ctx, dynamic_cast<const bustub::ProjectionPlanNode *>(projection.get()), std::move(filter));
+    return std::make_unique<bustub::FilterExecutor>(
+        &exec_ctx, dynamic_cast<const bustub::FilterPlanNode *>(upper_filter.get()), std::move(project));
+  };
+  const auto *agg_plan = dynamic_cast<const bustub::AggregationPlanNode *>(aggregation.get());
+
+  bustub::PipelineCache cache;
+  auto chain_pipeline = cache.GetOrCompile(upper_filter);
+  auto agg_pipeline = cache.GetOrCompile(aggregation);
+  if (chain_pipeline == nullptr || agg_pipeline == nullptr) {
+    fmt::print(stderr, "[error] the pipelines cannot be compiled\n");
+    return 1;
+  }
+
+  std::vector<std::pair<std::string, std::function<std::unique_ptr<AbstractExecutor>()>>> runs{
+      {"filter-project-filter, interpreted", make_chain},
+      {"filter-project-filter, compiled",
+       [&]() {
+         return std::make_unique<bustub::CompiledPipelineExecutor>(&exec_ctx, upper_filter.get(), chain_pipeline,
+                                                                   make_source());
+       }},
+      {"aggregation, interpreted",
+       [&]() { return std::make_unique<bustub::AggregationExecutor>(&exec_ctx, agg_plan, make_chain()); }},
+      {"aggregation, compiled",
+       [&]() {
+         return std::make_unique<bustub::AggregationExecutor>(&exec_ctx, agg_plan, make_source(), agg_pipeline);
+       }},
+  };
+
+  fmt::print(stderr, "[info] rows={}\n", num_rows);
+  fmt::print("<<< BEGIN\n");
+  std::pair<size_t, int64_t> expected;
+  bool ok = true;
+  for (size_t i = 0; i < runs.size(); i++) {
+    auto executor = runs[i].second();
+    auto start = ClockMs();
+    auto result = bustub::Drain(executor.get());
+    auto end = ClockMs();
+    fmt::print("{}: {} ms, {} rows per second\n", runs[i].first, end - start,
+               num_rows / static_cast<double>(std::max<uint64_t>(end - start, 1)) * 1000);
+    // The compiled run must produce what the interpreted run before it produced.
+    if (i % 2 == 0) {
+      expected = result;
+    } else if (result != expected) {
+      fmt::print(stderr, "[error] {} produced {} rows with sum {}, expected {} rows with sum {}\n", runs[i].first,
+                 result.first, result.second, expected.first, expected.second);
+      ok = false;
+    }
+  }
+  fmt::print(">>> END\n");
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,108 @@
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "argparse/argparse.hpp"
+#include "common/bustub_instance.h"
+#include "fmt/core.h"
+#include "optimizer/plan_cache.h"
+
+#include <sys/time.h>
+
+auto ClockMs() -> uint64_t {
+  struct timeval tm;
+  gettimeofday(&tm, nullptr);
+  return static_cast<uint64_t>(tm.tv_sec * 1000) + static_cast<uint64_t>(tm.tv_usec / 1000);
+}
+
+namespace bustub {
+
+/** Sums the cells of the results, so that runs can be checked against each other. */
+class SumWriter : public NoopWriter {
+ public:
+  void WriteCell(const std::string &cell) override {
+    sum_ += std::stoll(cell);
+    cells_++;
+  }
+
+  int64_t sum_{0};
+  size_t cells_{0};
+};
+
+}  // namespace bustub
+
+// NOLINTNEXTLINE
+auto main(int argc, char **argv) -> int {
+  argparse::ArgumentParser program("bustub-plan-cache-bench");
+  program.add_argument("--statements").help("run n point selects in each run");
+
+  try {
+    program.parse_args(argc, argv);
+  } catch (const std::runtime_error &err) {
+    std::cerr << err.what() << std::endl;
+    std::cerr << program;
+    return 1;
+  }
+
+  size_t num_statements = 20000;
+  if (program.present("--statements")) {
+    num_statements = std::stoul(program.get("--statements"));
+  }
+
+  auto bustub = std::make_unique<bustub::BustubInstance>();
+  bustub->GenerateMockTable();
+  bustub::NoopWriter noop;
+
+  // Point selects on a 100-row table, over a set of hot keys, so that each statement text is run many times.
+  auto key = [](size_t i) { return (i * 37) % 100; };
+  std::vector<std::pair<std::string, std::function<void(size_t, bustub::ResultWriter &)>>> runs{
+      {"ad-hoc, no plan cache",
+       [&](size_t i, bustub::ResultWriter &writer) {
+         bustub->ExecuteSql(fmt::format("select colB from __mock_table_1 where colA = {}", key(i)), writer);
+       }},
+      {"ad-hoc, plan cache",
+       [&](size_t i, bustub::ResultWriter &writer) {
+         bustub->ExecuteSql(fmt::format("select colB from __mock_table_1 where colA = {}", key(i)), writer);
+       }},
+      {"prepared", [&](size_t i, bustub::ResultWriter &writer) {
+         bustub->ExecuteSql(fmt::format("execute point_select({})", key(i)), writer);
+       }}};
+
+  fmt::print(stderr, "[info] statements={}\n", num_statements);
+  fmt::print("<<< BEGIN\n");
+  bool ok = true;
+  int64_t expected = 0;
+  for (size_t r = 0; r < runs.size(); r++) {
+    if (r == 0) {
+      bustub->ExecuteSql("set enable_plan_cache = false", noop);
+    } else if (r == 1) {
+      bustub->ExecuteSql("set enable_plan_cache = true", noop);
+    } else {
+      bustub->ExecuteSql("prepare point_select as select colB from __mock_table_1 where colA = $1", noop);
+    }
+    bustub::SumWriter writer;
+    auto start = ClockMs();
+    for (size_t i = 0; i < num_statements; i++) {
+      runs[r].second(i, writer);
+    }
+    auto end = ClockMs();
+    fmt::print("{}: {} ms, {:.0f} statements per second\n", runs[r].first, end - start,
+               num_statements / static_cast<double>(std::max<uint64_t>(end - start, 1)) * 1000);
+    // Every run must return what the first one returned.
+    if (r == 0) {
+      expected = writer.sum_;
+    } else if (writer.sum_ != expected || writer.cells_ != num_statements) {
+      fmt::print(stderr, "[error] {} returned {} rows with sum {}, expected {}\n", runs[r].first, writer.cells_,
+                 writer.sum_, expected);
+      ok = false;
+    }
+  }
+  fmt::print("plan cache: {} hits, {} misses\n", bustub->plan_cache_->GetHits(), bustub->plan_cache_->GetMisses());
+  fmt::print(">>> END\n");
+  return ok ? 0 : 1;
+}
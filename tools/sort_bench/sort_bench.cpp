@@ -0,0 +1,148 @@
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "argparse/argparse.hpp"
+#include "buffer/buffer_pool_manager.h"
+#include "common/config.h"
+#include "execution/executor_context.h"
+#include "execution/executors/abstract_executor.h"
+#include "execution/executors/sort_executor.h"
+#include "execution/expressions/column_value_expression.h"
+#include "execution/plans/sort_plan.h"
+#include "fmt/core.h"
+#include "storage/disk/disk_manager_memory.h"
+#include "type/limits.h"
+#include "type/value_factory.h"
+
+#include <sys/time.h>
+
+auto ClockMs() -> uint64_t {
+  struct timeval tm;
+  gettimeofday(&tm, nullptr);
+  return static_cast<uint64_t>(tm.tv_sec * 1000) + static_cast<uint64_t>(tm.tv_usec / 1000);
+}
+
+static const size_t LRU_K_SIZE = 16;
+static const size_t BUSTUB_BPM_SIZE = 256;
+
+namespace bustub {
+
+/** Produces rows (random key, sequence number) for the sort to consume. */
+class RandomRowsExecutor : public AbstractExecutor {
+ public:
+  RandomRowsExecutor(ExecutorContext *exec_ctx, const Schema *schema, size_t num_rows)
+      : AbstractExecutor(exec_ctx), schema_(schema), num_rows_(num_rows) {}
+
+  void Init() override {
+    generator_.seed(15445);
+    produced_ = 0;
+  }
+
+  auto Next(Tuple *tuple, RID *rid) -> bool override { return NextFromBatch(tuple, rid); }
+
+  auto NextBatch(TupleBatch *batch) -> bool override {
+    batch->Reset(schema_);
+    while (!batch->IsFull() && produced_ < num_rows_) {
+      batch->AppendValues({ValueFactory::GetIntegerValue(distribution_(generator_)),
+                           ValueFactory::GetBigIntValue(static_cast<int64_t>(produced_++))});
+    }
+    return !batch->Empty();
+  }
+
+  auto SupportsBatch() const -> bool override { return true; }
+
+  auto GetOutputSchema() const -> const Schema & override { return *schema_; }
+
+ private:
+  const Schema *schema_;
+  size_t num_rows_;
+  size_t produced_{0};
+  std::mt19937 generator_;
+  std::uniform_int_distribution<int32_t> distribution_{BUSTUB_INT32_MIN, BUSTUB_INT32_MAX};
+};
+
+}  // namespace bustub
+
+// NOLINTNEXTLINE
+auto main(int argc, char **argv) -> int {
+  using bustub::BufferPoolManager;
+  using bustub::DiskManagerUnlimitedMemory;
+
+  argparse::ArgumentParser program("bustub-sort-bench");
+  program.add_argument("--rows").help("sort n rows");
+  program.add_argument("--budget").help("sort memory budget in percent of the data size");
+
+  try {
+    program.parse_args(argc, argv);
+  } catch (const std::runtime_error &err) {
+    std::cerr << err.what() << std::endl;
+    std::cerr << program;
+    return 1;
+  }
+
+  size_t num_rows = 10000000;
+  if (program.present("--rows")) {
+    num_rows = std::stoul(program.get("--rows"));
+  }
+
+  double budget_percent = 1;
+  if (program.present("--budget")) {
+    budget_percent = std::stod(program.get("--budget"));
+  }
+
+  auto schema = std::make_shared<bustub::Schema>(
+      std::vector<bustub::Column>{bustub::Column{"key", bustub::TypeId::INTEGER},
+                                  bustub::Column{"seq", bustub::TypeId::BIGINT}});
+  auto data_size = num_rows * schema->GetLength();
+  auto budget = static_cast<size_t>(static_cast<double>(data_size) * budget_percent / 100);
+
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(BUSTUB_BPM_SIZE, disk_manager.get(), LRU_K_SIZE);
+  bustub::ExecutorContext exec_ctx(nullptr, nullptr, bpm.get(), nullptr, nullptr, false);
+  exec_ctx.SetSortMemoryBudget(budget);
+
+  std::vector<std::pair<bustub::OrderByType, bustub::AbstractExpressionRef>> order_bys{
+      {bustub::OrderByType::ASC, std::make_shared<bustub::ColumnValueExpression>(0, 0, bustub::TypeId::INTEGER)}};
+  bustub::SortPlanNode plan(schema, nullptr, order_bys);
+  bustub::SortExecutor sort(&exec_ctx, &plan,
+                            std::make_unique<bustub::RandomRowsExecutor>(&exec_ctx, schema.get(), num_rows));
+
+  fmt::print(stderr, "[info] rows={}, data_size={}, sort_memory_budget={}, bpm_size={}\n", num_rows, data_size,
+             budget, BUSTUB_BPM_SIZE);
+
+  auto start = ClockMs();
+  sort.Init();
+  auto runs_done = ClockMs();
+
+  bustub::TupleBatch batch;
+  size_t count = 0;
+  int32_t last = 0;
+  bool ordered = true;
+  while (sort.NextBatch(&batch)) {
+    for (uint32_t i = 0; i < batch.Size(); i++) {
+      auto key = batch.GetValue(i, 0).GetAs<int32_t>();
+      ordered = ordered && (count == 0 || last <= key);
+      last = key;
+      count++;
+    }
+  }
+  auto end = ClockMs();
+
+  fmt::print("<<< BEGIN\n");
+  fmt::print("run generation: {} ms\n", runs_done - start);
+  fmt::print("merge: {} ms\n", end - runs_done);
+  fmt::print("rows per second: {}\n", count / static_cast<double>(std::max<uint64_t>(end - start, 1)) * 1000);
+  fmt::print(">>> END\n");
+
+  if (count != num_rows || !ordered) {
+    fmt::print(stderr, "[error] sorted {} of {} rows, ordered={}\n", count, num_rows, ordered);
+    return 1;
+  }
+  return 0;
+}
@@ -93,6 +93,11 @@ auto ProcessExtraOptions(const std::string &sql, bustub::BustubInstance &instanc
           fmt::print("HashJoin should appear exactly thrice\n");
           return false;
         }
+      } else if (opt == "ensure:merge_join") {
+        if (!bustub::StringUtil::Contains(result.str(), "MergeJoin")) {
+          fmt::print("MergeJoin not found\n");
+          return false;
+        }
       } else if (opt == "ensure:topn") {
         if (!bustub::StringUtil::Contains(result.str(), "TopN")) {
           fmt::print("TopN not found\n");
@@ -110,6 +115,16 @@ auto ProcessExtraOptions(const std::string &sql, bustub::BustubInstance &instanc
           fmt::print("NestedIndexJoin not found\n");
           return false;
         }
+      } else if (opt == "ensure:cte_scan") {
+        if (!bustub::StringUtil::Contains(result.str(), "CTEScan")) {
+          fmt::print("CTEScan not found\n");
+          return false;
+        }
+      } else if (opt == "ensure:no_cte_scan") {
+        if (bustub::StringUtil::Contains(result.str(), "CTEScan")) {
+          fmt::print("CTEScan should not appear\n");
+          return false;
+        }
       } else if (opt == "ensure:nlj_init_check") {
         if (!bustub::StringUtil::Contains(result.str(), "NestedLoopJoin")) {
           fmt::print("NestedLoopJoin not found\n");
@@ -0,0 +1,192 @@
+#include <chrono>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <random>
+#include <string>
+#include <string_view>
+#include <unordered_set>
+#include <vector>
+
+#include "argparse/argparse.hpp"
+#include "fmt/format.h"
+#include "primer/trie.h"
+
+#include <sys/time.h>
+
+auto ClockMs() -> uint64_t {
+  struct timeval tm;
+  gettimeofday(&tm, nullptr);
+  return static_cast<uint64_t>(tm.tv_sec * 1000) + static_cast<uint64_t>(tm.tv_usec / 1000);
+}
+
+static const size_t TOTAL_KEYS = 200000;
+static const size_t KEY_LENGTH = 32;
+
+/**
+ * The copy-on-write trie with one `std::map` per node, i.e. the layout before adaptive radix tree nodes were
+ * introduced. Used as the baseline of this benchmark.
+ */
+class MapTrie {
+ public:
+  struct Node {
+    std::map<char, std::shared_ptr<const Node>> children_;
+    std::shared_ptr<uint64_t> value_;
+  };
+
+  MapTrie() = default;
+
+  auto Get(std::string_view key) const -> const uint64_t * {
+    const Node *node = root_.get();
+    for (char c : key) {
+      if (node == nullptr) {
+        return nullptr;
+      }
+      auto it = node->children_.find(c);
+      node = it == node->children_.end() ? nullptr : it->second.get();
+    }
+    return node == nullptr ? nullptr : node->value_.get();
+  }
+
+  auto Put(std::string_view key, uint64_t value) const -> MapTrie {
+    return MapTrie(PutNode(root_, key, std::make_shared<uint64_t>(value)));
+  }
+
+  auto MemoryUsage() const -> size_t { return MemoryUsage(root_.get()); }
+
+ private:
+  explicit MapTrie(std::shared_ptr<const Node> root) : root_(std::move(root)) {}
+
+  static auto PutNode(const std::shared_ptr<const Node> &node, std::string_view key,
+                      const std::shared_ptr<uint64_t> &value) -> std::shared_ptr<const Node> {
+    auto new_node = node == nullptr ? std::make_shared<Node>() : std::make_shared<Node>(*node);
+    if (key.empty()) {
+      new_node->value_ = value;
+      return new_node;
+    }
+    auto it = new_node->children_.find(key[0]);
+    auto child = it == new_node->children_.end() ? nullptr : it->second;
+    new_node->children_[key[0]] = PutNode(child, key.substr(1), value);
+    return new_node;
+  }
+
+  static auto MemoryUsage(const Node *node) -> size_t {
+    if (node == nullptr) {
+      return 0;
+    }
+    // Every map entry is a red-black tree node: three pointers and a color besides the payload.
+    constexpr size_t map_node_size = 4 * sizeof(void *) + sizeof(std::pair<char, std::shared_ptr<const Node>>);
+    size_t bytes = sizeof(Node) + node->children_.size() * map_node_size;
+    if (node->value_ != nullptr) {
+      bytes += sizeof(uint64_t);
+    }
+    for (const auto &[c, child] : node->children_) {
+      bytes += MemoryUsage(child.get());
+    }
+    return bytes;
+  }
+
+  std::shared_ptr<const Node> root_;
+};
+
+auto ArtMemoryUsage(const bustub::TrieNode *node) -> size_t {
+  size_t bytes = node->is_value_node_ ? sizeof(bustub::TrieNodeWithValue<uint64_t>) + sizeof(uint64_t)
+                                      : sizeof(bustub::TrieNode);
+  bytes += node->children_.MemoryUsage();
+  if (node->prefix_.capacity() > std::string().capacity()) {
+    bytes += node->prefix_.capacity();
+  }
+  node->children_.ForEach([&](char c, const std::shared_ptr<const bustub::TrieNode> &child) {
+    bytes += ArtMemoryUsage(child.get());
+  });
+  return bytes;
+}
+
+template <class TrieType, class MemoryFn>
+void RunBench(const std::string &name, const std::vector<std::string> &keys, size_t rounds, MemoryFn memory_fn) {
+  TrieType trie;
+  auto start = ClockMs();
+  for (size_t i = 0; i < keys.size(); i++) {
+    trie = trie.Put(keys[i], i);
+  }
+  auto put_ms = std::max<uint64_t>(ClockMs() - start, 1);
+
+  start = ClockMs();
+  uint64_t checksum = 0;
+  for (size_t round = 0; round < rounds; round++) {
+    for (const auto &key : keys) {
+      checksum += *trie.Get(key);
+    }
+  }
+  auto get_ms = std::max<uint64_t>(ClockMs() - start, 1);
+
+  auto bytes = memory_fn(trie);
+  fmt::print("{:<8} put: {:>12.0f} ops/s  get: {:>12.0f} ops/s  memory: {:>8.1f} bytes/key  (checksum={})\n", name,
+             keys.size() / static_cast<double>(put_ms) * 1000,
+             keys.size() * rounds / static_cast<double>(get_ms) * 1000, bytes / static_cast<double>(keys.size()),
+             checksum);
+}
+
+/** Adapts bustub::Trie to the interface used by `RunBench`. */
+class ArtTrie {
+ public:
+  auto Get(std::string_view key) const -> const uint64_t * { return trie_.Get<uint64_t>(key); }
+  auto Put(std::string_view key, uint64_t value) const -> ArtTrie { return ArtTrie(trie_.Put<uint64_t>(key, value)); }
+  auto GetRoot() const { return trie_.GetRoot(); }
+
+  ArtTrie() = default;
+
+ private:
+  explicit ArtTrie(bustub::Trie trie) : trie_(std::move(trie)) {}
+  bustub::Trie trie_;
+};
+
+// NOLINTNEXTLINE
+auto main(int argc, char **argv) -> int {
+  argparse::ArgumentParser program("bustub-trie-bench");
+  program.add_argument("--keys").help("number of keys to insert");
+  program.add_argument("--key-length").help("length of each key in bytes");
+  program.add_argument("--rounds").help("number of passes over all keys for the get benchmark");
+
+  try {
+    program.parse_args(argc, argv);
+  } catch (const std::runtime_error &err) {
+    std::cerr << err.what() << std::endl;
+    std::cerr << program;
+    return 1;
+  }
+
+  size_t total_keys = TOTAL_KEYS;
+  if (program.present("--keys")) {
+    total_keys = std::stoi(program.get("--keys"));
+  }
+  size_t key_length = KEY_LENGTH;
+  if (program.present("--key-length")) {
+    key_length = std::stoi(program.get("--key-length"));
+  }
+  size_t rounds = 5;
+  if (program.present("--rounds")) {
+    rounds = std::stoi(program.get("--rounds"));
+  }
+
+  fmt::print(stderr, "[info] total_keys={}, key_length={}, rounds={}\n", total_keys, key_length, rounds);
+
+  std::mt19937_64 gen(2333);
+  std::uniform_int_distribution<int> byte_dis(0, 255);
+  std::unordered_set<std::string> seen;
+  std::vector<std::string> keys;
+  while (keys.size() < total_keys) {
+    std::string key(key_length, '\0');
+    for (auto &c : key) {
+      c = static_cast<char>(byte_dis(gen));
+    }
+    if (seen.insert(key).second) {
+      keys.push_back(std::move(key));
+    }
+  }
+
+  RunBench<MapTrie>("map", keys, rounds, [](const MapTrie &trie) { return trie.MemoryUsage(); });
+  RunBench<ArtTrie>("art", keys, rounds, [](const ArtTrie &trie) { return ArtMemoryUsage(trie.GetRoot().get()); });
+
+  return 0;
+}